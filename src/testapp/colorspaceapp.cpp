@@ -71,6 +71,7 @@ struct Arguments {
 	double peak_luminance;
 	char approximate_gamma;
 	char scene_referred;
+	unsigned lut_size;
 	const char *visualise_path;
 	unsigned times;
 	zimg::CPUClass cpu;
@@ -84,6 +85,7 @@ const ArgparseOption program_switches[] = {
 	{ OPTION_FLOAT,  nullptr, "peak-luminance", offsetof(Arguments, peak_luminance),    nullptr, "nominal peak luminance for SDR (cd/m^2)" },
 	{ OPTION_FLAG,   nullptr, "lut",            offsetof(Arguments, approximate_gamma), nullptr, "use LUT to evaluate transfer functions" },
 	{ OPTION_FLAG,   "s",     "scene-referred", offsetof(Arguments, scene_referred),    nullptr, "use scene-referred transfer functions" },
+	{ OPTION_UINT,   nullptr, "lut3d",          offsetof(Arguments, lut_size),          nullptr, "approximate conversion by 3D LUT of given size" },
 	{ OPTION_STRING, nullptr, "visualise",      offsetof(Arguments, visualise_path),    nullptr, "path to BMP file for visualisation" },
 	{ OPTION_UINT,   nullptr, "times",          offsetof(Arguments, times),             nullptr, "number of benchmark cycles" },
 	{ OPTION_USER1,  nullptr, "cpu",            offsetof(Arguments, cpu),               arg_decode_cpu, "select CPU type" },
@@ -137,10 +139,14 @@ int colorspace_main(int argc, char **argv)
 		    .set_csp_out(args.csp_out)
 		    .set_approximate_gamma(!!args.approximate_gamma)
 		    .set_scene_referred(!!args.scene_referred)
+		    .set_lut_size(args.lut_size)
 		    .set_cpu(args.cpu);
 		if (!std::isnan(args.peak_luminance))
 			conv.set_peak_luminance(args.peak_luminance);
 
+		if (args.lut_size)
+			std::cout << "3D LUT max error: " << conv.measure_lut_error() << '\n';
+
 		auto convert = conv.create();
 		execute(convert.get(), &src_frame, &dst_frame, args.times);
 
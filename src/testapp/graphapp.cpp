@@ -194,6 +194,18 @@ void read_graph_params(zimg::graph::GraphBuilder::params *params, const json::Ob
 		params->scene_referred = val.boolean();
 	if (const auto &val = obj["cpu"])
 		params->cpu = g_cpu_table[val.string().c_str()];
+	if (const auto &val = obj["tile_autotune"])
+		params->tile_autotune = val.boolean();
+	if (const auto &val = obj["tile_profile"])
+		params->tile_profile = val.string();
+	if (const auto &val = obj["colorspace_lut_size"])
+		params->colorspace_lut_size = static_cast<unsigned>(val.number());
+	if (const auto &val = obj["specialized_kernels"])
+		params->specialized_kernels = val.boolean();
+	if (const auto &val = obj["concurrent_graphs"])
+		params->concurrent_graphs = static_cast<unsigned>(val.number());
+	if (const auto &val = obj["disable_fusion"])
+		params->disable_fusion = val.boolean();
 }
 
 std::unique_ptr<zimg::graph::FilterGraph> create_graph(const json::Object &spec,
@@ -267,7 +279,37 @@ void thread_target(const zimg::graph::FilterGraph *graph,
 	}
 }
 
-void execute(const json::Object &spec, unsigned times, unsigned threads, unsigned tile_width)
+void execute_frame_threads(const zimg::graph::FilterGraph &graph,
+                          const zimg::graph::GraphBuilder::state &src_state,
+                          const zimg::graph::GraphBuilder::state &dst_state,
+                          unsigned times,
+                          unsigned threads)
+{
+	ImageFrame src_frame = allocate_frame(src_state);
+	ImageFrame dst_frame = allocate_frame(dst_state);
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(threads));
+
+	// Compare serial processing against frames divided among threads.
+	for (unsigned n : { 1U, threads }) {
+		Timer timer;
+
+		timer.start();
+		for (unsigned i = 0; i < times; ++i) {
+			if (n > 1)
+				graph.process_mt(src_frame.as_read_buffer(), dst_frame.as_write_buffer(), tmp.data(), nullptr, nullptr, n);
+			else
+				graph.process(src_frame.as_read_buffer(), dst_frame.as_write_buffer(), tmp.data(), nullptr, nullptr);
+		}
+		timer.stop();
+
+		std::cout << '\n';
+		std::cout << "frame threads: " << n << '\n';
+		std::cout << "iterations:    " << times << '\n';
+		std::cout << "fps:           " << times / timer.elapsed() << '\n';
+	}
+}
+
+void execute(const json::Object &spec, unsigned times, unsigned threads, unsigned frame_threads, unsigned tile_width)
 {
 	zimg::graph::GraphBuilder::state src_state;
 	zimg::graph::GraphBuilder::state dst_state;
@@ -282,6 +324,11 @@ void execute(const json::Object &spec, unsigned times, unsigned threads, unsigne
 	std::cout << "heap size:        " << graph->get_tmp_size() << '\n';
 	std::cout << "tile width:       " << graph->tile_width() << '\n';
 
+	if (frame_threads) {
+		execute_frame_threads(*graph, src_state, dst_state, times, frame_threads);
+		return;
+	}
+
 	if (!threads && !std::thread::hardware_concurrency())
 		throw std::runtime_error{ "could not auto-detect CPU count" };
 
@@ -322,13 +369,15 @@ struct Arguments {
 	const char *specpath;
 	unsigned times;
 	unsigned threads;
+	unsigned frame_threads;
 	unsigned tile_width;
 };
 
 const ArgparseOption program_switches[] = {
 	{ OPTION_UINT, nullptr, "times",      offsetof(Arguments, times),      nullptr, "number of benchmark cycles per thread" },
-	{ OPTION_UINT, nullptr, "threads",    offsetof(Arguments, threads),    nullptr, "number of threads" },
-	{ OPTION_UINT, nullptr, "tile-width", offsetof(Arguments, tile_width), nullptr, "graph tile width" },
+	{ OPTION_UINT, nullptr, "threads",       offsetof(Arguments, threads),       nullptr, "number of threads" },
+	{ OPTION_UINT, nullptr, "frame-threads", offsetof(Arguments, frame_threads), nullptr, "compare serial processing against multithreaded frames" },
+	{ OPTION_UINT, nullptr, "tile-width",    offsetof(Arguments, tile_width),    nullptr, "graph tile width" },
 	{ OPTION_NULL }
 };
 
@@ -354,7 +403,7 @@ int graph_main(int argc, char **argv)
 
 	try {
 		json::Object spec = read_graph_spec(args.specpath);
-		execute(spec, args.times, args.threads, args.tile_width);
+		execute(spec, args.times, args.threads, args.frame_threads, args.tile_width);
 	} catch (const zimg::error::Exception &e) {
 		std::cerr << e.what() << '\n';
 		return 2;
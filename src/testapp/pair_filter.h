@@ -38,6 +38,8 @@ private:
 public:
 	PairFilter(std::unique_ptr<zimg::graph::ImageFilter> &&first, std::unique_ptr<zimg::graph::ImageFilter> &&second);
 
+	const char *get_name() const override { return "pair"; }
+
 	filter_flags get_flags() const override;
 
 	image_attributes get_image_attributes() const override;
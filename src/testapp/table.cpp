@@ -43,9 +43,12 @@ filter_uptr make_null_filter(double, double) { return nullptr; }
 } // namespace
 
 
-const zimg::static_string_map<CPUClass, 8> g_cpu_table{
+const zimg::static_string_map<CPUClass, 9> g_cpu_table{
 	{ "none", CPUClass::NONE },
 	{ "auto", CPUClass::AUTO_64B },
+#ifdef ZIMG_GENERIC_SIMD
+	{ "generic", CPUClass::GENERIC_SIMD },
+#endif
 #ifdef ZIMG_X86
 	{ "sse",    CPUClass::X86_SSE },
 	{ "sse2",   CPUClass::X86_SSE2 },
@@ -140,6 +140,13 @@ struct zfilter_graph_builder_params : zimg_graph_builder_params {
 	}
 };
 
+struct ztask_scheduler : zimg_task_scheduler {
+	ztask_scheduler()
+	{
+		zimg_task_scheduler_default(this, ZIMG_API_VERSION);
+	}
+};
+
 class FilterGraph {
 private:
 	zimg_filter_graph *m_graph;
@@ -209,6 +216,27 @@ public:
 		check(zimg_filter_graph_process(m_graph, &src, &dst, tmp, unpack_cb, unpack_user, pack_cb, pack_user));
 	}
 
+	size_t get_tmp_size_mt(unsigned threads) const
+	{
+		size_t ret;
+		check(zimg_filter_graph_get_tmp_size_mt(m_graph, threads, &ret));
+		return ret;
+	}
+
+	void process_mt(const zimg_image_buffer_const &src, const zimg_image_buffer &dst, void *tmp, unsigned threads,
+	                zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
+	                zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0) const
+	{
+		check(zimg_filter_graph_process_mt(m_graph, &src, &dst, tmp, unpack_cb, unpack_user, pack_cb, pack_user, threads));
+	}
+
+	void process_scheduled(const zimg_image_buffer_const &src, const zimg_image_buffer &dst, void *tmp, const zimg_task_scheduler &scheduler,
+	                       zimg_filter_graph_callback unpack_cb = 0, void *unpack_user = 0,
+	                       zimg_filter_graph_callback pack_cb = 0, void *pack_user = 0) const
+	{
+		check(zimg_filter_graph_process_scheduled(m_graph, &src, &dst, tmp, unpack_cb, unpack_user, pack_cb, pack_user, &scheduler));
+	}
+
 	static zimg_filter_graph *build(const zimg_image_format &src_format, const zimg_image_format &dst_format, const zimg_graph_builder_params *params = 0)
 	{
 		zimg_filter_graph *graph;
@@ -220,6 +248,47 @@ public:
 	}
 };
 
+class GraphCache {
+private:
+	zimg_graph_cache *m_cache;
+
+	GraphCache(const GraphCache &);
+
+	GraphCache &operator=(const GraphCache &);
+
+	void check(zimg_error_code_e err) const
+	{
+		if (err)
+			throw zerror();
+	}
+public:
+	explicit GraphCache(size_t max_entries = 0) : m_cache(zimg_graph_cache_create(max_entries))
+	{
+		if (!m_cache)
+			throw zerror();
+	}
+
+	~GraphCache()
+	{
+		zimg_graph_cache_free(m_cache);
+	}
+
+	zimg_filter_graph *get(const zimg_image_format &src_format, const zimg_image_format &dst_format, const zimg_graph_builder_params *params = 0)
+	{
+		zimg_filter_graph *graph;
+
+		if (!(graph = zimg_graph_cache_get(m_cache, &src_format, &dst_format, params)))
+			throw zerror();
+
+		return graph;
+	}
+
+	void get_stats(unsigned long long *hits, unsigned long long *misses, size_t *entries) const
+	{
+		check(zimg_graph_cache_get_stats(m_cache, hits, misses, entries));
+	}
+};
+
 } // namespace zimgxx
 
 #endif // ZIMGPLUSPLUS_HPP_
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -9,8 +10,10 @@
 #include "common/make_unique.h"
 #include "common/pixel.h"
 #include "common/static_map.h"
+#include "common/version.h"
 #include "common/zassert.h"
 #include "graph/filtergraph.h"
+#include "graph/graph_cache.h"
 #include "graph/graphbuilder.h"
 #include "graph/image_buffer.h"
 #include "colorspace/colorspace.h"
@@ -25,6 +28,7 @@ namespace {
 constexpr unsigned API_VERSION_2_0 = ZIMG_MAKE_API_VERSION(2, 0);
 constexpr unsigned API_VERSION_2_1 = ZIMG_MAKE_API_VERSION(2, 1);
 constexpr unsigned API_VERSION_2_2 = ZIMG_MAKE_API_VERSION(2, 2);
+constexpr unsigned API_VERSION_2_4 = ZIMG_MAKE_API_VERSION(2, 4);
 
 #define API_VERSION_ASSERT(x) zassert_d((x) >= API_VERSION_2_0, "API version invalid")
 #define POINTER_ALIGNMENT_ASSERT(x) zassert_d(!(x) || reinterpret_cast<uintptr_t>(x) % zimg::ALIGNMENT_RELAXED == 0, "pointer not aligned")
@@ -36,8 +40,6 @@ constexpr unsigned API_VERSION_2_2 = ZIMG_MAKE_API_VERSION(2, 2);
 thread_local zimg_error_code_e g_last_error = ZIMG_ERROR_SUCCESS;
 thread_local std::string g_last_error_msg;
 
-constexpr unsigned VERSION_INFO[] = { 2, 6, 3 };
-
 
 template <class T, class U>
 T *assert_dynamic_type(U *ptr) noexcept
@@ -129,10 +131,15 @@ zimg::CPUClass translate_cpu(zimg_cpu_type_e cpu)
 {
 	using zimg::CPUClass;
 
-	static SM_CONSTEXPR_14 const zimg::static_map<zimg_cpu_type_e, CPUClass, 15> map{
+	static SM_CONSTEXPR_14 const zimg::static_map<zimg_cpu_type_e, CPUClass, 16> map{
 		{ ZIMG_CPU_NONE,           CPUClass::NONE },
 		{ ZIMG_CPU_AUTO,           CPUClass::AUTO },
 		{ ZIMG_CPU_AUTO_64B,       CPUClass::AUTO_64B },
+#ifdef ZIMG_GENERIC_SIMD
+		{ ZIMG_CPU_GENERIC_SIMD,   CPUClass::GENERIC_SIMD },
+#else
+		{ ZIMG_CPU_GENERIC_SIMD,   CPUClass::NONE },
+#endif
 #ifdef ZIMG_X86
 		{ ZIMG_CPU_X86_MMX,        CPUClass::NONE },
 		{ ZIMG_CPU_X86_SSE,        CPUClass::X86_SSE },
@@ -197,6 +204,26 @@ zimg::graph::GraphBuilder::FieldParity translate_field_parity(zimg_field_parity_
 	return search_enum_map(map, field, "unrecognized field parity");
 }
 
+zimg::graph::GraphBuilder::PixelPacking translate_pixel_packing(zimg_pixel_packing_e packing)
+{
+	using zimg::graph::GraphBuilder;
+
+	static SM_CONSTEXPR_14 const zimg::static_map<zimg_pixel_packing_e, GraphBuilder::PixelPacking, 11> map{
+		{ ZIMG_PACKING_PLANAR, GraphBuilder::PixelPacking::PLANAR },
+		{ ZIMG_PACKING_RGB,    GraphBuilder::PixelPacking::RGB },
+		{ ZIMG_PACKING_BGR,    GraphBuilder::PixelPacking::BGR },
+		{ ZIMG_PACKING_RGBA,   GraphBuilder::PixelPacking::RGBA },
+		{ ZIMG_PACKING_BGRA,   GraphBuilder::PixelPacking::BGRA },
+		{ ZIMG_PACKING_ARGB,   GraphBuilder::PixelPacking::ARGB },
+		{ ZIMG_PACKING_ABGR,   GraphBuilder::PixelPacking::ABGR },
+		{ ZIMG_PACKING_NV12,   GraphBuilder::PixelPacking::NV12 },
+		{ ZIMG_PACKING_YUY2,   GraphBuilder::PixelPacking::YUY2 },
+		{ ZIMG_PACKING_V210,   GraphBuilder::PixelPacking::V210 },
+		{ ZIMG_PACKING_Y410,   GraphBuilder::PixelPacking::Y410 },
+	};
+	return search_enum_map(map, packing, "unrecognized pixel packing");
+}
+
 std::pair<zimg::graph::GraphBuilder::ChromaLocationW, zimg::graph::GraphBuilder::ChromaLocationH> translate_chroma_location(zimg_chroma_location_e chromaloc)
 {
 	typedef zimg::graph::GraphBuilder::ChromaLocationW ChromaLocationW;
@@ -364,6 +391,47 @@ zimg::graph::ColorImageBuffer<const void> import_image_buffer(const zimg_image_b
 	return dst;
 }
 
+void check_buffer_alignment(const zimg::graph::FilterGraph *graph, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp)
+{
+	if (graph->requires_64b_alignment()) {
+		POINTER_ALIGNMENT64_ASSERT(src->plane[0].data);
+		POINTER_ALIGNMENT64_ASSERT(src->plane[1].data);
+		POINTER_ALIGNMENT64_ASSERT(src->plane[2].data);
+
+		STRIDE_ALIGNMENT64_ASSERT(src->plane[0].stride);
+		STRIDE_ALIGNMENT64_ASSERT(src->plane[1].stride);
+		STRIDE_ALIGNMENT64_ASSERT(src->plane[2].stride);
+
+		POINTER_ALIGNMENT64_ASSERT(dst->plane[0].data);
+		POINTER_ALIGNMENT64_ASSERT(dst->plane[1].data);
+		POINTER_ALIGNMENT64_ASSERT(dst->plane[2].data);
+
+		STRIDE_ALIGNMENT64_ASSERT(dst->plane[0].stride);
+		STRIDE_ALIGNMENT64_ASSERT(dst->plane[1].stride);
+		STRIDE_ALIGNMENT64_ASSERT(dst->plane[2].stride);
+
+		POINTER_ALIGNMENT64_ASSERT(tmp);
+	} else {
+		POINTER_ALIGNMENT_ASSERT(src->plane[0].data);
+		POINTER_ALIGNMENT_ASSERT(src->plane[1].data);
+		POINTER_ALIGNMENT_ASSERT(src->plane[2].data);
+
+		STRIDE_ALIGNMENT_ASSERT(src->plane[0].stride);
+		STRIDE_ALIGNMENT_ASSERT(src->plane[1].stride);
+		STRIDE_ALIGNMENT_ASSERT(src->plane[2].stride);
+
+		POINTER_ALIGNMENT_ASSERT(dst->plane[0].data);
+		POINTER_ALIGNMENT_ASSERT(dst->plane[1].data);
+		POINTER_ALIGNMENT_ASSERT(dst->plane[2].data);
+
+		STRIDE_ALIGNMENT_ASSERT(dst->plane[0].stride);
+		STRIDE_ALIGNMENT_ASSERT(dst->plane[1].stride);
+		STRIDE_ALIGNMENT_ASSERT(dst->plane[2].stride);
+
+		POINTER_ALIGNMENT_ASSERT(tmp);
+	}
+}
+
 void import_graph_state_common(const zimg_image_format &src, zimg::graph::GraphBuilder::state *out)
 {
 	if (src.version >= API_VERSION_2_0) {
@@ -393,6 +461,10 @@ void import_graph_state_common(const zimg_image_format &src, zimg::graph::GraphB
 		out->active_width = src.width;
 		out->active_height = src.height;
 	}
+	if (src.version >= API_VERSION_2_4)
+		out->packing = translate_pixel_packing(src.pixel_packing);
+	else
+		out->packing = zimg::graph::GraphBuilder::PixelPacking::PLANAR;
 }
 
 std::pair<zimg::graph::GraphBuilder::state, zimg::graph::GraphBuilder::state> import_graph_state(const zimg_image_format &src, const zimg_image_format &dst)
@@ -447,10 +519,122 @@ zimg::graph::GraphBuilder::params import_graph_params(const zimg_graph_builder_p
 		params.peak_luminance = src.nominal_peak_luminance;
 		params.approximate_gamma = !!src.allow_approximate_gamma;
 	}
+	if (src.version >= API_VERSION_2_4) {
+		params.tile_autotune = !!src.tile_autotune;
+		params.tile_profile = src.tile_profile ? src.tile_profile : "";
+		params.colorspace_lut_size = src.colorspace_lut_size;
+		params.specialized_kernels = !!src.allow_specialized_kernels;
+		params.concurrent_graphs = src.concurrent_graphs;
+	}
 
 	return params;
 }
 
+class GraphCacheKey {
+	std::string m_key;
+
+	template <class T>
+	void append_raw(const T &x)
+	{
+		m_key.append(reinterpret_cast<const char *>(&x), sizeof(x));
+	}
+public:
+	template <class T>
+	void append(T x)
+	{
+		static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "type must be integral or enumeration");
+		append_raw(x);
+	}
+
+	void append(double x)
+	{
+		// Treat all NaNs as equal.
+		append_raw(std::isnan(x) ? static_cast<double>(NAN) : x);
+	}
+
+	void append(const char *str)
+	{
+		size_t len = str ? std::strlen(str) : 0;
+		append_raw(len);
+		m_key.append(str ? str : "", len);
+	}
+
+	void append(const zimg_image_format &fmt)
+	{
+		API_VERSION_ASSERT(fmt.version);
+
+		append(fmt.width);
+		append(fmt.height);
+		append(fmt.pixel_type);
+		append(fmt.subsample_w);
+		append(fmt.subsample_h);
+		append(fmt.color_family);
+		append(fmt.matrix_coefficients);
+		append(fmt.transfer_characteristics);
+		append(fmt.color_primaries);
+		append(fmt.depth);
+		append(fmt.pixel_range);
+		append(fmt.field_parity);
+		append(fmt.chroma_location);
+
+		bool v2_1 = fmt.version >= API_VERSION_2_1;
+		append(v2_1 ? fmt.active_region.left : NAN);
+		append(v2_1 ? fmt.active_region.top : NAN);
+		append(v2_1 ? fmt.active_region.width : NAN);
+		append(v2_1 ? fmt.active_region.height : NAN);
+
+		bool v2_4 = fmt.version >= API_VERSION_2_4;
+		append(v2_4 ? fmt.pixel_packing : ZIMG_PACKING_PLANAR);
+	}
+
+	void append(const zimg_graph_builder_params *params)
+	{
+		append(!!params);
+		if (!params)
+			return;
+
+		API_VERSION_ASSERT(params->version);
+
+		append(params->resample_filter);
+		append(params->filter_param_a);
+		append(params->filter_param_b);
+		append(params->resample_filter_uv);
+		append(params->filter_param_a_uv);
+		append(params->filter_param_b_uv);
+		append(params->dither_type);
+		append(params->cpu_type);
+
+		bool v2_2 = params->version >= API_VERSION_2_2;
+		append(v2_2 ? params->nominal_peak_luminance : NAN);
+		append(v2_2 ? !!params->allow_approximate_gamma : false);
+
+		bool v2_4 = params->version >= API_VERSION_2_4;
+		append(v2_4 ? !!params->tile_autotune : false);
+		append(v2_4 && params->tile_autotune ? params->tile_profile : nullptr);
+		append(v2_4 ? params->colorspace_lut_size : 0U);
+		append(v2_4 ? !!params->allow_specialized_kernels : false);
+		append(v2_4 ? params->concurrent_graphs : 0U);
+	}
+
+	std::string release() { return std::move(m_key); }
+};
+
+zimg::graph::FilterGraph *build_graph(const zimg_image_format &src_format, const zimg_image_format &dst_format, const zimg_graph_builder_params *params)
+{
+	zimg::graph::GraphBuilder::state src_state;
+	zimg::graph::GraphBuilder::state dst_state;
+	zimg::graph::GraphBuilder::params graph_params;
+
+	std::tie(src_state, dst_state) = import_graph_state(src_format, dst_format);
+	if (params)
+		graph_params = import_graph_params(*params);
+
+	return zimg::graph::GraphBuilder{}.set_source(src_state)
+	                                  .connect_graph(dst_state, params ? &graph_params : nullptr)
+	                                  .complete_graph()
+	                                  .release();
+}
+
 } // namespace
 
 
@@ -460,9 +644,9 @@ void zimg_get_version_info(unsigned *major, unsigned *minor, unsigned *micro)
 	zassert_d(minor, "null pointer");
 	zassert_d(micro, "null pointer");
 
-	*major = VERSION_INFO[0];
-	*minor = VERSION_INFO[1];
-	*micro = VERSION_INFO[2];
+	*major = zimg::VERSION_INFO[0];
+	*minor = zimg::VERSION_INFO[1];
+	*micro = zimg::VERSION_INFO[2];
 }
 
 unsigned zimg_get_api_version(unsigned *major, unsigned *minor)
@@ -551,47 +735,66 @@ zimg_error_code_e zimg_filter_graph_process(const zimg_filter_graph *ptr, const
 	EX_BEGIN
 	const zimg::graph::FilterGraph *graph = assert_dynamic_type<const zimg::graph::FilterGraph>(ptr);
 
-	if (graph->requires_64b_alignment()) {
-		POINTER_ALIGNMENT64_ASSERT(src->plane[0].data);
-		POINTER_ALIGNMENT64_ASSERT(src->plane[1].data);
-		POINTER_ALIGNMENT64_ASSERT(src->plane[2].data);
+	check_buffer_alignment(graph, src, dst, tmp);
 
-		STRIDE_ALIGNMENT64_ASSERT(src->plane[0].stride);
-		STRIDE_ALIGNMENT64_ASSERT(src->plane[1].stride);
-		STRIDE_ALIGNMENT64_ASSERT(src->plane[2].stride);
+	auto src_buf = import_image_buffer(*src);
+	auto dst_buf = import_image_buffer(*dst);
+	graph->process(src_buf, dst_buf, tmp, { unpack_cb, unpack_user }, { pack_cb, pack_user });
+	EX_END
+}
 
-		POINTER_ALIGNMENT64_ASSERT(dst->plane[0].data);
-		POINTER_ALIGNMENT64_ASSERT(dst->plane[1].data);
-		POINTER_ALIGNMENT64_ASSERT(dst->plane[2].data);
+zimg_error_code_e zimg_filter_graph_get_tmp_size_mt(const zimg_filter_graph *ptr, unsigned threads, size_t *out)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(out, "null pointer");
 
-		STRIDE_ALIGNMENT64_ASSERT(dst->plane[0].stride);
-		STRIDE_ALIGNMENT64_ASSERT(dst->plane[1].stride);
-		STRIDE_ALIGNMENT64_ASSERT(dst->plane[2].stride);
+	EX_BEGIN
+	*out = assert_dynamic_type<const zimg::graph::FilterGraph>(ptr)->get_tmp_size_mt(threads);
+	EX_END
+}
 
-		POINTER_ALIGNMENT64_ASSERT(tmp);
-	} else {
-		POINTER_ALIGNMENT_ASSERT(src->plane[0].data);
-		POINTER_ALIGNMENT_ASSERT(src->plane[1].data);
-		POINTER_ALIGNMENT_ASSERT(src->plane[2].data);
+zimg_error_code_e zimg_filter_graph_process_mt(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                               zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                               zimg_filter_graph_callback pack_cb, void *pack_user,
+                                               unsigned threads)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(src, "null pointer");
+	zassert_d(dst, "null pointer");
 
-		STRIDE_ALIGNMENT_ASSERT(src->plane[0].stride);
-		STRIDE_ALIGNMENT_ASSERT(src->plane[1].stride);
-		STRIDE_ALIGNMENT_ASSERT(src->plane[2].stride);
+	EX_BEGIN
+	const zimg::graph::FilterGraph *graph = assert_dynamic_type<const zimg::graph::FilterGraph>(ptr);
 
-		POINTER_ALIGNMENT_ASSERT(dst->plane[0].data);
-		POINTER_ALIGNMENT_ASSERT(dst->plane[1].data);
-		POINTER_ALIGNMENT_ASSERT(dst->plane[2].data);
+	check_buffer_alignment(graph, src, dst, tmp);
 
-		STRIDE_ALIGNMENT_ASSERT(dst->plane[0].stride);
-		STRIDE_ALIGNMENT_ASSERT(dst->plane[1].stride);
-		STRIDE_ALIGNMENT_ASSERT(dst->plane[2].stride);
+	auto src_buf = import_image_buffer(*src);
+	auto dst_buf = import_image_buffer(*dst);
+	graph->process_mt(src_buf, dst_buf, tmp, { unpack_cb, unpack_user }, { pack_cb, pack_user }, threads);
+	EX_END
+}
 
-		POINTER_ALIGNMENT_ASSERT(tmp);
-	}
+zimg_error_code_e zimg_filter_graph_process_scheduled(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                                      zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                      zimg_filter_graph_callback pack_cb, void *pack_user,
+                                                      const zimg_task_scheduler *scheduler)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(src, "null pointer");
+	zassert_d(dst, "null pointer");
+	zassert_d(scheduler, "null pointer");
+	zassert_d(scheduler->submit, "null pointer");
+	zassert_d(scheduler->wait, "null pointer");
+
+	EX_BEGIN
+	const zimg::graph::FilterGraph *graph = assert_dynamic_type<const zimg::graph::FilterGraph>(ptr);
+
+	API_VERSION_ASSERT(scheduler->version);
+	check_buffer_alignment(graph, src, dst, tmp);
 
 	auto src_buf = import_image_buffer(*src);
 	auto dst_buf = import_image_buffer(*dst);
-	graph->process(src_buf, dst_buf, tmp, { unpack_cb, unpack_user }, { pack_cb, pack_user });
+	zimg::graph::FilterGraph::scheduler sched{ scheduler->submit, scheduler->wait, scheduler->user };
+	graph->process_mt(src_buf, dst_buf, tmp, { unpack_cb, unpack_user }, { pack_cb, pack_user }, scheduler->num_workers, sched);
 	EX_END
 }
 
@@ -630,6 +833,8 @@ void zimg_image_format_default(zimg_image_format *ptr, unsigned version)
 		ptr->active_region.width = NAN;
 		ptr->active_region.height = NAN;
 	}
+	if (version >= API_VERSION_2_4)
+		ptr->pixel_packing = ZIMG_PACKING_PLANAR;
 }
 
 void zimg_graph_builder_params_default(zimg_graph_builder_params *ptr, unsigned version)
@@ -656,6 +861,28 @@ void zimg_graph_builder_params_default(zimg_graph_builder_params *ptr, unsigned
 		ptr->nominal_peak_luminance = NAN;
 		ptr->allow_approximate_gamma = 0;
 	}
+	if (version >= API_VERSION_2_4) {
+		ptr->tile_autotune = 0;
+		ptr->tile_profile = nullptr;
+		ptr->colorspace_lut_size = 0;
+		ptr->allow_specialized_kernels = 0;
+		ptr->concurrent_graphs = 0;
+	}
+}
+
+void zimg_task_scheduler_default(zimg_task_scheduler *ptr, unsigned version)
+{
+	zassert_d(ptr, "null pointer");
+	API_VERSION_ASSERT(version);
+
+	ptr->version = version;
+
+	if (version >= API_VERSION_2_4) {
+		ptr->num_workers = 0;
+		ptr->submit = nullptr;
+		ptr->wait = nullptr;
+		ptr->user = nullptr;
+	}
 }
 
 zimg_filter_graph *zimg_filter_graph_build(const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_graph_builder_params *params)
@@ -664,20 +891,64 @@ zimg_filter_graph *zimg_filter_graph_build(const zimg_image_format *src_format,
 	zassert_d(dst_format, "null pointer");
 
 	try {
-		zimg::graph::GraphBuilder::state src_state;
-		zimg::graph::GraphBuilder::state dst_state;
-		zimg::graph::GraphBuilder::params graph_params;
-
-		std::tie(src_state, dst_state) = import_graph_state(*src_format, *dst_format);
-		if (params)
-			graph_params = import_graph_params(*params);
-
-		return zimg::graph::GraphBuilder{}.set_source(src_state)
-		                                  .connect_graph(dst_state, params ? &graph_params : nullptr)
-		                                  .complete_graph()
-		                                  .release();
+		return build_graph(*src_format, *dst_format, params);
+	} catch (...) {
+		handle_exception(std::current_exception());
+		return nullptr;
+	}
+}
+
+zimg_graph_cache *zimg_graph_cache_create(size_t max_entries)
+{
+	try {
+		return ztd::make_unique<zimg::graph::GraphCache>(max_entries).release();
+	} catch (...) {
+		handle_exception(std::current_exception());
+		return nullptr;
+	}
+}
+
+void zimg_graph_cache_free(zimg_graph_cache *ptr)
+{
+	delete ptr;
+}
+
+zimg_filter_graph *zimg_graph_cache_get(zimg_graph_cache *ptr, const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_graph_builder_params *params)
+{
+	zassert_d(ptr, "null pointer");
+	zassert_d(src_format, "null pointer");
+	zassert_d(dst_format, "null pointer");
+
+	try {
+		GraphCacheKey key;
+		key.append(*src_format);
+		key.append(*dst_format);
+		key.append(params);
+
+		auto build = [=]() { return std::unique_ptr<zimg::graph::FilterGraph>{ build_graph(*src_format, *dst_format, params) }; };
+		return assert_dynamic_type<zimg::graph::GraphCache>(ptr)->get(key.release(), build).release();
 	} catch (...) {
 		handle_exception(std::current_exception());
 		return nullptr;
 	}
 }
+
+zimg_error_code_e zimg_graph_cache_get_stats(const zimg_graph_cache *ptr, unsigned long long *hits, unsigned long long *misses, size_t *entries)
+{
+	zassert_d(ptr, "null pointer");
+
+	try {
+		zimg::graph::GraphCache::stats stats = assert_dynamic_type<const zimg::graph::GraphCache>(ptr)->get_stats();
+
+		if (hits)
+			*hits = stats.hits;
+		if (misses)
+			*misses = stats.misses;
+		if (entries)
+			*entries = stats.entries;
+	} catch (...) {
+		return handle_exception(std::current_exception());
+	}
+
+	return ZIMG_ERROR_SUCCESS;
+}
@@ -29,7 +29,7 @@ extern "C" {
  */
 #define ZIMG_MAKE_API_VERSION(x, y) (((x) << 8) | (y))
 #define ZIMG_API_VERSION_MAJOR 2
-#define ZIMG_API_VERSION_MINOR 3
+#define ZIMG_API_VERSION_MINOR 4
 #define ZIMG_API_VERSION ZIMG_MAKE_API_VERSION(ZIMG_API_VERSION_MAJOR, ZIMG_API_VERSION_MINOR)
 
 /**
@@ -153,9 +153,10 @@ void zimg_clear_last_error(void);
  * Constants are not implied to be in any particular order.
  */
 typedef enum zimg_cpu_type_e {
-	ZIMG_CPU_NONE     = 0, /**< Portable C-based implementation. */
-	ZIMG_CPU_AUTO     = 1, /**< Runtime CPU detection. */
-	ZIMG_CPU_AUTO_64B = 2, /**< Allow use of 64-byte (512-bit) instructions. Since API 2.3. */
+	ZIMG_CPU_NONE         = 0, /**< Portable C-based implementation. */
+	ZIMG_CPU_AUTO         = 1, /**< Runtime CPU detection. */
+	ZIMG_CPU_AUTO_64B     = 2, /**< Allow use of 64-byte (512-bit) instructions. Since API 2.3. */
+	ZIMG_CPU_GENERIC_SIMD = 3, /**< Portable compiler vector extensions. Since API 2.4. */
 #if defined(__i386) || defined(_M_IX86) || defined(_M_X64) || defined(__x86_64__)
 	ZIMG_CPU_X86_MMX        = 1000,
 	ZIMG_CPU_X86_SSE        = 1001,
@@ -221,6 +222,43 @@ typedef enum zimg_field_parity_e {
 	ZIMG_FIELD_BOTTOM      = 2  /**< Bottom field of interlaced image. */
 } zimg_field_parity_e;
 
+/**
+ * Pixel packing constants. Since API 2.4.
+ *
+ * Packed formats interleave the channels of each pixel in the first plane of
+ * the image buffer, which must be large enough to hold all of the channels.
+ * The remaining planes are not accessed. Packed formats require the RGB color
+ * family. The alpha channel is discarded on input and set to the maximum
+ * value of the pixel format on output.
+ *
+ * The semi-planar format stores the luma channel in the first plane and the U
+ * and V channels, interleaved in that order, in the second plane, as in NV12,
+ * P010, and P016. The third plane is not accessed. Semi-planar formats
+ * require the YUV color family. The samples of P010 are stored in the upper
+ * bits of each word, so P010 is processed as a 16-bit format.
+ *
+ * The packed YUV formats store all channels in the first plane and require
+ * the YUV color family. The 4:2:2 format stores each pair of pixels as Y0 U
+ * Y1 V, as in YUY2, Y210, and Y216; like P010, Y210 is processed as a 16-bit
+ * format. The v210 format requires 4:2:2 subsampling and Y410 requires no
+ * subsampling, and both require 10-bit WORD samples. Rows of v210 consist of
+ * 16-byte groups of six pixels, with the last group padded. The alpha channel
+ * of Y410 is discarded on input and set to the maximum value on output.
+ */
+typedef enum zimg_pixel_packing_e {
+	ZIMG_PACKING_PLANAR = 0, /**< Separate planes for each channel. */
+	ZIMG_PACKING_RGB    = 1,
+	ZIMG_PACKING_BGR    = 2,
+	ZIMG_PACKING_RGBA   = 3,
+	ZIMG_PACKING_BGRA   = 4,
+	ZIMG_PACKING_ARGB   = 5,
+	ZIMG_PACKING_ABGR   = 6,
+	ZIMG_PACKING_NV12   = 7, /**< Luma plane followed by a plane of interleaved U and V samples. */
+	ZIMG_PACKING_YUY2   = 8, /**< Packed 4:2:2 YUV in Y U Y V order. */
+	ZIMG_PACKING_V210   = 9, /**< Packed 10-bit 4:2:2 YUV, three samples per 32-bit word. */
+	ZIMG_PACKING_Y410   = 10 /**< Packed 10-bit 4:4:4 YUV with 2-bit alpha. */
+} zimg_pixel_packing_e;
+
 /**
  * Chroma location constants.
  *
@@ -503,6 +541,146 @@ zimg_error_code_e zimg_filter_graph_process(const zimg_filter_graph *ptr, const
                                             zimg_filter_graph_callback unpack_cb, void *unpack_user,
                                             zimg_filter_graph_callback pack_cb, void *pack_user);
 
+/**
+ * Query the size of the temporary buffer required to execute the graph on
+ * multiple threads.
+ *
+ * Since API 2.4.
+ *
+ * @pre out != 0
+ * @param ptr graph handle
+ * @param threads number of threads, or zero to use all processors
+ * @param[out] out set to the size of the buffer in bytes
+ * @return error code
+ * @see zimg_filter_graph_process_mt
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_get_tmp_size_mt(const zimg_filter_graph *ptr, unsigned threads, size_t *out);
+
+/**
+ * Process an image with the filter graph using multiple threads.
+ *
+ * The image is divided into vertical tiles which are processed concurrently.
+ * Graphs without stateful filters are also divided into horizontal bands,
+ * unless callbacks are provided, so that each row is passed to the callbacks
+ * only once. Each thread uses a separate portion of the temporary buffer,
+ * which must be at least as large as the size returned by
+ * {@link zimg_filter_graph_get_tmp_size_mt} for the same number of threads.
+ *
+ * Concurrent execution requires the input and output buffers to contain the
+ * entire image, indicated by a mask of {@link ZIMG_BUFFER_MAX}. Otherwise,
+ * the image is processed on the calling thread. If callbacks are provided,
+ * they may be invoked simultaneously from multiple threads.
+ *
+ * Since API 2.4.
+ *
+ * @param ptr graph handle
+ * @param[in] src input image buffer
+ * @param[out] dst output image buffer
+ * @param tmp temporary buffer
+ * @param unpack_cb user-defined input callback, may be NULL
+ * @param unpack_user private data for callback
+ * @param pack_cb user-defined output callback, may be NULL
+ * @param pack_user private data for callback
+ * @param threads number of threads, or zero to use all processors
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_process_mt(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                               zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                               zimg_filter_graph_callback pack_cb, void *pack_user,
+                                               unsigned threads);
+
+/**
+ * Unit of work submitted to a user-defined task scheduler.
+ *
+ * @param task task data passed to {@link zimg_scheduler_submit_func}
+ */
+typedef void (*zimg_task_func)(void *task);
+
+/**
+ * User callback to enqueue a task on a host thread pool.
+ *
+ * The task must be executed exactly once by calling func(task), and may be
+ * executed on any thread. A task that is not accepted by the scheduler is
+ * not lost, as its share of the work is taken over by the remaining tasks.
+ *
+ * @param user user-defined private data
+ * @param func task function
+ * @param task task data
+ * @return zero if the task was accepted or non-zero if it was rejected
+ */
+typedef int (*zimg_scheduler_submit_func)(void *user, zimg_task_func func, void *task);
+
+/**
+ * User callback to wait for all tasks accepted during the current call.
+ *
+ * The callback must not return until every accepted task has finished
+ * executing. It is invoked on the thread which called
+ * {@link zimg_filter_graph_process_scheduled}. If that thread belongs to the
+ * host thread pool, the callback should execute pending tasks itself rather
+ * than block, to prevent deadlock.
+ *
+ * @param user user-defined private data
+ */
+typedef void (*zimg_scheduler_wait_func)(void *user);
+
+/**
+ * Task scheduler descriptor.
+ *
+ * Allows a filter graph to distribute work to a thread pool owned by the
+ * host application, instead of creating its own threads.
+ */
+typedef struct zimg_task_scheduler {
+	unsigned version; /**< @see ZIMG_API_VERSION */
+
+	unsigned num_workers; /**< Maximum number of concurrent tasks, including the calling thread. Default 0 (all processors). */
+
+	zimg_scheduler_submit_func submit; /**< Task submission callback. */
+	zimg_scheduler_wait_func wait; /**< Task completion callback. */
+	void *user; /**< Private data passed to callbacks. */
+} zimg_task_scheduler;
+
+/**
+ * Initialize task scheduler structure with default values.
+ *
+ * Since API 2.4.
+ *
+ * @param[out] ptr structure to be initialized
+ * @param version API version used by caller
+ */
+ZIMG_VISIBILITY
+void zimg_task_scheduler_default(zimg_task_scheduler *ptr, unsigned version);
+
+/**
+ * Process an image with the filter graph using a user-defined scheduler.
+ *
+ * The image is divided into vertical tiles, as in
+ * {@link zimg_filter_graph_process_mt}. Up to num_workers - 1 tasks are
+ * submitted to the scheduler, and one share of the work is executed on the
+ * calling thread before waiting for the submitted tasks. The temporary buffer
+ * must be at least as large as the size returned by
+ * {@link zimg_filter_graph_get_tmp_size_mt} for num_workers threads.
+ *
+ * Since API 2.4.
+ *
+ * @param ptr graph handle
+ * @param[in] src input image buffer
+ * @param[out] dst output image buffer
+ * @param tmp temporary buffer
+ * @param unpack_cb user-defined input callback, may be NULL
+ * @param unpack_user private data for callback
+ * @param pack_cb user-defined output callback, may be NULL
+ * @param pack_user private data for callback
+ * @param[in] scheduler task scheduler
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_filter_graph_process_scheduled(const zimg_filter_graph *ptr, const zimg_image_buffer_const *src, const zimg_image_buffer *dst, void *tmp,
+                                                      zimg_filter_graph_callback unpack_cb, void *unpack_user,
+                                                      zimg_filter_graph_callback pack_cb, void *pack_user,
+                                                      const zimg_task_scheduler *scheduler);
+
 
 /**
  * Image format descriptor.
@@ -535,6 +713,9 @@ typedef struct zimg_image_format {
 		double width;  /**< Subpixel width, counting from {@link left} (default NAN, same as image width). */
 		double height; /**< Subpixel height, counting from {@link top} (default NAN, same as image height). */
 	} active_region;
+
+	/** Pixel packing (default ZIMG_PACKING_PLANAR). Since API 2.4. */
+	zimg_pixel_packing_e pixel_packing;
 } zimg_image_format;
 
 /**
@@ -590,6 +771,80 @@ typedef struct zimg_graph_builder_params {
 
 	/** Allow evaluating transfer functions at reduced precision (default false). */
 	char allow_approximate_gamma;
+
+	/**
+	 * Select the tile width by measuring the speed of the graph (default false).
+	 *
+	 * Measurement is performed during {@link zimg_filter_graph_build} and may
+	 * take several frames worth of processing time. Results are retained for
+	 * the lifetime of the process, so that identical graphs built later are
+	 * not measured again. The width is measured on one thread. Multithreaded
+	 * processing still divides the frame into at least one tile per thread.
+	 *
+	 * Since API 2.4.
+	 */
+	char tile_autotune;
+
+	/**
+	 * Path to a file used to persist autotuning results between processes.
+	 *
+	 * Results are stored for each combination of graph and processor model.
+	 * The file is created if it does not exist. Errors accessing the file are
+	 * not reported. Only used if {@p tile_autotune} is set.
+	 *
+	 * Since API 2.4.
+	 *
+	 * The default value is NULL, which disables persistence.
+	 */
+	const char *tile_profile;
+
+	/**
+	 * Approximate colorspace conversion by a 3D LUT of the given size (default 0).
+	 *
+	 * The conversion is sampled on a grid of N x N x N points when the graph is
+	 * built and applied with tetrahedral interpolation. This is faster for
+	 * conversions involving several transfer functions, at reduced accuracy.
+	 * Values outside the nominal range of the source colorspace are clamped.
+	 * The LUT is not used if the source transfer characteristics are linear or
+	 * unspecified, as such values are not bounded. Typical sizes are 33 and 65.
+	 * The maximum size is 129.
+	 *
+	 * Since API 2.4.
+	 *
+	 * The default value is 0, which evaluates the conversion exactly.
+	 */
+	unsigned colorspace_lut_size;
+
+	/**
+	 * Allow single-pass kernels for known conversions (default false).
+	 *
+	 * The only conversions with a single-pass kernel are matrix conversions
+	 * between 4:4:4 integer RGB and non-constant luminance YUV, with the same
+	 * dimensions, transfer characteristics, and primaries. These are performed
+	 * without intermediate floating point planes. Results may differ from the
+	 * default graph by one code value. Not used with dithering.
+	 *
+	 * Conversions involving resizing, chroma subsampling, or a change of
+	 * transfer characteristics or primaries, such as BT.2020 PQ to BT.709,
+	 * always use the default graph.
+	 *
+	 * Since API 2.4.
+	 */
+	char allow_specialized_kernels;
+
+	/**
+	 * Number of graphs the caller executes concurrently (default 0).
+	 *
+	 * Concurrent graphs share the processor caches. The tile width is chosen
+	 * from the share of the cache available to each thread of each graph.
+	 * Callers processing several frames at once should set this to the number
+	 * of frames in flight.
+	 *
+	 * Since API 2.4.
+	 *
+	 * The default value is 0, which is interpreted as 1.
+	 */
+	unsigned concurrent_graphs;
 } zimg_graph_builder_params;
 
 /**
@@ -624,6 +879,71 @@ void zimg_graph_builder_params_default(zimg_graph_builder_params *ptr, unsigned
 ZIMG_VISIBILITY
 zimg_filter_graph *zimg_filter_graph_build(const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_graph_builder_params *params);
 
+/**
+ * Handle to a cache of filter graphs.
+ *
+ * The cache retains graphs built for previously requested format pairs and
+ * parameters. Graphs returned from the cache share their execution plan with
+ * the cached graph, and may be used concurrently from multiple threads.
+ *
+ * Since API 2.4.
+ */
+typedef struct zimg_graph_cache zimg_graph_cache;
+
+/**
+ * Create a graph cache.
+ *
+ * Upon failure, a NULL pointer is returned. The function
+ * {@link zimg_get_last_error} may be called to obtain the failure reason.
+ *
+ * @param max_entries maximum number of graphs retained, or 0 for unlimited
+ * @return cache handle, or NULL on failure
+ */
+ZIMG_VISIBILITY
+zimg_graph_cache *zimg_graph_cache_create(size_t max_entries);
+
+/**
+ * Delete a graph cache.
+ *
+ * Graphs previously returned from the cache remain valid, and must still be
+ * released with {@link zimg_filter_graph_free}.
+ *
+ * @param ptr cache handle, may be NULL
+ */
+ZIMG_VISIBILITY
+void zimg_graph_cache_free(zimg_graph_cache *ptr);
+
+/**
+ * Get a graph converting the specified formats from a cache.
+ *
+ * If no graph matching the formats and parameters is cached, a new graph is
+ * created as if by {@link zimg_filter_graph_build} and added to the cache.
+ * The function is thread-safe.
+ *
+ * Upon failure, a NULL pointer is returned. The function
+ * {@link zimg_get_last_error} may be called to obtain the failure reason.
+ *
+ * @param ptr cache handle
+ * @param[in] src_format input image format
+ * @param[in] dst_format output image format
+ * @param[in] params filter parameters, may be NULL
+ * @return graph handle, to be released with {@link zimg_filter_graph_free}, or NULL on failure
+ */
+ZIMG_VISIBILITY
+zimg_filter_graph *zimg_graph_cache_get(zimg_graph_cache *ptr, const zimg_image_format *src_format, const zimg_image_format *dst_format, const zimg_graph_builder_params *params);
+
+/**
+ * Query the usage statistics of a graph cache.
+ *
+ * @param ptr cache handle
+ * @param[out] hits number of requests satisfied from the cache, may be NULL
+ * @param[out] misses number of requests requiring a new graph, may be NULL
+ * @param[out] entries number of graphs currently cached, may be NULL
+ * @return error code
+ */
+ZIMG_VISIBILITY
+zimg_error_code_e zimg_graph_cache_get_stats(const zimg_graph_cache *ptr, unsigned long long *hits, unsigned long long *misses, size_t *entries);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
+#include "common/align.h"
+#include "common/alloc.h"
 #include "common/cpuinfo.h"
 #include "common/except.h"
 #include "common/make_unique.h"
@@ -10,32 +15,80 @@
 #include "colorspace.h"
 #include "graph.h"
 #include "operation.h"
+#include "operation_impl.h"
 
 namespace zimg {
 namespace colorspace {
 
 namespace {
 
+// Number of pixels passed through all operations at once, sized to keep the
+// three planes in L1 cache between operations.
+constexpr unsigned CHUNK_WIDTH = 512;
+
+constexpr unsigned LUT_SIZE_MAX = 129;
+
+std::vector<std::unique_ptr<Operation>> create_operations(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, CPUClass cpu)
+{
+	std::vector<std::unique_ptr<Operation>> operations;
+
+	auto path = get_operation_path(in, out);
+	zassert(!path.empty(), "empty path");
+
+	for (const auto &func : path) {
+		std::unique_ptr<Operation> op = func(params, cpu);
+
+		// Consecutive matrices, e.g. YUV-RGB-YUV or LMS-RGB-gamut, are applied as their product.
+		if (!operations.empty()) {
+			if (std::unique_ptr<Operation> combined = combine_matrix_operations(*operations.back(), *op, cpu)) {
+				operations.back() = std::move(combined);
+				continue;
+			}
+		}
+		operations.emplace_back(std::move(op));
+	}
+
+	return operations;
+}
+
+std::unique_ptr<Operation> create_lut3d(const std::vector<std::unique_ptr<Operation>> &operations, const ColorspaceDefinition &in, unsigned lut_size, CPUClass cpu)
+{
+	if (lut_size < 2 || lut_size > LUT_SIZE_MAX)
+		error::throw_<error::IllegalArgument>("3D LUT size out of range");
+
+	// The LUT clamps its input to the nominal range. Linear light, such as
+	// scene-referred HDR, and values of unspecified transfer are not bounded.
+	if (in.transfer == TransferCharacteristics::LINEAR || in.transfer == TransferCharacteristics::UNSPECIFIED)
+		return nullptr;
+
+	return create_lut3d_operation(bake_lut3d(operations, in.matrix != MatrixCoefficients::RGB, lut_size), cpu);
+}
+
 class ColorspaceConversionImpl final : public graph::ImageFilterBase {
 	std::vector<std::unique_ptr<Operation>> m_operations;
 	unsigned m_width;
 	unsigned m_height;
 public:
 	ColorspaceConversionImpl(unsigned width, unsigned height, const ColorspaceDefinition &in, const ColorspaceDefinition &out,
-	                         const OperationParams &params, CPUClass cpu) :
+	                         const OperationParams &params, unsigned lut_size, CPUClass cpu) :
 		m_width{ width },
 		m_height{ height }
 	{
 		zassert_d(width <= pixel_max_width(PixelType::FLOAT), "overflow");
 
-		auto path = get_operation_path(in, out);
-		zassert(!path.empty(), "empty path");
+		m_operations = create_operations(in, out, params, cpu);
 
-		for (const auto &func : path) {
-			m_operations.emplace_back(func(params, cpu));
+		// The whole path is replaced by a single table lookup.
+		if (lut_size) {
+			if (std::unique_ptr<Operation> lut = create_lut3d(m_operations, in, lut_size, cpu)) {
+				m_operations.clear();
+				m_operations.emplace_back(std::move(lut));
+			}
 		}
 	}
 
+	const char *get_name() const override { return "colorspace"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -62,10 +115,17 @@ public:
 			dst_ptr[p] = static_cast<float *>(dst[p][i]);
 		}
 
-		m_operations[0]->process(src_ptr, dst_ptr, left, right);
+		// Run all operations over each chunk before moving to the next, rather
+		// than sweeping the entire line once per operation.
+		for (unsigned j = left; j < right; ) {
+			unsigned j_end = std::min(floor_n(j, CHUNK_WIDTH) + CHUNK_WIDTH, right);
+
+			m_operations[0]->process(src_ptr, dst_ptr, j, j_end);
 
-		for (size_t i = 1; i < m_operations.size(); ++i) {
-			m_operations[i]->process(dst_ptr, dst_ptr, left, right);
+			for (size_t n = 1; n < m_operations.size(); ++n) {
+				m_operations[n]->process(dst_ptr, dst_ptr, j, j_end);
+			}
+			j = j_end;
 		}
 	}
 };
@@ -81,6 +141,7 @@ ColorspaceConversion::ColorspaceConversion(unsigned width, unsigned height) :
 	peak_luminance{ 100.0 },
 	approximate_gamma{},
 	scene_referred{},
+	lut_size{},
 	cpu{ CPUClass::NONE }
 {}
 
@@ -94,7 +155,68 @@ std::unique_ptr<graph::ImageFilter> ColorspaceConversion::create() const try
 	if (csp_in == csp_out)
 		return ztd::make_unique<graph::CopyFilter>(width, height, PixelType::FLOAT, true);
 	else
-		return ztd::make_unique<ColorspaceConversionImpl>(width, height, csp_in, csp_out, params, cpu);
+		return ztd::make_unique<ColorspaceConversionImpl>(width, height, csp_in, csp_out, params, lut_size, cpu);
+} catch (const std::bad_alloc &) {
+	error::throw_<error::OutOfMemory>();
+}
+
+double ColorspaceConversion::measure_lut_error() const try
+{
+	OperationParams params;
+	params.set_peak_luminance(peak_luminance)
+	      .set_approximate_gamma(approximate_gamma)
+	      .set_scene_referred(scene_referred);
+
+	if (csp_in == csp_out)
+		return 0.0;
+
+	auto operations = create_operations(csp_in, csp_out, params, cpu);
+	auto lut = create_lut3d(operations, csp_in, lut_size, cpu);
+	if (!lut)
+		return 0.0;
+
+	// Sample the centre of every cell in a single line.
+	const bool yuv = csp_in.matrix != MatrixCoefficients::RGB;
+	const unsigned n = lut_size - 1;
+	const unsigned num_samples = n * n * n;
+
+	AlignedVector<float> exact[3];
+	AlignedVector<float> approx[3];
+	float *exact_ptr[3];
+	float *approx_ptr[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		exact[p].resize(ceil_n(num_samples, AlignmentOf<float>::value));
+		approx[p].resize(ceil_n(num_samples, AlignmentOf<float>::value));
+		exact_ptr[p] = exact[p].data();
+		approx_ptr[p] = approx[p].data();
+	}
+
+	for (unsigned x = 0; x < n; ++x) {
+		for (unsigned y = 0; y < n; ++y) {
+			for (unsigned z = 0; z < n; ++z) {
+				unsigned idx = (x * n + y) * n + z;
+				exact[0][idx] = (x + 0.5f) / n;
+				exact[1][idx] = (y + 0.5f) / n - (yuv ? 0.5f : 0.0f);
+				exact[2][idx] = (z + 0.5f) / n - (yuv ? 0.5f : 0.0f);
+			}
+		}
+	}
+
+	lut->process(exact_ptr, approx_ptr, 0, num_samples);
+
+	for (const auto &op : operations) {
+		op->process(exact_ptr, exact_ptr, 0, num_samples);
+	}
+
+	double max_error = 0.0;
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned i = 0; i < num_samples; ++i) {
+			max_error = std::max(max_error, static_cast<double>(std::fabs(exact[p][i] - approx[p][i])));
+		}
+	}
+	return max_error;
 } catch (const std::bad_alloc &) {
 	error::throw_<error::OutOfMemory>();
 }
@@ -120,12 +120,25 @@ struct ColorspaceConversion {
 	BUILDER_MEMBER(double, peak_luminance)
 	BUILDER_MEMBER(bool, approximate_gamma)
 	BUILDER_MEMBER(bool, scene_referred)
+	BUILDER_MEMBER(unsigned, lut_size)
 	BUILDER_MEMBER(CPUClass, cpu)
 #undef BUILDER_MEMBER
 
 	ColorspaceConversion(unsigned width, unsigned height);
 
 	std::unique_ptr<graph::ImageFilter> create() const;
+
+	/**
+	 * Measure the accuracy of the 3D LUT used if {@p lut_size} is set.
+	 *
+	 * The LUT is compared to the exact conversion at the centre of each cell,
+	 * where the interpolation error is largest. For YUV input, the cells span
+	 * colors outside of the RGB gamut, where transfer functions may be steep.
+	 *
+	 * @return maximum absolute error over all channels, or zero if the LUT is
+	 *         not used for the input colorspace
+	 */
+	double measure_lut_error() const;
 };
 
 } // namespace colorspace
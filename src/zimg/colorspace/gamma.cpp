@@ -12,27 +12,6 @@ namespace colorspace {
 
 namespace {
 
-constexpr float REC709_ALPHA = 1.09929682680944f;
-constexpr float REC709_BETA = 0.018053968510807f;
-
-constexpr float SMPTE_240M_ALPHA = 1.111572195921731f;
-constexpr float SMPTE_240M_BETA  = 0.022821585529445f;
-
-// Adjusted for continuity of first derivative.
-constexpr float SRGB_ALPHA = 1.055010718947587f;
-constexpr float SRGB_BETA = 0.003041282560128f;
-
-constexpr float ST2084_M1 = 0.1593017578125f;
-constexpr float ST2084_M2 = 78.84375f;
-constexpr float ST2084_C1 = 0.8359375f;
-constexpr float ST2084_C2 = 18.8515625f;
-constexpr float ST2084_C3 = 18.6875f;
-
-constexpr float ARIB_B67_A = 0.17883277f;
-constexpr float ARIB_B67_B = 0.28466892f;
-constexpr float ARIB_B67_C = 0.55991073f;
-
-
 // Chosen for compatibility with higher precision REC709_ALPHA/REC709_BETA.
 // See: ITU-R BT.2390-2 5.3.1
 constexpr float ST2084_OOTF_SCALE = 59.49080238715383f;
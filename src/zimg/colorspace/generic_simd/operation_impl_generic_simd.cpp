@@ -0,0 +1,158 @@
+#ifdef ZIMG_GENERIC_SIMD
+
+#include <cstdint>
+#include <vector>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/cpuinfo.h"
+#include "common/make_unique.h"
+#include "colorspace/gamma.h"
+#include "colorspace/operation.h"
+#include "colorspace/operation_impl.h"
+#include "operation_impl_generic_simd.h"
+
+#include "common/generic_simd/generic_simd_util.h"
+
+namespace zimg {
+namespace colorspace {
+
+namespace {
+
+constexpr unsigned LUT_DEPTH = 15;
+
+template <bool Partial>
+inline FORCE_INLINE void matrix_filter_line_generic_simd_xiter(unsigned j, unsigned n, const float (*matrix)[3],
+                                                               const float * const * RESTRICT src, float * const * RESTRICT dst)
+{
+	vf32x8 a = Partial ? vec8_load_f32_n(src[0] + j, n) : vec8_load_f32(src[0] + j);
+	vf32x8 b = Partial ? vec8_load_f32_n(src[1] + j, n) : vec8_load_f32(src[1] + j);
+	vf32x8 c = Partial ? vec8_load_f32_n(src[2] + j, n) : vec8_load_f32(src[2] + j);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		vf32x8 x = vec8_set1_f32(matrix[p][0]) * a + vec8_set1_f32(matrix[p][1]) * b + vec8_set1_f32(matrix[p][2]) * c;
+
+		if (Partial)
+			vec8_store_n(dst[p] + j, x, n);
+		else
+			vec8_store(dst[p] + j, x);
+	}
+}
+
+void matrix_filter_line_generic_simd(const float (*matrix)[3], const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + floor_n(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		matrix_filter_line_generic_simd_xiter<false>(j, 8, matrix, src, dst);
+	}
+	if (right != vec_right)
+		matrix_filter_line_generic_simd_xiter<true>(vec_right, right - vec_right, matrix, src, dst);
+}
+
+inline FORCE_INLINE vi32x8 lut_index(vf32x8 x, const vf32x8 &scale, const vf32x8 &limit)
+{
+	// NaN is mapped to zero by the clamp.
+	x = x * scale;
+	x = vec8_max_f32(x, vec8_set1_f32(0.0f));
+	x = vec8_min_f32(x, limit);
+	return vec8_round_u23(x);
+}
+
+void lut_filter_line(const float * RESTRICT lut, unsigned lut_depth, float prescale, const float *src, float *dst, unsigned left, unsigned right)
+{
+	const int lut_limit = 1 << lut_depth;
+	const vf32x8 scale = vec8_set1_f32(prescale * lut_limit);
+	const vf32x8 limit = vec8_set1_f32(static_cast<float>(lut_limit));
+
+	unsigned vec_right = left + floor_n(right - left, 8);
+	int32_t idx[8];
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		vec8_store(idx, lut_index(vec8_load_f32(src + j), scale, limit));
+
+		for (unsigned n = 0; n < 8; ++n) {
+			dst[j + n] = lut[idx[n]];
+		}
+	}
+	if (right != vec_right) {
+		vec8_store(idx, lut_index(vec8_load_f32_n(src + vec_right, right - vec_right), scale, limit));
+
+		for (unsigned n = 0; n < right - vec_right; ++n) {
+			dst[vec_right + n] = lut[idx[n]];
+		}
+	}
+}
+
+
+class MatrixOperationGenericSIMD final : public MatrixOperationImpl {
+public:
+	explicit MatrixOperationGenericSIMD(const Matrix3x3 &m) : MatrixOperationImpl(m) {}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		matrix_filter_line_generic_simd(m_matrix, src, dst, left, right);
+	}
+};
+
+class LutOperationGenericSIMD final : public Operation {
+	std::vector<float> m_lut;
+	unsigned m_lut_depth;
+	float m_prescale;
+public:
+	LutOperationGenericSIMD(gamma_func func, unsigned lut_depth, float prescale, float postscale) :
+		m_lut((1 << lut_depth) + 1),
+		m_lut_depth{ lut_depth },
+		m_prescale{ prescale }
+	{
+		EnsureSinglePrecision x87;
+
+		// Allocate an extra LUT entry so that indexing can be done by multipying by a power of 2.
+		for (unsigned i = 0; i < m_lut.size(); ++i) {
+			float x = static_cast<float>(i) / (1 << lut_depth);
+			m_lut[i] = func(x) * postscale;
+		}
+	}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		lut_filter_line(m_lut.data(), m_lut_depth, m_prescale, src[0], dst[0], left, right);
+		lut_filter_line(m_lut.data(), m_lut_depth, m_prescale, src[1], dst[1], left, right);
+		lut_filter_line(m_lut.data(), m_lut_depth, m_prescale, src[2], dst[2], left, right);
+	}
+};
+
+} // namespace
+
+
+std::unique_ptr<Operation> create_matrix_operation_generic_simd(const Matrix3x3 &m, CPUClass cpu)
+{
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return nullptr;
+
+	return ztd::make_unique<MatrixOperationGenericSIMD>(m);
+}
+
+std::unique_ptr<Operation> create_gamma_operation_generic_simd(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu)
+{
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return nullptr;
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return ztd::make_unique<LutOperationGenericSIMD>(transfer.to_gamma, LUT_DEPTH, transfer.to_gamma_scale, 1.0f);
+}
+
+std::unique_ptr<Operation> create_inverse_gamma_operation_generic_simd(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu)
+{
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return nullptr;
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return ztd::make_unique<LutOperationGenericSIMD>(transfer.to_linear, LUT_DEPTH, 1.0f, transfer.to_linear_scale);
+}
+
+} // namespace colorspace
+} // namespace zimg
+
+#endif // ZIMG_GENERIC_SIMD
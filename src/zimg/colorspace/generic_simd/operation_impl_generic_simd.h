@@ -0,0 +1,32 @@
+#pragma once
+
+#ifdef ZIMG_GENERIC_SIMD
+
+#ifndef ZIMG_COLORSPACE_GENERIC_SIMD_OPERATION_IMPL_GENERIC_SIMD_H_
+#define ZIMG_COLORSPACE_GENERIC_SIMD_OPERATION_IMPL_GENERIC_SIMD_H_
+
+#include <memory>
+
+namespace zimg {
+
+enum class CPUClass;
+
+namespace colorspace {
+
+struct Matrix3x3;
+struct OperationParams;
+struct TransferFunction;
+class Operation;
+
+std::unique_ptr<Operation> create_matrix_operation_generic_simd(const Matrix3x3 &m, CPUClass cpu);
+
+std::unique_ptr<Operation> create_gamma_operation_generic_simd(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
+
+std::unique_ptr<Operation> create_inverse_gamma_operation_generic_simd(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
+
+} // namespace colorspace
+} // namespace zimg
+
+#endif // ZIMG_COLORSPACE_GENERIC_SIMD_OPERATION_IMPL_GENERIC_SIMD_H_
+
+#endif // ZIMG_GENERIC_SIMD
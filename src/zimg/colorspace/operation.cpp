@@ -72,7 +72,7 @@ std::unique_ptr<Operation> create_gamma_to_linear_operation(const ColorspaceDefi
 		cpu = CPUClass::NONE;
 
 	if (in.transfer == TransferCharacteristics::ARIB_B67 && use_display_referred_b67(in.primaries, params))
-		return create_inverse_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(in.primaries), params);
+		return create_inverse_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(in.primaries), params, cpu);
 	else
 		return create_inverse_gamma_operation(select_transfer_function(in.transfer, params.peak_luminance, params.scene_referred), params, cpu);
 }
@@ -87,7 +87,7 @@ std::unique_ptr<Operation> create_linear_to_gamma_operation(const ColorspaceDefi
 		cpu = CPUClass::NONE;
 
 	if (out.transfer == TransferCharacteristics::ARIB_B67 && use_display_referred_b67(out.primaries, params))
-		return create_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(out.primaries), params);
+		return create_arib_b67_operation(ncl_rgb_to_yuv_matrix_from_primaries(out.primaries), params, cpu);
 	else
 		return create_gamma_operation(select_transfer_function(out.transfer, params.peak_luminance, params.scene_referred), params, cpu);
 }
@@ -1,5 +1,8 @@
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <utility>
+#include "common/align.h"
 #include "common/make_unique.h"
 #include "common/zassert.h"
 #include "colorspace.h"
@@ -13,6 +16,10 @@
   #include "x86/operation_impl_x86.h"
 #endif
 
+#ifdef ZIMG_GENERIC_SIMD
+  #include "generic_simd/operation_impl_generic_simd.h"
+#endif
+
 namespace zimg {
 namespace colorspace {
 
@@ -272,10 +279,64 @@ public:
 	}
 };
 
+class Lut3DOperationC final : public Operation {
+	Lut3D m_lut;
+public:
+	explicit Lut3DOperationC(Lut3D &&lut) : m_lut(std::move(lut)) {}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		const float *lut = m_lut.data.data();
+		const float limit = static_cast<float>(m_lut.size - 1);
+		const unsigned stride_x = m_lut.size * m_lut.size * 4;
+		const unsigned stride_y = m_lut.size * 4;
+		const unsigned stride_z = 4;
+
+		for (unsigned i = left; i < right; ++i) {
+			float u[3];
+			unsigned idx = 0;
+
+			for (unsigned p = 0; p < 3; ++p) {
+				// Clamp before truncation, also mapping NaN to zero.
+				float x = src[p][i] * m_lut.scale[p] + m_lut.offset[p];
+				x = x > 0.0f ? x : 0.0f;
+				x = std::min(x, limit);
+
+				unsigned base = std::min(static_cast<unsigned>(x), m_lut.size - 2);
+				u[p] = x - static_cast<float>(base);
+				idx = idx * m_lut.size + base;
+			}
+			idx *= 4;
+
+			// Select the tetrahedron containing the point. The vertices are on the
+			// path from (0, 0, 0) to (1, 1, 1), stepping along the axes in order
+			// of decreasing fractional coordinate.
+			float w_max = std::max(std::max(u[0], u[1]), u[2]);
+			float w_min = std::min(std::min(u[0], u[1]), u[2]);
+			float w_mid = u[0] + u[1] + u[2] - w_max - w_min;
+
+			unsigned step1 = u[0] >= u[1] && u[0] >= u[2] ? stride_x : u[1] >= u[2] ? stride_y : stride_z;
+			unsigned step3 = u[0] <= u[1] && u[0] <= u[2] ? stride_x : u[1] <= u[2] ? stride_y : stride_z;
+			unsigned v1 = idx + step1;
+			unsigned v2 = idx + stride_x + stride_y + stride_z - step3;
+			unsigned v3 = idx + stride_x + stride_y + stride_z;
+
+			for (unsigned p = 0; p < 3; ++p) {
+				float y = lut[idx + p] * (1.0f - w_max);
+				y += lut[v1 + p] * (w_max - w_mid);
+				y += lut[v2 + p] * (w_mid - w_min);
+				y += lut[v3 + p] * w_min;
+				dst[p][i] = y;
+			}
+		}
+	}
+};
+
 } // namespace
 
 
-MatrixOperationImpl::MatrixOperationImpl(const Matrix3x3 &m)
+MatrixOperationImpl::MatrixOperationImpl(const Matrix3x3 &m) :
+	m_matrix_exact(m)
 {
 	for (int i = 0; i < 3; ++i) {
 		for (int j = 0; j < 3; ++j) {
@@ -291,6 +352,10 @@ std::unique_ptr<Operation> create_matrix_operation(const Matrix3x3 &m, CPUClass
 
 #ifdef ZIMG_X86
 	ret = create_matrix_operation_x86(m, cpu);
+#endif
+#ifdef ZIMG_GENERIC_SIMD
+	if (!ret)
+		ret = create_matrix_operation_generic_simd(m, cpu);
 #endif
 	if (!ret)
 		ret = ztd::make_unique<MatrixOperationC>(m);
@@ -298,12 +363,27 @@ std::unique_ptr<Operation> create_matrix_operation(const Matrix3x3 &m, CPUClass
 	return ret;
 }
 
+std::unique_ptr<Operation> combine_matrix_operations(const Operation &first, const Operation &second, CPUClass cpu)
+{
+	const MatrixOperationImpl *first_matrix = dynamic_cast<const MatrixOperationImpl *>(&first);
+	const MatrixOperationImpl *second_matrix = dynamic_cast<const MatrixOperationImpl *>(&second);
+
+	if (!first_matrix || !second_matrix)
+		return nullptr;
+
+	return create_matrix_operation(second_matrix->get_matrix() * first_matrix->get_matrix(), cpu);
+}
+
 std::unique_ptr<Operation> create_gamma_operation(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu)
 {
 	std::unique_ptr<Operation> ret;
 
 #ifdef ZIMG_X86
 	ret = create_gamma_operation_x86(transfer, params, cpu);
+#endif
+#ifdef ZIMG_GENERIC_SIMD
+	if (!ret)
+		ret = create_gamma_operation_generic_simd(transfer, params, cpu);
 #endif
 	if (!ret)
 		ret = ztd::make_unique<GammaOperationC>(transfer.to_gamma, transfer.to_gamma_scale, 1.0f);
@@ -317,6 +397,10 @@ std::unique_ptr<Operation> create_inverse_gamma_operation(const TransferFunction
 
 #ifdef ZIMG_X86
 	ret = create_inverse_gamma_operation_x86(transfer, params, cpu);
+#endif
+#ifdef ZIMG_GENERIC_SIMD
+	if (!ret)
+		ret = create_inverse_gamma_operation_generic_simd(transfer, params, cpu);
 #endif
 	if (!ret)
 		ret = ztd::make_unique<GammaOperationC>(transfer.to_linear, 1.0f, transfer.to_linear_scale);
@@ -324,20 +408,36 @@ std::unique_ptr<Operation> create_inverse_gamma_operation(const TransferFunction
 	return ret;
 }
 
-std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params)
+std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu)
 {
 	zassert_d(!params.scene_referred, "must be display-referred");
 
 	TransferFunction func = select_transfer_function(TransferCharacteristics::ARIB_B67, params.peak_luminance, false);
-	return ztd::make_unique<AribB67OperationC>(m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+	std::unique_ptr<Operation> ret;
+
+#ifdef ZIMG_X86
+	ret = create_arib_b67_operation_x86(m, func.to_gamma_scale, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<AribB67OperationC>(m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+
+	return ret;
 }
 
-std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params)
+std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu)
 {
 	zassert_d(!params.scene_referred, "must be display-referred");
 
 	TransferFunction func = select_transfer_function(TransferCharacteristics::ARIB_B67, params.peak_luminance, false);
-	return ztd::make_unique<AribB67InverseOperationC>(m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+	std::unique_ptr<Operation> ret;
+
+#ifdef ZIMG_X86
+	ret = create_inverse_arib_b67_operation_x86(m, func.to_linear_scale, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<AribB67InverseOperationC>(m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+
+	return ret;
 }
 
 std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, CPUClass cpu)
@@ -349,7 +449,18 @@ std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation(const ColorspaceDefini
 	// CL is always scene-referred.
 	TransferFunction func = select_transfer_function(in.transfer, params.peak_luminance, true);
 	Matrix3x3 m = in.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_CL ? ncl_rgb_to_yuv_matrix_from_primaries(in.primaries) : ncl_rgb_to_yuv_matrix(in.matrix);
-	return ztd::make_unique<CLToRGBOperationC>(func.to_gamma, func.to_linear, m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+	std::unique_ptr<Operation> ret;
+
+#ifdef ZIMG_X86
+	// Vectorized transfer functions are only implemented for BT.2020 CL, and
+	// are not exact.
+	if (params.approximate_gamma && in.transfer == TransferCharacteristics::REC_709)
+		ret = create_cl_yuv_to_rgb_operation_x86(m, func.to_linear_scale, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<CLToRGBOperationC>(func.to_gamma, func.to_linear, m[0][0], m[0][1], m[0][2], func.to_linear_scale);
+
+	return ret;
 }
 
 std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation(const ColorspaceDefinition &in, const ColorspaceDefinition &out, const OperationParams &params, CPUClass cpu)
@@ -361,7 +472,83 @@ std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation(const ColorspaceDefini
 	// CL is always scene-referred.
 	TransferFunction func = select_transfer_function(out.transfer, params.peak_luminance, true);
 	Matrix3x3 m = out.matrix == MatrixCoefficients::CHROMATICITY_DERIVED_CL ? ncl_rgb_to_yuv_matrix_from_primaries(out.primaries) : ncl_rgb_to_yuv_matrix(out.matrix);
-	return ztd::make_unique<CLToYUVOperationC>(func.to_gamma, m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+	std::unique_ptr<Operation> ret;
+
+#ifdef ZIMG_X86
+	// Vectorized transfer functions are only implemented for BT.2020 CL, and
+	// are not exact.
+	if (params.approximate_gamma && out.transfer == TransferCharacteristics::REC_709)
+		ret = create_cl_rgb_to_yuv_operation_x86(m, func.to_gamma_scale, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<CLToYUVOperationC>(func.to_gamma, m[0][0], m[0][1], m[0][2], func.to_gamma_scale);
+
+	return ret;
+}
+
+Lut3D bake_lut3d(const std::vector<std::unique_ptr<Operation>> &path, bool yuv, unsigned size)
+{
+	zassert_d(size >= 2, "LUT too small");
+	zassert_d(!path.empty(), "empty path");
+
+	const float lower[3] = { 0.0f, yuv ? -0.5f : 0.0f, yuv ? -0.5f : 0.0f };
+	const float upper[3] = { 1.0f, yuv ? 0.5f : 1.0f, yuv ? 0.5f : 1.0f };
+
+	Lut3D lut;
+	unsigned num_entries = size * size * size;
+
+	lut.data.resize(static_cast<size_t>(num_entries) * 4);
+	lut.size = size;
+
+	for (unsigned p = 0; p < 3; ++p) {
+		lut.scale[p] = (size - 1) / (upper[p] - lower[p]);
+		lut.offset[p] = -lower[p] * lut.scale[p];
+	}
+
+	// Evaluate the whole grid as a single line, padded for vector access.
+	AlignedVector<float> grid[3];
+	float *grid_ptr[3];
+
+	for (unsigned p = 0; p < 3; ++p) {
+		grid[p].resize(ceil_n(num_entries, AlignmentOf<float>::value));
+		grid_ptr[p] = grid[p].data();
+	}
+
+	for (unsigned x = 0; x < size; ++x) {
+		for (unsigned y = 0; y < size; ++y) {
+			for (unsigned z = 0; z < size; ++z) {
+				unsigned idx = (x * size + y) * size + z;
+				grid[0][idx] = lower[0] + (upper[0] - lower[0]) * x / (size - 1);
+				grid[1][idx] = lower[1] + (upper[1] - lower[1]) * y / (size - 1);
+				grid[2][idx] = lower[2] + (upper[2] - lower[2]) * z / (size - 1);
+			}
+		}
+	}
+
+	for (const auto &op : path) {
+		op->process(grid_ptr, grid_ptr, 0, num_entries);
+	}
+
+	for (unsigned idx = 0; idx < num_entries; ++idx) {
+		lut.data[idx * 4 + 0] = grid[0][idx];
+		lut.data[idx * 4 + 1] = grid[1][idx];
+		lut.data[idx * 4 + 2] = grid[2][idx];
+	}
+
+	return lut;
+}
+
+std::unique_ptr<Operation> create_lut3d_operation(Lut3D &&lut, CPUClass cpu)
+{
+	std::unique_ptr<Operation> ret;
+
+#ifdef ZIMG_X86
+	ret = create_lut3d_operation_x86(std::move(lut), cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<Lut3DOperationC>(std::move(lut));
+
+	return ret;
 }
 
 } // namespace colorspace
@@ -3,7 +3,11 @@
 #ifndef ZIMG_COLORSPACE_OPERATION_IMPL_H_
 #define ZIMG_COLORSPACE_OPERATION_IMPL_H_
 
+#include <memory>
+#include <vector>
+#include "common/alloc.h"
 #include "common/libm_wrapper.h"
+#include "matrix3.h"
 #include "operation.h"
 
 namespace zimg {
@@ -12,13 +16,13 @@ enum class CPUClass;
 
 namespace colorspace {
 
-struct Matrix3x3;
 struct TransferFunction;
 
 /**
  * Base class for matrix operation implementations.
  */
 class MatrixOperationImpl : public Operation {
+	Matrix3x3 m_matrix_exact;
 protected:
 	/**
 	 * Transformation matrix.
@@ -31,6 +35,13 @@ protected:
 	 * @param m transformation matrix
 	 */
 	explicit MatrixOperationImpl(const Matrix3x3 &matrix);
+public:
+	/**
+	 * Get the transformation matrix in full precision.
+	 *
+	 * @return matrix
+	 */
+	const Matrix3x3 &get_matrix() const { return m_matrix_exact; }
 };
 
 /**
@@ -42,6 +53,16 @@ protected:
  */
 std::unique_ptr<Operation> create_matrix_operation(const Matrix3x3 &m, CPUClass cpu);
 
+/**
+ * Combine two consecutive matrix operations into a single operation.
+ *
+ * @param first operation applied first
+ * @param second operation applied to the output of the first
+ * @param cpu create operation optimized for given cpu
+ * @return concrete operation, or nullptr if either is not a matrix operation
+ */
+std::unique_ptr<Operation> combine_matrix_operations(const Operation &first, const Operation &second, CPUClass cpu);
+
 /**
  * Create operation consisting of converting linear light to non-linear ("gamma") encoding.
  *
@@ -64,18 +85,66 @@ std::unique_ptr<Operation> create_inverse_gamma_operation(const TransferFunction
  *
  * @param m RGB to YUV conversion matrix for color primaries
  * @param params parameters
+ * @param cpu create operation optimized for given cpu
  * @return concrete operation
  */
-std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params);
+std::unique_ptr<Operation> create_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu);
 
 /**
  * Create operation consisting of converting ARIB STD-B67 to linear light using display-referred EOTF.
  *
  * @param m RGB to YUV conversion matrix for color primaries
  * @param params parameters
+ * @param cpu create operation optimized for given cpu
+ * @return concrete operation
+ */
+std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params, CPUClass cpu);
+
+/**
+ * Three-dimensional lookup table sampled from a sequence of operations.
+ */
+struct Lut3D {
+	/**
+	 * Table entries, with the third input channel varying fastest. Each
+	 * entry holds the three output channels padded to four floats.
+	 */
+	AlignedVector<float> data;
+
+	/**
+	 * Number of entries along each dimension.
+	 */
+	unsigned size;
+
+	/**
+	 * Mapping of input values to table coordinates, x * scale + offset.
+	 */
+	float scale[3];
+	float offset[3];
+};
+
+/**
+ * Sample a sequence of operations on a uniform grid.
+ *
+ * The grid spans [0, 1] in the first channel. The other two channels span
+ * [-0.5, 0.5] for YUV input or [0, 1] for RGB input.
+ *
+ * @param path operations to apply in order
+ * @param yuv true if the input channels are YUV
+ * @param size number of entries along each dimension
+ * @return lookup table
+ */
+Lut3D bake_lut3d(const std::vector<std::unique_ptr<Operation>> &path, bool yuv, unsigned size);
+
+/**
+ * Create operation consisting of tetrahedral interpolation in a 3D LUT.
+ *
+ * Inputs outside of the range covered by the table are clamped.
+ *
+ * @param lut lookup table, moved into the operation
+ * @param cpu create operation optimized for given cpu
  * @return concrete operation
  */
-std::unique_ptr<Operation> create_inverse_arib_b67_operation(const Matrix3x3 &m, const OperationParams &params);
+std::unique_ptr<Operation> create_lut3d_operation(Lut3D &&lut, CPUClass cpu);
 
 } // namespace colorspace
 } // namespace zimg
@@ -1,7 +1,10 @@
 #ifdef ZIMG_X86
 
 #include <algorithm>
+#include <cfloat>
 #include <cstdint>
+#include <initializer_list>
+#include <utility>
 #include <vector>
 #include <immintrin.h>
 #include "common/align.h"
@@ -9,8 +12,12 @@
 #include "common/make_unique.h"
 #include "colorspace/gamma.h"
 #include "colorspace/operation.h"
+#include "colorspace/operation_impl.h"
 #include "operation_impl_x86.h"
 
+#include "common/x86/avx_util.h"
+#include "common/x86/avx2_util.h"
+
 namespace zimg {
 namespace colorspace {
 
@@ -79,6 +86,480 @@ void to_gamma_lut_filter_line(const float *RESTRICT lut, const float *src, float
 	}
 }
 
+inline FORCE_INLINE void lut3d_filter_line_avx2_xiter(unsigned j, const Lut3D &lut, const float * const *src, __m256 &out0, __m256 &out1, __m256 &out2)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 limit = _mm256_set1_ps(static_cast<float>(lut.size - 1));
+	const __m256i base_limit = _mm256_set1_epi32(lut.size - 2);
+	const __m256i stride_x = _mm256_set1_epi32(lut.size * lut.size * 4);
+	const __m256i stride_y = _mm256_set1_epi32(lut.size * 4);
+	const __m256i stride_z = _mm256_set1_epi32(4);
+	const __m256i stride_xyz = _mm256_add_epi32(_mm256_add_epi32(stride_x, stride_y), stride_z);
+
+	__m256 u[3];
+	__m256i idx = _mm256_setzero_si256();
+
+	for (unsigned p = 0; p < 3; ++p) {
+		__m256 x = _mm256_load_ps(src[p] + j);
+		x = _mm256_add_ps(_mm256_mul_ps(x, _mm256_broadcast_ss(lut.scale + p)), _mm256_broadcast_ss(lut.offset + p));
+		x = _mm256_max_ps(x, zero); // NaN to zero.
+		x = _mm256_min_ps(x, limit);
+
+		__m256i base = _mm256_min_epi32(_mm256_cvttps_epi32(x), base_limit);
+		u[p] = _mm256_sub_ps(x, _mm256_cvtepi32_ps(base));
+		idx = _mm256_add_epi32(_mm256_mullo_epi32(idx, _mm256_set1_epi32(lut.size)), base);
+	}
+	idx = _mm256_slli_epi32(idx, 2);
+
+	__m256 w_max = _mm256_max_ps(_mm256_max_ps(u[0], u[1]), u[2]);
+	__m256 w_min = _mm256_min_ps(_mm256_min_ps(u[0], u[1]), u[2]);
+	__m256 w_mid = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(u[0], u[1]), u[2]), w_max), w_min);
+
+	__m256 mask_x = _mm256_and_ps(_mm256_cmp_ps(u[0], u[1], _CMP_GE_OQ), _mm256_cmp_ps(u[0], u[2], _CMP_GE_OQ));
+	__m256 mask_y = _mm256_cmp_ps(u[1], u[2], _CMP_GE_OQ);
+	__m256i step1 = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(stride_z), _mm256_castsi256_ps(stride_y), mask_y));
+	step1 = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(step1), _mm256_castsi256_ps(stride_x), mask_x));
+
+	mask_x = _mm256_and_ps(_mm256_cmp_ps(u[0], u[1], _CMP_LE_OQ), _mm256_cmp_ps(u[0], u[2], _CMP_LE_OQ));
+	mask_y = _mm256_cmp_ps(u[1], u[2], _CMP_LE_OQ);
+	__m256i step3 = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(stride_z), _mm256_castsi256_ps(stride_y), mask_y));
+	step3 = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(step3), _mm256_castsi256_ps(stride_x), mask_x));
+
+	__m256i v1 = _mm256_add_epi32(idx, step1);
+	__m256i v2 = _mm256_sub_epi32(_mm256_add_epi32(idx, stride_xyz), step3);
+	__m256i v3 = _mm256_add_epi32(idx, stride_xyz);
+
+	__m256 w0 = _mm256_sub_ps(_mm256_set1_ps(1.0f), w_max);
+	__m256 w1 = _mm256_sub_ps(w_max, w_mid);
+	__m256 w2 = _mm256_sub_ps(w_mid, w_min);
+	__m256 w3 = w_min;
+
+	__m256 *out[3] = { &out0, &out1, &out2 };
+
+	for (unsigned p = 0; p < 3; ++p) {
+		const float *table = lut.data.data() + p;
+		__m256 y;
+
+		y = _mm256_mul_ps(_mm256_i32gather_ps(table, idx, sizeof(float)), w0);
+		y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_i32gather_ps(table, v1, sizeof(float)), w1));
+		y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_i32gather_ps(table, v2, sizeof(float)), w2));
+		y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_i32gather_ps(table, v3, sizeof(float)), w3));
+		*out[p] = y;
+	}
+}
+
+void lut3d_filter_line_avx2(const Lut3D &lut, const float * const *src, float * const *dst, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+	__m256 out0, out1, out2;
+
+#define XITER lut3d_filter_line_avx2_xiter
+#define XARGS lut, src, out0, out1, out2
+	if (left != vec_left) {
+		XITER(vec_left - 8, XARGS);
+
+		mm256_store_idxhi_ps(dst[0] + vec_left - 8, out0, left % 8);
+		mm256_store_idxhi_ps(dst[1] + vec_left - 8, out1, left % 8);
+		mm256_store_idxhi_ps(dst[2] + vec_left - 8, out2, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		XITER(j, XARGS);
+
+		_mm256_store_ps(dst[0] + j, out0);
+		_mm256_store_ps(dst[1] + j, out1);
+		_mm256_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+
+		mm256_store_idxlo_ps(dst[0] + vec_right, out0, right % 8);
+		mm256_store_idxlo_ps(dst[1] + vec_right, out1, right % 8);
+		mm256_store_idxlo_ps(dst[2] + vec_right, out2, right % 8);
+	}
+#undef XITER
+#undef XARGS
+}
+
+
+inline FORCE_INLINE __m256 arib_b67_oetf_avx2(__m256 x)
+{
+	__m256 lo, hi, mask;
+
+	// Prevent negative pixels from yielding NAN.
+	x = _mm256_max_ps(x, _mm256_setzero_ps());
+
+	lo = _mm256_sqrt_ps(_mm256_mul_ps(x, _mm256_set1_ps(3.0f)));
+	hi = mm256_log_ps(_mm256_sub_ps(_mm256_mul_ps(x, _mm256_set1_ps(12.0f)), _mm256_set1_ps(ARIB_B67_B)));
+	hi = _mm256_fmadd_ps(hi, _mm256_set1_ps(ARIB_B67_A), _mm256_set1_ps(ARIB_B67_C));
+
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(1.0f / 12.0f), _CMP_LE_OQ);
+	return _mm256_blendv_ps(hi, lo, mask);
+}
+
+inline FORCE_INLINE __m256 arib_b67_inverse_oetf_avx2(__m256 x)
+{
+	__m256 lo, hi, mask;
+
+	// Prevent negative pixels expanding into positive values.
+	x = _mm256_max_ps(x, _mm256_setzero_ps());
+
+	lo = _mm256_mul_ps(_mm256_mul_ps(x, x), _mm256_set1_ps(1.0f / 3.0f));
+	hi = mm256_exp_ps(_mm256_mul_ps(_mm256_sub_ps(x, _mm256_set1_ps(ARIB_B67_C)), _mm256_set1_ps(1.0f / ARIB_B67_A)));
+	hi = _mm256_mul_ps(_mm256_add_ps(hi, _mm256_set1_ps(ARIB_B67_B)), _mm256_set1_ps(1.0f / 12.0f));
+
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(0.5f), _CMP_LE_OQ);
+	return _mm256_blendv_ps(hi, lo, mask);
+}
+
+template <bool Inverse>
+inline FORCE_INLINE void arib_b67_filter_line_avx2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m256 &out0, __m256 &out1, __m256 &out2,
+                                                         const __m256 &kr, const __m256 &kg, const __m256 &kb, const __m256 &scale)
+{
+	const float gamma = 1.2f;
+
+	__m256 r = _mm256_load_ps(src[0] + j);
+	__m256 g = _mm256_load_ps(src[1] + j);
+	__m256 b = _mm256_load_ps(src[2] + j);
+	__m256 y;
+
+	if (!Inverse) {
+		r = _mm256_mul_ps(r, scale);
+		g = _mm256_mul_ps(g, scale);
+		b = _mm256_mul_ps(b, scale);
+	}
+
+	y = _mm256_mul_ps(kr, r);
+	y = _mm256_fmadd_ps(kg, g, y);
+	y = _mm256_fmadd_ps(kb, b, y);
+	y = _mm256_max_ps(y, _mm256_set1_ps(FLT_MIN));
+
+	if (Inverse) {
+		y = mm256_pow_ps(y, _mm256_set1_ps(gamma - 1.0f));
+		out0 = _mm256_mul_ps(arib_b67_inverse_oetf_avx2(_mm256_mul_ps(r, y)), scale);
+		out1 = _mm256_mul_ps(arib_b67_inverse_oetf_avx2(_mm256_mul_ps(g, y)), scale);
+		out2 = _mm256_mul_ps(arib_b67_inverse_oetf_avx2(_mm256_mul_ps(b, y)), scale);
+	} else {
+		y = mm256_pow_ps(y, _mm256_set1_ps((1.0f - gamma) / gamma));
+		out0 = arib_b67_oetf_avx2(_mm256_mul_ps(r, y));
+		out1 = arib_b67_oetf_avx2(_mm256_mul_ps(g, y));
+		out2 = arib_b67_oetf_avx2(_mm256_mul_ps(b, y));
+	}
+}
+
+template <bool Inverse>
+void arib_b67_filter_line_avx2(const float *coeffs, float scale, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	const __m256 kr = _mm256_set1_ps(coeffs[0]);
+	const __m256 kg = _mm256_set1_ps(coeffs[1]);
+	const __m256 kb = _mm256_set1_ps(coeffs[2]);
+	const __m256 scale_ps = _mm256_set1_ps(scale);
+	__m256 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+#define XITER arib_b67_filter_line_avx2_xiter<Inverse>
+#define XARGS src, out0, out1, out2, kr, kg, kb, scale_ps
+	if (left != vec_left) {
+		XITER(vec_left - 8, XARGS);
+
+		mm256_store_idxhi_ps(dst[0] + vec_left - 8, out0, left % 8);
+		mm256_store_idxhi_ps(dst[1] + vec_left - 8, out1, left % 8);
+		mm256_store_idxhi_ps(dst[2] + vec_left - 8, out2, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		XITER(j, XARGS);
+
+		_mm256_store_ps(dst[0] + j, out0);
+		_mm256_store_ps(dst[1] + j, out1);
+		_mm256_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+
+		mm256_store_idxlo_ps(dst[0] + vec_right, out0, right % 8);
+		mm256_store_idxlo_ps(dst[1] + vec_right, out1, right % 8);
+		mm256_store_idxlo_ps(dst[2] + vec_right, out2, right % 8);
+	}
+#undef XITER
+#undef XARGS
+}
+
+inline FORCE_INLINE __m256 rec_709_oetf_avx2(__m256 x)
+{
+	const __m256 alpha = _mm256_set1_ps(REC709_ALPHA);
+	__m256 lo, hi, mask;
+
+	lo = _mm256_mul_ps(x, _mm256_set1_ps(4.5f));
+	hi = mm256_pow_ps(x, _mm256_set1_ps(0.45f));
+	hi = _mm256_sub_ps(_mm256_mul_ps(alpha, hi), _mm256_sub_ps(alpha, _mm256_set1_ps(1.0f)));
+
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(REC709_BETA), _CMP_LT_OQ);
+	return _mm256_blendv_ps(hi, lo, mask);
+}
+
+inline FORCE_INLINE __m256 rec_709_inverse_oetf_avx2(__m256 x)
+{
+	const __m256 alpha = _mm256_set1_ps(REC709_ALPHA);
+	__m256 lo, hi, mask;
+
+	lo = _mm256_mul_ps(x, _mm256_set1_ps(1.0f / 4.5f));
+	hi = _mm256_div_ps(_mm256_add_ps(x, _mm256_sub_ps(alpha, _mm256_set1_ps(1.0f))), alpha);
+	hi = mm256_pow_ps(hi, _mm256_set1_ps(1.0f / 0.45f));
+
+	mask = _mm256_cmp_ps(x, _mm256_set1_ps(4.5f * REC709_BETA), _CMP_LT_OQ);
+	return _mm256_blendv_ps(hi, lo, mask);
+}
+
+inline FORCE_INLINE void cl_to_rgb_avx2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m256 &out0, __m256 &out1, __m256 &out2, const float *coeffs)
+{
+	const __m256 kr = _mm256_set1_ps(coeffs[0]);
+	const __m256 kg = _mm256_set1_ps(coeffs[1]);
+	const __m256 kb = _mm256_set1_ps(coeffs[2]);
+	const __m256 nb = _mm256_set1_ps(coeffs[3]);
+	const __m256 pb = _mm256_set1_ps(coeffs[4]);
+	const __m256 nr = _mm256_set1_ps(coeffs[5]);
+	const __m256 pr = _mm256_set1_ps(coeffs[6]);
+	const __m256 scale = _mm256_set1_ps(coeffs[7]);
+	const __m256 two = _mm256_set1_ps(2.0f);
+	const __m256 zero = _mm256_setzero_ps();
+
+	__m256 y = _mm256_load_ps(src[0] + j);
+	__m256 u = _mm256_load_ps(src[1] + j);
+	__m256 v = _mm256_load_ps(src[2] + j);
+	__m256 r, g, b, k, mask;
+
+	// Select the chroma scale by the sign of the difference.
+	mask = _mm256_cmp_ps(u, zero, _CMP_LT_OQ);
+	k = _mm256_blendv_ps(pb, nb, mask);
+	b = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(u, two), k), y);
+
+	mask = _mm256_cmp_ps(v, zero, _CMP_LT_OQ);
+	k = _mm256_blendv_ps(pr, nr, mask);
+	r = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(v, two), k), y);
+
+	b = rec_709_inverse_oetf_avx2(b);
+	r = rec_709_inverse_oetf_avx2(r);
+	y = rec_709_inverse_oetf_avx2(y);
+
+	g = _mm256_sub_ps(y, _mm256_mul_ps(kr, r));
+	g = _mm256_sub_ps(g, _mm256_mul_ps(kb, b));
+	g = _mm256_div_ps(g, kg);
+
+	out0 = _mm256_mul_ps(r, scale);
+	out1 = _mm256_mul_ps(g, scale);
+	out2 = _mm256_mul_ps(b, scale);
+}
+
+inline FORCE_INLINE void cl_to_yuv_avx2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m256 &out0, __m256 &out1, __m256 &out2, const float *coeffs)
+{
+	const __m256 kr = _mm256_set1_ps(coeffs[0]);
+	const __m256 kg = _mm256_set1_ps(coeffs[1]);
+	const __m256 kb = _mm256_set1_ps(coeffs[2]);
+	const __m256 nb = _mm256_set1_ps(coeffs[3]);
+	const __m256 pb = _mm256_set1_ps(coeffs[4]);
+	const __m256 nr = _mm256_set1_ps(coeffs[5]);
+	const __m256 pr = _mm256_set1_ps(coeffs[6]);
+	const __m256 scale = _mm256_set1_ps(coeffs[7]);
+	const __m256 two = _mm256_set1_ps(2.0f);
+	const __m256 zero = _mm256_setzero_ps();
+
+	__m256 r = _mm256_mul_ps(_mm256_load_ps(src[0] + j), scale);
+	__m256 g = _mm256_mul_ps(_mm256_load_ps(src[1] + j), scale);
+	__m256 b = _mm256_mul_ps(_mm256_load_ps(src[2] + j), scale);
+	__m256 y, k, mask;
+
+	y = _mm256_mul_ps(kr, r);
+	y = _mm256_fmadd_ps(kg, g, y);
+	y = _mm256_fmadd_ps(kb, b, y);
+
+	y = rec_709_oetf_avx2(y);
+	b = _mm256_sub_ps(rec_709_oetf_avx2(b), y);
+	r = _mm256_sub_ps(rec_709_oetf_avx2(r), y);
+
+	// Select the chroma scale by the sign of the difference.
+	mask = _mm256_cmp_ps(b, zero, _CMP_LT_OQ);
+	k = _mm256_blendv_ps(pb, nb, mask);
+	b = _mm256_div_ps(b, _mm256_mul_ps(two, k));
+
+	mask = _mm256_cmp_ps(r, zero, _CMP_LT_OQ);
+	k = _mm256_blendv_ps(pr, nr, mask);
+	r = _mm256_div_ps(r, _mm256_mul_ps(two, k));
+
+	out0 = y;
+	out1 = b;
+	out2 = r;
+}
+
+template <bool ToYUV>
+inline FORCE_INLINE void cl_filter_line_avx2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m256 &out0, __m256 &out1, __m256 &out2, const float *coeffs)
+{
+	if (ToYUV)
+		cl_to_yuv_avx2_xiter(j, src, out0, out1, out2, coeffs);
+	else
+		cl_to_rgb_avx2_xiter(j, src, out0, out1, out2, coeffs);
+}
+
+template <bool ToYUV>
+void cl_filter_line_avx2(const float *coeffs, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	__m256 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+#define XITER cl_filter_line_avx2_xiter<ToYUV>
+#define XARGS src, out0, out1, out2, coeffs
+	if (left != vec_left) {
+		XITER(vec_left - 8, XARGS);
+
+		mm256_store_idxhi_ps(dst[0] + vec_left - 8, out0, left % 8);
+		mm256_store_idxhi_ps(dst[1] + vec_left - 8, out1, left % 8);
+		mm256_store_idxhi_ps(dst[2] + vec_left - 8, out2, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		XITER(j, XARGS);
+
+		_mm256_store_ps(dst[0] + j, out0);
+		_mm256_store_ps(dst[1] + j, out1);
+		_mm256_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+
+		mm256_store_idxlo_ps(dst[0] + vec_right, out0, right % 8);
+		mm256_store_idxlo_ps(dst[1] + vec_right, out1, right % 8);
+		mm256_store_idxlo_ps(dst[2] + vec_right, out2, right % 8);
+	}
+#undef XITER
+#undef XARGS
+}
+
+// Transfer functions evaluated with polynomial approximations of the
+// logarithm and exponential instead of a table lookup. They are used on CPUs
+// where gathers are slow. See the AVX-512 implementation for the meaning of
+// the parameters.
+template <bool Inverse>
+struct SegmentedPowerAVX2 {
+	__m256 alpha;
+	__m256 beta;
+	__m256 slope;
+	__m256 power;
+
+	explicit SegmentedPowerAVX2(const float *params) :
+		alpha{ _mm256_set1_ps(params[0]) },
+		beta{ _mm256_set1_ps(Inverse ? params[1] * params[2] : params[1]) },
+		slope{ _mm256_set1_ps(Inverse ? 1.0f / params[2] : params[2]) },
+		power{ _mm256_set1_ps(Inverse ? 1.0f / params[3] : params[3]) }
+	{}
+
+	inline FORCE_INLINE __m256 operator()(__m256 x) const
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+		__m256 lo, hi, mask;
+
+		lo = _mm256_mul_ps(x, slope);
+
+		if (Inverse) {
+			hi = _mm256_div_ps(_mm256_add_ps(x, _mm256_sub_ps(alpha, one)), alpha);
+			hi = mm256_pow_ps(_mm256_max_ps(hi, _mm256_set1_ps(FLT_MIN)), power);
+		} else {
+			hi = mm256_pow_ps(_mm256_max_ps(x, _mm256_set1_ps(FLT_MIN)), power);
+			hi = _mm256_fmsub_ps(alpha, hi, _mm256_sub_ps(alpha, one));
+		}
+
+		mask = _mm256_cmp_ps(x, beta, _CMP_LT_OQ);
+		return _mm256_blendv_ps(hi, lo, mask);
+	}
+};
+
+struct PowerAVX2 {
+	__m256 power;
+
+	explicit PowerAVX2(const float *params) : power{ _mm256_set1_ps(params[0]) } {}
+
+	inline FORCE_INLINE __m256 operator()(__m256 x) const
+	{
+		__m256 y = mm256_pow_ps(_mm256_max_ps(x, _mm256_set1_ps(FLT_MIN)), power);
+		__m256 mask = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ);
+		return _mm256_and_ps(mask, y);
+	}
+};
+
+template <bool Inverse>
+struct LogarithmicAVX2 {
+	__m256 threshold;
+	__m256 decades;
+
+	explicit LogarithmicAVX2(const float *params) :
+		threshold{ _mm256_set1_ps(params[0]) },
+		decades{ _mm256_set1_ps(params[1]) }
+	{}
+
+	inline FORCE_INLINE __m256 operator()(__m256 x) const
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 ln_10 = _mm256_set1_ps(2.302585093f);
+		__m256 y, mask;
+
+		if (Inverse) {
+			y = mm256_exp_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(x, one), decades), ln_10));
+			mask = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LE_OQ);
+			return _mm256_blendv_ps(y, threshold, mask);
+		} else {
+			y = _mm256_div_ps(mm256_log_ps(_mm256_max_ps(x, threshold)), _mm256_mul_ps(decades, ln_10));
+			y = _mm256_add_ps(y, one);
+			mask = _mm256_cmp_ps(x, threshold, _CMP_GT_OQ);
+			return _mm256_and_ps(mask, y);
+		}
+	}
+};
+
+template <bool Inverse>
+struct AribB67AVX2 {
+	explicit AribB67AVX2(const float *) {}
+
+	inline FORCE_INLINE __m256 operator()(__m256 x) const
+	{
+		return Inverse ? arib_b67_inverse_oetf_avx2(x) : arib_b67_oetf_avx2(x);
+	}
+};
+
+template <class F>
+void gamma_filter_line_avx2(const F &func, float prescale, float postscale, const float *src, float *dst, unsigned left, unsigned right)
+{
+	const __m256 prescale_ps = _mm256_set1_ps(prescale);
+	const __m256 postscale_ps = _mm256_set1_ps(postscale);
+
+	unsigned vec_left = ceil_n(left, 8);
+	unsigned vec_right = floor_n(right, 8);
+
+	if (left != vec_left) {
+		__m256 x = _mm256_load_ps(src + vec_left - 8);
+		x = _mm256_mul_ps(func(_mm256_mul_ps(x, prescale_ps)), postscale_ps);
+		mm256_store_idxhi_ps(dst + vec_left - 8, x, left % 8);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 8) {
+		__m256 x = _mm256_load_ps(src + j);
+		x = _mm256_mul_ps(func(_mm256_mul_ps(x, prescale_ps)), postscale_ps);
+		_mm256_store_ps(dst + j, x);
+	}
+
+	if (right != vec_right) {
+		__m256 x = _mm256_load_ps(src + vec_right);
+		x = _mm256_mul_ps(func(_mm256_mul_ps(x, prescale_ps)), postscale_ps);
+		mm256_store_idxlo_ps(dst + vec_right, x, right % 8);
+	}
+}
+
 
 class ToLinearLutOperationAVX2 final : public Operation {
 	std::vector<float> m_lut;
@@ -129,23 +610,194 @@ public:
 	}
 };
 
+template <class F>
+class GammaOperationAVX2 final : public Operation {
+	float m_params[4];
+	float m_prescale;
+	float m_postscale;
+public:
+	GammaOperationAVX2(std::initializer_list<float> params, float prescale, float postscale) :
+		m_params{},
+		m_prescale{ prescale },
+		m_postscale{ postscale }
+	{
+		std::copy(params.begin(), params.end(), m_params);
+	}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		F func{ m_params };
+
+		gamma_filter_line_avx2(func, m_prescale, m_postscale, src[0], dst[0], left, right);
+		gamma_filter_line_avx2(func, m_prescale, m_postscale, src[1], dst[1], left, right);
+		gamma_filter_line_avx2(func, m_prescale, m_postscale, src[2], dst[2], left, right);
+	}
+};
+
+class Lut3DOperationAVX2 final : public Operation {
+	Lut3D m_lut;
+public:
+	explicit Lut3DOperationAVX2(Lut3D &&lut) : m_lut(std::move(lut)) {}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		lut3d_filter_line_avx2(m_lut, src, dst, left, right);
+	}
+};
+
+template <bool Inverse>
+class AribB67OperationAVX2 final : public Operation {
+	float m_coeffs[3];
+	float m_scale;
+public:
+	AribB67OperationAVX2(const Matrix3x3 &m, float scale) :
+		m_coeffs{ static_cast<float>(m[0][0]), static_cast<float>(m[0][1]), static_cast<float>(m[0][2]) },
+		m_scale{ scale }
+	{}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		arib_b67_filter_line_avx2<Inverse>(m_coeffs, m_scale, src, dst, left, right);
+	}
+};
+
+// Coefficients are Kr, Kg, Kb, Nb, Pb, Nr, Pr, and the linear scale factor.
+template <bool ToYUV>
+class CLOperationAVX2 final : public Operation {
+	float m_coeffs[8];
+public:
+	CLOperationAVX2(const Matrix3x3 &m, float scale) :
+		m_coeffs{}
+	{
+		float kr = static_cast<float>(m[0][0]);
+		float kg = static_cast<float>(m[0][1]);
+		float kb = static_cast<float>(m[0][2]);
+
+		m_coeffs[0] = kr;
+		m_coeffs[1] = kg;
+		m_coeffs[2] = kb;
+		m_coeffs[3] = rec_709_oetf(1.0f - kb);
+		m_coeffs[4] = 1.0f - rec_709_oetf(kb);
+		m_coeffs[5] = rec_709_oetf(1.0f - kr);
+		m_coeffs[6] = 1.0f - rec_709_oetf(kr);
+		m_coeffs[7] = scale;
+	}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		cl_filter_line_avx2<ToYUV>(m_coeffs, src, dst, left, right);
+	}
+};
+
+template <class F>
+std::unique_ptr<Operation> make_gamma_operation_avx2(std::initializer_list<float> params, float prescale, float postscale)
+{
+	return ztd::make_unique<GammaOperationAVX2<F>>(params, prescale, postscale);
+}
+
+std::unique_ptr<Operation> create_vector_gamma_operation_avx2(gamma_func func, float prescale, float postscale)
+{
+	if (func == rec_709_oetf)
+		return make_gamma_operation_avx2<SegmentedPowerAVX2<false>>({ REC709_ALPHA, REC709_BETA, 4.5f, 0.45f }, prescale, postscale);
+	if (func == rec_709_inverse_oetf)
+		return make_gamma_operation_avx2<SegmentedPowerAVX2<true>>({ REC709_ALPHA, REC709_BETA, 4.5f, 0.45f }, prescale, postscale);
+	if (func == smpte_240m_inverse_oetf)
+		return make_gamma_operation_avx2<SegmentedPowerAVX2<false>>({ SMPTE_240M_ALPHA, SMPTE_240M_BETA, 4.0f, 0.45f }, prescale, postscale);
+	if (func == smpte_240m_oetf)
+		return make_gamma_operation_avx2<SegmentedPowerAVX2<true>>({ SMPTE_240M_ALPHA, SMPTE_240M_BETA, 4.0f, 0.45f }, prescale, postscale);
+	if (func == srgb_inverse_eotf)
+		return make_gamma_operation_avx2<SegmentedPowerAVX2<false>>({ SRGB_ALPHA, SRGB_BETA, 12.92f, 1.0f / 2.4f }, prescale, postscale);
+	if (func == srgb_eotf)
+		return make_gamma_operation_avx2<SegmentedPowerAVX2<true>>({ SRGB_ALPHA, SRGB_BETA, 12.92f, 1.0f / 2.4f }, prescale, postscale);
+
+	if (func == rec_1886_eotf)
+		return make_gamma_operation_avx2<PowerAVX2>({ 2.4f }, prescale, postscale);
+	if (func == rec_1886_inverse_eotf)
+		return make_gamma_operation_avx2<PowerAVX2>({ 1.0f / 2.4f }, prescale, postscale);
+	if (func == rec_470m_oetf)
+		return make_gamma_operation_avx2<PowerAVX2>({ 2.2f }, prescale, postscale);
+	if (func == rec_470m_inverse_oetf)
+		return make_gamma_operation_avx2<PowerAVX2>({ 1.0f / 2.2f }, prescale, postscale);
+	if (func == rec_470bg_oetf)
+		return make_gamma_operation_avx2<PowerAVX2>({ 2.8f }, prescale, postscale);
+	if (func == rec_470bg_inverse_oetf)
+		return make_gamma_operation_avx2<PowerAVX2>({ 1.0f / 2.8f }, prescale, postscale);
+
+	if (func == log100_oetf)
+		return make_gamma_operation_avx2<LogarithmicAVX2<false>>({ 0.01f, 2.0f }, prescale, postscale);
+	if (func == log100_inverse_oetf)
+		return make_gamma_operation_avx2<LogarithmicAVX2<true>>({ 0.01f, 2.0f }, prescale, postscale);
+	if (func == log316_oetf)
+		return make_gamma_operation_avx2<LogarithmicAVX2<false>>({ 0.00316227766f, 2.5f }, prescale, postscale);
+	if (func == log316_inverse_oetf)
+		return make_gamma_operation_avx2<LogarithmicAVX2<true>>({ 0.00316227766f, 2.5f }, prescale, postscale);
+
+	// ST 2084 evaluates two powers per pixel, which costs more than even a slow
+	// gather, so it always uses the table.
+	if (func == arib_b67_oetf)
+		return make_gamma_operation_avx2<AribB67AVX2<false>>({}, prescale, postscale);
+	if (func == arib_b67_inverse_oetf)
+		return make_gamma_operation_avx2<AribB67AVX2<true>>({}, prescale, postscale);
+
+	return nullptr;
+}
+
 } // namespace
 
 
-std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params, bool lut)
 {
+	std::unique_ptr<Operation> ret;
+
 	if (!params.approximate_gamma)
 		return nullptr;
 
-	return ztd::make_unique<ToGammaLutOperationAVX2>(transfer.to_gamma, transfer.to_gamma_scale);
+	if (!lut)
+		ret = create_vector_gamma_operation_avx2(transfer.to_gamma, transfer.to_gamma_scale, 1.0f);
+	if (!ret)
+		ret = ztd::make_unique<ToGammaLutOperationAVX2>(transfer.to_gamma, transfer.to_gamma_scale);
+
+	return ret;
 }
 
-std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params)
+std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params, bool lut)
 {
+	std::unique_ptr<Operation> ret;
+
 	if (!params.approximate_gamma)
 		return nullptr;
 
-	return ztd::make_unique<ToLinearLutOperationAVX2>(transfer.to_linear, LUT_DEPTH, transfer.to_linear_scale);
+	if (!lut)
+		ret = create_vector_gamma_operation_avx2(transfer.to_linear, 1.0f, transfer.to_linear_scale);
+	if (!ret)
+		ret = ztd::make_unique<ToLinearLutOperationAVX2>(transfer.to_linear, LUT_DEPTH, transfer.to_linear_scale);
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_lut3d_operation_avx2(Lut3D &&lut)
+{
+	return ztd::make_unique<Lut3DOperationAVX2>(std::move(lut));
+}
+
+std::unique_ptr<Operation> create_arib_b67_operation_avx2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<AribB67OperationAVX2<false>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<AribB67OperationAVX2<true>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<CLOperationAVX2<false>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<CLOperationAVX2<true>>(m, scale);
 }
 
 } // namespace colorspace
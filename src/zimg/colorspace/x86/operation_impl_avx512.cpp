@@ -2,10 +2,16 @@
 
 #ifdef ZIMG_X86_AVX512
 
+#include <algorithm>
+#include <cfloat>
+#include <initializer_list>
+#include <utility>
 #include <immintrin.h>
 #include "common/align.h"
 #include "common/ccdep.h"
 #include "common/make_unique.h"
+#include "colorspace/gamma.h"
+#include "colorspace/operation.h"
 #include "colorspace/operation_impl.h"
 #include "operation_impl_x86.h"
 
@@ -89,6 +95,530 @@ void matrix_filter_line_avx512(const float *matrix, const float * const * RESTRI
 #undef XARGS
 }
 
+inline FORCE_INLINE void lut3d_filter_line_avx512_xiter(unsigned j, const Lut3D &lut, const float * const *src, __m512 &out0, __m512 &out1, __m512 &out2)
+{
+	const __m512 zero = _mm512_setzero_ps();
+	const __m512 limit = _mm512_set1_ps(static_cast<float>(lut.size - 1));
+	const __m512i base_limit = _mm512_set1_epi32(lut.size - 2);
+	const __m512i stride_x = _mm512_set1_epi32(lut.size * lut.size * 4);
+	const __m512i stride_y = _mm512_set1_epi32(lut.size * 4);
+	const __m512i stride_z = _mm512_set1_epi32(4);
+	const __m512i stride_xyz = _mm512_add_epi32(_mm512_add_epi32(stride_x, stride_y), stride_z);
+
+	__m512 u[3];
+	__m512i idx = _mm512_setzero_si512();
+
+	for (unsigned p = 0; p < 3; ++p) {
+		__m512 x = _mm512_load_ps(src[p] + j);
+		x = _mm512_add_ps(_mm512_mul_ps(x, _mm512_set1_ps(lut.scale[p])), _mm512_set1_ps(lut.offset[p]));
+		x = _mm512_max_ps(x, zero); // NaN to zero.
+		x = _mm512_min_ps(x, limit);
+
+		__m512i base = _mm512_min_epi32(_mm512_cvttps_epi32(x), base_limit);
+		u[p] = _mm512_sub_ps(x, _mm512_cvtepi32_ps(base));
+		idx = _mm512_add_epi32(_mm512_mullo_epi32(idx, _mm512_set1_epi32(lut.size)), base);
+	}
+	idx = _mm512_slli_epi32(idx, 2);
+
+	__m512 w_max = _mm512_max_ps(_mm512_max_ps(u[0], u[1]), u[2]);
+	__m512 w_min = _mm512_min_ps(_mm512_min_ps(u[0], u[1]), u[2]);
+	__m512 w_mid = _mm512_sub_ps(_mm512_sub_ps(_mm512_add_ps(_mm512_add_ps(u[0], u[1]), u[2]), w_max), w_min);
+
+	__mmask16 mask_x = _mm512_cmp_ps_mask(u[0], u[1], _CMP_GE_OQ) & _mm512_cmp_ps_mask(u[0], u[2], _CMP_GE_OQ);
+	__mmask16 mask_y = _mm512_cmp_ps_mask(u[1], u[2], _CMP_GE_OQ);
+	__m512i step1 = _mm512_mask_blend_epi32(mask_x, _mm512_mask_blend_epi32(mask_y, stride_z, stride_y), stride_x);
+
+	mask_x = _mm512_cmp_ps_mask(u[0], u[1], _CMP_LE_OQ) & _mm512_cmp_ps_mask(u[0], u[2], _CMP_LE_OQ);
+	mask_y = _mm512_cmp_ps_mask(u[1], u[2], _CMP_LE_OQ);
+	__m512i step3 = _mm512_mask_blend_epi32(mask_x, _mm512_mask_blend_epi32(mask_y, stride_z, stride_y), stride_x);
+
+	__m512i v1 = _mm512_add_epi32(idx, step1);
+	__m512i v2 = _mm512_sub_epi32(_mm512_add_epi32(idx, stride_xyz), step3);
+	__m512i v3 = _mm512_add_epi32(idx, stride_xyz);
+
+	__m512 w0 = _mm512_sub_ps(_mm512_set1_ps(1.0f), w_max);
+	__m512 w1 = _mm512_sub_ps(w_max, w_mid);
+	__m512 w2 = _mm512_sub_ps(w_mid, w_min);
+	__m512 w3 = w_min;
+
+	__m512 *out[3] = { &out0, &out1, &out2 };
+
+	for (unsigned p = 0; p < 3; ++p) {
+		const float *table = lut.data.data() + p;
+		__m512 y;
+
+		y = _mm512_mul_ps(_mm512_i32gather_ps(idx, table, sizeof(float)), w0);
+		y = _mm512_add_ps(y, _mm512_mul_ps(_mm512_i32gather_ps(v1, table, sizeof(float)), w1));
+		y = _mm512_add_ps(y, _mm512_mul_ps(_mm512_i32gather_ps(v2, table, sizeof(float)), w2));
+		y = _mm512_add_ps(y, _mm512_mul_ps(_mm512_i32gather_ps(v3, table, sizeof(float)), w3));
+		*out[p] = y;
+	}
+}
+
+void lut3d_filter_line_avx512(const Lut3D &lut, const float * const *src, float * const *dst, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+	__m512 out0, out1, out2;
+
+#define XITER lut3d_filter_line_avx512_xiter
+#define XARGS lut, src, out0, out1, out2
+	if (left != vec_left) {
+		XITER(vec_left - 16, XARGS);
+		__mmask16 mask = mmask16_set_hi(vec_left - left);
+
+		_mm512_mask_store_ps(dst[0] + vec_left - 16, mask, out0);
+		_mm512_mask_store_ps(dst[1] + vec_left - 16, mask, out1);
+		_mm512_mask_store_ps(dst[2] + vec_left - 16, mask, out2);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		XITER(j, XARGS);
+
+		_mm512_store_ps(dst[0] + j, out0);
+		_mm512_store_ps(dst[1] + j, out1);
+		_mm512_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+		__mmask16 mask = mmask16_set_lo(right - vec_right);
+
+		_mm512_mask_store_ps(dst[0] + vec_right, mask, out0);
+		_mm512_mask_store_ps(dst[1] + vec_right, mask, out1);
+		_mm512_mask_store_ps(dst[2] + vec_right, mask, out2);
+	}
+#undef XITER
+#undef XARGS
+}
+
+
+inline FORCE_INLINE __m512 arib_b67_oetf_avx512(__m512 x)
+{
+	__m512 lo, hi;
+	__mmask16 mask;
+
+	// Prevent negative pixels from yielding NAN.
+	x = _mm512_max_ps(x, _mm512_setzero_ps());
+
+	lo = _mm512_sqrt_ps(_mm512_mul_ps(x, _mm512_set1_ps(3.0f)));
+	hi = mm512_log2_ps<true>(_mm512_sub_ps(_mm512_mul_ps(x, _mm512_set1_ps(12.0f)), _mm512_set1_ps(ARIB_B67_B)));
+	hi = _mm512_fmadd_ps(hi, _mm512_set1_ps(ARIB_B67_A * 0.693147181f), _mm512_set1_ps(ARIB_B67_C));
+
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(1.0f / 12.0f), _CMP_LE_OQ);
+	return _mm512_mask_blend_ps(mask, hi, lo);
+}
+
+inline FORCE_INLINE __m512 arib_b67_inverse_oetf_avx512(__m512 x)
+{
+	__m512 lo, hi;
+	__mmask16 mask;
+
+	// Prevent negative pixels expanding into positive values.
+	x = _mm512_max_ps(x, _mm512_setzero_ps());
+
+	lo = _mm512_mul_ps(_mm512_mul_ps(x, x), _mm512_set1_ps(1.0f / 3.0f));
+	hi = mm512_exp2_ps<true>(_mm512_mul_ps(_mm512_sub_ps(x, _mm512_set1_ps(ARIB_B67_C)), _mm512_set1_ps(1.44269504f / ARIB_B67_A)));
+	hi = _mm512_mul_ps(_mm512_add_ps(hi, _mm512_set1_ps(ARIB_B67_B)), _mm512_set1_ps(1.0f / 12.0f));
+
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(0.5f), _CMP_LE_OQ);
+	return _mm512_mask_blend_ps(mask, hi, lo);
+}
+
+template <bool Inverse>
+inline FORCE_INLINE void arib_b67_filter_line_avx512_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m512 &out0, __m512 &out1, __m512 &out2,
+                                                           const __m512 &kr, const __m512 &kg, const __m512 &kb, const __m512 &scale)
+{
+	const float gamma = 1.2f;
+
+	__m512 r = _mm512_load_ps(src[0] + j);
+	__m512 g = _mm512_load_ps(src[1] + j);
+	__m512 b = _mm512_load_ps(src[2] + j);
+	__m512 y;
+
+	if (!Inverse) {
+		r = _mm512_mul_ps(r, scale);
+		g = _mm512_mul_ps(g, scale);
+		b = _mm512_mul_ps(b, scale);
+	}
+
+	y = _mm512_mul_ps(kr, r);
+	y = _mm512_fmadd_ps(kg, g, y);
+	y = _mm512_fmadd_ps(kb, b, y);
+	y = _mm512_max_ps(y, _mm512_set1_ps(FLT_MIN));
+
+	if (Inverse) {
+		y = mm512_pow_ps<true>(y, _mm512_set1_ps(gamma - 1.0f));
+		out0 = _mm512_mul_ps(arib_b67_inverse_oetf_avx512(_mm512_mul_ps(r, y)), scale);
+		out1 = _mm512_mul_ps(arib_b67_inverse_oetf_avx512(_mm512_mul_ps(g, y)), scale);
+		out2 = _mm512_mul_ps(arib_b67_inverse_oetf_avx512(_mm512_mul_ps(b, y)), scale);
+	} else {
+		y = mm512_pow_ps<true>(y, _mm512_set1_ps((1.0f - gamma) / gamma));
+		out0 = arib_b67_oetf_avx512(_mm512_mul_ps(r, y));
+		out1 = arib_b67_oetf_avx512(_mm512_mul_ps(g, y));
+		out2 = arib_b67_oetf_avx512(_mm512_mul_ps(b, y));
+	}
+}
+
+template <bool Inverse>
+void arib_b67_filter_line_avx512(const float *coeffs, float scale, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	const __m512 kr = _mm512_set1_ps(coeffs[0]);
+	const __m512 kg = _mm512_set1_ps(coeffs[1]);
+	const __m512 kb = _mm512_set1_ps(coeffs[2]);
+	const __m512 scale_ps = _mm512_set1_ps(scale);
+	__m512 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+
+#define XITER arib_b67_filter_line_avx512_xiter<Inverse>
+#define XARGS src, out0, out1, out2, kr, kg, kb, scale_ps
+	if (left != vec_left) {
+		XITER(vec_left - 16, XARGS);
+		__mmask16 mask = mmask16_set_hi(vec_left - left);
+
+		_mm512_mask_store_ps(dst[0] + vec_left - 16, mask, out0);
+		_mm512_mask_store_ps(dst[1] + vec_left - 16, mask, out1);
+		_mm512_mask_store_ps(dst[2] + vec_left - 16, mask, out2);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		XITER(j, XARGS);
+
+		_mm512_store_ps(dst[0] + j, out0);
+		_mm512_store_ps(dst[1] + j, out1);
+		_mm512_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+		__mmask16 mask = mmask16_set_lo(right - vec_right);
+
+		_mm512_mask_store_ps(dst[0] + vec_right, mask, out0);
+		_mm512_mask_store_ps(dst[1] + vec_right, mask, out1);
+		_mm512_mask_store_ps(dst[2] + vec_right, mask, out2);
+	}
+#undef XITER
+#undef XARGS
+}
+
+inline FORCE_INLINE __m512 rec_709_oetf_avx512(__m512 x)
+{
+	const __m512 alpha = _mm512_set1_ps(REC709_ALPHA);
+	__m512 lo, hi;
+	__mmask16 mask;
+
+	lo = _mm512_mul_ps(x, _mm512_set1_ps(4.5f));
+	hi = mm512_pow_ps<true>(x, _mm512_set1_ps(0.45f));
+	hi = _mm512_sub_ps(_mm512_mul_ps(alpha, hi), _mm512_sub_ps(alpha, _mm512_set1_ps(1.0f)));
+
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(REC709_BETA), _CMP_LT_OQ);
+	return _mm512_mask_blend_ps(mask, hi, lo);
+}
+
+inline FORCE_INLINE __m512 rec_709_inverse_oetf_avx512(__m512 x)
+{
+	const __m512 alpha = _mm512_set1_ps(REC709_ALPHA);
+	__m512 lo, hi;
+	__mmask16 mask;
+
+	lo = _mm512_mul_ps(x, _mm512_set1_ps(1.0f / 4.5f));
+	hi = _mm512_div_ps(_mm512_add_ps(x, _mm512_sub_ps(alpha, _mm512_set1_ps(1.0f))), alpha);
+	hi = mm512_pow_ps<true>(hi, _mm512_set1_ps(1.0f / 0.45f));
+
+	mask = _mm512_cmp_ps_mask(x, _mm512_set1_ps(4.5f * REC709_BETA), _CMP_LT_OQ);
+	return _mm512_mask_blend_ps(mask, hi, lo);
+}
+
+inline FORCE_INLINE void cl_to_rgb_avx512_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m512 &out0, __m512 &out1, __m512 &out2, const float *coeffs)
+{
+	const __m512 kr = _mm512_set1_ps(coeffs[0]);
+	const __m512 kg = _mm512_set1_ps(coeffs[1]);
+	const __m512 kb = _mm512_set1_ps(coeffs[2]);
+	const __m512 nb = _mm512_set1_ps(coeffs[3]);
+	const __m512 pb = _mm512_set1_ps(coeffs[4]);
+	const __m512 nr = _mm512_set1_ps(coeffs[5]);
+	const __m512 pr = _mm512_set1_ps(coeffs[6]);
+	const __m512 scale = _mm512_set1_ps(coeffs[7]);
+	const __m512 two = _mm512_set1_ps(2.0f);
+	const __m512 zero = _mm512_setzero_ps();
+
+	__m512 y = _mm512_load_ps(src[0] + j);
+	__m512 u = _mm512_load_ps(src[1] + j);
+	__m512 v = _mm512_load_ps(src[2] + j);
+	__m512 r, g, b, k;
+	__mmask16 mask;
+
+	// Select the chroma scale by the sign of the difference.
+	mask = _mm512_cmp_ps_mask(u, zero, _CMP_LT_OQ);
+	k = _mm512_mask_blend_ps(mask, pb, nb);
+	b = _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(u, two), k), y);
+
+	mask = _mm512_cmp_ps_mask(v, zero, _CMP_LT_OQ);
+	k = _mm512_mask_blend_ps(mask, pr, nr);
+	r = _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(v, two), k), y);
+
+	b = rec_709_inverse_oetf_avx512(b);
+	r = rec_709_inverse_oetf_avx512(r);
+	y = rec_709_inverse_oetf_avx512(y);
+
+	g = _mm512_sub_ps(y, _mm512_mul_ps(kr, r));
+	g = _mm512_sub_ps(g, _mm512_mul_ps(kb, b));
+	g = _mm512_div_ps(g, kg);
+
+	out0 = _mm512_mul_ps(r, scale);
+	out1 = _mm512_mul_ps(g, scale);
+	out2 = _mm512_mul_ps(b, scale);
+}
+
+inline FORCE_INLINE void cl_to_yuv_avx512_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m512 &out0, __m512 &out1, __m512 &out2, const float *coeffs)
+{
+	const __m512 kr = _mm512_set1_ps(coeffs[0]);
+	const __m512 kg = _mm512_set1_ps(coeffs[1]);
+	const __m512 kb = _mm512_set1_ps(coeffs[2]);
+	const __m512 nb = _mm512_set1_ps(coeffs[3]);
+	const __m512 pb = _mm512_set1_ps(coeffs[4]);
+	const __m512 nr = _mm512_set1_ps(coeffs[5]);
+	const __m512 pr = _mm512_set1_ps(coeffs[6]);
+	const __m512 scale = _mm512_set1_ps(coeffs[7]);
+	const __m512 two = _mm512_set1_ps(2.0f);
+	const __m512 zero = _mm512_setzero_ps();
+
+	__m512 r = _mm512_mul_ps(_mm512_load_ps(src[0] + j), scale);
+	__m512 g = _mm512_mul_ps(_mm512_load_ps(src[1] + j), scale);
+	__m512 b = _mm512_mul_ps(_mm512_load_ps(src[2] + j), scale);
+	__m512 y, k;
+	__mmask16 mask;
+
+	y = _mm512_mul_ps(kr, r);
+	y = _mm512_fmadd_ps(kg, g, y);
+	y = _mm512_fmadd_ps(kb, b, y);
+
+	y = rec_709_oetf_avx512(y);
+	b = _mm512_sub_ps(rec_709_oetf_avx512(b), y);
+	r = _mm512_sub_ps(rec_709_oetf_avx512(r), y);
+
+	// Select the chroma scale by the sign of the difference.
+	mask = _mm512_cmp_ps_mask(b, zero, _CMP_LT_OQ);
+	k = _mm512_mask_blend_ps(mask, pb, nb);
+	b = _mm512_div_ps(b, _mm512_mul_ps(two, k));
+
+	mask = _mm512_cmp_ps_mask(r, zero, _CMP_LT_OQ);
+	k = _mm512_mask_blend_ps(mask, pr, nr);
+	r = _mm512_div_ps(r, _mm512_mul_ps(two, k));
+
+	out0 = y;
+	out1 = b;
+	out2 = r;
+}
+
+template <bool ToYUV>
+inline FORCE_INLINE void cl_filter_line_avx512_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m512 &out0, __m512 &out1, __m512 &out2, const float *coeffs)
+{
+	if (ToYUV)
+		cl_to_yuv_avx512_xiter(j, src, out0, out1, out2, coeffs);
+	else
+		cl_to_rgb_avx512_xiter(j, src, out0, out1, out2, coeffs);
+}
+
+template <bool ToYUV>
+void cl_filter_line_avx512(const float *coeffs, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	__m512 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+
+#define XITER cl_filter_line_avx512_xiter<ToYUV>
+#define XARGS src, out0, out1, out2, coeffs
+	if (left != vec_left) {
+		XITER(vec_left - 16, XARGS);
+		__mmask16 mask = mmask16_set_hi(vec_left - left);
+
+		_mm512_mask_store_ps(dst[0] + vec_left - 16, mask, out0);
+		_mm512_mask_store_ps(dst[1] + vec_left - 16, mask, out1);
+		_mm512_mask_store_ps(dst[2] + vec_left - 16, mask, out2);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		XITER(j, XARGS);
+
+		_mm512_store_ps(dst[0] + j, out0);
+		_mm512_store_ps(dst[1] + j, out1);
+		_mm512_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+		__mmask16 mask = mmask16_set_lo(right - vec_right);
+
+		_mm512_mask_store_ps(dst[0] + vec_right, mask, out0);
+		_mm512_mask_store_ps(dst[1] + vec_right, mask, out1);
+		_mm512_mask_store_ps(dst[2] + vec_right, mask, out2);
+	}
+#undef XITER
+#undef XARGS
+}
+
+// Transfer functions evaluated with polynomial approximations of the
+// logarithm and exponential instead of a table lookup. Each functor is
+// constructed from the parameters stored in the operation.
+template <bool Inverse>
+struct SegmentedPowerAVX512 {
+	// Linear segment x * slope below beta, else alpha * x^power - (alpha - 1).
+	__m512 alpha;
+	__m512 beta;
+	__m512 slope;
+	__m512 power;
+
+	explicit SegmentedPowerAVX512(const float *params) :
+		alpha{ _mm512_set1_ps(params[0]) },
+		beta{ _mm512_set1_ps(Inverse ? params[1] * params[2] : params[1]) },
+		slope{ _mm512_set1_ps(Inverse ? 1.0f / params[2] : params[2]) },
+		power{ _mm512_set1_ps(Inverse ? 1.0f / params[3] : params[3]) }
+	{}
+
+	inline FORCE_INLINE __m512 operator()(__m512 x) const
+	{
+		const __m512 one = _mm512_set1_ps(1.0f);
+		__m512 lo, hi;
+		__mmask16 mask;
+
+		lo = _mm512_mul_ps(x, slope);
+
+		if (Inverse) {
+			hi = _mm512_div_ps(_mm512_add_ps(x, _mm512_sub_ps(alpha, one)), alpha);
+			hi = mm512_pow_ps<false>(_mm512_max_ps(hi, _mm512_set1_ps(FLT_MIN)), power);
+		} else {
+			hi = mm512_pow_ps<false>(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)), power);
+			hi = _mm512_fmsub_ps(alpha, hi, _mm512_sub_ps(alpha, one));
+		}
+
+		mask = _mm512_cmp_ps_mask(x, beta, _CMP_LT_OQ);
+		return _mm512_mask_blend_ps(mask, hi, lo);
+	}
+};
+
+struct PowerAVX512 {
+	__m512 power;
+
+	explicit PowerAVX512(const float *params) : power{ _mm512_set1_ps(params[0]) } {}
+
+	inline FORCE_INLINE __m512 operator()(__m512 x) const
+	{
+		__m512 y = mm512_pow_ps<false>(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)), power);
+		__mmask16 mask = _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GT_OQ);
+		return _mm512_maskz_mov_ps(mask, y);
+	}
+};
+
+template <bool Inverse>
+struct LogarithmicAVX512 {
+	// Logarithmic segment above threshold, spanning the given number of decades.
+	__m512 threshold;
+	__m512 decades;
+
+	explicit LogarithmicAVX512(const float *params) :
+		threshold{ _mm512_set1_ps(params[0]) },
+		decades{ _mm512_set1_ps(params[1]) }
+	{}
+
+	inline FORCE_INLINE __m512 operator()(__m512 x) const
+	{
+		const __m512 one = _mm512_set1_ps(1.0f);
+		const __m512 log2_10 = _mm512_set1_ps(3.321928095f);
+		__m512 y;
+		__mmask16 mask;
+
+		if (Inverse) {
+			y = mm512_exp2_ps<false>(_mm512_mul_ps(_mm512_mul_ps(_mm512_sub_ps(x, one), decades), log2_10));
+			mask = _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_LE_OQ);
+			return _mm512_mask_blend_ps(mask, y, threshold);
+		} else {
+			y = _mm512_div_ps(mm512_log2_ps<false>(_mm512_max_ps(x, threshold)), _mm512_mul_ps(decades, log2_10));
+			y = _mm512_add_ps(y, one);
+			mask = _mm512_cmp_ps_mask(x, threshold, _CMP_GT_OQ);
+			return _mm512_maskz_mov_ps(mask, y);
+		}
+	}
+};
+
+struct St2084EotfAVX512 {
+	explicit St2084EotfAVX512(const float *) {}
+
+	inline FORCE_INLINE __m512 operator()(__m512 x) const
+	{
+		__m512 xpow, num, den;
+		__mmask16 mask;
+
+		xpow = mm512_pow_ps<false>(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)), _mm512_set1_ps(1.0f / ST2084_M2));
+		num = _mm512_max_ps(_mm512_sub_ps(xpow, _mm512_set1_ps(ST2084_C1)), _mm512_setzero_ps());
+		den = _mm512_max_ps(_mm512_fnmadd_ps(_mm512_set1_ps(ST2084_C3), xpow, _mm512_set1_ps(ST2084_C2)), _mm512_set1_ps(FLT_MIN));
+		x = _mm512_div_ps(num, den);
+
+		mask = _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GT_OQ);
+		x = mm512_pow_ps<false>(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)), _mm512_set1_ps(1.0f / ST2084_M1));
+		return _mm512_maskz_mov_ps(mask, x);
+	}
+};
+
+struct St2084InverseEotfAVX512 {
+	explicit St2084InverseEotfAVX512(const float *) {}
+
+	inline FORCE_INLINE __m512 operator()(__m512 x) const
+	{
+		const __m512 one = _mm512_set1_ps(1.0f);
+		__m512 xpow, num, den;
+		__mmask16 mask;
+
+		mask = _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GT_OQ);
+		xpow = mm512_pow_ps<false>(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)), _mm512_set1_ps(ST2084_M1));
+		num = _mm512_fmadd_ps(_mm512_set1_ps(ST2084_C2 - ST2084_C3), xpow, _mm512_set1_ps(ST2084_C1 - 1.0f));
+		den = _mm512_fmadd_ps(_mm512_set1_ps(ST2084_C3), xpow, one);
+		x = mm512_pow_ps<false>(_mm512_add_ps(_mm512_div_ps(num, den), one), _mm512_set1_ps(ST2084_M2));
+		return _mm512_maskz_mov_ps(mask, x);
+	}
+};
+
+template <bool Inverse>
+struct AribB67AVX512 {
+	explicit AribB67AVX512(const float *) {}
+
+	inline FORCE_INLINE __m512 operator()(__m512 x) const
+	{
+		return Inverse ? arib_b67_inverse_oetf_avx512(x) : arib_b67_oetf_avx512(x);
+	}
+};
+
+template <class F>
+void gamma_filter_line_avx512(const F &func, float prescale, float postscale, const float *src, float *dst, unsigned left, unsigned right)
+{
+	const __m512 prescale_ps = _mm512_set1_ps(prescale);
+	const __m512 postscale_ps = _mm512_set1_ps(postscale);
+
+	unsigned vec_left = ceil_n(left, 16);
+	unsigned vec_right = floor_n(right, 16);
+
+	if (left != vec_left) {
+		__m512 x = _mm512_load_ps(src + vec_left - 16);
+		x = _mm512_mul_ps(func(_mm512_mul_ps(x, prescale_ps)), postscale_ps);
+		_mm512_mask_store_ps(dst + vec_left - 16, mmask16_set_hi(vec_left - left), x);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 16) {
+		__m512 x = _mm512_load_ps(src + j);
+		x = _mm512_mul_ps(func(_mm512_mul_ps(x, prescale_ps)), postscale_ps);
+		_mm512_store_ps(dst + j, x);
+	}
+
+	if (right != vec_right) {
+		__m512 x = _mm512_load_ps(src + vec_right);
+		x = _mm512_mul_ps(func(_mm512_mul_ps(x, prescale_ps)), postscale_ps);
+		_mm512_mask_store_ps(dst + vec_right, mmask16_set_lo(right - vec_right), x);
+	}
+}
+
 
 class MatrixOperationAVX512 final : public MatrixOperationImpl {
 public:
@@ -103,6 +633,140 @@ public:
 	}
 };
 
+class Lut3DOperationAVX512 final : public Operation {
+	Lut3D m_lut;
+public:
+	explicit Lut3DOperationAVX512(Lut3D &&lut) : m_lut(std::move(lut)) {}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		lut3d_filter_line_avx512(m_lut, src, dst, left, right);
+	}
+};
+
+template <bool Inverse>
+class AribB67OperationAVX512 final : public Operation {
+	float m_coeffs[3];
+	float m_scale;
+public:
+	AribB67OperationAVX512(const Matrix3x3 &m, float scale) :
+		m_coeffs{ static_cast<float>(m[0][0]), static_cast<float>(m[0][1]), static_cast<float>(m[0][2]) },
+		m_scale{ scale }
+	{}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		arib_b67_filter_line_avx512<Inverse>(m_coeffs, m_scale, src, dst, left, right);
+	}
+};
+
+// Coefficients are Kr, Kg, Kb, Nb, Pb, Nr, Pr, and the linear scale factor.
+template <bool ToYUV>
+class CLOperationAVX512 final : public Operation {
+	float m_coeffs[8];
+public:
+	CLOperationAVX512(const Matrix3x3 &m, float scale) :
+		m_coeffs{}
+	{
+		float kr = static_cast<float>(m[0][0]);
+		float kg = static_cast<float>(m[0][1]);
+		float kb = static_cast<float>(m[0][2]);
+
+		m_coeffs[0] = kr;
+		m_coeffs[1] = kg;
+		m_coeffs[2] = kb;
+		m_coeffs[3] = rec_709_oetf(1.0f - kb);
+		m_coeffs[4] = 1.0f - rec_709_oetf(kb);
+		m_coeffs[5] = rec_709_oetf(1.0f - kr);
+		m_coeffs[6] = 1.0f - rec_709_oetf(kr);
+		m_coeffs[7] = scale;
+	}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		cl_filter_line_avx512<ToYUV>(m_coeffs, src, dst, left, right);
+	}
+};
+
+template <class F>
+class GammaOperationAVX512 final : public Operation {
+	float m_params[4];
+	float m_prescale;
+	float m_postscale;
+public:
+	GammaOperationAVX512(std::initializer_list<float> params, float prescale, float postscale) :
+		m_params{},
+		m_prescale{ prescale },
+		m_postscale{ postscale }
+	{
+		std::copy(params.begin(), params.end(), m_params);
+	}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		F func{ m_params };
+
+		gamma_filter_line_avx512(func, m_prescale, m_postscale, src[0], dst[0], left, right);
+		gamma_filter_line_avx512(func, m_prescale, m_postscale, src[1], dst[1], left, right);
+		gamma_filter_line_avx512(func, m_prescale, m_postscale, src[2], dst[2], left, right);
+	}
+};
+
+template <class F>
+std::unique_ptr<Operation> make_gamma_operation_avx512(std::initializer_list<float> params, float prescale, float postscale)
+{
+	return ztd::make_unique<GammaOperationAVX512<F>>(params, prescale, postscale);
+}
+
+std::unique_ptr<Operation> create_vector_gamma_operation_avx512(gamma_func func, float prescale, float postscale)
+{
+	if (func == rec_709_oetf)
+		return make_gamma_operation_avx512<SegmentedPowerAVX512<false>>({ REC709_ALPHA, REC709_BETA, 4.5f, 0.45f }, prescale, postscale);
+	if (func == rec_709_inverse_oetf)
+		return make_gamma_operation_avx512<SegmentedPowerAVX512<true>>({ REC709_ALPHA, REC709_BETA, 4.5f, 0.45f }, prescale, postscale);
+	if (func == smpte_240m_inverse_oetf)
+		return make_gamma_operation_avx512<SegmentedPowerAVX512<false>>({ SMPTE_240M_ALPHA, SMPTE_240M_BETA, 4.0f, 0.45f }, prescale, postscale);
+	if (func == smpte_240m_oetf)
+		return make_gamma_operation_avx512<SegmentedPowerAVX512<true>>({ SMPTE_240M_ALPHA, SMPTE_240M_BETA, 4.0f, 0.45f }, prescale, postscale);
+	if (func == srgb_inverse_eotf)
+		return make_gamma_operation_avx512<SegmentedPowerAVX512<false>>({ SRGB_ALPHA, SRGB_BETA, 12.92f, 1.0f / 2.4f }, prescale, postscale);
+	if (func == srgb_eotf)
+		return make_gamma_operation_avx512<SegmentedPowerAVX512<true>>({ SRGB_ALPHA, SRGB_BETA, 12.92f, 1.0f / 2.4f }, prescale, postscale);
+
+	if (func == rec_1886_eotf)
+		return make_gamma_operation_avx512<PowerAVX512>({ 2.4f }, prescale, postscale);
+	if (func == rec_1886_inverse_eotf)
+		return make_gamma_operation_avx512<PowerAVX512>({ 1.0f / 2.4f }, prescale, postscale);
+	if (func == rec_470m_oetf)
+		return make_gamma_operation_avx512<PowerAVX512>({ 2.2f }, prescale, postscale);
+	if (func == rec_470m_inverse_oetf)
+		return make_gamma_operation_avx512<PowerAVX512>({ 1.0f / 2.2f }, prescale, postscale);
+	if (func == rec_470bg_oetf)
+		return make_gamma_operation_avx512<PowerAVX512>({ 2.8f }, prescale, postscale);
+	if (func == rec_470bg_inverse_oetf)
+		return make_gamma_operation_avx512<PowerAVX512>({ 1.0f / 2.8f }, prescale, postscale);
+
+	if (func == log100_oetf)
+		return make_gamma_operation_avx512<LogarithmicAVX512<false>>({ 0.01f, 2.0f }, prescale, postscale);
+	if (func == log100_inverse_oetf)
+		return make_gamma_operation_avx512<LogarithmicAVX512<true>>({ 0.01f, 2.0f }, prescale, postscale);
+	if (func == log316_oetf)
+		return make_gamma_operation_avx512<LogarithmicAVX512<false>>({ 0.00316227766f, 2.5f }, prescale, postscale);
+	if (func == log316_inverse_oetf)
+		return make_gamma_operation_avx512<LogarithmicAVX512<true>>({ 0.00316227766f, 2.5f }, prescale, postscale);
+
+	if (func == st_2084_eotf)
+		return make_gamma_operation_avx512<St2084EotfAVX512>({}, prescale, postscale);
+	if (func == st_2084_inverse_eotf)
+		return make_gamma_operation_avx512<St2084InverseEotfAVX512>({}, prescale, postscale);
+	if (func == arib_b67_oetf)
+		return make_gamma_operation_avx512<AribB67AVX512<false>>({}, prescale, postscale);
+	if (func == arib_b67_inverse_oetf)
+		return make_gamma_operation_avx512<AribB67AVX512<true>>({}, prescale, postscale);
+
+	return nullptr;
+}
+
 } // namespace
 
 
@@ -111,6 +775,47 @@ std::unique_ptr<Operation> create_matrix_operation_avx512(const Matrix3x3 &m)
 	return ztd::make_unique<MatrixOperationAVX512>(m);
 }
 
+std::unique_ptr<Operation> create_gamma_operation_avx512(const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return create_vector_gamma_operation_avx512(transfer.to_gamma, transfer.to_gamma_scale, 1.0f);
+}
+
+std::unique_ptr<Operation> create_inverse_gamma_operation_avx512(const TransferFunction &transfer, const OperationParams &params)
+{
+	if (!params.approximate_gamma)
+		return nullptr;
+
+	return create_vector_gamma_operation_avx512(transfer.to_linear, 1.0f, transfer.to_linear_scale);
+}
+
+std::unique_ptr<Operation> create_lut3d_operation_avx512(Lut3D &&lut)
+{
+	return ztd::make_unique<Lut3DOperationAVX512>(std::move(lut));
+}
+
+std::unique_ptr<Operation> create_arib_b67_operation_avx512(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<AribB67OperationAVX512<false>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx512(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<AribB67OperationAVX512<true>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx512(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<CLOperationAVX512<false>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx512(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<CLOperationAVX512<true>>(m, scale);
+}
+
 } // namespace colorspace
 } // namespace zimg
 
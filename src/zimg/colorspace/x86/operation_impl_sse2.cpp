@@ -1,6 +1,7 @@
 #ifdef ZIMG_X86
 
 #include <algorithm>
+#include <cfloat>
 #include <cstddef>
 #include <cstdint>
 #include <vector>
@@ -13,6 +14,9 @@
 #include "colorspace/operation_impl.h"
 #include "operation_impl_x86.h"
 
+#include "common/x86/sse_util.h"
+#include "common/x86/sse2_util.h"
+
 namespace zimg {
 namespace colorspace {
 
@@ -62,6 +66,265 @@ void lut_filter_line(const float *RESTRICT lut, unsigned lut_depth, float presca
 }
 
 
+inline FORCE_INLINE __m128 arib_b67_oetf_sse2(__m128 x)
+{
+	__m128 lo, hi, mask;
+
+	// Prevent negative pixels from yielding NAN.
+	x = _mm_max_ps(x, _mm_setzero_ps());
+
+	lo = _mm_sqrt_ps(_mm_mul_ps(x, _mm_set_ps1(3.0f)));
+	hi = mm_log_ps(_mm_sub_ps(_mm_mul_ps(x, _mm_set_ps1(12.0f)), _mm_set_ps1(ARIB_B67_B)));
+	hi = _mm_add_ps(_mm_mul_ps(hi, _mm_set_ps1(ARIB_B67_A)), _mm_set_ps1(ARIB_B67_C));
+
+	mask = _mm_cmple_ps(x, _mm_set_ps1(1.0f / 12.0f));
+	return _mm_or_ps(_mm_and_ps(mask, lo), _mm_andnot_ps(mask, hi));
+}
+
+inline FORCE_INLINE __m128 arib_b67_inverse_oetf_sse2(__m128 x)
+{
+	__m128 lo, hi, mask;
+
+	// Prevent negative pixels expanding into positive values.
+	x = _mm_max_ps(x, _mm_setzero_ps());
+
+	lo = _mm_mul_ps(_mm_mul_ps(x, x), _mm_set_ps1(1.0f / 3.0f));
+	hi = mm_exp_ps(_mm_mul_ps(_mm_sub_ps(x, _mm_set_ps1(ARIB_B67_C)), _mm_set_ps1(1.0f / ARIB_B67_A)));
+	hi = _mm_mul_ps(_mm_add_ps(hi, _mm_set_ps1(ARIB_B67_B)), _mm_set_ps1(1.0f / 12.0f));
+
+	mask = _mm_cmple_ps(x, _mm_set_ps1(0.5f));
+	return _mm_or_ps(_mm_and_ps(mask, lo), _mm_andnot_ps(mask, hi));
+}
+
+template <bool Inverse>
+inline FORCE_INLINE void arib_b67_filter_line_sse2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m128 &out0, __m128 &out1, __m128 &out2,
+                                                         const __m128 &kr, const __m128 &kg, const __m128 &kb, const __m128 &scale)
+{
+	const float gamma = 1.2f;
+
+	__m128 r = _mm_load_ps(src[0] + j);
+	__m128 g = _mm_load_ps(src[1] + j);
+	__m128 b = _mm_load_ps(src[2] + j);
+	__m128 y;
+
+	if (!Inverse) {
+		r = _mm_mul_ps(r, scale);
+		g = _mm_mul_ps(g, scale);
+		b = _mm_mul_ps(b, scale);
+	}
+
+	y = _mm_mul_ps(kr, r);
+	y = _mm_add_ps(y, _mm_mul_ps(kg, g));
+	y = _mm_add_ps(y, _mm_mul_ps(kb, b));
+	y = _mm_max_ps(y, _mm_set_ps1(FLT_MIN));
+
+	if (Inverse) {
+		y = mm_pow_ps(y, _mm_set_ps1(gamma - 1.0f));
+		out0 = _mm_mul_ps(arib_b67_inverse_oetf_sse2(_mm_mul_ps(r, y)), scale);
+		out1 = _mm_mul_ps(arib_b67_inverse_oetf_sse2(_mm_mul_ps(g, y)), scale);
+		out2 = _mm_mul_ps(arib_b67_inverse_oetf_sse2(_mm_mul_ps(b, y)), scale);
+	} else {
+		y = mm_pow_ps(y, _mm_set_ps1((1.0f - gamma) / gamma));
+		out0 = arib_b67_oetf_sse2(_mm_mul_ps(r, y));
+		out1 = arib_b67_oetf_sse2(_mm_mul_ps(g, y));
+		out2 = arib_b67_oetf_sse2(_mm_mul_ps(b, y));
+	}
+}
+
+template <bool Inverse>
+void arib_b67_filter_line_sse2(const float *coeffs, float scale, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	const __m128 kr = _mm_set_ps1(coeffs[0]);
+	const __m128 kg = _mm_set_ps1(coeffs[1]);
+	const __m128 kb = _mm_set_ps1(coeffs[2]);
+	const __m128 scale_ps = _mm_set_ps1(scale);
+	__m128 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 4);
+	unsigned vec_right = floor_n(right, 4);
+
+#define XITER arib_b67_filter_line_sse2_xiter<Inverse>
+#define XARGS src, out0, out1, out2, kr, kg, kb, scale_ps
+	if (left != vec_left) {
+		XITER(vec_left - 4, XARGS);
+
+		mm_store_idxhi_ps(dst[0] + vec_left - 4, out0, left % 4);
+		mm_store_idxhi_ps(dst[1] + vec_left - 4, out1, left % 4);
+		mm_store_idxhi_ps(dst[2] + vec_left - 4, out2, left % 4);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		XITER(j, XARGS);
+
+		_mm_store_ps(dst[0] + j, out0);
+		_mm_store_ps(dst[1] + j, out1);
+		_mm_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+
+		mm_store_idxlo_ps(dst[0] + vec_right, out0, right % 4);
+		mm_store_idxlo_ps(dst[1] + vec_right, out1, right % 4);
+		mm_store_idxlo_ps(dst[2] + vec_right, out2, right % 4);
+	}
+#undef XITER
+#undef XARGS
+}
+
+inline FORCE_INLINE __m128 rec_709_oetf_sse2(__m128 x)
+{
+	const __m128 alpha = _mm_set_ps1(REC709_ALPHA);
+	__m128 lo, hi, mask;
+
+	lo = _mm_mul_ps(x, _mm_set_ps1(4.5f));
+	hi = mm_pow_ps(x, _mm_set_ps1(0.45f));
+	hi = _mm_sub_ps(_mm_mul_ps(alpha, hi), _mm_sub_ps(alpha, _mm_set_ps1(1.0f)));
+
+	mask = _mm_cmplt_ps(x, _mm_set_ps1(REC709_BETA));
+	return _mm_or_ps(_mm_and_ps(mask, lo), _mm_andnot_ps(mask, hi));
+}
+
+inline FORCE_INLINE __m128 rec_709_inverse_oetf_sse2(__m128 x)
+{
+	const __m128 alpha = _mm_set_ps1(REC709_ALPHA);
+	__m128 lo, hi, mask;
+
+	lo = _mm_mul_ps(x, _mm_set_ps1(1.0f / 4.5f));
+	hi = _mm_div_ps(_mm_add_ps(x, _mm_sub_ps(alpha, _mm_set_ps1(1.0f))), alpha);
+	hi = mm_pow_ps(hi, _mm_set_ps1(1.0f / 0.45f));
+
+	mask = _mm_cmplt_ps(x, _mm_set_ps1(4.5f * REC709_BETA));
+	return _mm_or_ps(_mm_and_ps(mask, lo), _mm_andnot_ps(mask, hi));
+}
+
+inline FORCE_INLINE void cl_to_rgb_sse2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m128 &out0, __m128 &out1, __m128 &out2, const float *coeffs)
+{
+	const __m128 kr = _mm_set_ps1(coeffs[0]);
+	const __m128 kg = _mm_set_ps1(coeffs[1]);
+	const __m128 kb = _mm_set_ps1(coeffs[2]);
+	const __m128 nb = _mm_set_ps1(coeffs[3]);
+	const __m128 pb = _mm_set_ps1(coeffs[4]);
+	const __m128 nr = _mm_set_ps1(coeffs[5]);
+	const __m128 pr = _mm_set_ps1(coeffs[6]);
+	const __m128 scale = _mm_set_ps1(coeffs[7]);
+	const __m128 two = _mm_set_ps1(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	__m128 y = _mm_load_ps(src[0] + j);
+	__m128 u = _mm_load_ps(src[1] + j);
+	__m128 v = _mm_load_ps(src[2] + j);
+	__m128 r, g, b, k, mask;
+
+	// Select the chroma scale by the sign of the difference.
+	mask = _mm_cmplt_ps(u, zero);
+	k = _mm_or_ps(_mm_and_ps(mask, nb), _mm_andnot_ps(mask, pb));
+	b = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(u, two), k), y);
+
+	mask = _mm_cmplt_ps(v, zero);
+	k = _mm_or_ps(_mm_and_ps(mask, nr), _mm_andnot_ps(mask, pr));
+	r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(v, two), k), y);
+
+	b = rec_709_inverse_oetf_sse2(b);
+	r = rec_709_inverse_oetf_sse2(r);
+	y = rec_709_inverse_oetf_sse2(y);
+
+	g = _mm_sub_ps(y, _mm_mul_ps(kr, r));
+	g = _mm_sub_ps(g, _mm_mul_ps(kb, b));
+	g = _mm_div_ps(g, kg);
+
+	out0 = _mm_mul_ps(r, scale);
+	out1 = _mm_mul_ps(g, scale);
+	out2 = _mm_mul_ps(b, scale);
+}
+
+inline FORCE_INLINE void cl_to_yuv_sse2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m128 &out0, __m128 &out1, __m128 &out2, const float *coeffs)
+{
+	const __m128 kr = _mm_set_ps1(coeffs[0]);
+	const __m128 kg = _mm_set_ps1(coeffs[1]);
+	const __m128 kb = _mm_set_ps1(coeffs[2]);
+	const __m128 nb = _mm_set_ps1(coeffs[3]);
+	const __m128 pb = _mm_set_ps1(coeffs[4]);
+	const __m128 nr = _mm_set_ps1(coeffs[5]);
+	const __m128 pr = _mm_set_ps1(coeffs[6]);
+	const __m128 scale = _mm_set_ps1(coeffs[7]);
+	const __m128 two = _mm_set_ps1(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	__m128 r = _mm_mul_ps(_mm_load_ps(src[0] + j), scale);
+	__m128 g = _mm_mul_ps(_mm_load_ps(src[1] + j), scale);
+	__m128 b = _mm_mul_ps(_mm_load_ps(src[2] + j), scale);
+	__m128 y, k, mask;
+
+	y = _mm_mul_ps(kr, r);
+	y = _mm_add_ps(y, _mm_mul_ps(kg, g));
+	y = _mm_add_ps(y, _mm_mul_ps(kb, b));
+
+	y = rec_709_oetf_sse2(y);
+	b = _mm_sub_ps(rec_709_oetf_sse2(b), y);
+	r = _mm_sub_ps(rec_709_oetf_sse2(r), y);
+
+	// Select the chroma scale by the sign of the difference.
+	mask = _mm_cmplt_ps(b, zero);
+	k = _mm_or_ps(_mm_and_ps(mask, nb), _mm_andnot_ps(mask, pb));
+	b = _mm_div_ps(b, _mm_mul_ps(two, k));
+
+	mask = _mm_cmplt_ps(r, zero);
+	k = _mm_or_ps(_mm_and_ps(mask, nr), _mm_andnot_ps(mask, pr));
+	r = _mm_div_ps(r, _mm_mul_ps(two, k));
+
+	out0 = y;
+	out1 = b;
+	out2 = r;
+}
+
+template <bool ToYUV>
+inline FORCE_INLINE void cl_filter_line_sse2_xiter(unsigned j, const float * RESTRICT const * RESTRICT src, __m128 &out0, __m128 &out1, __m128 &out2, const float *coeffs)
+{
+	if (ToYUV)
+		cl_to_yuv_sse2_xiter(j, src, out0, out1, out2, coeffs);
+	else
+		cl_to_rgb_sse2_xiter(j, src, out0, out1, out2, coeffs);
+}
+
+template <bool ToYUV>
+void cl_filter_line_sse2(const float *coeffs, const float * const * RESTRICT src, float * const * RESTRICT dst, unsigned left, unsigned right)
+{
+	__m128 out0, out1, out2;
+
+	unsigned vec_left = ceil_n(left, 4);
+	unsigned vec_right = floor_n(right, 4);
+
+#define XITER cl_filter_line_sse2_xiter<ToYUV>
+#define XARGS src, out0, out1, out2, coeffs
+	if (left != vec_left) {
+		XITER(vec_left - 4, XARGS);
+
+		mm_store_idxhi_ps(dst[0] + vec_left - 4, out0, left % 4);
+		mm_store_idxhi_ps(dst[1] + vec_left - 4, out1, left % 4);
+		mm_store_idxhi_ps(dst[2] + vec_left - 4, out2, left % 4);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		XITER(j, XARGS);
+
+		_mm_store_ps(dst[0] + j, out0);
+		_mm_store_ps(dst[1] + j, out1);
+		_mm_store_ps(dst[2] + j, out2);
+	}
+
+	if (right != vec_right) {
+		XITER(vec_right, XARGS);
+
+		mm_store_idxlo_ps(dst[0] + vec_right, out0, right % 4);
+		mm_store_idxlo_ps(dst[1] + vec_right, out1, right % 4);
+		mm_store_idxlo_ps(dst[2] + vec_right, out2, right % 4);
+	}
+#undef XITER
+#undef XARGS
+}
+
+
 class LutOperationSSE2 final : public Operation {
 	std::vector<float> m_lut;
 	unsigned m_lut_depth;
@@ -89,6 +352,50 @@ public:
 	}
 };
 
+template <bool Inverse>
+class AribB67OperationSSE2 final : public Operation {
+	float m_coeffs[3];
+	float m_scale;
+public:
+	AribB67OperationSSE2(const Matrix3x3 &m, float scale) :
+		m_coeffs{ static_cast<float>(m[0][0]), static_cast<float>(m[0][1]), static_cast<float>(m[0][2]) },
+		m_scale{ scale }
+	{}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		arib_b67_filter_line_sse2<Inverse>(m_coeffs, m_scale, src, dst, left, right);
+	}
+};
+
+// Coefficients are Kr, Kg, Kb, Nb, Pb, Nr, Pr, and the linear scale factor.
+template <bool ToYUV>
+class CLOperationSSE2 final : public Operation {
+	float m_coeffs[8];
+public:
+	CLOperationSSE2(const Matrix3x3 &m, float scale) :
+		m_coeffs{}
+	{
+		float kr = static_cast<float>(m[0][0]);
+		float kg = static_cast<float>(m[0][1]);
+		float kb = static_cast<float>(m[0][2]);
+
+		m_coeffs[0] = kr;
+		m_coeffs[1] = kg;
+		m_coeffs[2] = kb;
+		m_coeffs[3] = rec_709_oetf(1.0f - kb);
+		m_coeffs[4] = 1.0f - rec_709_oetf(kb);
+		m_coeffs[5] = rec_709_oetf(1.0f - kr);
+		m_coeffs[6] = 1.0f - rec_709_oetf(kr);
+		m_coeffs[7] = scale;
+	}
+
+	void process(const float * const *src, float * const *dst, unsigned left, unsigned right) const override
+	{
+		cl_filter_line_sse2<ToYUV>(m_coeffs, src, dst, left, right);
+	}
+};
+
 } // namespace
 
 
@@ -108,6 +415,26 @@ std::unique_ptr<Operation> create_inverse_gamma_operation_sse2(const TransferFun
 	return ztd::make_unique<LutOperationSSE2>(transfer.to_linear, LUT_DEPTH, 1.0f, transfer.to_linear_scale);
 }
 
+std::unique_ptr<Operation> create_arib_b67_operation_sse2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<AribB67OperationSSE2<false>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_sse2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<AribB67OperationSSE2<true>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_sse2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<CLOperationSSE2<false>>(m, scale);
+}
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_sse2(const Matrix3x3 &m, float scale)
+{
+	return ztd::make_unique<CLOperationSSE2<true>>(m, scale);
+}
+
 } // namespace colorspace
 } // namespace zimg
 
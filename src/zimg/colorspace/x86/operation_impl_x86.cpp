@@ -1,5 +1,6 @@
 #ifdef ZIMG_X86
 
+#include <utility>
 #include "common/cpuinfo.h"
 #include "common/x86/cpuinfo_x86.h"
 #include "colorspace/operation.h"
@@ -43,13 +44,21 @@ std::unique_ptr<Operation> create_gamma_operation_x86(const TransferFunction &tr
 	std::unique_ptr<Operation> ret;
 
 	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_gamma_operation_avx512(transfer, params);
+#endif
 		if (!ret && caps.avx2 && caps.f16c)
-			ret = create_gamma_operation_avx2(transfer, params);
+			ret = create_gamma_operation_avx2(transfer, params, !caps.fma || cpu_has_fast_gather_x86(cpu));
 		if (!ret && caps.sse2)
 			ret = create_gamma_operation_sse2(transfer, params);
 	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_gamma_operation_avx512(transfer, params);
+#endif
 		if (!ret && cpu >= CPUClass::X86_AVX2)
-			ret = create_gamma_operation_avx2(transfer, params);
+			ret = create_gamma_operation_avx2(transfer, params, cpu_has_fast_gather_x86(cpu));
 		if (!ret && cpu >= CPUClass::X86_SSE2)
 			ret = create_gamma_operation_sse2(transfer, params);
 	}
@@ -63,13 +72,21 @@ std::unique_ptr<Operation> create_inverse_gamma_operation_x86(const TransferFunc
 	std::unique_ptr<Operation> ret;
 
 	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_inverse_gamma_operation_avx512(transfer, params);
+#endif
 		if (!ret && caps.avx2 && caps.f16c)
-			ret = create_inverse_gamma_operation_avx2(transfer, params);
+			ret = create_inverse_gamma_operation_avx2(transfer, params, !caps.fma || cpu_has_fast_gather_x86(cpu));
 		if (!ret && caps.sse2)
 			ret = create_inverse_gamma_operation_sse2(transfer, params);
 	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_inverse_gamma_operation_avx512(transfer, params);
+#endif
 		if (!ret && cpu >= CPUClass::X86_AVX2)
-			ret = create_inverse_gamma_operation_avx2(transfer, params);
+			ret = create_inverse_gamma_operation_avx2(transfer, params, cpu_has_fast_gather_x86(cpu));
 		if (!ret && cpu >= CPUClass::X86_SSE2)
 			ret = create_inverse_gamma_operation_sse2(transfer, params);
 	}
@@ -77,6 +94,142 @@ std::unique_ptr<Operation> create_inverse_gamma_operation_x86(const TransferFunc
 	return ret;
 }
 
+std::unique_ptr<Operation> create_arib_b67_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_arib_b67_operation_avx512(m, scale);
+#endif
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_arib_b67_operation_avx2(m, scale);
+		if (!ret && caps.sse2)
+			ret = create_arib_b67_operation_sse2(m, scale);
+	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_arib_b67_operation_avx512(m, scale);
+#endif
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_arib_b67_operation_avx2(m, scale);
+		if (!ret && cpu >= CPUClass::X86_SSE2)
+			ret = create_arib_b67_operation_sse2(m, scale);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_inverse_arib_b67_operation_avx512(m, scale);
+#endif
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_inverse_arib_b67_operation_avx2(m, scale);
+		if (!ret && caps.sse2)
+			ret = create_inverse_arib_b67_operation_sse2(m, scale);
+	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_inverse_arib_b67_operation_avx512(m, scale);
+#endif
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_inverse_arib_b67_operation_avx2(m, scale);
+		if (!ret && cpu >= CPUClass::X86_SSE2)
+			ret = create_inverse_arib_b67_operation_sse2(m, scale);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_cl_yuv_to_rgb_operation_avx512(m, scale);
+#endif
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_cl_yuv_to_rgb_operation_avx2(m, scale);
+		if (!ret && caps.sse2)
+			ret = create_cl_yuv_to_rgb_operation_sse2(m, scale);
+	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_cl_yuv_to_rgb_operation_avx512(m, scale);
+#endif
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_cl_yuv_to_rgb_operation_avx2(m, scale);
+		if (!ret && cpu >= CPUClass::X86_SSE2)
+			ret = create_cl_yuv_to_rgb_operation_sse2(m, scale);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f)
+			ret = create_cl_rgb_to_yuv_operation_avx512(m, scale);
+#endif
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_cl_rgb_to_yuv_operation_avx2(m, scale);
+		if (!ret && caps.sse2)
+			ret = create_cl_rgb_to_yuv_operation_sse2(m, scale);
+	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_cl_rgb_to_yuv_operation_avx512(m, scale);
+#endif
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_cl_rgb_to_yuv_operation_avx2(m, scale);
+		if (!ret && cpu >= CPUClass::X86_SSE2)
+			ret = create_cl_rgb_to_yuv_operation_sse2(m, scale);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<Operation> create_lut3d_operation_x86(Lut3D &&lut, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<Operation> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f && caps.avx512dq && caps.avx512bw && caps.avx512vl)
+			ret = create_lut3d_operation_avx512(std::move(lut));
+#endif
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_lut3d_operation_avx2(std::move(lut));
+	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_lut3d_operation_avx512(std::move(lut));
+#endif
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_lut3d_operation_avx2(std::move(lut));
+	}
+
+	return ret;
+}
+
 } // namespace colorspace
 } // namespace zimg
 
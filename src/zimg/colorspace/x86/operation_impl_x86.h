@@ -13,6 +13,7 @@ enum class CPUClass;
 
 namespace colorspace {
 
+struct Lut3D;
 struct Matrix3x3;
 struct OperationParams;
 struct TransferFunction;
@@ -25,15 +26,46 @@ std::unique_ptr<Operation> create_matrix_operation_avx512(const Matrix3x3 &m);
 std::unique_ptr<Operation> create_matrix_operation_x86(const Matrix3x3 &m, CPUClass cpu);
 
 std::unique_ptr<Operation> create_gamma_operation_sse2(const TransferFunction &transfer, const OperationParams &params);
-std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params, bool lut);
+std::unique_ptr<Operation> create_gamma_operation_avx512(const TransferFunction &transfer, const OperationParams &params);
 
 std::unique_ptr<Operation> create_gamma_operation_x86(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
 
 std::unique_ptr<Operation> create_inverse_gamma_operation_sse2(const TransferFunction &transfer, const OperationParams &params);
-std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params);
+std::unique_ptr<Operation> create_inverse_gamma_operation_avx2(const TransferFunction &transfer, const OperationParams &params, bool lut);
+std::unique_ptr<Operation> create_inverse_gamma_operation_avx512(const TransferFunction &transfer, const OperationParams &params);
 
 std::unique_ptr<Operation> create_inverse_gamma_operation_x86(const TransferFunction &transfer, const OperationParams &params, CPUClass cpu);
 
+std::unique_ptr<Operation> create_arib_b67_operation_sse2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_arib_b67_operation_avx2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_arib_b67_operation_avx512(const Matrix3x3 &m, float scale);
+
+std::unique_ptr<Operation> create_arib_b67_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu);
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_sse2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_avx512(const Matrix3x3 &m, float scale);
+
+std::unique_ptr<Operation> create_inverse_arib_b67_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu);
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_sse2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_avx512(const Matrix3x3 &m, float scale);
+
+std::unique_ptr<Operation> create_cl_yuv_to_rgb_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu);
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_sse2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx2(const Matrix3x3 &m, float scale);
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_avx512(const Matrix3x3 &m, float scale);
+
+std::unique_ptr<Operation> create_cl_rgb_to_yuv_operation_x86(const Matrix3x3 &m, float scale, CPUClass cpu);
+
+std::unique_ptr<Operation> create_lut3d_operation_avx2(Lut3D &&lut);
+std::unique_ptr<Operation> create_lut3d_operation_avx512(Lut3D &&lut);
+
+std::unique_ptr<Operation> create_lut3d_operation_x86(Lut3D &&lut, CPUClass cpu);
+
 } // namespace colorspace
 } // namespace zimg
 
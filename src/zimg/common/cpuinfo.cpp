@@ -6,13 +6,31 @@
 
 namespace zimg {
 
-unsigned long cpu_cache_size() noexcept
+CacheHierarchy cpu_cache_hierarchy() noexcept
 {
-	unsigned long ret = 0;
+	CacheHierarchy cache{};
 #ifdef ZIMG_X86
-	ret = cpu_cache_size_x86();
+	cache = cpu_cache_hierarchy_x86();
 #endif
-	return ret ? ret : 1024 * 1024UL;
+	// Assume a private 1 MB cache if the hierarchy is unknown.
+	if (!cache.l1d && !cache.l2 && !cache.l3) {
+		cache.l2 = 1024 * 1024UL;
+		cache.l2_threads = 1;
+	}
+
+	cache.l1d_threads = cache.l1d_threads ? cache.l1d_threads : 1;
+	cache.l2_threads = cache.l2_threads ? cache.l2_threads : 1;
+	cache.l3_threads = cache.l3_threads ? cache.l3_threads : 1;
+	return cache;
+}
+
+const char *cpu_model_name() noexcept
+{
+	const char *ret = nullptr;
+#ifdef ZIMG_X86
+	ret = cpu_model_name_x86();
+#endif
+	return ret && *ret ? ret : "generic";
 }
 
 bool cpu_has_fast_f16(CPUClass cpu) noexcept
@@ -12,6 +12,9 @@ enum class CPUClass {
 	NONE,
 	AUTO,
 	AUTO_64B,
+#ifdef ZIMG_GENERIC_SIMD
+	GENERIC_SIMD, // Compiler vector extensions.
+#endif // ZIMG_GENERIC_SIMD
 #ifdef ZIMG_X86
 	X86_SSE,
 	X86_SSE2,
@@ -27,7 +30,24 @@ constexpr bool cpu_is_autodetect(CPUClass cpu) noexcept
 	return cpu == CPUClass::AUTO || cpu == CPUClass::AUTO_64B;
 }
 
-unsigned long cpu_cache_size() noexcept;
+/**
+ * Processor cache hierarchy.
+ *
+ * Sizes are in bytes. Thread counts are the number of logical processors
+ * sharing each cache. Absent cache levels have zero size.
+ */
+struct CacheHierarchy {
+	unsigned long l1d;
+	unsigned long l2;
+	unsigned long l3;
+	unsigned l1d_threads;
+	unsigned l2_threads;
+	unsigned l3_threads;
+};
+
+CacheHierarchy cpu_cache_hierarchy() noexcept;
+
+const char *cpu_model_name() noexcept;
 
 bool cpu_has_fast_f16(CPUClass cpu) noexcept;
 bool cpu_requires_64b_alignment(CPUClass cpu) noexcept;
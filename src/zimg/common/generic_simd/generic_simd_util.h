@@ -0,0 +1,140 @@
+#pragma once
+
+#ifdef ZIMG_GENERIC_SIMD
+
+#ifndef ZIMG_GENERIC_SIMD_GENERIC_SIMD_UTIL_H_
+#define ZIMG_GENERIC_SIMD_GENERIC_SIMD_UTIL_H_
+
+#include <cstdint>
+#include <cstring>
+#include "common/ccdep.h"
+
+namespace zimg {
+
+// Portable 8-lane vectors using GCC/Clang vector extensions. The compiler
+// lowers these to the native SIMD registers of the target, splitting them if
+// the target vectors are narrower.
+typedef float vf32x8 __attribute__((vector_size(32)));
+typedef int32_t vi32x8 __attribute__((vector_size(32)));
+typedef uint16_t vu16x8 __attribute__((vector_size(16)));
+typedef uint8_t vu8x8 __attribute__((vector_size(8)));
+
+static inline FORCE_INLINE vf32x8 vec8_set1_f32(float x) { return vf32x8{ x, x, x, x, x, x, x, x }; }
+
+static inline FORCE_INLINE vi32x8 vec8_set1_i32(int32_t x) { return vi32x8{ x, x, x, x, x, x, x, x }; }
+
+// Load eight elements from [ptr], widening integers to 32 bits.
+static inline FORCE_INLINE vi32x8 vec8_load_i32(const uint8_t *ptr)
+{
+	vu8x8 x;
+	std::memcpy(&x, ptr, sizeof(x));
+	return __builtin_convertvector(x, vi32x8);
+}
+
+static inline FORCE_INLINE vi32x8 vec8_load_i32(const uint16_t *ptr)
+{
+	vu16x8 x;
+	std::memcpy(&x, ptr, sizeof(x));
+	return __builtin_convertvector(x, vi32x8);
+}
+
+static inline FORCE_INLINE vi32x8 vec8_load_i32(const int32_t *ptr)
+{
+	vi32x8 x;
+	std::memcpy(&x, ptr, sizeof(x));
+	return x;
+}
+
+static inline FORCE_INLINE vf32x8 vec8_load_f32(const uint8_t *ptr) { return __builtin_convertvector(vec8_load_i32(ptr), vf32x8); }
+
+static inline FORCE_INLINE vf32x8 vec8_load_f32(const uint16_t *ptr) { return __builtin_convertvector(vec8_load_i32(ptr), vf32x8); }
+
+static inline FORCE_INLINE vf32x8 vec8_load_f32(const float *ptr)
+{
+	vf32x8 x;
+	std::memcpy(&x, ptr, sizeof(x));
+	return x;
+}
+
+// Store eight elements to [dst], narrowing integers by truncation.
+static inline FORCE_INLINE void vec8_store(uint8_t *dst, vi32x8 x)
+{
+	vu8x8 y = __builtin_convertvector(x, vu8x8);
+	std::memcpy(dst, &y, sizeof(y));
+}
+
+static inline FORCE_INLINE void vec8_store(uint16_t *dst, vi32x8 x)
+{
+	vu16x8 y = __builtin_convertvector(x, vu16x8);
+	std::memcpy(dst, &y, sizeof(y));
+}
+
+static inline FORCE_INLINE void vec8_store(int32_t *dst, vi32x8 x) { std::memcpy(dst, &x, sizeof(x)); }
+
+static inline FORCE_INLINE void vec8_store(float *dst, vf32x8 x) { std::memcpy(dst, &x, sizeof(x)); }
+
+// Load the first [n] elements from [ptr] and set the remainder to zero.
+template <class T>
+static inline FORCE_INLINE vi32x8 vec8_load_i32_n(const T *ptr, unsigned n)
+{
+	T tmp[8] = { 0 };
+	std::memcpy(tmp, ptr, n * sizeof(T));
+	return vec8_load_i32(tmp);
+}
+
+template <class T>
+static inline FORCE_INLINE vf32x8 vec8_load_f32_n(const T *ptr, unsigned n)
+{
+	T tmp[8] = { 0 };
+	std::memcpy(tmp, ptr, n * sizeof(T));
+	return vec8_load_f32(tmp);
+}
+
+// Store the first [n] elements of [x] to [dst].
+template <class T, class V>
+static inline FORCE_INLINE void vec8_store_n(T *dst, V x, unsigned n)
+{
+	T tmp[8];
+	vec8_store(tmp, x);
+	std::memcpy(dst, tmp, n * sizeof(T));
+}
+
+static inline FORCE_INLINE vi32x8 vec8_min_i32(vi32x8 a, vi32x8 b)
+{
+	vi32x8 mask = a < b;
+	return (a & mask) | (b & ~mask);
+}
+
+static inline FORCE_INLINE vi32x8 vec8_max_i32(vi32x8 a, vi32x8 b)
+{
+	vi32x8 mask = a > b;
+	return (a & mask) | (b & ~mask);
+}
+
+// Comparison masks are used for selection, so that NaN is replaced by [b].
+static inline FORCE_INLINE vf32x8 vec8_min_f32(vf32x8 a, vf32x8 b)
+{
+	vi32x8 mask = a < b;
+	return reinterpret_cast<vf32x8>((reinterpret_cast<vi32x8>(a) & mask) | (reinterpret_cast<vi32x8>(b) & ~mask));
+}
+
+static inline FORCE_INLINE vf32x8 vec8_max_f32(vf32x8 a, vf32x8 b)
+{
+	vi32x8 mask = a > b;
+	return reinterpret_cast<vf32x8>((reinterpret_cast<vi32x8>(a) & mask) | (reinterpret_cast<vi32x8>(b) & ~mask));
+}
+
+// Round to nearest-even in the current rounding mode. Only valid for 0 <= x < 2^23.
+static inline FORCE_INLINE vi32x8 vec8_round_u23(vf32x8 x)
+{
+	const vf32x8 magic = vec8_set1_f32(8388608.0f);
+
+	x = (x + magic) - magic;
+	return __builtin_convertvector(x, vi32x8);
+}
+
+} // namespace zimg
+
+#endif // ZIMG_GENERIC_SIMD_GENERIC_SIMD_UTIL_H_
+
+#endif // ZIMG_GENERIC_SIMD
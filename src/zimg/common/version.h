@@ -0,0 +1,13 @@
+#pragma once
+
+#ifndef ZIMG_VERSION_H_
+#define ZIMG_VERSION_H_
+
+namespace zimg {
+
+// Library version as major, minor, and micro numbers.
+constexpr unsigned VERSION_INFO[] = { 2, 6, 3 };
+
+} // namespace zimg
+
+#endif // ZIMG_VERSION_H_
@@ -110,6 +110,76 @@ static inline FORCE_INLINE void mm256_transpose16_epi16(__m256i &row0, __m256i &
 	_avx2::mm256_exchange_lanes_si128(row7, row15);
 }
 
+// Natural logarithm of positive normal elements. Maximum relative error is 2^-22.
+static inline FORCE_INLINE __m256 mm256_log_ps(__m256 x)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	__m256i xi = _mm256_castps_si256(x);
+	__m256 e, m, mask, z, y;
+
+	// Split into exponent and mantissa in [sqrt(0.5), sqrt(2)).
+	e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(xi, 23), _mm256_set1_epi32(126)));
+	m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(xi, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F000000)));
+
+	mask = _mm256_cmp_ps(m, _mm256_set1_ps(0.70710678f), _CMP_LT_OQ);
+	e = _mm256_sub_ps(e, _mm256_and_ps(mask, one));
+	m = _mm256_add_ps(_mm256_sub_ps(m, one), _mm256_and_ps(mask, m));
+
+	z = _mm256_mul_ps(m, m);
+	y = _mm256_set1_ps(7.0376836292e-2f);
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.1514610310e-1f));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.1676998740e-1f));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.2420140846e-1f));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.4249322787e-1f));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.6668057665e-1f));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(2.0000714765e-1f));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-2.4999993993e-1f));
+	y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(3.3333331174e-1f));
+	y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+
+	// ln(2) is split into two parts to preserve precision.
+	y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(-2.12194440e-4f)));
+	y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+	m = _mm256_add_ps(m, y);
+	m = _mm256_add_ps(m, _mm256_mul_ps(e, _mm256_set1_ps(0.693359375f)));
+	return m;
+}
+
+// Natural exponential. Maximum relative error is 2^-22. Saturates at 2^-126 and 2^127.
+static inline FORCE_INLINE __m256 mm256_exp_ps(__m256 x)
+{
+	__m256i n;
+	__m256 nf, z, y;
+
+	x = _mm256_max_ps(x, _mm256_set1_ps(-87.33654f));
+	x = _mm256_min_ps(x, _mm256_set1_ps(88.0f));
+
+	n = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)));
+	nf = _mm256_cvtepi32_ps(n);
+	x = _mm256_sub_ps(x, _mm256_mul_ps(nf, _mm256_set1_ps(0.693359375f)));
+	x = _mm256_sub_ps(x, _mm256_mul_ps(nf, _mm256_set1_ps(-2.12194440e-4f)));
+
+	z = _mm256_mul_ps(x, x);
+	y = _mm256_set1_ps(1.9875691500e-4f);
+	y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507e-3f));
+	y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073e-3f));
+	y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894e-2f));
+	y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459e-1f));
+	y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201e-1f));
+	y = _mm256_fmadd_ps(y, z, x);
+	y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+
+	// Multiply by 2^n.
+	n = _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23);
+	return _mm256_mul_ps(y, _mm256_castsi256_ps(n));
+}
+
+// Raise positive normal elements to the power [y].
+static inline FORCE_INLINE __m256 mm256_pow_ps(__m256 x, __m256 y)
+{
+	return mm256_exp_ps(_mm256_mul_ps(mm256_log_ps(x), y));
+}
+
 } // namespace zimg
 
 #endif // ZIMG_X86_AVX2_UTIL_H_
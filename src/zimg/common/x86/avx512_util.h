@@ -175,6 +175,98 @@ static inline FORCE_INLINE void mm512_transpose32_epi16(
 	_avx512::mm512_transpose4_si128(row7, row15, row23, row31);
 }
 
+// Base-2 logarithm of positive normal elements. The accurate variant has a
+// maximum relative error of about 2^-22, the fast variant 2^-19.
+template <bool Accurate>
+static inline FORCE_INLINE __m512 mm512_log2_ps(__m512 x)
+{
+	__m512i xi = _mm512_castps_si512(x);
+	__m512i k;
+	__m512 m, y;
+
+	// Split into exponent and mantissa in [sqrt(0.5), sqrt(2)).
+	k = _mm512_srai_epi32(_mm512_sub_epi32(xi, _mm512_set1_epi32(0x3F3504F3)), 23);
+	m = _mm512_castsi512_ps(_mm512_sub_epi32(xi, _mm512_slli_epi32(k, 23)));
+	m = _mm512_sub_ps(m, _mm512_set1_ps(1.0f));
+
+	if (Accurate) {
+		// ln(1 + m) = m - m^2 / 2 + m^3 * P(m), converted to base 2.
+		__m512 z = _mm512_mul_ps(m, m);
+
+		y = _mm512_set1_ps(7.0376836292e-2f);
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-1.1514610310e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(1.1676998740e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-1.2420140846e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(1.4249322787e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-1.6668057665e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(2.0000714765e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-2.4999993993e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(3.3333331174e-1f));
+		y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+		y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+		y = _mm512_add_ps(m, y);
+		return _mm512_fmadd_ps(y, _mm512_set1_ps(1.44269504f), _mm512_cvtepi32_ps(k));
+	} else {
+		y = _mm512_set1_ps(1.761577943e-1f);
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-2.709743207e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(2.951010590e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-3.591851510e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(4.806486524e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(-7.213676861e-1f));
+		y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(1.442696307e+0f));
+		return _mm512_fmadd_ps(y, m, _mm512_cvtepi32_ps(k));
+	}
+}
+
+// Base-2 exponential. The accurate variant has a maximum relative error of
+// about 2^-23, the fast variant 2^-22. Saturates at 2^-126 and 2^127.
+template <bool Accurate>
+static inline FORCE_INLINE __m512 mm512_exp2_ps(__m512 x)
+{
+	__m512i n;
+	__m512 y;
+
+	x = _mm512_max_ps(x, _mm512_set1_ps(-126.0f));
+	x = _mm512_min_ps(x, _mm512_set1_ps(127.0f));
+
+	n = _mm512_cvtps_epi32(x);
+	x = _mm512_sub_ps(x, _mm512_cvtepi32_ps(n));
+
+	if (Accurate) {
+		// e^r = 1 + r + r^2 * P(r), with r = x * ln(2).
+		__m512 r = _mm512_mul_ps(x, _mm512_set1_ps(0.693147181f));
+		__m512 z = _mm512_mul_ps(r, r);
+
+		y = _mm512_set1_ps(1.9875691500e-4f);
+		y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(1.3981999507e-3f));
+		y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(8.3334519073e-3f));
+		y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(4.1665795894e-2f));
+		y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(1.6666665459e-1f));
+		y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(5.0000001201e-1f));
+		y = _mm512_fmadd_ps(y, z, r);
+		y = _mm512_add_ps(y, _mm512_set1_ps(1.0f));
+	} else {
+		y = _mm512_set1_ps(1.340967682e-3f);
+		y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(9.676038062e-3f));
+		y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(5.550298321e-2f));
+		y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(2.402210733e-1f));
+		y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(6.931472248e-1f));
+		y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(1.000000076e+0f));
+	}
+
+	// Multiply by 2^n.
+	n = _mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(127)), 23);
+	return _mm512_mul_ps(y, _mm512_castsi512_ps(n));
+}
+
+// Raise positive normal elements to the power [y]. The error grows with the
+// magnitude of log2(x) * y.
+template <bool Accurate>
+static inline FORCE_INLINE __m512 mm512_pow_ps(__m512 x, __m512 y)
+{
+	return mm512_exp2_ps<Accurate>(_mm512_mul_ps(mm512_log2_ps<Accurate>(x), y));
+}
+
 } // namespace zimg
 
 #endif // ZIMG_X86_AVX512_UTIL_H_
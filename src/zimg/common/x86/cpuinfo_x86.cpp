@@ -6,22 +6,21 @@
   #include <cpuid.h>
 #endif
 
+#include <cstring>
 #include "common/cpuinfo.h"
 #include "cpuinfo_x86.h"
 
 namespace zimg {
 namespace {
 
-struct X86CacheHierarchy {
-	unsigned long l1d;
-	unsigned long l1d_threads;
-	unsigned long l2;
-	unsigned long l2_threads;
-	unsigned long l3;
-	unsigned long l3_threads;
-	bool l2_inclusive;
-	bool l3_inclusive;
-	bool valid;
+struct X86ModelName {
+	char str[49];
+};
+
+enum class X86Vendor {
+	GENUINEINTEL,
+	AUTHENTICAMD,
+	OTHER,
 };
 
 /**
@@ -106,6 +105,71 @@ X86Capabilities do_query_x86_capabilities() noexcept
 	return caps;
 }
 
+/**
+ * Parse the deterministic cache parameters reported by CPUID.
+ *
+ * Intel processors report cache parameters in leaf 4, and AMD processors with
+ * topology extensions report the same structure in leaf 0x8000001D.
+ *
+ * @param[out] cache cache hierarchy
+ * @param leaf CPUID leaf
+ */
+void do_query_x86_deterministic_cache_params(X86CacheHierarchy *cache, int leaf) noexcept
+{
+	int regs[4];
+
+	for (int i = 0; i < 8; ++i) {
+		unsigned threads;
+		unsigned long line_size;
+		unsigned long partitions;
+		unsigned long ways;
+		unsigned long sets;
+		unsigned long cache_size;
+		int cache_type;
+		bool inclusive;
+
+		do_cpuid(regs, leaf, i);
+		cache_type = regs[0] & 0x1FU;
+
+		// No more caches.
+		if (cache_type == 0)
+			break;
+
+		// Not data or unified cache.
+		if (cache_type != 1 && cache_type != 3)
+			continue;
+
+		threads    = ((static_cast<unsigned>(regs[0]) >> 14) & 0x0FFFU) + 1;
+		line_size  = ((static_cast<unsigned>(regs[1]) >> 0) & 0x0FFFU) + 1;
+		partitions = ((static_cast<unsigned>(regs[1]) >> 12) & 0x03FFU) + 1;
+		ways       = ((static_cast<unsigned>(regs[1]) >> 22) & 0x03FFU) + 1;
+		sets       = static_cast<unsigned>(regs[2]) + 1;
+
+		cache_size = line_size * partitions * ways * sets;
+		inclusive = regs[3] & (1U << 1);
+
+		// Cache level.
+		switch ((static_cast<unsigned>(regs[0]) >> 5) & 0x07U) {
+		case 1:
+			cache->l1d = cache_size;
+			cache->l1d_threads = threads;
+			break;
+		case 2:
+			cache->l2 = cache_size;
+			cache->l2_threads = threads;
+			cache->l2_inclusive = inclusive;
+			break;
+		case 3:
+			cache->l3 = cache_size;
+			cache->l3_threads = threads;
+			cache->l3_inclusive = inclusive;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 X86CacheHierarchy do_query_x86_cache_hierarchy_intel(int max_feature) noexcept
 {
 	X86CacheHierarchy cache = { 0 };
@@ -119,58 +183,8 @@ X86CacheHierarchy do_query_x86_cache_hierarchy_intel(int max_feature) noexcept
 		return cache;
 
 	// Detect cache hierarchy.
-	if (max_feature >= 4) {
-		for (int i = 0; i < 8; ++i) {
-			unsigned threads;
-			unsigned long line_size;
-			unsigned long partitions;
-			unsigned long ways;
-			unsigned long sets;
-			unsigned long cache_size;
-			int cache_type;
-			bool inclusive;
-
-			do_cpuid(regs, 4, i);
-			cache_type = regs[0] & 0x1FU;
-
-			// No more caches.
-			if (cache_type == 0)
-				break;
-
-			// Not data or unified cache.
-			if (cache_type != 1 && cache_type != 3)
-				continue;
-
-			threads    = ((static_cast<unsigned>(regs[0]) >> 14) & 0x0FFFU) + 1;
-			line_size  = ((static_cast<unsigned>(regs[1]) >> 0) & 0x0FFFU) + 1;
-			partitions = ((static_cast<unsigned>(regs[1]) >> 12) & 0x03FFU) + 1;
-			ways       = ((static_cast<unsigned>(regs[1]) >> 22) & 0x03FFU) + 1;
-			sets       = static_cast<unsigned>(regs[2]) + 1;
-
-			cache_size = line_size * partitions * ways * sets;
-			inclusive = regs[3] & (1U << 1);
-
-			// Cache level.
-			switch ((static_cast<unsigned>(regs[0]) >> 5) & 0x07U) {
-			case 1:
-				cache.l1d = cache_size;
-				cache.l1d_threads = threads;
-				break;
-			case 2:
-				cache.l2 = cache_size;
-				cache.l2_threads = threads;
-				cache.l2_inclusive = inclusive;
-				break;
-			case 3:
-				cache.l3 = cache_size;
-				cache.l3_threads = threads;
-				cache.l3_inclusive = inclusive;
-				break;
-			default:
-				break;
-			}
-		}
-	}
+	if (max_feature >= 4)
+		do_query_x86_deterministic_cache_params(&cache, 4);
 
 	// Detect logical processor count on x2APIC systems.
 	if (max_feature >= 0x0B) {
@@ -204,32 +218,122 @@ X86CacheHierarchy do_query_x86_cache_hierarchy_intel(int max_feature) noexcept
 	return cache;
 }
 
-X86CacheHierarchy do_query_x86_cache_hierarchy() noexcept
+X86CacheHierarchy do_query_x86_cache_hierarchy_amd() noexcept
 {
-	enum { GENUINEINTEL, AUTHENTICAMD, OTHER } vendor;
-
 	X86CacheHierarchy cache = { 0 };
+	int regs[4];
+
+	do_cpuid(regs, static_cast<int>(0x80000000U), 0);
+	if (static_cast<unsigned>(regs[0]) < 0x8000001DU)
+		return cache;
+
+	// Topology extensions.
+	do_cpuid(regs, static_cast<int>(0x80000001U), 0);
+	if (!(regs[2] & (1U << 22)))
+		return cache;
+
+	do_query_x86_deterministic_cache_params(&cache, static_cast<int>(0x8000001DU));
+	cache.valid = true;
+	return cache;
+}
+
+X86Vendor do_query_x86_vendor(int *max_feature) noexcept
+{
 	int regs[4] = { 0 };
-	int max_feature;
 
 	do_cpuid(regs, 0, 1);
-	max_feature = regs[0] & 0xFF;
+	*max_feature = regs[0] & 0xFF;
 
 	if (regs[1] == 0x756E6547U && regs[3] == 0x49656E69U && regs[2] == 0x6C65746EU)
-		vendor = GENUINEINTEL;
+		return X86Vendor::GENUINEINTEL;
 	else if (regs[1] == 0x68747541U && regs[3] == 0x69746E65U && regs[2] == 0x444D4163U)
-		vendor = AUTHENTICAMD;
+		return X86Vendor::AUTHENTICAMD;
 	else
-		vendor = OTHER;
+		return X86Vendor::OTHER;
+}
+
+X86CacheHierarchy do_query_x86_cache_hierarchy() noexcept
+{
+	X86CacheHierarchy cache = { 0 };
+	int max_feature;
+	X86Vendor vendor = do_query_x86_vendor(&max_feature);
 
-	if (vendor == GENUINEINTEL)
+	if (vendor == X86Vendor::GENUINEINTEL)
 		return do_query_x86_cache_hierarchy_intel(max_feature);
-	else if (vendor == AUTHENTICAMD)
-		return cache;
+	else if (vendor == X86Vendor::AUTHENTICAMD)
+		return do_query_x86_cache_hierarchy_amd();
 	else
 		return cache;
 }
 
+bool do_query_x86_fast_gather() noexcept
+{
+	int regs[4] = { 0 };
+	int max_feature;
+	X86Vendor vendor = do_query_x86_vendor(&max_feature);
+	unsigned family;
+	unsigned model;
+
+	if (max_feature < 1)
+		return false;
+
+	do_cpuid(regs, 1, 0);
+	family = (regs[0] >> 8) & 0x0F;
+	model = (regs[0] >> 4) & 0x0F;
+
+	if (family == 0x0F)
+		family += (regs[0] >> 20) & 0xFF;
+	if (family == 0x06 || family >= 0x0F)
+		model |= ((regs[0] >> 16) & 0x0F) << 4;
+
+	if (vendor == X86Vendor::GENUINEINTEL) {
+		// Gathers are split into one load per element on Haswell and Broadwell.
+		if (family != 0x06)
+			return false;
+
+		switch (model) {
+		case 0x3C: case 0x3F: case 0x45: case 0x46:
+		case 0x3D: case 0x47: case 0x4F: case 0x56:
+			return false;
+		default:
+			return true;
+		}
+	} else if (vendor == X86Vendor::AUTHENTICAMD) {
+		// Gathers are microcoded on Zen 1 and Zen 2.
+		return family >= 0x19;
+	} else {
+		return false;
+	}
+}
+
+X86ModelName do_query_x86_model_name() noexcept
+{
+	X86ModelName name = { { 0 } };
+	int regs[4] = { 0 };
+
+	do_cpuid(regs, static_cast<int>(0x80000000U), 0);
+	if (static_cast<unsigned>(regs[0]) < 0x80000004U)
+		return name;
+
+	// Processor brand string.
+	for (unsigned i = 0; i < 3; ++i) {
+		do_cpuid(regs, static_cast<int>(0x80000002U + i), 0);
+		std::memcpy(name.str + i * 16, regs, 16);
+	}
+	name.str[48] = '\0';
+
+	// Remove leading and trailing spaces.
+	size_t first = std::strspn(name.str, " ");
+	size_t len = std::strlen(name.str + first);
+
+	std::memmove(name.str, name.str + first, len + 1);
+	while (len && name.str[len - 1] == ' ') {
+		name.str[--len] = '\0';
+	}
+
+	return name;
+}
+
 } // namespace
 
 
@@ -239,23 +343,33 @@ X86Capabilities query_x86_capabilities() noexcept
 	return caps;
 }
 
-unsigned long cpu_cache_size_x86() noexcept
+X86CacheHierarchy query_x86_cache_hierarchy() noexcept
 {
 	static const X86CacheHierarchy cache = do_query_x86_cache_hierarchy();
+	return cache;
+}
+
+CacheHierarchy cpu_cache_hierarchy_x86() noexcept
+{
+	X86CacheHierarchy x86_cache = query_x86_cache_hierarchy();
+	CacheHierarchy cache{};
 
-	if (!cache.valid)
-		return 0;
+	if (!x86_cache.valid)
+		return cache;
 
-	// Detect Skylake-SP cache hierarchy and report L2 size instead of L3.
-	if (cache.l3 && !cache.l3_inclusive && cache.l2 >= 1024 * 1024U && cache.l2_threads <= 2)
-		return cache.l2 / cache.l2_threads;
+	cache.l1d = x86_cache.l1d;
+	cache.l2 = x86_cache.l2;
+	cache.l3 = x86_cache.l3;
+	cache.l1d_threads = x86_cache.l1d_threads;
+	cache.l2_threads = x86_cache.l2_threads;
+	cache.l3_threads = x86_cache.l3_threads;
+	return cache;
+}
 
-	if (cache.l3)
-		return cache.l3 / cache.l3_threads;
-	else if (cache.l2)
-		return cache.l2 / cache.l2_threads;
-	else
-		return cache.l1d / cache.l1d_threads;
+const char *cpu_model_name_x86() noexcept
+{
+	static const X86ModelName name = do_query_x86_model_name();
+	return name.str;
 }
 
 bool cpu_has_fast_f16_x86(CPUClass cpu) noexcept
@@ -269,6 +383,17 @@ bool cpu_has_fast_f16_x86(CPUClass cpu) noexcept
 	}
 }
 
+bool cpu_has_fast_gather_x86(CPUClass cpu) noexcept
+{
+	static const bool fast_gather = do_query_x86_fast_gather();
+
+	// Explicit instruction sets always use the table lookup, so that results are reproducible.
+	if (cpu_is_autodetect(cpu))
+		return fast_gather;
+	else
+		return true;
+}
+
 bool cpu_requires_64b_alignment_x86(CPUClass cpu) noexcept
 {
 	if (cpu == CPUClass::AUTO_64B) {
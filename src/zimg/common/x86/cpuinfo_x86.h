@@ -8,6 +8,7 @@
 namespace zimg {
 
 enum class CPUClass;
+struct CacheHierarchy;
 
 /**
  * Bitfield of selected x86 feature flags.
@@ -30,6 +31,24 @@ struct X86Capabilities {
 	unsigned avx512vl : 1;
 };
 
+/**
+ * Cache hierarchy reported by CPUID.
+ *
+ * Sizes are in bytes. Thread counts are the number of logical processors
+ * sharing each cache.
+ */
+struct X86CacheHierarchy {
+	unsigned long l1d;
+	unsigned long l1d_threads;
+	unsigned long l2;
+	unsigned long l2_threads;
+	unsigned long l3;
+	unsigned long l3_threads;
+	bool l2_inclusive;
+	bool l3_inclusive;
+	bool valid;
+};
+
 /**
  * Get the x86 feature flags on the current CPU.
  *
@@ -37,9 +56,19 @@ struct X86Capabilities {
  */
 X86Capabilities query_x86_capabilities() noexcept;
 
-unsigned long cpu_cache_size_x86() noexcept;
+/**
+ * Get the cache hierarchy of the current CPU.
+ *
+ * @return cache hierarchy
+ */
+X86CacheHierarchy query_x86_cache_hierarchy() noexcept;
+
+CacheHierarchy cpu_cache_hierarchy_x86() noexcept;
+
+const char *cpu_model_name_x86() noexcept;
 
 bool cpu_has_fast_f16_x86(CPUClass cpu) noexcept;
+bool cpu_has_fast_gather_x86(CPUClass cpu) noexcept;
 bool cpu_requires_64b_alignment_x86(CPUClass cpu) noexcept;
 
 } // namespace zimg
@@ -122,6 +122,168 @@ static inline FORCE_INLINE __m128i mm_packus_epi32(__m128i a, __m128i b)
 	return a;
 }
 
+// Select elements from [a] where [mask] is set, otherwise from [b].
+static inline FORCE_INLINE __m128i mm_blendv_si128(__m128i a, __m128i b, __m128i mask)
+{
+	a = _mm_and_si128(mask, a);
+	b = _mm_andnot_si128(mask, b);
+
+	return _mm_or_si128(a, b);
+}
+
+// Minimum of signed 32-bit elements.
+static inline FORCE_INLINE __m128i mm_min_epi32(__m128i a, __m128i b)
+{
+	__m128i mask = _mm_cmplt_epi32(a, b);
+	return mm_blendv_si128(a, b, mask);
+}
+
+// Convert the low four half-precision elements of [x] to single-precision.
+static inline FORCE_INLINE __m128 mm_cvtph_ps(__m128i x)
+{
+	__m128 magic = _mm_castsi128_ps(_mm_set1_epi32(113UL << 23));
+	__m128i shift_exp = _mm_set1_epi32(0x7C00UL << 13);
+	__m128i sign_mask = _mm_set1_epi32(0x8000U);
+	__m128i mant_mask = _mm_set1_epi32(0x7FFF);
+	__m128i exp_adjust = _mm_set1_epi32((127UL - 15UL) << 23);
+	__m128i exp_adjust_nan = _mm_set1_epi32((127UL - 16UL) << 23);
+	__m128i exp_adjust_denorm = _mm_set1_epi32(1UL << 23);
+	__m128i zero = _mm_set1_epi16(0);
+
+	__m128i exp, ret, ret_nan, ret_denorm, sign, mask0, mask1;
+
+	x = _mm_unpacklo_epi16(x, zero);
+
+	ret = _mm_and_si128(x, mant_mask);
+	ret = _mm_slli_epi32(ret, 13);
+	exp = _mm_and_si128(shift_exp, ret);
+	ret = _mm_add_epi32(ret, exp_adjust);
+
+	mask0 = _mm_cmpeq_epi32(exp, shift_exp);
+	mask1 = _mm_cmpeq_epi32(exp, zero);
+
+	ret_nan = _mm_add_epi32(ret, exp_adjust_nan);
+	ret_denorm = _mm_add_epi32(ret, exp_adjust_denorm);
+	ret_denorm = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(ret_denorm), magic));
+
+	sign = _mm_and_si128(x, sign_mask);
+	sign = _mm_slli_epi32(sign, 16);
+
+	ret = mm_blendv_si128(ret_nan, ret, mask0);
+	ret = mm_blendv_si128(ret_denorm, ret, mask1);
+
+	ret = _mm_or_si128(ret, sign);
+	return _mm_castsi128_ps(ret);
+}
+
+// Convert single-precision to half-precision in the low four elements.
+static inline FORCE_INLINE __m128i mm_cvtps_ph(__m128 x)
+{
+	__m128 magic = _mm_castsi128_ps(_mm_set1_epi32(15UL << 23));
+	__m128i inf = _mm_set1_epi32(255UL << 23);
+	__m128i f16inf = _mm_set1_epi32(31UL << 23);
+	__m128i sign_mask = _mm_set1_epi32(0x80000000UL);
+	__m128i round_mask = _mm_set1_epi32(~0x0FFFU);
+
+	__m128i ret_0x7E00 = _mm_set1_epi32(0x7E00);
+	__m128i ret_0x7C00 = _mm_set1_epi32(0x7C00);
+
+	__m128i f, sign, ge_inf, eq_inf;
+
+	f = _mm_castps_si128(x);
+	sign = _mm_and_si128(f, sign_mask);
+	f = _mm_xor_si128(f, sign);
+
+	ge_inf = _mm_cmpgt_epi32(f, inf);
+	eq_inf = _mm_cmpeq_epi32(f, inf);
+
+	f = _mm_and_si128(f, round_mask);
+	f = _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(f), magic));
+	f = _mm_sub_epi32(f, round_mask);
+
+	f = mm_min_epi32(f, f16inf);
+	f = _mm_srli_epi32(f, 13);
+
+	f = mm_blendv_si128(ret_0x7E00, f, ge_inf);
+	f = mm_blendv_si128(ret_0x7C00, f, eq_inf);
+
+	sign = _mm_srli_epi32(sign, 16);
+	f = _mm_or_si128(f, sign);
+
+	f = mm_packus_epi32(f, _mm_setzero_si128());
+	return f;
+}
+
+// Natural logarithm of positive normal elements. Maximum relative error is 2^-22.
+static inline FORCE_INLINE __m128 mm_log_ps(__m128 x)
+{
+	const __m128 one = _mm_set_ps1(1.0f);
+	__m128i xi = _mm_castps_si128(x);
+	__m128 e, m, mask, z, y;
+
+	// Split into exponent and mantissa in [sqrt(0.5), sqrt(2)).
+	e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(xi, 23), _mm_set1_epi32(126)));
+	m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(xi, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F000000)));
+
+	mask = _mm_cmplt_ps(m, _mm_set_ps1(0.70710678f));
+	e = _mm_sub_ps(e, _mm_and_ps(mask, one));
+	m = _mm_add_ps(_mm_sub_ps(m, one), _mm_and_ps(mask, m));
+
+	z = _mm_mul_ps(m, m);
+	y = _mm_set_ps1(7.0376836292e-2f);
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(-1.1514610310e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(1.1676998740e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(-1.2420140846e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(1.4249322787e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(-1.6668057665e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(2.0000714765e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(-2.4999993993e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set_ps1(3.3333331174e-1f));
+	y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+
+	// ln(2) is split into two parts to preserve precision.
+	y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set_ps1(-2.12194440e-4f)));
+	y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set_ps1(0.5f)));
+	m = _mm_add_ps(m, y);
+	m = _mm_add_ps(m, _mm_mul_ps(e, _mm_set_ps1(0.693359375f)));
+	return m;
+}
+
+// Natural exponential. Maximum relative error is 2^-22. Saturates at 2^-126 and 2^127.
+static inline FORCE_INLINE __m128 mm_exp_ps(__m128 x)
+{
+	__m128i n;
+	__m128 nf, z, y;
+
+	x = _mm_max_ps(x, _mm_set_ps1(-87.33654f));
+	x = _mm_min_ps(x, _mm_set_ps1(88.0f));
+
+	n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set_ps1(1.44269504f)));
+	nf = _mm_cvtepi32_ps(n);
+	x = _mm_sub_ps(x, _mm_mul_ps(nf, _mm_set_ps1(0.693359375f)));
+	x = _mm_sub_ps(x, _mm_mul_ps(nf, _mm_set_ps1(-2.12194440e-4f)));
+
+	z = _mm_mul_ps(x, x);
+	y = _mm_set_ps1(1.9875691500e-4f);
+	y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set_ps1(1.3981999507e-3f));
+	y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set_ps1(8.3334519073e-3f));
+	y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set_ps1(4.1665795894e-2f));
+	y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set_ps1(1.6666665459e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set_ps1(5.0000001201e-1f));
+	y = _mm_add_ps(_mm_mul_ps(y, z), x);
+	y = _mm_add_ps(y, _mm_set_ps1(1.0f));
+
+	// Multiply by 2^n.
+	n = _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+	return _mm_mul_ps(y, _mm_castsi128_ps(n));
+}
+
+// Raise positive normal elements to the power [y].
+static inline FORCE_INLINE __m128 mm_pow_ps(__m128 x, __m128 y)
+{
+	return mm_exp_ps(_mm_mul_ps(mm_log_ps(x), y));
+}
+
 } // namespace zimg
 
 #endif // ZIMG_X86_SSE2_UTIL_H_
@@ -14,6 +14,10 @@
   #include "x86/depth_convert_x86.h"
 #endif
 
+#ifdef ZIMG_GENERIC_SIMD
+  #include "generic_simd/depth_convert_generic_simd.h"
+#endif
+
 namespace zimg {
 namespace depth {
 
@@ -121,6 +125,8 @@ public:
 		m_shift = pixel_out.depth - pixel_in.depth;
 	}
 
+	const char *get_name() const override { return "left_shift"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -195,6 +201,8 @@ public:
 		m_offset = static_cast<float>(-offset * (1.0 / range));
 	}
 
+	const char *get_name() const override { return "convert_to_float"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -264,6 +272,10 @@ std::unique_ptr<graph::ImageFilter> create_left_shift(unsigned width, unsigned h
 
 #ifdef ZIMG_X86
 	func = select_left_shift_func_x86(pixel_in.type, pixel_out.type, cpu);
+#endif
+#ifdef ZIMG_GENERIC_SIMD
+	if (!func)
+		func = select_left_shift_func_generic_simd(pixel_in.type, pixel_out.type, cpu);
 #endif
 	if (!func)
 		func = select_left_shift_func(pixel_in.type, pixel_out.type);
@@ -284,6 +296,10 @@ std::unique_ptr<graph::ImageFilter> create_convert_to_float(unsigned width, unsi
 
 	if (needs_f16c)
 		f16c = select_depth_f16c_func_x86(pixel_out.type == PixelType::HALF, cpu);
+#endif
+#ifdef ZIMG_GENERIC_SIMD
+	if (!func)
+		func = select_depth_convert_func_generic_simd(pixel_in, pixel_out, cpu);
 #endif
 	if (!func)
 		func = select_depth_convert_func(pixel_in.type, pixel_out.type);
@@ -20,6 +20,10 @@
   #include "x86/dither_x86.h"
 #endif
 
+#ifdef ZIMG_GENERIC_SIMD
+  #include "generic_simd/dither_generic_simd.h"
+#endif
+
 namespace zimg {
 namespace depth {
 
@@ -262,6 +266,8 @@ public:
 		m_dither_table = std::move(table);
 	}
 
+	const char *get_name() const override { return "ordered_dither"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -363,6 +369,8 @@ public:
 		std::tie(m_scale, m_offset) = get_scale_offset(format_in, format_out);
 	}
 
+	const char *get_name() const override { return "error_diffusion_c"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -484,6 +492,10 @@ std::unique_ptr<graph::ImageFilter> create_dither(DitherType type, unsigned widt
 	if (needs_f16c)
 		f16c = select_dither_f16c_func_x86(cpu);
 #endif
+#ifdef ZIMG_GENERIC_SIMD
+	if (!func)
+		func = select_ordered_dither_func_generic_simd(pixel_in, pixel_out, cpu);
+#endif
 
 	if (!func)
 		func = select_ordered_dither_func(pixel_in.type, pixel_out.type);
@@ -0,0 +1,98 @@
+#ifdef ZIMG_GENERIC_SIMD
+
+#include <cstdint>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "depth_convert_generic_simd.h"
+
+#include "common/generic_simd/generic_simd_util.h"
+
+namespace zimg {
+namespace depth {
+
+namespace {
+
+template <class T, class U>
+void left_shift_generic_simd(const void *src, void *dst, unsigned shift, unsigned left, unsigned right)
+{
+	const T *src_p = static_cast<const T *>(src);
+	U *dst_p = static_cast<U *>(dst);
+
+	unsigned vec_right = left + floor_n(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		vi32x8 x = vec8_load_i32(src_p + j);
+		vec8_store(dst_p + j, x << shift);
+	}
+	if (right != vec_right) {
+		vi32x8 x = vec8_load_i32_n(src_p + vec_right, right - vec_right);
+		vec8_store_n(dst_p + vec_right, x << shift, right - vec_right);
+	}
+}
+
+template <class T>
+void depth_convert_generic_simd(const void *src, void *dst, float scale, float offset, unsigned left, unsigned right)
+{
+	const T *src_p = static_cast<const T *>(src);
+	float *dst_p = static_cast<float *>(dst);
+
+	const vf32x8 scale_v = vec8_set1_f32(scale);
+	const vf32x8 offset_v = vec8_set1_f32(offset);
+
+	unsigned vec_right = left + floor_n(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		vf32x8 x = vec8_load_f32(src_p + j);
+		vec8_store(dst_p + j, x * scale_v + offset_v);
+	}
+	if (right != vec_right) {
+		vf32x8 x = vec8_load_f32_n(src_p + vec_right, right - vec_right);
+		vec8_store_n(dst_p + vec_right, x * scale_v + offset_v, right - vec_right);
+	}
+}
+
+} // namespace
+
+
+left_shift_func select_left_shift_func_generic_simd(PixelType pixel_in, PixelType pixel_out, CPUClass cpu)
+{
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return nullptr;
+
+	if (pixel_in == PixelType::BYTE && pixel_out == PixelType::BYTE)
+		return left_shift_generic_simd<uint8_t, uint8_t>;
+	else if (pixel_in == PixelType::BYTE && pixel_out == PixelType::WORD)
+		return left_shift_generic_simd<uint8_t, uint16_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::BYTE)
+		return left_shift_generic_simd<uint16_t, uint8_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::WORD)
+		return left_shift_generic_simd<uint16_t, uint16_t>;
+	else
+		return nullptr;
+}
+
+depth_convert_func select_depth_convert_func_generic_simd(const PixelFormat &format_in, const PixelFormat &format_out, CPUClass cpu)
+{
+	PixelType pixel_in = format_in.type;
+	PixelType pixel_out = format_out.type;
+
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return nullptr;
+
+	if (pixel_out == PixelType::HALF)
+		pixel_out = PixelType::FLOAT;
+
+	if (pixel_in == PixelType::BYTE && pixel_out == PixelType::FLOAT)
+		return depth_convert_generic_simd<uint8_t>;
+	else if (pixel_in == PixelType::WORD && pixel_out == PixelType::FLOAT)
+		return depth_convert_generic_simd<uint16_t>;
+	else
+		return nullptr;
+}
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_GENERIC_SIMD
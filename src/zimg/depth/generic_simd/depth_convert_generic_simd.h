@@ -0,0 +1,22 @@
+#pragma once
+
+#ifdef ZIMG_GENERIC_SIMD
+
+#ifndef ZIMG_DEPTH_GENERIC_SIMD_DEPTH_CONVERT_GENERIC_SIMD_H_
+#define ZIMG_DEPTH_GENERIC_SIMD_DEPTH_CONVERT_GENERIC_SIMD_H_
+
+#include "depth/depth_convert.h"
+
+namespace zimg {
+namespace depth {
+
+left_shift_func select_left_shift_func_generic_simd(PixelType pixel_in, PixelType pixel_out, CPUClass cpu);
+
+depth_convert_func select_depth_convert_func_generic_simd(const PixelFormat &format_in, const PixelFormat &format_out, CPUClass cpu);
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_DEPTH_GENERIC_SIMD_DEPTH_CONVERT_GENERIC_SIMD_H_
+
+#endif // ZIMG_GENERIC_SIMD
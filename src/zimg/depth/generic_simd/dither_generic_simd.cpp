@@ -0,0 +1,94 @@
+#ifdef ZIMG_GENERIC_SIMD
+
+#include <cstdint>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "dither_generic_simd.h"
+
+#include "common/generic_simd/generic_simd_util.h"
+
+namespace zimg {
+namespace depth {
+
+namespace {
+
+inline FORCE_INLINE vf32x8 load_dither_8(const float *dither, unsigned dither_offset, unsigned dither_mask, unsigned j)
+{
+	float tmp[8];
+
+	for (unsigned n = 0; n < 8; ++n) {
+		tmp[n] = dither[(dither_offset + j + n) & dither_mask];
+	}
+	return vec8_load_f32(tmp);
+}
+
+inline FORCE_INLINE vi32x8 dither_quantize(vf32x8 x, vf32x8 d, const vf32x8 &scale, const vf32x8 &offset, const vf32x8 &out_max)
+{
+	x = x * scale + offset;
+	x = x + d;
+	x = vec8_max_f32(x, vec8_set1_f32(0.0f));
+	x = vec8_min_f32(x, out_max);
+	return vec8_round_u23(x);
+}
+
+template <class T, class U>
+void ordered_dither_generic_simd(const float *dither, unsigned dither_offset, unsigned dither_mask,
+                                 const void *src, void *dst, float scale, float offset, unsigned bits, unsigned left, unsigned right)
+{
+	const T *src_p = static_cast<const T *>(src);
+	U *dst_p = static_cast<U *>(dst);
+
+	const vf32x8 scale_v = vec8_set1_f32(scale);
+	const vf32x8 offset_v = vec8_set1_f32(offset);
+	const vf32x8 out_max = vec8_set1_f32(static_cast<float>(1UL << bits) - 1);
+
+	unsigned vec_right = left + floor_n(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		vf32x8 x = vec8_load_f32(src_p + j);
+		vf32x8 d = load_dither_8(dither, dither_offset, dither_mask, j);
+		vec8_store(dst_p + j, dither_quantize(x, d, scale_v, offset_v, out_max));
+	}
+	if (right != vec_right) {
+		vf32x8 x = vec8_load_f32_n(src_p + vec_right, right - vec_right);
+		vf32x8 d = load_dither_8(dither, dither_offset, dither_mask, vec_right);
+		vec8_store_n(dst_p + vec_right, dither_quantize(x, d, scale_v, offset_v, out_max), right - vec_right);
+	}
+}
+
+} // namespace
+
+
+dither_convert_func select_ordered_dither_func_generic_simd(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu)
+{
+	PixelType type_in = pixel_in.type;
+	PixelType type_out = pixel_out.type;
+
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return nullptr;
+
+	if (type_in == PixelType::HALF)
+		type_in = PixelType::FLOAT;
+
+	if (type_in == PixelType::BYTE && type_out == PixelType::BYTE)
+		return ordered_dither_generic_simd<uint8_t, uint8_t>;
+	else if (type_in == PixelType::BYTE && type_out == PixelType::WORD)
+		return ordered_dither_generic_simd<uint8_t, uint16_t>;
+	else if (type_in == PixelType::WORD && type_out == PixelType::BYTE)
+		return ordered_dither_generic_simd<uint16_t, uint8_t>;
+	else if (type_in == PixelType::WORD && type_out == PixelType::WORD)
+		return ordered_dither_generic_simd<uint16_t, uint16_t>;
+	else if (type_in == PixelType::FLOAT && type_out == PixelType::BYTE)
+		return ordered_dither_generic_simd<float, uint8_t>;
+	else if (type_in == PixelType::FLOAT && type_out == PixelType::WORD)
+		return ordered_dither_generic_simd<float, uint16_t>;
+	else
+		return nullptr;
+}
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_GENERIC_SIMD
@@ -0,0 +1,20 @@
+#pragma once
+
+#ifdef ZIMG_GENERIC_SIMD
+
+#ifndef ZIMG_DEPTH_GENERIC_SIMD_DITHER_GENERIC_SIMD_H_
+#define ZIMG_DEPTH_GENERIC_SIMD_DITHER_GENERIC_SIMD_H_
+
+#include "depth/dither.h"
+
+namespace zimg {
+namespace depth {
+
+dither_convert_func select_ordered_dither_func_generic_simd(const PixelFormat &pixel_in, const PixelFormat &pixel_out, CPUClass cpu);
+
+} // namespace depth
+} // namespace zimg
+
+#endif // ZIMG_DEPTH_GENERIC_SIMD_DITHER_GENERIC_SIMD_H_
+
+#endif // ZIMG_GENERIC_SIMD
@@ -495,6 +495,8 @@ public:
 		std::tie(m_scale, m_offset) = get_scale_offset(format_in, format_out);
 	}
 
+	const char *get_name() const override { return "error_diffusion_avx2"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -10,6 +10,11 @@ CopyFilter::CopyFilter(unsigned width, unsigned height, PixelType type, bool col
 	m_color{ color }
 {}
 
+const char *CopyFilter::get_name() const
+{
+	return "copy";
+}
+
 auto CopyFilter::get_flags() const -> filter_flags
 {
 	filter_flags flags{};
@@ -18,6 +18,8 @@ class CopyFilter : public ImageFilterBase {
 public:
 	CopyFilter(unsigned width, unsigned height, PixelType type, bool color = false);
 
+	const char *get_name() const override;
+
 	filter_flags get_flags() const override;
 
 	image_attributes get_image_attributes() const override;
@@ -1,9 +1,19 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <climits>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <stdexcept>
+#include <thread>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 #include "common/align.h"
 #include "common/alloc.h"
@@ -14,6 +24,7 @@
 #include "common/zassert.h"
 #include "copy_filter.h"
 #include "filtergraph.h"
+#include "fused_filter.h"
 #include "image_filter.h"
 
 namespace zimg {
@@ -28,6 +39,8 @@ public:
 		m_rgb{ rgb }
 	{}
 
+	const char *get_name() const override { return "color_extend"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags = CopyFilter::get_flags();
@@ -82,6 +95,8 @@ public:
 			m_value.f = 0.0f;
 	}
 
+	const char *get_name() const override { return "chroma_initialize"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -321,7 +336,7 @@ protected:
 	{
 		auto attr = get_image_attributes();
 
-		ctx->cache_pos = 0;
+		ctx->cache_pos = UINT_MAX;
 		ctx->source_left = attr.width;
 		ctx->source_right = 0;
 	}
@@ -332,6 +347,7 @@ public:
 	unsigned get_cache_id() const { return m_cache_id; }
 
 	void add_ref() { ++m_ref_count; }
+	void remove_ref() { --m_ref_count; }
 	unsigned get_ref() const { return m_ref_count; }
 
 	unsigned get_cache_lines(ExecutionStrategy strategy) const { return m_cache_lines[static_cast<int>(strategy)]; }
@@ -345,12 +361,27 @@ public:
 
 	virtual bool entire_row() const = 0;
 
+	virtual bool has_state() const = 0;
+
+	virtual unsigned get_simultaneous_lines() const = 0;
+
+	virtual const ImageFilter *get_filter() const = 0;
+
 	virtual void request_external_cache(unsigned id) = 0;
 
+	/**
+	 * Merge the parent node into this node if both are per-pixel filters.
+	 *
+	 * @return merged node, or nullptr if no merge was possible
+	 */
+	virtual GraphNode *fuse_parent() = 0;
+
 	virtual void complete() = 0;
 
 	virtual void simulate(SimulationState *state, unsigned first, unsigned last, bool uv) = 0;
 
+	virtual unsigned get_simulation_pos(const SimulationState *state, unsigned cache_id) const = 0;
+
 	virtual size_t get_context_size(ExecutionStrategy strategy) const = 0;
 
 	virtual size_t get_tmp_size(unsigned left, unsigned right) const = 0;
@@ -361,6 +392,8 @@ public:
 
 	virtual void set_tile_region(ExecutionState *state, unsigned left, unsigned right, bool uv) const = 0;
 
+	virtual void set_row_region(ExecutionState *state, unsigned top, bool uv) const = 0;
+
 	virtual void generate_line(ExecutionState *state, unsigned i, bool uv) const = 0;
 };
 
@@ -372,14 +405,20 @@ public:
 	ImageFilter::image_attributes get_image_attributes() const override { return m_attr; }
 	ImageFilter::image_attributes get_image_attributes(bool uv) const override { return m_attr; }
 	bool entire_row() const override { return false; }
+	bool has_state() const override { return false; }
+	unsigned get_simultaneous_lines() const override { return 1; }
+	const ImageFilter *get_filter() const override { return nullptr; }
 	void request_external_cache(unsigned) override {}
+	GraphNode *fuse_parent() override { return nullptr; }
 	void complete() override {}
 	void simulate(SimulationState *, unsigned, unsigned, bool) override {}
+	unsigned get_simulation_pos(const SimulationState *, unsigned) const override { return 0; }
 	size_t get_context_size(ExecutionStrategy) const override { return 0; }
 	size_t get_tmp_size(unsigned, unsigned) const override { return 0; }
 	void init_context(ExecutionState *, ExecutionStrategy) const override {}
 	void reset_context(ExecutionState *) const override {}
 	void set_tile_region(ExecutionState *, unsigned, unsigned, bool) const override {}
+	void set_row_region(ExecutionState *, unsigned, bool) const override {}
 	void generate_line(ExecutionState *, unsigned, bool) const override {}
 };
 
@@ -410,11 +449,19 @@ public:
 
 	bool entire_row() const override { return false; }
 
+	bool has_state() const override { return false; }
+
+	unsigned get_simultaneous_lines() const override { return 1U << m_subsample_h; }
+
+	const ImageFilter *get_filter() const override { return nullptr; }
+
 	void request_external_cache(unsigned id) override
 	{
 		zassert_d(false, "attempt to set external cache on source node");
 	}
 
+	GraphNode *fuse_parent() override { return nullptr; }
+
 	void complete() override {}
 
 	void simulate(SimulationState *state, unsigned first, unsigned last, bool uv) override
@@ -433,6 +480,8 @@ public:
 		update_cache_state(state, pos - first);
 	}
 
+	unsigned get_simulation_pos(const SimulationState *, unsigned) const override { return 0; }
+
 	size_t get_context_size(ExecutionStrategy) const override { return 0; }
 	size_t get_tmp_size(unsigned left, unsigned right) const override { return 0; }
 
@@ -450,6 +499,14 @@ public:
 		context->source_right = std::max(context->source_right, right);
 	}
 
+	void set_row_region(ExecutionState *state, unsigned top, bool uv) const override
+	{
+		auto *context = state->get_node_state(get_id());
+
+		top <<= uv ? m_subsample_h : 0;
+		context->cache_pos = std::min(context->cache_pos, floor_n(top, 1U << m_subsample_h));
+	}
+
 	void generate_line(ExecutionState *state, unsigned i, bool uv) const override
 	{
 		auto *context = state->get_node_state(get_id());
@@ -507,6 +564,28 @@ protected:
 		checked_size_t size = rowsize * get_real_cache_lines(strategy) * num_planes;
 		return size.get();
 	}
+
+	FilterNode *get_fusable_parent() const
+	{
+		// The parent must be of the same node type and have no other consumers.
+		if (typeid(*m_parent) != typeid(*this) || m_parent->get_ref() > 1 || m_parent->has_external_buffer())
+			return nullptr;
+
+		FilterNode *parent = static_cast<FilterNode *>(m_parent);
+		if (!filter_is_fusable(*m_filter) || !filter_is_fusable_head(*parent->m_filter))
+			return nullptr;
+
+		return parent;
+	}
+
+	void merge_parent(FilterNode *parent)
+	{
+		m_filter = std::make_shared<FusedFilter>(parent->m_filter, std::move(m_filter));
+		m_flags = m_filter->get_flags();
+		m_parent = parent->m_parent;
+		m_step = m_filter->get_simultaneous_lines();
+		parent->remove_ref();
+	}
 public:
 	FilterNode(unsigned id, std::shared_ptr<ImageFilter> filter, GraphNode *parent) :
 		GraphNode(id),
@@ -521,6 +600,12 @@ public:
 
 	bool entire_row() const override { return m_flags.entire_row || m_parent->entire_row(); }
 
+	bool has_state() const override { return m_flags.has_state || m_flags.entire_plane; }
+
+	unsigned get_simultaneous_lines() const override { return m_step; }
+
+	const ImageFilter *get_filter() const override { return m_filter.get(); }
+
 	void request_external_cache(unsigned id) override
 	{
 		if (m_parent->get_cache_id() == get_cache_id())
@@ -529,6 +614,14 @@ public:
 		set_cache_id(id);
 	}
 
+	GraphNode *fuse_parent() override
+	{
+		FilterNode *parent = get_fusable_parent();
+		if (parent)
+			merge_parent(parent);
+		return parent;
+	}
+
 	void complete() override
 	{
 		if (is_inplace_capable(m_parent))
@@ -546,7 +639,16 @@ public:
 
 		state[get_id()].pos = pos;
 		state[get_id()].hit = true;
-		update_cache_state(state, pos - first);
+		update_cache_state(state, get_simulation_pos(state, get_cache_id()) - first);
+	}
+
+	unsigned get_simulation_pos(const SimulationState *state, unsigned cache_id) const override
+	{
+		// Filters writing in-place to the same cache may run ahead of this node.
+		if (get_cache_id() != cache_id)
+			return 0;
+
+		return std::max(state[get_id()].pos, m_parent->get_simulation_pos(state, cache_id));
 	}
 
 	size_t get_tmp_size(unsigned left, unsigned right) const override
@@ -565,6 +667,20 @@ public:
 
 		m_parent->set_tile_region(state, range.first, range.second, uv);
 	}
+
+	void set_row_region(ExecutionState *state, unsigned top, bool uv) const override
+	{
+		auto *context = state->get_node_state(get_id());
+		unsigned pos = floor_n(top, m_step);
+
+		// Rows are requested in ascending order, so the region of the parent
+		// is already established by any earlier starting row.
+		if (pos >= context->cache_pos)
+			return;
+
+		context->cache_pos = pos;
+		m_parent->set_row_region(state, m_filter->get_required_row_range(pos).first, uv);
+	}
 };
 
 class LumaNode final : public FilterNode {
@@ -621,6 +737,12 @@ public:
 		FilterNode::set_tile_region(state, left, right, false);
 	}
 
+	void set_row_region(ExecutionState *state, unsigned top, bool uv) const override
+	{
+		zassert_d(!uv, "request for chroma plane on luma node");
+		FilterNode::set_row_region(state, top, false);
+	}
+
 	void generate_line(ExecutionState *state, unsigned i, bool uv) const override
 	{
 		zassert_d(!uv, "request for chroma plane on luma node");
@@ -647,15 +769,40 @@ public:
 };
 
 class ChromaNode final : public FilterNode {
+	// Filter for the V plane, if different from the U plane.
+	std::shared_ptr<ImageFilter> m_filter_v;
 	size_t m_filter_ctx_size;
+
+	const std::shared_ptr<ImageFilter> &filter_v() const { return m_filter_v ? m_filter_v : m_filter; }
 public:
-	ChromaNode(unsigned id, std::shared_ptr<ImageFilter> filter, GraphNode *parent) :
+	ChromaNode(unsigned id, std::shared_ptr<ImageFilter> filter, std::shared_ptr<ImageFilter> filter_v, GraphNode *parent) :
 		FilterNode(id, std::move(filter), parent),
+		m_filter_v{ std::move(filter_v) },
 		m_filter_ctx_size{}
 	{
 		m_filter_ctx_size = m_filter->get_context_size();
 	}
 
+	GraphNode *fuse_parent() override
+	{
+		FilterNode *parent = get_fusable_parent();
+		if (!parent)
+			return nullptr;
+
+		const ChromaNode *parent_uv = static_cast<ChromaNode *>(parent);
+
+		if (m_filter_v || parent_uv->m_filter_v) {
+			if (!filter_is_fusable(*filter_v()) || !filter_is_fusable_head(*parent_uv->filter_v()))
+				return nullptr;
+
+			m_filter_v = std::make_shared<FusedFilter>(parent_uv->filter_v(), filter_v());
+		}
+
+		merge_parent(parent);
+		m_filter_ctx_size = m_filter->get_context_size();
+		return parent;
+	}
+
 	ImageFilter::image_attributes get_image_attributes(bool uv) const override
 	{
 		zassert_d(uv, "request for luma plane on chroma node");
@@ -675,8 +822,7 @@ public:
 
 		FakeAllocator alloc;
 
-		alloc.allocate(m_filter->get_context_size());
-		alloc.allocate(m_filter->get_context_size());
+		alloc.allocate(m_filter_ctx_size + filter_v()->get_context_size());
 		if (get_cache_id() == get_id())
 			alloc.allocate(get_cache_size(strategy, 2));
 
@@ -691,21 +837,24 @@ public:
 		if (get_cache_id() == get_id())
 			state->alloc_cache(get_cache_id(), get_cache_stride(), get_real_cache_lines(strategy), select_zimg_buffer_mask(get_cache_lines(strategy)), enabled_planes);
 
-		size_t filter_ctx_size = m_filter->get_context_size();
-		void *filter_ctx = state->alloc_context(get_id(), m_filter->get_context_size() * 2);
+		void *filter_ctx = state->alloc_context(get_id(), m_filter_ctx_size + filter_v()->get_context_size());
 
 		m_filter->init_context(filter_ctx);
-		m_filter->init_context(static_cast<unsigned char *>(filter_ctx) + filter_ctx_size);
+		filter_v()->init_context(static_cast<unsigned char *>(filter_ctx) + m_filter_ctx_size);
 	}
 
 	void reset_context(ExecutionState *state) const override
 	{
-		size_t filter_ctx_size = m_filter->get_context_size();
 		void *filter_ctx = state->get_context(get_id());
 
 		reset_cache_context(state->get_node_state(get_id()));
 		m_filter->init_context(filter_ctx);
-		m_filter->init_context(static_cast<unsigned char *>(filter_ctx) + filter_ctx_size);
+		filter_v()->init_context(static_cast<unsigned char *>(filter_ctx) + m_filter_ctx_size);
+	}
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		return std::max(FilterNode::get_tmp_size(left, right), filter_v()->get_tmp_size(left, right));
 	}
 
 	void set_tile_region(ExecutionState *state, unsigned left, unsigned right, bool uv) const override
@@ -714,6 +863,12 @@ public:
 		FilterNode::set_tile_region(state, left, right, true);
 	}
 
+	void set_row_region(ExecutionState *state, unsigned top, bool uv) const override
+	{
+		zassert_d(uv, "request for luma plane on chroma node");
+		FilterNode::set_row_region(state, top, true);
+	}
+
 	void generate_line(ExecutionState *state, unsigned i, bool uv) const
 	{
 		zassert_d(uv, "request for luma plane on chroma node");
@@ -737,7 +892,7 @@ public:
 
 			m_filter->process(filter_ctx_u, input_buffer + 1, output_buffer + 1, state->get_tmp(), pos, context->source_left, context->source_right);
 			state->check_guard();
-			m_filter->process(filter_ctx_v, input_buffer + 2, output_buffer + 2, state->get_tmp(), pos, context->source_left, context->source_right);
+			filter_v()->process(filter_ctx_v, input_buffer + 2, output_buffer + 2, state->get_tmp(), pos, context->source_left, context->source_right);
 			state->check_guard();
 		}
 		context->cache_pos = pos;
@@ -767,6 +922,19 @@ public:
 		set_cache_id(id);
 	}
 
+	GraphNode *fuse_parent() override
+	{
+		if (m_parent != m_parent_uv)
+			return nullptr;
+
+		FilterNode *parent = get_fusable_parent();
+		if (parent) {
+			m_parent_uv = static_cast<ColorNode *>(parent)->m_parent_uv;
+			merge_parent(parent);
+		}
+		return parent;
+	}
+
 	void complete() override
 	{
 		if (is_inplace_capable(m_parent) && is_inplace_capable(m_parent_uv)) {
@@ -787,7 +955,18 @@ public:
 
 		state[get_id()].hit = true;
 		state[get_id()].pos = pos;
-		update_cache_state(state, pos - first);
+		update_cache_state(state, get_simulation_pos(state, get_cache_id()) - first);
+	}
+
+	unsigned get_simulation_pos(const SimulationState *state, unsigned cache_id) const override
+	{
+		if (get_cache_id() != cache_id)
+			return 0;
+
+		unsigned pos = state[get_id()].pos;
+		pos = std::max(pos, m_parent->get_simulation_pos(state, cache_id));
+		pos = std::max(pos, m_parent_uv->get_simulation_pos(state, cache_id));
+		return pos;
 	}
 
 	size_t get_context_size(ExecutionStrategy strategy) const override
@@ -844,6 +1023,21 @@ public:
 		m_parent_uv->set_tile_region(state, range.first, range.second, true);
 	}
 
+	void set_row_region(ExecutionState *state, unsigned top, bool) const override
+	{
+		auto *context = state->get_node_state(get_id());
+		unsigned pos = floor_n(top, m_step);
+
+		if (pos >= context->cache_pos)
+			return;
+
+		context->cache_pos = pos;
+
+		auto range = m_filter->get_required_row_range(pos);
+		m_parent->set_row_region(state, range.first, false);
+		m_parent_uv->set_row_region(state, range.first, true);
+	}
+
 	void generate_line(ExecutionState *state, unsigned i, bool uv) const override
 	{
 		auto *context = state->get_node_state(get_id());
@@ -884,6 +1078,13 @@ public:
 
 class FilterGraph::impl {
 	static constexpr unsigned TILE_WIDTH_MIN = 128;
+	static constexpr unsigned BAND_HEIGHT_MIN = 32;
+
+	// Location of a plane within the buffer of another plane.
+	struct plane_alias {
+		unsigned plane;
+		size_t offset;
+	};
 
 	std::vector<std::unique_ptr<GraphNode>> m_node_set;
 	GraphNode *m_head;
@@ -895,9 +1096,19 @@ class FilterGraph::impl {
 	unsigned m_subsample_w;
 	unsigned m_subsample_h;
 	unsigned m_tile_width;
+	unsigned m_tile_width_hint;
+	unsigned m_concurrent_graphs;
+	size_t m_input_row_size[3];
+	size_t m_output_row_size[3];
 	bool m_color_input;
 	bool m_color_filter;
+	bool m_packed_input;
+	bool m_packed_output;
+	plane_alias m_input_alias[3];
+	plane_alias m_output_alias[3];
+	unsigned m_output_pixel_group;
 	bool m_requires_64b_alignment;
+	bool m_fusion_disabled;
 	bool m_is_complete;
 
 	void check_incomplete() const
@@ -912,6 +1123,50 @@ class FilterGraph::impl {
 			error::throw_<error::InternalError>("cannot query properties on incomplete graph");
 	}
 
+	// Size in bytes of the rows of an input plane, or zero if not accessed.
+	size_t get_input_row_size(unsigned p) const
+	{
+		if (m_packed_input)
+			return m_input_row_size[p];
+		if (p && !m_color_input)
+			return 0;
+
+		auto attr = m_head->get_image_attributes(p != 0);
+		return static_cast<size_t>(attr.width) * pixel_size(attr.type);
+	}
+
+	// Size in bytes of the rows of an output plane, or zero if not accessed.
+	size_t get_output_row_size(unsigned p) const
+	{
+		if (m_packed_output)
+			return m_output_row_size[p];
+		if (p && !m_node_uv)
+			return 0;
+
+		auto attr = p ? m_node_uv->get_image_attributes(true) : m_node->get_image_attributes(false);
+		return static_cast<size_t>(attr.width) * pixel_size(attr.type);
+	}
+
+	// Merge chains of per-pixel filters, so that intermediate lines are not
+	// written to the node caches.
+	void fuse_nodes()
+	{
+		std::vector<GraphNode *> fused;
+
+		// Nodes are stored in topological order, so parents are merged first.
+		for (const auto &node : m_node_set) {
+			while (GraphNode *parent = node->fuse_parent()) {
+				fused.push_back(parent);
+			}
+		}
+
+		auto is_fused = [&](const std::unique_ptr<GraphNode> &node)
+		{
+			return std::find(fused.begin(), fused.end(), node.get()) != fused.end();
+		};
+		m_node_set.erase(std::remove_if(m_node_set.begin(), m_node_set.end(), is_fused), m_node_set.end());
+	}
+
 	size_t get_tmp_size(ExecutionStrategy strategy, unsigned tile_width) const
 	{
 		auto attr = m_node->get_image_attributes(false);
@@ -960,18 +1215,38 @@ class FilterGraph::impl {
 		checked_size_t tmp = get_tmp_size(strategy, output_attr.width);
 
 		if (strategy == ExecutionStrategy::LUMA || strategy == ExecutionStrategy::COLOR) {
-			tmp += ceil_n(static_cast<checked_size_t>(input_attr.width) * pixel_size(input_attr.type), ALIGNMENT) * input_buffering;
-			tmp += ceil_n(static_cast<checked_size_t>(output_attr.width) * pixel_size(output_attr.type), ALIGNMENT) * output_buffering;
+			tmp += ceil_n(static_cast<checked_size_t>(get_input_row_size(0)), ALIGNMENT) * input_buffering;
+			tmp += ceil_n(static_cast<checked_size_t>(get_output_row_size(0)), ALIGNMENT) * output_buffering;
 		}
 		if (m_color_input && (strategy == ExecutionStrategy::CHROMA || strategy == ExecutionStrategy::COLOR))
-			tmp += ceil_n(static_cast<checked_size_t>(input_attr.width >> m_input_subsample_w) * pixel_size(input_attr.type), ALIGNMENT) * (input_buffering >> m_input_subsample_h);
+			tmp += ceil_n(static_cast<checked_size_t>(get_input_row_size(1)), ALIGNMENT) * (input_buffering >> m_input_subsample_h);
 		if (m_node_uv && (strategy == ExecutionStrategy::CHROMA || strategy == ExecutionStrategy::COLOR))
-			tmp += ceil_n(static_cast<checked_size_t>(output_attr.width >> m_subsample_w) * pixel_size(output_attr.type), ALIGNMENT) * (output_buffering >> m_subsample_h);
+			tmp += ceil_n(static_cast<checked_size_t>(get_output_row_size(1)), ALIGNMENT) * (output_buffering >> m_subsample_h);
 
 		return tmp.get();
 	}
 
-	unsigned get_tile_width(ExecutionStrategy strategy) const
+	static size_t get_worker_cache_size(unsigned workers)
+	{
+		static const CacheHierarchy cache = cpu_cache_hierarchy();
+		static const unsigned processors = resolve_thread_count(0);
+
+		// Workers are assumed to be distributed evenly across processors, so
+		// each cache is shared by its proportion of the active workers,
+		// including workers of concurrent graphs.
+		auto sharers = [=](unsigned cache_threads)
+		{
+			unsigned long n = (static_cast<unsigned long>(workers) * cache_threads + processors - 1) / processors;
+			return std::max(n, 1UL);
+		};
+
+		unsigned long private_cache = cache.l2 ? cache.l2 / sharers(cache.l2_threads) : cache.l1d / sharers(cache.l1d_threads);
+		unsigned long shared_cache = cache.l3 ? cache.l3 / sharers(cache.l3_threads) : 0;
+
+		return private_cache + shared_cache;
+	}
+
+	unsigned get_tile_width(ExecutionStrategy strategy, unsigned threads = 1, bool callbacks = false) const
 	{
 		bool entire_row = m_node->entire_row() || (m_node_uv && m_node_uv->entire_row());
 		auto attr = m_node->get_image_attributes();
@@ -979,163 +1254,398 @@ class FilterGraph::impl {
 		if (entire_row)
 			return attr.width;
 		if (m_tile_width)
-			return m_tile_width;
+			return std::min(ceil_n(m_tile_width, m_output_pixel_group), attr.width);
 
-		size_t processor_cache = cpu_cache_size();
-		size_t footprint = get_cache_footprint(strategy);
+		unsigned tile_width;
 
-		unsigned tile_width = static_cast<unsigned>(std::lrint(static_cast<double>(attr.width) * processor_cache / footprint));
+		if (m_tile_width_hint) {
+			// A measured width replaces the cache model, but is still divided
+			// among the threads below.
+			tile_width = m_tile_width_hint;
+		} else {
+			// Concurrent graphs each run the same number of workers.
+			size_t processor_cache = get_worker_cache_size(threads * m_concurrent_graphs);
+			size_t footprint = get_cache_footprint(strategy);
+
+			tile_width = static_cast<unsigned>(std::lrint(static_cast<double>(attr.width) * processor_cache / footprint));
+
+			if (tile_width > attr.width * 5 / 4)
+				tile_width = attr.width;
+			else if (tile_width > attr.width / 2)
+				tile_width = ceil_n(attr.width / 2, ALIGNMENT);
+			else if (tile_width > attr.width / 3)
+				tile_width = ceil_n(attr.width / 3, ALIGNMENT);
+			else
+				tile_width = std::max(floor_n(tile_width, ALIGNMENT), TILE_WIDTH_MIN + 0);
+		}
 
-		if (tile_width > attr.width * 5 / 4)
-			tile_width = attr.width;
-		else if (tile_width > attr.width / 2)
-			tile_width = ceil_n(attr.width / 2, ALIGNMENT);
-		else if (tile_width > attr.width / 3)
-			tile_width = ceil_n(attr.width / 3, ALIGNMENT);
-		else
-			tile_width = std::max(floor_n(tile_width, ALIGNMENT), TILE_WIDTH_MIN + 0);
+		// Provide at least one tile per thread, unless the frame can also be
+		// divided into row bands.
+		if (threads > 1 && !can_process_bands(callbacks)) {
+			unsigned tile_width_mt = ceil_n((attr.width + threads - 1) / threads, ALIGNMENT);
+			tile_width = std::min(tile_width, std::max(tile_width_mt, TILE_WIDTH_MIN + 0));
+		}
 
-		return tile_width;
+		return std::min(ceil_n(tile_width, m_output_pixel_group), attr.width);
 	}
 
-	void process_color(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb) const
+	static unsigned gcd(unsigned a, unsigned b)
 	{
-		ExecutionState state{ m_id_counter, tmp, unpack_cb, pack_cb };
-		auto attr = m_node->get_image_attributes(false);
-		unsigned h_step = get_tile_width(ExecutionStrategy::COLOR);
-		unsigned v_step = 1U << m_subsample_h;
-
-		ColorImageBuffer<void> src_;
-		ColorImageBuffer<void> dst_;
+		while (b) {
+			unsigned t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
 
-		for (unsigned p = 0; p < 3; ++p) {
-			src_[p] = { const_cast<void *>(src[p].data()), src[p].stride(), src[p].mask() };
-			dst_[p] = dst[p];
+	bool has_state() const
+	{
+		for (const auto &node : m_node_set) {
+			if (node->has_state())
+				return true;
 		}
+		return false;
+	}
 
-		state.set_external_buffer(m_head->get_id(), src_);
-		state.set_external_buffer(m_node->get_id(), dst_);
-		if (m_node_uv && m_node != m_node_uv)
-			state.set_external_buffer(m_node_uv->get_id(), dst_);
+	bool can_process_bands(bool callbacks) const
+	{
+		// Bands recompute the rows above them, which would invoke the callbacks
+		// more than once, possibly concurrently, for the same rows.
+		return !callbacks && !has_state();
+	}
 
+	unsigned get_band_alignment() const
+	{
+		unsigned alignment = 1U << m_subsample_h;
+
+		// Bands overlap in intermediate buffers, but each output row must be
+		// written by exactly one band. This includes filters operating in-place
+		// on the output buffer.
 		for (const auto &node : m_node_set) {
-			node->init_context(&state, ExecutionStrategy::COLOR);
+			unsigned cache_id = node->get_cache_id();
+
+			if (cache_id == m_node->get_cache_id() || (m_node_uv && cache_id == m_node_uv->get_cache_id())) {
+				unsigned step = node->get_simultaneous_lines() << m_subsample_h;
+				alignment = alignment / gcd(alignment, step) * step;
+			}
 		}
+		return alignment;
+	}
 
-		for (unsigned j = 0; j < attr.width; j += h_step) {
-			unsigned j_end = std::min(j + h_step, attr.width);
+	unsigned get_band_height(unsigned tile_width, unsigned threads, bool callbacks) const
+	{
+		auto attr = m_node->get_image_attributes(false);
 
-			if (attr.width - j_end < TILE_WIDTH_MIN) {
-				j_end = attr.width;
-				h_step = attr.width - j;
-			}
+		if (threads <= 1 || !can_process_bands(callbacks))
+			return attr.height;
 
-			for (const auto &node : m_node_set) {
-				node->reset_context(&state);
-			}
+		// Use enough bands to divide the tiles evenly among the threads.
+		unsigned num_tiles = get_num_tiles(attr.width, tile_width);
+		unsigned num_bands = threads / gcd(threads, num_tiles);
+		unsigned band_height = (attr.height + num_bands - 1) / num_bands;
 
-			m_node->set_tile_region(&state, j, j_end, false);
-			if (m_node_uv)
-				m_node_uv->set_tile_region(&state, j >> m_subsample_w, j_end >> m_subsample_w, true);
+		band_height = ceil_n(std::max(band_height, BAND_HEIGHT_MIN + 0), get_band_alignment());
+		return std::min(band_height, attr.height);
+	}
 
-			for (unsigned i = 0; i < attr.height; i += v_step) {
-				for (unsigned ii = i; ii < i + v_step; ++ii) {
-					m_node->generate_line(&state, ii, false);
-				}
-				if (m_node_uv)
-					m_node_uv->generate_line(&state, i >> m_subsample_h, true);
+	static unsigned get_num_tiles(unsigned width, unsigned tile_width)
+	{
+		unsigned num_tiles = 0;
 
-				if (state.get_pack_cb())
-					state.get_pack_cb()(i, j, j_end);
-			}
+		for (unsigned j = 0; j < width; j += tile_width) {
+			++num_tiles;
+
+			if (width - std::min(j + tile_width, width) < TILE_WIDTH_MIN)
+				break;
 		}
+		return num_tiles;
+	}
+
+	static std::pair<unsigned, unsigned> get_tile_bounds(unsigned width, unsigned tile_width, unsigned n)
+	{
+		unsigned left = n * tile_width;
+		unsigned right = std::min(left + tile_width, width);
+
+		if (width - right < TILE_WIDTH_MIN)
+			right = width;
+
+		return{ left, right };
 	}
 
-	void process_luma(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp) const
+	static unsigned get_num_bands(unsigned height, unsigned band_height)
 	{
-		ExecutionState state{ m_id_counter, tmp, nullptr, nullptr };
+		return (height + band_height - 1) / band_height;
+	}
+
+	static std::pair<unsigned, unsigned> get_band_bounds(unsigned height, unsigned band_height, unsigned n)
+	{
+		unsigned top = n * band_height;
+		return{ top, std::min(top + band_height, height) };
+	}
+
+	static unsigned resolve_thread_count(unsigned threads)
+	{
+		if (!threads)
+			threads = std::thread::hardware_concurrency();
+
+		return threads ? threads : 1;
+	}
+
+	unsigned get_strategies(ExecutionStrategy strategies[2], bool callbacks) const
+	{
+		// Luma and chroma samples stored in the same output words must be
+		// written by the same worker.
+		bool shared_output = m_output_alias[1].plane == 0 || m_output_alias[2].plane == 0;
+
+		if (m_color_filter || callbacks || shared_output) {
+			strategies[0] = ExecutionStrategy::COLOR;
+			return 1;
+		}
+
+		strategies[0] = ExecutionStrategy::LUMA;
+		strategies[1] = ExecutionStrategy::CHROMA;
+		return m_node_uv ? 2 : 1;
+	}
+
+	unsigned get_parallel_tasks(unsigned threads, bool callbacks) const
+	{
+		ExecutionStrategy strategies[2];
+		unsigned num_strategies = get_strategies(strategies, callbacks);
 		auto attr = m_node->get_image_attributes(false);
-		unsigned step = get_tile_width(ExecutionStrategy::LUMA);
+		unsigned num_tasks = 0;
 
+		for (unsigned s = 0; s < num_strategies; ++s) {
+			unsigned tile_width = get_tile_width(strategies[s], threads, callbacks);
+			unsigned num_tiles = get_num_tiles(attr.width, tile_width);
+			unsigned num_bands = get_num_bands(attr.height, get_band_height(tile_width, threads, callbacks));
+			num_tasks += num_tiles * num_bands;
+		}
+		return num_tasks;
+	}
+
+	size_t get_worker_tmp_size(unsigned threads, bool callbacks) const
+	{
+		ExecutionStrategy strategies[2];
+		unsigned num_strategies = get_strategies(strategies, callbacks);
+		size_t tmp_size = 0;
+
+		for (unsigned s = 0; s < num_strategies; ++s) {
+			tmp_size = std::max(tmp_size, get_tmp_size(strategies[s], get_tile_width(strategies[s], threads, callbacks)));
+		}
+		return tmp_size;
+	}
+
+	void init_execution_state(ExecutionState *state, ExecutionStrategy strategy, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[]) const
+	{
 		ColorImageBuffer<void> src_;
 		ColorImageBuffer<void> dst_;
 
+		// Planes stored within the buffer of another plane start at an offset
+		// from that buffer.
 		for (unsigned p = 0; p < 3; ++p) {
-			src_[p] = { const_cast<void *>(src[p].data()), src[p].stride(), src[p].mask() };
-			dst_[p] = dst[p];
+			const ImageBuffer<const void> &src_base = src[m_input_alias[p].plane];
+			const ImageBuffer<void> &dst_base = dst[m_output_alias[p].plane];
+
+			src_[p] = { static_cast<unsigned char *>(const_cast<void *>(src_base.data())) + m_input_alias[p].offset, src_base.stride(), src_base.mask() };
+			dst_[p] = { static_cast<unsigned char *>(dst_base.data()) + m_output_alias[p].offset, dst_base.stride(), dst_base.mask() };
 		}
 
-		state.set_external_buffer(m_head->get_id(), src_);
-		state.set_external_buffer(m_node->get_id(), dst_);
+		state->set_external_buffer(m_head->get_id(), src_);
+		state->set_external_buffer(m_node->get_id(), dst_);
 		if (m_node_uv && m_node != m_node_uv)
-			state.set_external_buffer(m_node_uv->get_id(), dst_);
+			state->set_external_buffer(m_node_uv->get_id(), dst_);
 
 		for (const auto &node : m_node_set) {
-			node->init_context(&state, ExecutionStrategy::LUMA);
+			node->init_context(state, strategy);
 		}
+	}
 
-		for (unsigned j = 0; j < attr.width; j += step) {
-			unsigned j_end = std::min(j + step, attr.width);
-
-			if (attr.width - j_end < TILE_WIDTH_MIN) {
-				j_end = attr.width;
-				step = attr.width - j;
-			}
+	void process_tile(ExecutionState *state, ExecutionStrategy strategy, unsigned left, unsigned right, unsigned top, unsigned bottom) const
+	{
+		bool luma = strategy == ExecutionStrategy::LUMA || strategy == ExecutionStrategy::COLOR;
+		bool chroma = m_node_uv && (strategy == ExecutionStrategy::CHROMA || strategy == ExecutionStrategy::COLOR);
+		unsigned v_step = strategy == ExecutionStrategy::LUMA ? 1U : 1U << m_subsample_h;
 
-			for (const auto &node : m_node_set) {
-				node->reset_context(&state);
-			}
+		for (const auto &node : m_node_set) {
+			node->reset_context(state);
+		}
 
-			m_node->set_tile_region(&state, j, j_end, false);
+		if (luma) {
+			m_node->set_tile_region(state, left, right, false);
+			m_node->set_row_region(state, top, false);
+		}
+		if (chroma) {
+			m_node_uv->set_tile_region(state, left >> m_subsample_w, right >> m_subsample_w, true);
+			m_node_uv->set_row_region(state, top >> m_subsample_h, true);
+		}
 
-			for (unsigned i = 0; i < attr.height; ++i) {
-				m_node->generate_line(&state, i, false);
+		for (unsigned i = top; i < bottom; i += v_step) {
+			if (luma) {
+				for (unsigned ii = i; ii < i + v_step; ++ii) {
+					m_node->generate_line(state, ii, false);
+				}
 			}
+			if (chroma)
+				m_node_uv->generate_line(state, i >> m_subsample_h, true);
+
+			if (state->get_pack_cb())
+				state->get_pack_cb()(i, left, right);
 		}
 	}
 
-	void process_chroma(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp) const
+	void process_serial(ExecutionStrategy strategy, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb) const
 	{
-		ExecutionState state{ m_id_counter, tmp, nullptr, nullptr };
+		ExecutionState state{ m_id_counter, tmp, unpack_cb, pack_cb };
 		auto attr = m_node->get_image_attributes(false);
-		unsigned h_step = get_tile_width(ExecutionStrategy::CHROMA);
-		unsigned v_step = 1U << m_subsample_h;
+		unsigned tile_width = get_tile_width(strategy);
+		unsigned num_tiles = get_num_tiles(attr.width, tile_width);
 
-		ColorImageBuffer<void> src_;
-		ColorImageBuffer<void> dst_;
+		init_execution_state(&state, strategy, src, dst);
 
-		for (unsigned p = 0; p < 3; ++p) {
-			src_[p] = { const_cast<void *>(src[p].data()), src[p].stride(), src[p].mask() };
-			dst_[p] = dst[p];
+		for (unsigned n = 0; n < num_tiles; ++n) {
+			auto bounds = get_tile_bounds(attr.width, tile_width, n);
+			process_tile(&state, strategy, bounds.first, bounds.second, 0, attr.height);
 		}
+	}
 
-		state.set_external_buffer(m_head->get_id(), src_);
-		state.set_external_buffer(m_node->get_id(), dst_);
-		if (m_node_uv && m_node != m_node_uv)
-			state.set_external_buffer(m_node_uv->get_id(), dst_);
+	template <class T>
+	static void run_threads(T &worker, unsigned workers)
+	{
+		std::vector<std::thread> pool;
 
-		for (const auto &node : m_node_set) {
-			node->init_context(&state, ExecutionStrategy::CHROMA);
+		// Tiles are distributed dynamically, so any threads that fail to start
+		// simply leave more work to the remaining threads.
+		try {
+			pool.reserve(workers - 1);
+			for (unsigned n = 1; n < workers; ++n) {
+				pool.emplace_back(std::ref(worker), n);
+			}
+		} catch (...) {
 		}
 
-		for (unsigned j = 0; j < attr.width; j += h_step) {
-			unsigned j_end = std::min(j + h_step, attr.width);
+		worker(0);
 
-			if (attr.width - j_end < TILE_WIDTH_MIN) {
-				j_end = attr.width;
-				h_step = attr.width - j;
+		for (auto &th : pool) {
+			th.join();
+		}
+	}
+
+	template <class T>
+	static void run_scheduler(T &worker, unsigned workers, const scheduler &sched)
+	{
+		struct task {
+			T *worker;
+			unsigned id;
+
+			static void run(void *ptr)
+			{
+				task *t = static_cast<task *>(ptr);
+				(*t->worker)(t->id);
 			}
+		};
 
-			for (const auto &node : m_node_set) {
-				node->reset_context(&state);
+		std::vector<task> tasks;
+		unsigned submitted = 0;
+
+		// As with threads, tasks rejected by the scheduler leave more work to
+		// the accepted tasks and the calling thread.
+		try {
+			tasks.reserve(workers - 1);
+			for (unsigned n = 1; n < workers; ++n) {
+				tasks.push_back({ &worker, n });
 			}
+		} catch (...) {
+			tasks.clear();
+		}
 
-			m_node_uv->set_tile_region(&state, j >> m_subsample_w, j_end >> m_subsample_w, true);
+		for (auto &t : tasks) {
+			if (!sched.submit(task::run, &t))
+				break;
+			++submitted;
+		}
+
+		worker(0);
+
+		if (submitted)
+			sched.wait();
+	}
+
+	void process_parallel(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb, unsigned threads, unsigned workers, const scheduler *sched) const
+	{
+		ExecutionStrategy strategies[2];
+		unsigned num_strategies = get_strategies(strategies, unpack_cb || pack_cb);
+		auto attr = m_node->get_image_attributes(false);
+
+		unsigned tile_width[2] = {};
+		unsigned band_height[2] = {};
+		unsigned num_tiles[2] = {};
+		unsigned num_tasks[2] = {};
+		std::atomic_uint counter[2];
+
+		for (unsigned s = 0; s < num_strategies; ++s) {
+			tile_width[s] = get_tile_width(strategies[s], threads, unpack_cb || pack_cb);
+			band_height[s] = get_band_height(tile_width[s], threads, unpack_cb || pack_cb);
+			num_tiles[s] = get_num_tiles(attr.width, tile_width[s]);
+			num_tasks[s] = num_tiles[s] * get_num_bands(attr.height, band_height[s]);
+			counter[s] = 0;
+		}
+
+		size_t worker_tmp_size = get_worker_tmp_size(threads, unpack_cb || pack_cb);
+		std::atomic_bool failed{ false };
+		std::exception_ptr eptr;
+		std::mutex mutex;
+
+		auto worker = [&](unsigned id)
+		{
+			void *worker_tmp = static_cast<unsigned char *>(tmp) + worker_tmp_size * id;
+
+			try {
+				for (unsigned s = 0; s < num_strategies; ++s) {
+					ExecutionState state{ m_id_counter, worker_tmp, unpack_cb, pack_cb };
+					bool initialized = false;
+					unsigned n;
+
+					while (!failed && (n = counter[s]++) < num_tasks[s]) {
+						if (!initialized) {
+							init_execution_state(&state, strategies[s], src, dst);
+							initialized = true;
+						}
+
+						auto cols = get_tile_bounds(attr.width, tile_width[s], n % num_tiles[s]);
+						auto rows = get_band_bounds(attr.height, band_height[s], n / num_tiles[s]);
+						process_tile(&state, strategies[s], cols.first, cols.second, rows.first, rows.second);
+					}
+				}
+			} catch (...) {
+				std::lock_guard<std::mutex> lock{ mutex };
 
-			for (unsigned i = 0; i < attr.height; i += v_step) {
-				m_node_uv->generate_line(&state, i >> m_subsample_h, true);
+				if (!eptr)
+					eptr = std::current_exception();
+				failed = true;
 			}
+		};
+
+		if (sched)
+			run_scheduler(worker, workers, *sched);
+		else
+			run_threads(worker, workers);
+
+		if (eptr)
+			std::rethrow_exception(eptr);
+	}
+
+	bool can_process_parallel(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[]) const
+	{
+		// Tiles share the input and output buffers, which must therefore hold
+		// the entire image to prevent tiles from overwriting each other.
+		for (unsigned p = 0; p < 3; ++p) {
+			if (get_input_row_size(p) && src[p].mask() != BUFFER_MAX)
+				return false;
+			if (get_output_row_size(p) && dst[p].mask() != BUFFER_MAX)
+				return false;
 		}
+		return true;
 	}
 public:
 	impl(unsigned width, unsigned height, PixelType type, unsigned subsample_w, unsigned subsample_h, bool color) :
@@ -1148,9 +1658,19 @@ public:
 		m_subsample_w{},
 		m_subsample_h{},
 		m_tile_width{},
+		m_tile_width_hint{},
+		m_concurrent_graphs{ 1 },
+		m_input_row_size{},
+		m_output_row_size{},
 		m_color_input{ color },
 		m_color_filter{},
+		m_packed_input{},
+		m_packed_output{},
+		m_input_alias{ { 0, 0 }, { 1, 0 }, { 2, 0 } },
+		m_output_alias{ { 0, 0 }, { 1, 0 }, { 2, 0 } },
+		m_output_pixel_group{ 1 },
 		m_requires_64b_alignment{},
+		m_fusion_disabled{},
 		m_is_complete{}
 	{
 		zassert_d(width <= pixel_max_width(type), "image stride causes overflow");
@@ -1207,17 +1727,19 @@ public:
 			parent_uv->add_ref();
 	}
 
-	void attach_filter_uv(std::shared_ptr<ImageFilter> filter)
+	void attach_filter_uv(std::shared_ptr<ImageFilter> filter, std::shared_ptr<ImageFilter> filter_v = nullptr)
 	{
 		check_incomplete();
 
-		if (filter->get_flags().color)
+		if (filter->get_flags().color || (filter_v && filter_v->get_flags().color))
 			error::throw_<error::InternalError>("cannot use color filter as UV filter");
+		if (filter_v && (filter->get_image_attributes() != filter_v->get_image_attributes() || filter->get_simultaneous_lines() != filter_v->get_simultaneous_lines()))
+			error::throw_<error::InternalError>("cannot use mismatching U and V filters");
 
 		GraphNode *parent = m_node_uv;
 
 		m_node_set.reserve(m_node_set.size() + 1);
-		m_node_set.emplace_back(ztd::make_unique<ChromaNode>(m_id_counter++, std::move(filter), parent));
+		m_node_set.emplace_back(ztd::make_unique<ChromaNode>(m_id_counter++, std::move(filter), std::move(filter_v), parent));
 		m_node_uv = m_node_set.back().get();
 
 		parent->add_ref();
@@ -1257,8 +1779,66 @@ public:
 		m_requires_64b_alignment = true;
 	}
 
+	void disable_fusion()
+	{
+		check_incomplete();
+		m_fusion_disabled = true;
+	}
+
+	void set_input_row_size(const size_t row_size[3])
+	{
+		check_incomplete();
+		std::copy_n(row_size, 3, m_input_row_size);
+		m_packed_input = true;
+	}
+
+	void set_output_row_size(const size_t row_size[3])
+	{
+		check_incomplete();
+		std::copy_n(row_size, 3, m_output_row_size);
+		m_packed_output = true;
+	}
+
+	void set_input_plane_alias(unsigned p, unsigned base, size_t offset)
+	{
+		check_incomplete();
+
+		if (!m_color_input)
+			error::throw_<error::InternalError>("greyscale images have no chroma planes");
+		if (p == 0 || p > 2 || base >= p)
+			error::throw_<error::InternalError>("plane can only alias an earlier plane");
+
+		m_input_alias[p] = { base, offset };
+	}
+
+	void set_output_plane_alias(unsigned p, unsigned base, size_t offset)
+	{
+		check_incomplete();
+
+		if (!m_node_uv)
+			error::throw_<error::InternalError>("greyscale images have no chroma planes");
+		if (p == 0 || p > 2 || base >= p)
+			error::throw_<error::InternalError>("plane can only alias an earlier plane");
+
+		m_output_alias[p] = { base, offset };
+	}
+
+	void set_output_pixel_group(unsigned group)
+	{
+		check_incomplete();
+		m_output_pixel_group = group;
+	}
+
 	void set_tile_width(unsigned tile_width) { m_tile_width = tile_width; }
 
+	void set_tile_width_hint(unsigned tile_width) { m_tile_width_hint = tile_width; }
+
+	void set_concurrent_graphs(unsigned count)
+	{
+		check_incomplete();
+		m_concurrent_graphs = std::max(count, 1U);
+	}
+
 	void complete()
 	{
 		check_incomplete();
@@ -1294,6 +1874,9 @@ public:
 		if (m_node_uv)
 			m_node_uv->set_external_buffer();
 
+		if (!m_fusion_disabled)
+			fuse_nodes();
+
 		// Finalize node connections.
 		for (const auto &node : m_node_set) {
 			node->complete();
@@ -1335,6 +1918,8 @@ public:
 		m_is_complete = true;
 	}
 
+	bool is_complete() const { return m_is_complete; }
+
 	size_t get_tmp_size() const
 	{
 		check_complete();
@@ -1385,18 +1970,219 @@ public:
 		return get_tile_width(ExecutionStrategy::COLOR);
 	}
 
+	unsigned get_filter_count() const
+	{
+		check_complete();
+		return static_cast<unsigned>(std::count_if(m_node_set.begin(), m_node_set.end(), [](const std::unique_ptr<GraphNode> &node)
+		{
+			return node->get_filter() != nullptr;
+		}));
+	}
+
+	unsigned long long signature() const
+	{
+		check_complete();
+
+		// 64-bit FNV-1a.
+		unsigned long long hash = 14695981039346656037ULL;
+
+		auto hash_bytes = [&](const void *data, size_t size)
+		{
+			const unsigned char *ptr = static_cast<const unsigned char *>(data);
+			for (size_t i = 0; i < size; ++i) {
+				hash ^= ptr[i];
+				hash *= 1099511628211ULL;
+			}
+		};
+		auto hash_uint = [&](unsigned x)
+		{
+			unsigned char bytes[4] = { static_cast<unsigned char>(x), static_cast<unsigned char>(x >> 8), static_cast<unsigned char>(x >> 16), static_cast<unsigned char>(x >> 24) };
+			hash_bytes(bytes, sizeof(bytes));
+		};
+
+		hash_uint(m_input_subsample_w | (m_input_subsample_h << 4) | (m_subsample_w << 8) | (m_subsample_h << 12));
+		hash_uint(m_color_input | (m_color_filter << 1) | (m_requires_64b_alignment << 2));
+
+		for (const auto &node : m_node_set) {
+			auto attr = node->get_image_attributes();
+
+			hash_uint(node->get_id());
+			hash_uint(attr.width);
+			hash_uint(attr.height);
+			hash_uint(static_cast<unsigned>(attr.type));
+			hash_uint(node->get_simultaneous_lines());
+
+			// Filter names identify both the operation and the instruction set,
+			// and the buffering distinguishes filters of different support.
+			auto hash_filter = [&](const ImageFilter &filter)
+			{
+				const char *name = filter.get_name();
+
+				hash_bytes(name, std::strlen(name) + 1);
+				hash_uint(filter.get_simultaneous_lines());
+				hash_uint(filter.get_max_buffering());
+			};
+
+			if (const ImageFilter *filter = node->get_filter()) {
+				ImageFilter::filter_flags flags = filter->get_flags();
+
+				hash_filter(*filter);
+				if (const FusedFilter *fused = dynamic_cast<const FusedFilter *>(filter)) {
+					for (const auto &stage : fused->get_stages()) {
+						hash_filter(*stage);
+					}
+				}
+				hash_uint(flags.has_state | (flags.same_row << 1) | (flags.in_place << 2) | (flags.entire_row << 3) | (flags.entire_plane << 4) | (flags.color << 5));
+			}
+		}
+
+		return hash;
+	}
+
+	unsigned benchmark_tile_width()
+	{
+		static constexpr unsigned TILE_COUNT_MAX = 8;
+		static constexpr unsigned BENCHMARK_CYCLES = 3;
+
+		check_complete();
+
+		auto attr = m_node->get_image_attributes();
+		if (m_node->entire_row() || (m_node_uv && m_node_uv->entire_row()))
+			return attr.width;
+
+		unsigned saved_tile_width = m_tile_width;
+		unsigned saved_tile_width_hint = m_tile_width_hint;
+		m_tile_width = 0;
+		m_tile_width_hint = 0;
+
+		std::vector<unsigned> candidates{ get_tile_width(ExecutionStrategy::COLOR) };
+		for (unsigned n = 1; n <= TILE_COUNT_MAX; ++n) {
+			unsigned tile_width = n == 1 ? attr.width : ceil_n(attr.width / n, ALIGNMENT);
+
+			if (tile_width < TILE_WIDTH_MIN)
+				break;
+			if (std::find(candidates.begin(), candidates.end(), tile_width) == candidates.end())
+				candidates.push_back(tile_width);
+		}
+
+		if (candidates.size() == 1) {
+			m_tile_width = saved_tile_width;
+			m_tile_width_hint = saved_tile_width_hint;
+			return candidates.front();
+		}
+
+		auto input_attr = m_head->get_image_attributes();
+		AlignedVector<unsigned char> src_data[3];
+		AlignedVector<unsigned char> dst_data[3];
+		AlignedVector<unsigned char> tmp;
+		ImageBuffer<const void> src[3];
+		ImageBuffer<void> dst[3];
+
+		for (unsigned p = 0; p < 3; ++p) {
+			if (!get_input_row_size(p))
+				continue;
+
+			unsigned height = input_attr.height >> (p ? m_input_subsample_h : 0);
+			size_t stride = ceil_n(static_cast<checked_size_t>(get_input_row_size(p)), ALIGNMENT).get();
+
+			src_data[p].resize((static_cast<checked_size_t>(stride) * height).get());
+			src[p] = ImageBuffer<const void>{ src_data[p].data(), static_cast<ptrdiff_t>(stride), BUFFER_MAX };
+		}
+		for (unsigned p = 0; p < 3; ++p) {
+			if (!get_output_row_size(p))
+				continue;
+
+			unsigned height = attr.height >> (p ? m_subsample_h : 0);
+			size_t stride = ceil_n(static_cast<checked_size_t>(get_output_row_size(p)), ALIGNMENT).get();
+
+			dst_data[p].resize((static_cast<checked_size_t>(stride) * height).get());
+			dst[p] = ImageBuffer<void>{ dst_data[p].data(), static_cast<ptrdiff_t>(stride), BUFFER_MAX };
+		}
+
+		unsigned best_tile_width = candidates.front();
+		double best_time = INFINITY;
+
+		try {
+			for (unsigned tile_width : candidates) {
+				m_tile_width = tile_width;
+				tmp.resize(get_tmp_size());
+
+				double elapsed = INFINITY;
+
+				for (unsigned n = 0; n < BENCHMARK_CYCLES; ++n) {
+					auto start = std::chrono::steady_clock::now();
+					process(src, dst, tmp.data(), nullptr, nullptr);
+					auto end = std::chrono::steady_clock::now();
+
+					elapsed = std::min(elapsed, std::chrono::duration<double>(end - start).count());
+				}
+
+				if (elapsed < best_time) {
+					best_tile_width = tile_width;
+					best_time = elapsed;
+				}
+			}
+		} catch (...) {
+			m_tile_width = saved_tile_width;
+			m_tile_width_hint = saved_tile_width_hint;
+			throw;
+		}
+
+		m_tile_width = saved_tile_width;
+		m_tile_width_hint = saved_tile_width_hint;
+		return best_tile_width;
+	}
+
+	size_t get_tmp_size_mt(unsigned threads) const
+	{
+		check_complete();
+
+		threads = resolve_thread_count(threads);
+		if (threads == 1)
+			return get_tmp_size();
+
+		size_t tmp_size = get_tmp_size();
+
+		// Callbacks force the color strategy, which may have different tiling.
+		for (unsigned x = 0; x < 2; ++x) {
+			bool callbacks = !!x;
+			unsigned workers = std::min(threads, get_parallel_tasks(threads, callbacks));
+			checked_size_t size = get_worker_tmp_size(threads, callbacks);
+
+			try {
+				tmp_size = std::max(tmp_size, (size * workers).get());
+			} catch (const std::overflow_error &) {
+				error::throw_<error::OutOfMemory>();
+			}
+		}
+
+		return tmp_size;
+	}
+
 	void process(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb) const
 	{
 		check_complete();
 
-		if (m_color_filter || unpack_cb || pack_cb) {
-			process_color(src, dst, tmp, unpack_cb, pack_cb);
-		} else {
-			process_luma(src, dst, tmp);
-			if (m_node_uv)
-				process_chroma(src, dst, tmp);
+		ExecutionStrategy strategies[2];
+		unsigned num_strategies = get_strategies(strategies, unpack_cb || pack_cb);
+
+		for (unsigned s = 0; s < num_strategies; ++s) {
+			process_serial(strategies[s], src, dst, tmp, unpack_cb, pack_cb);
 		}
 	}
+
+	void process_mt(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb, unsigned threads, const scheduler *sched) const
+	{
+		check_complete();
+
+		threads = resolve_thread_count(threads);
+		unsigned workers = std::min(threads, get_parallel_tasks(threads, unpack_cb || pack_cb));
+
+		if (workers <= 1 || !can_process_parallel(src, dst))
+			process(src, dst, tmp, unpack_cb, pack_cb);
+		else
+			process_parallel(src, dst, tmp, unpack_cb, pack_cb, threads, workers, sched);
+	}
 };
 
 
@@ -1422,10 +2208,36 @@ void FilterGraph::callback::operator()(unsigned i, unsigned left, unsigned right
 }
 
 
+FilterGraph::scheduler::scheduler(submit_func submit, wait_func wait, void *user) : m_submit{ submit }, m_wait{ wait }, m_user{ user } {}
+
+bool FilterGraph::scheduler::submit(task_func func, void *task) const
+{
+	int ret;
+
+	try {
+		ret = m_submit(m_user, func, task);
+	} catch (...) {
+		ret = 1;
+		zassert_d(false, "user scheduler must not throw");
+	}
+
+	return !ret;
+}
+
+void FilterGraph::scheduler::wait() const
+{
+	// Tasks may still reference the caller's stack, so there is no way to
+	// recover from an exception thrown here.
+	m_wait(m_user);
+}
+
+
 FilterGraph::FilterGraph(unsigned width, unsigned height, PixelType type, unsigned subsample_w, unsigned subsample_h, bool color) :
 	m_impl{ ztd::make_unique<impl>(width, height, type, subsample_w, subsample_h, color) }
 {}
 
+FilterGraph::FilterGraph(std::shared_ptr<impl> impl) noexcept : m_impl{ std::move(impl) } {}
+
 FilterGraph::FilterGraph(FilterGraph &&other) noexcept = default;
 
 FilterGraph::~FilterGraph() = default;
@@ -1442,6 +2254,11 @@ void FilterGraph::attach_filter_uv(std::shared_ptr<ImageFilter> filter)
 	get_impl()->attach_filter_uv(std::move(filter));
 }
 
+void FilterGraph::attach_filter_uv(std::shared_ptr<ImageFilter> filter_u, std::shared_ptr<ImageFilter> filter_v)
+{
+	get_impl()->attach_filter_uv(std::move(filter_u), std::move(filter_v));
+}
+
 void FilterGraph::color_to_grey()
 {
 	get_impl()->color_to_grey();
@@ -1457,16 +2274,64 @@ void FilterGraph::set_requires_64b_alignment()
 	get_impl()->set_requires_64b_alignment();
 }
 
+void FilterGraph::disable_fusion()
+{
+	get_impl()->disable_fusion();
+}
+
+void FilterGraph::set_input_row_size(const size_t row_size[3])
+{
+	get_impl()->set_input_row_size(row_size);
+}
+
+void FilterGraph::set_output_row_size(const size_t row_size[3])
+{
+	get_impl()->set_output_row_size(row_size);
+}
+
+void FilterGraph::set_input_plane_alias(unsigned p, unsigned base, size_t offset)
+{
+	get_impl()->set_input_plane_alias(p, base, offset);
+}
+
+void FilterGraph::set_output_plane_alias(unsigned p, unsigned base, size_t offset)
+{
+	get_impl()->set_output_plane_alias(p, base, offset);
+}
+
+void FilterGraph::set_output_pixel_group(unsigned group)
+{
+	get_impl()->set_output_pixel_group(group);
+}
+
 void FilterGraph::set_tile_width(unsigned tile_width)
 {
 	get_impl()->set_tile_width(tile_width);
 }
 
+void FilterGraph::set_tile_width_hint(unsigned tile_width)
+{
+	get_impl()->set_tile_width_hint(tile_width);
+}
+
+void FilterGraph::set_concurrent_graphs(unsigned count)
+{
+	get_impl()->set_concurrent_graphs(count);
+}
+
 void FilterGraph::complete()
 {
 	get_impl()->complete();
 }
 
+std::unique_ptr<FilterGraph> FilterGraph::share() const
+{
+	if (!get_impl()->is_complete())
+		error::throw_<error::InternalError>("cannot share incomplete graph");
+
+	return std::unique_ptr<FilterGraph>{ new FilterGraph{ m_impl } };
+}
+
 size_t FilterGraph::get_tmp_size() const
 {
 	return get_impl()->get_tmp_size();
@@ -1492,10 +2357,40 @@ unsigned FilterGraph::tile_width() const
 	return get_impl()->tile_width();
 }
 
+unsigned FilterGraph::get_filter_count() const
+{
+	return get_impl()->get_filter_count();
+}
+
+unsigned long long FilterGraph::signature() const
+{
+	return get_impl()->signature();
+}
+
+unsigned FilterGraph::benchmark_tile_width()
+{
+	return get_impl()->benchmark_tile_width();
+}
+
 void FilterGraph::process(const ImageBuffer<const void> *src, const ImageBuffer<void> *dst, void *tmp, callback unpack_cb, callback pack_cb) const
 {
 	get_impl()->process(src, dst, tmp, unpack_cb, pack_cb);
 }
 
+size_t FilterGraph::get_tmp_size_mt(unsigned threads) const
+{
+	return get_impl()->get_tmp_size_mt(threads);
+}
+
+void FilterGraph::process_mt(const ImageBuffer<const void> *src, const ImageBuffer<void> *dst, void *tmp, callback unpack_cb, callback pack_cb, unsigned threads) const
+{
+	get_impl()->process_mt(src, dst, tmp, unpack_cb, pack_cb, threads, nullptr);
+}
+
+void FilterGraph::process_mt(const ImageBuffer<const void> *src, const ImageBuffer<void> *dst, void *tmp, callback unpack_cb, callback pack_cb, unsigned workers, const scheduler &sched) const
+{
+	get_impl()->process_mt(src, dst, tmp, unpack_cb, pack_cb, workers, &sched);
+}
+
 } // namespace graph
 } // namespace zimg
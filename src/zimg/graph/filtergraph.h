@@ -3,6 +3,7 @@
 #ifndef ZIMG_GRAPH_FILTERGRAPH_H_
 #define ZIMG_GRAPH_FILTERGRAPH_H_
 
+#include <cstddef>
 #include <memory>
 
 // Base class in global namespace for API export.
@@ -69,8 +70,47 @@ public:
 		 */
 		void operator()(unsigned i, unsigned left, unsigned right) const;
 	};
+
+	/**
+	 * User-defined task scheduler, used to execute work on a host thread pool.
+	 */
+	class scheduler {
+	public:
+		typedef void (*task_func)(void *task);
+		typedef int (*submit_func)(void *user, task_func func, void *task);
+		typedef void (*wait_func)(void *user);
+	private:
+		submit_func m_submit;
+		wait_func m_wait;
+		void *m_user;
+	public:
+		/**
+		 * Construct a scheduler from user-defined functions.
+		 *
+		 * @param submit function to enqueue a task
+		 * @param wait function to wait for all enqueued tasks
+		 * @param user user private data
+		 */
+		scheduler(submit_func submit, wait_func wait, void *user);
+
+		/**
+		 * Enqueue a task for execution.
+		 *
+		 * @param func task function
+		 * @param task task data
+		 * @return true if the task was accepted, else false
+		 */
+		bool submit(task_func func, void *task) const;
+
+		/**
+		 * Wait for all accepted tasks to complete.
+		 */
+		void wait() const;
+	};
 private:
-	std::unique_ptr<impl> m_impl;
+	std::shared_ptr<impl> m_impl;
+
+	explicit FilterGraph(std::shared_ptr<impl> impl) noexcept;
 
 	impl *get_impl() noexcept { return m_impl.get(); }
 	const impl *get_impl() const noexcept { return m_impl.get(); }
@@ -124,6 +164,16 @@ public:
 	 */
 	void attach_filter_uv(std::shared_ptr<ImageFilter> filter);
 
+	/**
+	 * Attach separate filters to the U and V channels.
+	 *
+	 * The filters must have identical image attributes.
+	 *
+	 * @param filter_u filter for U channel
+	 * @param filter_v filter for V channel
+	 */
+	void attach_filter_uv(std::shared_ptr<ImageFilter> filter_u, std::shared_ptr<ImageFilter> filter_v);
+
 	/**
 	 * Discard the chroma channels of the graph.
 	 */
@@ -147,6 +197,62 @@ public:
 	 */
 	void set_requires_64b_alignment();
 
+	/**
+	 * Execute each filter separately, instead of merging chains of per-pixel
+	 * filters. Used to compare the output of fused filters.
+	 */
+	void disable_fusion();
+
+	/**
+	 * Set the size of the rows read from the input buffers.
+	 *
+	 * Required if the first filter reads a packed format, in which the rows
+	 * differ in size from the image width. Planes of size zero are not read.
+	 *
+	 * @param row_size size of the rows of each plane in bytes
+	 */
+	void set_input_row_size(const size_t row_size[3]);
+
+	/**
+	 * Set the size of the rows written to the output buffers.
+	 *
+	 * @see set_input_row_size
+	 */
+	void set_output_row_size(const size_t row_size[3]);
+
+	/**
+	 * Read an input plane from the buffer of an earlier plane.
+	 *
+	 * The plane is addressed at the given offset from the start of the buffer,
+	 * with the stride of the buffer. This is used by formats storing several
+	 * planes in one buffer, such as interleaved chroma.
+	 *
+	 * @param p plane index
+	 * @param base index of plane containing the samples
+	 * @param offset offset in bytes
+	 */
+	void set_input_plane_alias(unsigned p, unsigned base, size_t offset);
+
+	/**
+	 * Write an output plane to the buffer of an earlier plane.
+	 *
+	 * If a chroma plane is written to the luma buffer, the luma and chroma
+	 * planes are processed together.
+	 *
+	 * @see set_input_plane_alias
+	 */
+	void set_output_plane_alias(unsigned p, unsigned base, size_t offset);
+
+	/**
+	 * Align the tiles of the output to groups of pixels.
+	 *
+	 * Required by formats storing the samples of adjacent pixels in the same
+	 * word, which must not be written by different tiles concurrently.
+	 *
+	 * @param group number of pixels
+	 */
+	void set_output_pixel_group(unsigned group);
+
 	/**
 	 * Override the tile width used for graph execution.
 	 *
@@ -154,6 +260,29 @@ public:
 	 */
 	void set_tile_width(unsigned tile_width);
 
+	/**
+	 * Set the tile width used for single-threaded graph execution.
+	 *
+	 * Unlike {@link set_tile_width}, the width is still reduced to provide at
+	 * least one tile per thread when executed concurrently. A tile width set
+	 * by {@link set_tile_width} takes precedence.
+	 *
+	 * @param tile_width tile width in output pixels, or zero to use the cache
+	 *                   model
+	 */
+	void set_tile_width_hint(unsigned tile_width);
+
+	/**
+	 * Set the number of graphs expected to execute concurrently.
+	 *
+	 * Concurrent graphs share the processor caches, so that narrower tiles are
+	 * selected as the count increases. Each graph is assumed to run the same
+	 * number of threads.
+	 *
+	 * @param count number of graphs, including this graph
+	 */
+	void set_concurrent_graphs(unsigned count);
+
 	/**
 	 * Finalize graph.
 	 *
@@ -162,6 +291,17 @@ public:
 	 */
 	void complete();
 
+	/**
+	 * Create a graph sharing the execution plan of a finalized graph.
+	 *
+	 * Finalized graphs are not modified by execution, so the returned graph
+	 * may be used concurrently with the original. The tile width must not be
+	 * changed on either graph once shared.
+	 *
+	 * @return graph
+	 */
+	std::unique_ptr<FilterGraph> share() const;
+
 	/**
 	 * Get size of temporary buffer required to execute graph.
 	 *
@@ -197,6 +337,36 @@ public:
 	 */
 	unsigned tile_width() const;
 
+	/**
+	 * Get number of filters executed by the graph.
+	 *
+	 * Filters merged into a fused filter are counted once.
+	 *
+	 * @return number of filters
+	 */
+	unsigned get_filter_count() const;
+
+	/**
+	 * Get a hash identifying the structure of the graph.
+	 *
+	 * Graphs with equal signatures execute the same filters on the same image
+	 * dimensions, and can be expected to perform identically.
+	 *
+	 * @return signature
+	 */
+	unsigned long long signature() const;
+
+	/**
+	 * Measure the execution speed of the graph on a range of tile widths.
+	 *
+	 * The graph is executed on scratch buffers allocated for the entire frame.
+	 * The tile widths set by {@link set_tile_width} and
+	 * {@link set_tile_width_hint} are not modified.
+	 *
+	 * @return fastest tile width in output pixels
+	 */
+	unsigned benchmark_tile_width();
+
 	/**
 	 * Process an image frame with filter graph.
 	 *
@@ -207,6 +377,54 @@ public:
 	 * @param pack_cb user-defined output callback
 	 */
 	void process(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb) const;
+
+	/**
+	 * Get size of temporary buffer required to execute graph on multiple threads.
+	 *
+	 * @param threads number of threads, or zero to use all processors
+	 * @return size in bytes
+	 */
+	size_t get_tmp_size_mt(unsigned threads) const;
+
+	/**
+	 * Process an image frame with filter graph, dividing the frame into tiles
+	 * that are executed concurrently. If no filter in the graph has state and
+	 * no callbacks are given, the frame is also divided into bands of rows,
+	 * recomputing the lines needed by vertical filters at the top of each
+	 * band.
+	 *
+	 * Tiles are only executed concurrently if the input and output buffers
+	 * contain the entire image. Otherwise, the frame is processed serially on
+	 * the calling thread. If executed concurrently, the user-defined callbacks
+	 * may be invoked simultaneously from multiple threads, but each is invoked
+	 * only once for any row and column.
+	 *
+	 * @param src pointer to input buffers
+	 * @param dst pointer to output buffers
+	 * @param tmp temporary buffer of size {@link get_tmp_size_mt}
+	 * @param unpack_cb user-defined input callback
+	 * @param pack_cb user-defined output callback
+	 * @param threads number of threads, or zero to use all processors
+	 */
+	void process_mt(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb, unsigned threads) const;
+
+	/**
+	 * Process an image frame with filter graph, dividing the frame into tiles
+	 * that are executed by a user-defined scheduler.
+	 *
+	 * Up to workers - 1 tasks are submitted to the scheduler, and one
+	 * additional share of the work is executed on the calling thread. The
+	 * same restrictions as {@link process_mt} apply.
+	 *
+	 * @param src pointer to input buffers
+	 * @param dst pointer to output buffers
+	 * @param tmp temporary buffer of size {@link get_tmp_size_mt}
+	 * @param unpack_cb user-defined input callback
+	 * @param pack_cb user-defined output callback
+	 * @param workers maximum number of concurrent tasks, or zero to use all processors
+	 * @param sched task scheduler
+	 */
+	void process_mt(const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, callback unpack_cb, callback pack_cb, unsigned workers, const scheduler &sched) const;
 };
 
 } // namespace graph
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include "common/align.h"
+#include "common/checked_int.h"
+#include "common/except.h"
+#include "common/pixel.h"
+#include "fused_filter.h"
+
+namespace zimg {
+namespace graph {
+
+namespace {
+
+// Limit the intermediate buffer of filters producing several lines per call.
+constexpr unsigned MAX_HEAD_LINES = 8;
+
+} // namespace
+
+
+bool filter_is_fusable(const ImageFilter &filter)
+{
+	ImageFilter::filter_flags flags = filter.get_flags();
+	auto attr = filter.get_image_attributes();
+
+	if (!flags.same_row || flags.has_state || flags.entire_row || flags.entire_plane)
+		return false;
+	if (filter.get_simultaneous_lines() != 1 || filter.get_required_row_range(0) != ImageFilter::pair_unsigned{ 0, 1 })
+		return false;
+
+	// Probe both the full row and an interior span to detect horizontal support.
+	if (filter.get_required_col_range(0, attr.width) != ImageFilter::pair_unsigned{ 0, attr.width })
+		return false;
+	if (filter.get_required_col_range(attr.width / 2, attr.width) != ImageFilter::pair_unsigned{ attr.width / 2, attr.width })
+		return false;
+
+	return true;
+}
+
+bool filter_is_fusable_head(const ImageFilter &filter)
+{
+	ImageFilter::filter_flags flags = filter.get_flags();
+
+	if (flags.has_state || flags.entire_row || flags.entire_plane)
+		return false;
+	if (filter.get_simultaneous_lines() > MAX_HEAD_LINES)
+		return false;
+
+	return true;
+}
+
+
+FusedFilter::FusedFilter(std::shared_ptr<ImageFilter> first, std::shared_ptr<ImageFilter> second) :
+	m_flags{},
+	m_num_planes{},
+	m_num_buffers{},
+	m_buffer_lines{},
+	m_buffer_mask{},
+	m_buffer_pixel_size{}
+{
+	for (auto *filter : { &first, &second }) {
+		if (const FusedFilter *fused = dynamic_cast<const FusedFilter *>(filter->get()))
+			m_stages.insert(m_stages.end(), fused->m_stages.begin(), fused->m_stages.end());
+		else
+			m_stages.push_back(std::move(*filter));
+	}
+
+	bool color = m_stages.front()->get_flags().color;
+	unsigned width = m_stages.front()->get_image_attributes().width;
+	unsigned height = m_stages.front()->get_image_attributes().height;
+
+	for (const auto &stage : m_stages) {
+		auto attr = stage->get_image_attributes();
+
+		if (stage == m_stages.front() ? !filter_is_fusable_head(*stage) : !filter_is_fusable(*stage))
+			error::throw_<error::InternalError>("filter is not a per-pixel operation");
+		if (stage->get_flags().color != color)
+			error::throw_<error::InternalError>("cannot fuse color and greyscale filters");
+		if (attr.width != width || attr.height != height)
+			error::throw_<error::InternalError>("cannot fuse filters with different dimensions");
+	}
+
+	for (size_t n = 0; n < m_stages.size() - 1; ++n) {
+		m_buffer_pixel_size = std::max(m_buffer_pixel_size, pixel_size(m_stages[n]->get_image_attributes().type));
+	}
+
+	// Output is written only by the last stage, so in-place operation is
+	// possible if the first stage reads from the same row.
+	m_flags.same_row = m_stages.front()->get_flags().same_row;
+	m_flags.in_place = m_flags.same_row;
+	m_flags.color = color;
+
+	m_num_planes = color ? 3 : 1;
+	m_num_buffers = m_stages.size() > 2 ? 2 : 1;
+	m_buffer_lines = m_stages.front()->get_simultaneous_lines();
+	m_buffer_mask = select_zimg_buffer_mask(m_buffer_lines);
+}
+
+size_t FusedFilter::get_padding_size() const
+{
+	// Stages address the intermediate buffers with absolute column indices.
+	// Reserve space before the buffers, which is never accessed, so that the
+	// buffer pointers can be offset by the column of a chunk.
+	return ceil_n(static_cast<size_t>(get_image_attributes().width) * m_buffer_pixel_size, ALIGNMENT);
+}
+
+size_t FusedFilter::get_buffer_size() const
+{
+	return ceil_n(static_cast<size_t>(CHUNK_WIDTH) * m_buffer_pixel_size, ALIGNMENT) * (m_buffer_mask + 1);
+}
+
+auto FusedFilter::get_flags() const -> filter_flags
+{
+	return m_flags;
+}
+
+auto FusedFilter::get_image_attributes() const -> image_attributes
+{
+	return m_stages.back()->get_image_attributes();
+}
+
+auto FusedFilter::get_required_row_range(unsigned i) const -> pair_unsigned
+{
+	return m_stages.front()->get_required_row_range(i);
+}
+
+auto FusedFilter::get_required_col_range(unsigned left, unsigned right) const -> pair_unsigned
+{
+	return m_stages.front()->get_required_col_range(left, right);
+}
+
+unsigned FusedFilter::get_simultaneous_lines() const
+{
+	return m_buffer_lines;
+}
+
+unsigned FusedFilter::get_max_buffering() const
+{
+	return m_stages.front()->get_max_buffering();
+}
+
+size_t FusedFilter::get_context_size() const
+{
+	try {
+		checked_size_t size = 0;
+
+		for (const auto &stage : m_stages) {
+			size += ceil_n(stage->get_context_size(), ALIGNMENT);
+		}
+		return size.get();
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+}
+
+size_t FusedFilter::get_tmp_size(unsigned left, unsigned right) const
+{
+	try {
+		checked_size_t size = static_cast<checked_size_t>(get_buffer_size()) * m_num_buffers * m_num_planes;
+		size += get_padding_size();
+		size_t stage_size = 0;
+
+		for (unsigned j = left; j < right; ) {
+			unsigned j_end = std::min(floor_n(j, CHUNK_WIDTH) + CHUNK_WIDTH, right);
+
+			for (const auto &stage : m_stages) {
+				stage_size = std::max(stage_size, stage->get_tmp_size(j, j_end));
+			}
+			j = j_end;
+		}
+
+		size += stage_size;
+		return size.get();
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+}
+
+void FusedFilter::init_context(void *ctx) const
+{
+	unsigned char *ctx_p = static_cast<unsigned char *>(ctx);
+
+	for (const auto &stage : m_stages) {
+		stage->init_context(ctx_p);
+		ctx_p += ceil_n(stage->get_context_size(), ALIGNMENT);
+	}
+}
+
+void FusedFilter::process(void *ctx, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, unsigned i, unsigned left, unsigned right) const
+{
+	size_t buffer_size = get_buffer_size();
+	ptrdiff_t line_stride = static_cast<ptrdiff_t>(buffer_size / (m_buffer_mask + 1));
+	unsigned char *buffer_base = static_cast<unsigned char *>(tmp) + get_padding_size();
+	void *stage_tmp = buffer_base + buffer_size * m_num_buffers * m_num_planes;
+
+	// The first stage may produce several lines, which are passed one by one to the others.
+	unsigned line_end = std::min(i + m_buffer_lines, get_image_attributes().height);
+
+	for (unsigned j = left; j < right; ) {
+		unsigned chunk_base = floor_n(j, CHUNK_WIDTH);
+		unsigned j_end = std::min(chunk_base + CHUNK_WIDTH, right);
+
+		unsigned char *ctx_p = static_cast<unsigned char *>(ctx);
+		ImageBuffer<const void> stage_src[3] = { src[0], m_num_planes > 1 ? src[1] : src[0], m_num_planes > 2 ? src[2] : src[0] };
+
+		for (size_t n = 0; n < m_stages.size(); ++n) {
+			const ImageFilter &stage = *m_stages[n];
+			bool last = n == m_stages.size() - 1;
+
+			// Intermediate buffers hold a single chunk. Rows are selected by the
+			// buffer mask, and the pointer is offset into the padding so that the
+			// stage can address columns with absolute indices.
+			ptrdiff_t offset = static_cast<ptrdiff_t>(chunk_base) * pixel_size(stage.get_image_attributes().type);
+			ImageBuffer<void> stage_dst[3];
+
+			for (unsigned p = 0; p < m_num_planes; ++p) {
+				unsigned char *buf = buffer_base + ((n % m_num_buffers) * m_num_planes + p) * buffer_size;
+				stage_dst[p] = last ? dst[p] : ImageBuffer<void>{ buf - offset, line_stride, m_buffer_mask };
+			}
+
+			if (n == 0) {
+				stage.process(ctx_p, stage_src, stage_dst, stage_tmp, i, j, j_end);
+			} else {
+				for (unsigned ii = i; ii < line_end; ++ii) {
+					stage.process(ctx_p, stage_src, stage_dst, stage_tmp, ii, j, j_end);
+				}
+			}
+
+			for (unsigned p = 0; p < m_num_planes; ++p) {
+				stage_src[p] = stage_dst[p];
+			}
+			ctx_p += ceil_n(stage.get_context_size(), ALIGNMENT);
+		}
+
+		j = j_end;
+	}
+}
+
+} // namespace graph
+} // namespace zimg
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_FUSED_FILTER_H_
+#define ZIMG_GRAPH_FUSED_FILTER_H_
+
+#include <memory>
+#include <vector>
+#include "image_filter.h"
+
+namespace zimg {
+namespace graph {
+
+/**
+ * Check if a filter is a per-pixel operation that can be fused.
+ *
+ * Such filters produce each output pixel only from the input pixel at the
+ * same position and do not retain state between lines.
+ *
+ * @param filter filter
+ * @return true if fusable, else false
+ */
+bool filter_is_fusable(const ImageFilter &filter);
+
+/**
+ * Check if a filter can be the first stage of a fused filter.
+ *
+ * The first stage may have arbitrary support, such as a resizer, but must
+ * produce a few lines at a time and accept any column range.
+ *
+ * @param filter filter
+ * @return true if fusable, else false
+ */
+bool filter_is_fusable_head(const ImageFilter &filter);
+
+/**
+ * Sequence of per-pixel filters executed as a single filter.
+ *
+ * Each line is processed in column chunks small enough for the intermediate
+ * results of all stages to remain in L1 cache, so that only the input and
+ * output of the last stage are written to the node caches. The first stage
+ * may also be a filter with support, whose output is passed to the
+ * per-pixel stages while still in cache.
+ */
+class FusedFilter final : public ImageFilterBase {
+public:
+	typedef std::vector<std::shared_ptr<ImageFilter>> stage_list;
+private:
+	stage_list m_stages;
+	filter_flags m_flags;
+	unsigned m_num_planes;
+	unsigned m_num_buffers;
+	unsigned m_buffer_lines;
+	unsigned m_buffer_mask;
+	unsigned m_buffer_pixel_size;
+
+	size_t get_padding_size() const;
+	size_t get_buffer_size() const;
+public:
+	/**
+	 * Width of the column chunks in pixels.
+	 */
+	static constexpr unsigned CHUNK_WIDTH = 512;
+
+	/**
+	 * Construct a fused filter from two filters.
+	 *
+	 * If either filter is already a {@link FusedFilter}, its stages are
+	 * inserted directly. Only the first filter may have support.
+	 *
+	 * @param first filter applied first
+	 * @param second filter applied to the output of the first
+	 */
+	FusedFilter(std::shared_ptr<ImageFilter> first, std::shared_ptr<ImageFilter> second);
+
+	const stage_list &get_stages() const { return m_stages; }
+
+	const char *get_name() const override { return "fused"; }
+
+	filter_flags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+
+	pair_unsigned get_required_row_range(unsigned i) const override;
+
+	pair_unsigned get_required_col_range(unsigned left, unsigned right) const override;
+
+	unsigned get_simultaneous_lines() const override;
+
+	unsigned get_max_buffering() const override;
+
+	size_t get_context_size() const override;
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override;
+
+	void init_context(void *ctx) const override;
+
+	void process(void *ctx, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *tmp, unsigned i, unsigned left, unsigned right) const override;
+};
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_GRAPH_FUSED_FILTER_H_
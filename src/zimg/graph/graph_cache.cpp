@@ -0,0 +1,69 @@
+#include "common/except.h"
+#include "filtergraph.h"
+#include "graph_cache.h"
+
+namespace zimg {
+namespace graph {
+
+GraphCache::GraphCache(size_t max_entries) :
+	m_max_entries{ max_entries },
+	m_hits{},
+	m_misses{}
+{}
+
+GraphCache::~GraphCache() = default;
+
+void GraphCache::insert(const std::string &key, std::unique_ptr<FilterGraph> graph)
+{
+	// Another thread may have built the same graph in the meantime.
+	if (m_index.find(key) != m_index.end())
+		return;
+
+	m_entries.emplace_front(key, std::move(graph));
+
+	try {
+		m_index.emplace(key, m_entries.begin());
+	} catch (...) {
+		m_entries.pop_front();
+		throw;
+	}
+
+	while (m_max_entries && m_entries.size() > m_max_entries) {
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+}
+
+std::unique_ptr<FilterGraph> GraphCache::get(const std::string &key, const build_func &build) try
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		auto it = m_index.find(key);
+
+		if (it != m_index.end()) {
+			++m_hits;
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			return it->second->second->share();
+		}
+
+		++m_misses;
+	}
+
+	std::unique_ptr<FilterGraph> graph = build();
+	std::unique_ptr<FilterGraph> shared = graph->share();
+
+	std::lock_guard<std::mutex> lock{ m_mutex };
+	insert(key, std::move(graph));
+	return shared;
+} catch (const std::bad_alloc &) {
+	error::throw_<error::OutOfMemory>();
+}
+
+GraphCache::stats GraphCache::get_stats() const
+{
+	std::lock_guard<std::mutex> lock{ m_mutex };
+	return{ m_hits, m_misses, m_entries.size() };
+}
+
+} // namespace graph
+} // namespace zimg
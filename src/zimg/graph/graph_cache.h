@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_GRAPH_CACHE_H_
+#define ZIMG_GRAPH_GRAPH_CACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Base class in global namespace for API export.
+struct zimg_graph_cache {
+	virtual inline ~zimg_graph_cache() = 0;
+};
+
+zimg_graph_cache::~zimg_graph_cache() = default;
+
+
+namespace zimg {
+namespace graph {
+
+class FilterGraph;
+
+/**
+ * Thread-safe cache of finalized graphs.
+ *
+ * Graphs are identified by an opaque key, which must encode every parameter
+ * affecting graph construction. Lookups return graphs sharing the execution
+ * plan of the cached graph, so that building a graph is avoided on a hit.
+ */
+class GraphCache : public zimg_graph_cache {
+public:
+	typedef std::function<std::unique_ptr<FilterGraph>()> build_func;
+
+	/**
+	 * Cache statistics.
+	 */
+	struct stats {
+		unsigned long long hits;
+		unsigned long long misses;
+		size_t entries;
+	};
+private:
+	typedef std::list<std::pair<std::string, std::unique_ptr<FilterGraph>>> entry_list;
+
+	// Ordered from most to least recently used.
+	entry_list m_entries;
+	std::unordered_map<std::string, entry_list::iterator> m_index;
+	size_t m_max_entries;
+	unsigned long long m_hits;
+	unsigned long long m_misses;
+	mutable std::mutex m_mutex;
+
+	void insert(const std::string &key, std::unique_ptr<FilterGraph> graph);
+public:
+	/**
+	 * Construct an empty cache.
+	 *
+	 * @param max_entries maximum number of graphs retained, or zero for unlimited
+	 */
+	explicit GraphCache(size_t max_entries);
+
+	/**
+	 * Destroy cache. Graphs previously returned by the cache remain valid.
+	 */
+	~GraphCache();
+
+	/**
+	 * Get a graph from the cache, building it if not present.
+	 *
+	 * The build function is invoked without holding the cache lock, so misses
+	 * on different keys may be built concurrently.
+	 *
+	 * @param key graph key
+	 * @param build function returning a finalized graph
+	 * @return graph
+	 */
+	std::unique_ptr<FilterGraph> get(const std::string &key, const build_func &build);
+
+	/**
+	 * Get cache statistics.
+	 *
+	 * @return statistics
+	 */
+	stats get_stats() const;
+};
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_GRAPH_GRAPH_CACHE_H_
@@ -6,11 +6,16 @@
 #include "common/except.h"
 #include "common/make_unique.h"
 #include "common/pixel.h"
+#include "depth/quantize.h"
 #include "resize/filter.h"
+#include "resize/resize.h"
 #include "filtergraph.h"
 #include "copy_filter.h"
 #include "graphbuilder.h"
 #include "image_filter.h"
+#include "packed_filter.h"
+#include "specialized_filter.h"
+#include "tile_profile.h"
 
 #ifndef ZIMG_UNSAFE_IMAGE_SIZE
 #include <limits>
@@ -143,6 +148,36 @@ void validate_state(const GraphBuilder::state &state)
 		error::throw_<error::InvalidImageSize>("active window must be finite");
 	if (state.active_width <= 0 || state.active_height <= 0)
 		error::throw_<error::InvalidImageSize>("active window must be positive");
+
+	if (state.packing == GraphBuilder::PixelPacking::NV12) {
+		if (!is_yuv(state))
+			error::throw_<error::ColorFamilyMismatch>("semi-planar format requires YUV color family");
+		if (state.width > pixel_max_width(state.type) / 2)
+			error::throw_<error::InvalidImageSize>("semi-planar image width exceeds memory addressing limit");
+	} else if (state.packing == GraphBuilder::PixelPacking::YUY2) {
+		if (!is_yuv(state))
+			error::throw_<error::ColorFamilyMismatch>("packed YUV format requires YUV color family");
+		if (state.subsample_w != 1 || state.subsample_h != 0)
+			error::throw_<error::UnsupportedSubsampling>("packed 4:2:2 format requires 4:2:2 subsampling");
+		if (state.width > pixel_max_width(state.type) / 2)
+			error::throw_<error::InvalidImageSize>("packed image width exceeds memory addressing limit");
+	} else if (state.packing == GraphBuilder::PixelPacking::V210 || state.packing == GraphBuilder::PixelPacking::Y410) {
+		unsigned subsample_w = state.packing == GraphBuilder::PixelPacking::V210 ? 1 : 0;
+
+		if (!is_yuv(state))
+			error::throw_<error::ColorFamilyMismatch>("packed YUV format requires YUV color family");
+		if (state.subsample_w != subsample_w || state.subsample_h != 0)
+			error::throw_<error::UnsupportedSubsampling>(subsample_w ? "v210 requires 4:2:2 subsampling" : "Y410 requires 4:4:4 subsampling");
+		if (state.type != PixelType::WORD || state.depth != 10)
+			error::throw_<error::UnsupportedOperation>("10-bit packed format requires 10-bit WORD samples");
+		if (state.width > pixel_max_width(PixelType::FLOAT))
+			error::throw_<error::InvalidImageSize>("packed image width exceeds memory addressing limit");
+	} else if (state.packing != GraphBuilder::PixelPacking::PLANAR) {
+		if (!is_rgb(state))
+			error::throw_<error::ColorFamilyMismatch>("packed pixels require RGB color family");
+		if (state.width > pixel_max_width(state.type) / 4)
+			error::throw_<error::InvalidImageSize>("packed image width exceeds memory addressing limit");
+	}
 }
 
 bool needs_colorspace(const GraphBuilder::state &source, const GraphBuilder::state &target)
@@ -237,7 +272,12 @@ GraphBuilder::params::params() noexcept :
 	peak_luminance{ NAN },
 	approximate_gamma{},
 	scene_referred{},
-	cpu{}
+	colorspace_lut_size{},
+	cpu{},
+	tile_autotune{},
+	specialized_kernels{},
+	concurrent_graphs{},
+	disable_fusion{}
 {}
 
 struct GraphBuilder::resize_spec {
@@ -268,7 +308,7 @@ struct GraphBuilder::resize_spec {
 	{}
 };
 
-GraphBuilder::GraphBuilder() noexcept : m_state{} {}
+GraphBuilder::GraphBuilder() noexcept : m_state{}, m_tile_autotune{}, m_concurrent_graphs{} {}
 
 GraphBuilder::~GraphBuilder() = default;
 
@@ -345,6 +385,7 @@ void GraphBuilder::convert_colorspace(const colorspace::ColorspaceDefinition &co
 			conv.set_peak_luminance(params->peak_luminance);
 		conv.set_approximate_gamma(params->approximate_gamma);
 		conv.set_scene_referred(params->scene_referred);
+		conv.set_lut_size(params->colorspace_lut_size);
 	}
 
 	for (auto &&filter : factory->create_colorspace(conv)) {
@@ -398,7 +439,7 @@ void GraphBuilder::convert_depth(const PixelFormat &format, const params *params
 	m_state.fullrange = format.fullrange;
 }
 
-void GraphBuilder::convert_resize(const resize_spec &spec, const params *params, FilterFactory *factory)
+void GraphBuilder::convert_resize(const resize_spec &spec, const params *params, FilterFactory *factory, bool to_float)
 {
 	resize::BicubicFilter bicubic_filter{ 1.0 / 3.0, 1.0 / 3.0 };
 	resize::BilinearFilter bilinear_filter;
@@ -420,15 +461,6 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 	if (!subsample_h)
 		chroma_location_h = ChromaLocationH::CENTER;
 
-	if (m_state.width == spec.width &&
-	    m_state.height == spec.height &&
-	    m_state.subsample_w == subsample_w &&
-	    m_state.subsample_h == subsample_h &&
-	    m_state.chroma_location_w == chroma_location_w &&
-	    m_state.chroma_location_h == chroma_location_h &&
-	    !image_shifted)
-		return;
-
 	const resize::Filter *resample_filter = params ? params->filter.get() : &bicubic_filter;
 	const resize::Filter *resample_filter_uv = params ? params->filter_uv.get() : &bilinear_filter;
 	bool unresize = params && params->unresize;
@@ -441,9 +473,30 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 	                        ((m_state.subsample_h || subsample_h) && m_state.chroma_location_h != chroma_location_h) ||
 	                        image_shifted;
 
+	// Integer images are converted to float by the first resize pass if every plane is resized.
+	// Otherwise, a separate depth conversion is inserted.
+	PixelFormat src_format{ m_state.type, m_state.depth, m_state.fullrange, false, is_ycgco(m_state) };
+	bool fused_load = to_float && !pixel_is_float(m_state.type) && !unresize &&
+	                  do_resize_luma && (!is_yuv(m_state) || do_resize_chroma) &&
+	                  resize::resize_supports_integer_load(cpu);
+
+	if (to_float && !fused_load)
+		convert_depth(PixelType::FLOAT, params, factory);
+
+	if (m_state.width == spec.width &&
+	    m_state.height == spec.height &&
+	    m_state.subsample_w == subsample_w &&
+	    m_state.subsample_h == subsample_h &&
+	    m_state.chroma_location_w == chroma_location_w &&
+	    m_state.chroma_location_h == chroma_location_h &&
+	    !image_shifted)
+		return;
+
 	if (unresize && (spec.subwidth != m_state.width || spec.subheight != m_state.height))
 		error::throw_<error::ResamplingNotAvailable>("unresize not supported for given subregion");
 
+	PixelType type = fused_load ? PixelType::FLOAT : m_state.type;
+
 	if (do_resize_luma) {
 		double extra_shift_h = luma_shift_factor(m_state.parity, m_state.height, spec.height);
 
@@ -459,8 +512,8 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 
 			filter_list = factory->create_unresize(conv);
 		} else {
-			auto conv = resize::ResizeConversion{ m_state.width, m_state.height, m_state.type }
-				.set_depth(m_state.depth)
+			auto conv = resize::ResizeConversion{ m_state.width, m_state.height, type }
+				.set_depth(fused_load ? pixel_depth(type) : m_state.depth)
 				.set_filter(resample_filter)
 				.set_dst_width(spec.width)
 				.set_dst_height(spec.height)
@@ -470,6 +523,12 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 				.set_subheight(spec.subheight)
 				.set_cpu(cpu);
 
+			if (fused_load) {
+				conv.set_src_type(m_state.type)
+				    .set_src_scale(static_cast<float>(1.0 / depth::integer_range(src_format)))
+				    .set_src_offset(static_cast<float>(-depth::integer_offset(src_format) * (1.0 / depth::integer_range(src_format))));
+			}
+
 			filter_list = factory->create_resize(conv);
 		}
 
@@ -508,8 +567,8 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 
 			filter_list_uv = factory->create_unresize(conv);
 		} else {
-			auto conv = resize::ResizeConversion{ chroma_width_in, chroma_height_in, m_state.type }
-				.set_depth(m_state.depth)
+			auto conv = resize::ResizeConversion{ chroma_width_in, chroma_height_in, type }
+				.set_depth(fused_load ? pixel_depth(type) : m_state.depth)
 				.set_filter(resample_filter_uv)
 				.set_dst_width(chroma_width_out)
 				.set_dst_height(chroma_height_out)
@@ -519,6 +578,15 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 				.set_subheight(spec.subheight / (1 << m_state.subsample_h))
 				.set_cpu(cpu);
 
+			if (fused_load) {
+				PixelFormat src_format_uv = src_format;
+				src_format_uv.chroma = true;
+
+				conv.set_src_type(m_state.type)
+				    .set_src_scale(static_cast<float>(1.0 / depth::integer_range(src_format_uv)))
+				    .set_src_offset(static_cast<float>(-depth::integer_offset(src_format_uv) * (1.0 / depth::integer_range(src_format_uv))));
+			}
+
 			filter_list_uv = factory->create_resize(conv);
 		}
 
@@ -527,6 +595,12 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 		}
 	}
 
+	if (fused_load) {
+		m_state.type = PixelType::FLOAT;
+		m_state.depth = pixel_depth(PixelType::FLOAT);
+		m_state.fullrange = false;
+	}
+
 	m_state.width = spec.width;
 	m_state.height = spec.height;
 	m_state.subsample_w = subsample_w;
@@ -539,6 +613,89 @@ void GraphBuilder::convert_resize(const resize_spec &spec, const params *params,
 	m_state.active_height = spec.height;
 }
 
+void GraphBuilder::unpack_pixels(const params *params)
+{
+	CPUClass cpu = params ? params->cpu : CPUClass::AUTO;
+	unsigned chroma_width = m_state.width >> m_state.subsample_w;
+	unsigned chroma_height = m_state.height >> m_state.subsample_h;
+	size_t sample_size = pixel_size(m_state.type);
+	size_t row_size[3] = { packed_row_size(m_state.packing, m_state.width, m_state.type), 0, 0 };
+
+	switch (m_state.packing) {
+	case PixelPacking::NV12:
+		// U and V alternate in the second plane.
+		row_size[1] = static_cast<size_t>(chroma_width) * 2 * sample_size;
+		attach_filter_uv(create_deinterleave_filter(chroma_width, chroma_height, m_state.type, 2, cpu));
+		m_graph->set_input_plane_alias(2, 1, sample_size);
+		break;
+	case PixelPacking::YUY2:
+		// Each pair of pixels is stored as Y0 U Y1 V.
+		attach_filter(create_deinterleave_filter(m_state.width, m_state.height, m_state.type, 2, cpu));
+		attach_filter_uv(create_deinterleave_filter(chroma_width, chroma_height, m_state.type, 4, cpu));
+		m_graph->set_input_plane_alias(1, 0, sample_size);
+		m_graph->set_input_plane_alias(2, 0, sample_size * 3);
+		break;
+	case PixelPacking::V210:
+		attach_filter(create_v210_unpack_filter(m_state.width, m_state.height, 0, cpu));
+		m_graph->attach_filter_uv(create_v210_unpack_filter(chroma_width, chroma_height, 1, cpu), create_v210_unpack_filter(chroma_width, chroma_height, 2, cpu));
+		m_graph->set_input_plane_alias(1, 0, 0);
+		m_graph->set_input_plane_alias(2, 0, 0);
+		break;
+	case PixelPacking::Y410:
+		attach_filter(create_y410_unpack_filter(m_state.width, m_state.height, cpu));
+		break;
+	default:
+		attach_filter(create_unpack_filter(m_state, cpu));
+		break;
+	}
+
+	m_graph->set_input_row_size(row_size);
+	m_state.packing = PixelPacking::PLANAR;
+}
+
+void GraphBuilder::pack_pixels(PixelPacking packing, const params *params)
+{
+	CPUClass cpu = params ? params->cpu : CPUClass::AUTO;
+	unsigned chroma_width = m_state.width >> m_state.subsample_w;
+	unsigned chroma_height = m_state.height >> m_state.subsample_h;
+	size_t sample_size = pixel_size(m_state.type);
+	size_t row_size[3] = { packed_row_size(packing, m_state.width, m_state.type), 0, 0 };
+
+	state packed = m_state;
+	packed.packing = packing;
+
+	switch (packing) {
+	case PixelPacking::NV12:
+		row_size[1] = static_cast<size_t>(chroma_width) * 2 * sample_size;
+		attach_filter_uv(create_interleave_filter(chroma_width, chroma_height, m_state.type, 2, cpu));
+		m_graph->set_output_plane_alias(2, 1, sample_size);
+		break;
+	case PixelPacking::YUY2:
+		attach_filter(create_interleave_filter(m_state.width, m_state.height, m_state.type, 2, cpu));
+		attach_filter_uv(create_interleave_filter(chroma_width, chroma_height, m_state.type, 4, cpu));
+		m_graph->set_output_plane_alias(1, 0, sample_size);
+		m_graph->set_output_plane_alias(2, 0, sample_size * 3);
+		m_graph->set_output_pixel_group(2);
+		break;
+	case PixelPacking::V210:
+		attach_filter(create_v210_pack_filter(m_state.width, m_state.height, 0, cpu));
+		m_graph->attach_filter_uv(create_v210_pack_filter(chroma_width, chroma_height, 1, cpu), create_v210_pack_filter(chroma_width, chroma_height, 2, cpu));
+		m_graph->set_output_plane_alias(1, 0, 0);
+		m_graph->set_output_plane_alias(2, 0, 0);
+		m_graph->set_output_pixel_group(6);
+		break;
+	case PixelPacking::Y410:
+		attach_filter(create_y410_pack_filter(m_state.width, m_state.height, cpu));
+		break;
+	default:
+		attach_filter(create_pack_filter(packed, cpu));
+		break;
+	}
+
+	m_graph->set_output_row_size(row_size);
+	m_state.packing = packing;
+}
+
 GraphBuilder &GraphBuilder::set_source(const state &source) try
 {
 	if (m_graph)
@@ -556,6 +713,7 @@ GraphBuilder &GraphBuilder::set_source(const state &source) try
 GraphBuilder &GraphBuilder::connect_graph(const state &target, const params *params, FilterFactory *factory) try
 {
 	DefaultFilterFactory default_factory;
+	bool use_specialized = !factory && params && params->specialized_kernels;
 
 	if (!m_graph)
 		error::throw_<error::InternalError>("no active graph");
@@ -573,6 +731,33 @@ GraphBuilder &GraphBuilder::connect_graph(const state &target, const params *par
 
 	if (params && cpu_requires_64b_alignment(params->cpu))
 		m_graph->set_requires_64b_alignment();
+	if (params && params->disable_fusion)
+		m_graph->disable_fusion();
+
+	if (params && params->tile_autotune) {
+		m_tile_autotune = true;
+		m_tile_profile = params->tile_profile;
+	}
+	if (params)
+		m_concurrent_graphs = params->concurrent_graphs;
+
+	if (m_state.packing != PixelPacking::PLANAR)
+		unpack_pixels(params);
+
+	// If requested, known conversions are performed in one pass by a dedicated
+	// kernel. User supplied factories always receive the generic sequence of
+	// conversions.
+	if (use_specialized) {
+		if (std::unique_ptr<ImageFilter> filter = create_specialized_filter(m_state, target, params)) {
+			attach_filter(std::move(filter));
+
+			m_state.type = target.type;
+			m_state.color = target.color;
+			m_state.colorspace = target.colorspace;
+			m_state.depth = target.depth;
+			m_state.fullrange = target.fullrange;
+		}
+	}
 
 	while (true) {
 		if (needs_colorspace(m_state, target)) {
@@ -589,10 +774,7 @@ GraphBuilder &GraphBuilder::connect_graph(const state &target, const params *par
 				spec.height = std::min(m_state.height, target.height);
 			}
 
-			if (m_state.type != PixelType::FLOAT)
-				convert_depth(PixelType::FLOAT, params, factory);
-
-			convert_resize(spec, params, factory);
+			convert_resize(spec, params, factory, m_state.type != PixelType::FLOAT);
 
 			if (is_greyscale(m_state))
 				grey_to_color(target.color, target.colorspace.matrix, 0, 0, target.chroma_location_w, target.chroma_location_h);
@@ -604,17 +786,26 @@ GraphBuilder &GraphBuilder::connect_graph(const state &target, const params *par
 			// Convert to the target pixel format to reduce the required number of conversions.
 			// If neither the source nor target pixel format is directly supported, select a different format.
 			// Direct operation on half-precision is slightly slower, so avoid it if the target is not also half.
+			// Without fast F16C, half is only resized directly when both source and target are half.
+			// Byte images are resized directly unless a depth conversion would follow, which is more accurate on words.
+			bool half_resize = target.type == PixelType::HALF &&
+			                   (fast_f16 || (m_state.type == PixelType::HALF && resize::resize_supports_half(params ? params->cpu : CPUClass::NONE)));
+			bool byte_resize = m_state.type == PixelType::BYTE && !needs_depth(m_state, target) &&
+			                   (!params || params->dither_type == depth::DitherType::NONE);
+
+			bool to_float = false;
+
 			if (params && params->unresize)
 				convert_depth(PixelType::FLOAT, params, factory);
 			else if (target.type == PixelType::WORD)
 				convert_depth(PixelFormat{ target.type, target.depth, target.fullrange, false, is_ycgco(target) }, params, factory);
-			else if (target.type == PixelType::HALF && fast_f16)
+			else if (half_resize)
 				convert_depth(PixelType::HALF, params, factory);
 			else if (target.type == PixelType::FLOAT)
-				convert_depth(PixelType::FLOAT, params, factory);
-			else if (m_state.type == PixelType::BYTE)
+				to_float = m_state.type != PixelType::FLOAT;
+			else if (m_state.type == PixelType::BYTE && !byte_resize)
 				convert_depth(PixelFormat{ PixelType::WORD, 16, false, false, is_ycgco(target) }, params, factory);
-			else if (m_state.type == PixelType::HALF && (target.type != PixelType::HALF || !fast_f16))
+			else if (m_state.type == PixelType::HALF && !half_resize)
 				convert_depth(PixelType::FLOAT, params, factory);
 
 			resize_spec spec{ m_state };
@@ -625,7 +816,7 @@ GraphBuilder &GraphBuilder::connect_graph(const state &target, const params *par
 			spec.chroma_location_w = target.chroma_location_w;
 			spec.chroma_location_h = target.chroma_location_h;
 
-			convert_resize(spec, params, factory);
+			convert_resize(spec, params, factory, to_float);
 		} else if (needs_depth(m_state, target)) {
 			PixelFormat format{ target.type, target.depth, target.fullrange, false, is_ycgco(target) };
 			convert_depth(format, params, factory);
@@ -636,6 +827,9 @@ GraphBuilder &GraphBuilder::connect_graph(const state &target, const params *par
 		}
 	}
 
+	if (target.packing != PixelPacking::PLANAR)
+		pack_pixels(target.packing, params);
+
 	return *this;
 } catch (const std::bad_alloc &) {
 	error::throw_<error::OutOfMemory>();
@@ -643,7 +837,14 @@ GraphBuilder &GraphBuilder::connect_graph(const state &target, const params *par
 
 std::unique_ptr<FilterGraph> GraphBuilder::complete_graph() try
 {
+	if (m_concurrent_graphs)
+		m_graph->set_concurrent_graphs(m_concurrent_graphs);
+
 	m_graph->complete();
+
+	if (m_tile_autotune)
+		m_graph->set_tile_width_hint(autotune_tile_width(*m_graph, m_tile_profile));
+
 	return std::move(m_graph);
 } catch (const std::bad_alloc &) {
 	error::throw_<error::OutOfMemory>();
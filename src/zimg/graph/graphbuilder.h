@@ -4,6 +4,7 @@
 #define ZIMG_GRAPH_GRAPHBUILDER_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 #include "common/pixel.h"
 #include "colorspace/colorspace.h"
@@ -105,6 +106,20 @@ public:
 		BOTTOM,
 	};
 
+	enum class PixelPacking {
+		PLANAR,
+		RGB,
+		BGR,
+		RGBA,
+		BGRA,
+		ARGB,
+		ABGR,
+		NV12,
+		YUY2,
+		V210,
+		Y410,
+	};
+
 	/**
 	 * Filter instantiation parameters.
 	 */
@@ -116,7 +131,13 @@ public:
 		double peak_luminance;
 		bool approximate_gamma;
 		bool scene_referred;
+		unsigned colorspace_lut_size;
 		CPUClass cpu;
+		bool tile_autotune;
+		std::string tile_profile;
+		bool specialized_kernels;
+		unsigned concurrent_graphs;
+		bool disable_fusion;
 
 		params() noexcept;
 	};
@@ -130,6 +151,7 @@ public:
 		PixelType type;
 		unsigned subsample_w;
 		unsigned subsample_h;
+		PixelPacking packing;
 
 		ColorFamily color;
 		colorspace::ColorspaceDefinition colorspace;
@@ -151,6 +173,9 @@ private:
 
 	std::unique_ptr<FilterGraph> m_graph;
 	state m_state;
+	bool m_tile_autotune;
+	std::string m_tile_profile;
+	unsigned m_concurrent_graphs;
 
 	void attach_filter(std::shared_ptr<ImageFilter> filter);
 
@@ -165,7 +190,11 @@ private:
 
 	void convert_depth(const PixelFormat &format, const params *params, FilterFactory *factory);
 
-	void convert_resize(const resize_spec &spec, const params *params, FilterFactory *factory);
+	void convert_resize(const resize_spec &spec, const params *params, FilterFactory *factory, bool to_float = false);
+
+	void unpack_pixels(const params *params);
+
+	void pack_pixels(PixelPacking packing, const params *params);
 public:
 	/**
 	 * Default construct GraphBuilder, creating a builder that manages no graph.
@@ -197,6 +226,9 @@ public:
 	/**
 	 * Finalize and return managed graph.
 	 *
+	 * If tile width autotuning was requested in any call to {@link connect_graph},
+	 * the graph is benchmarked after finalization.
+	 *
 	 * @return graph
 	 */
 	std::unique_ptr<FilterGraph> complete_graph();
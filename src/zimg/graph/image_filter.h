@@ -72,6 +72,16 @@ public:
 	 */
 	virtual ~ImageFilter() = 0;
 
+	/**
+	 * Get a name identifying the operation and implementation of the filter.
+	 *
+	 * Names are stored in tile profiles, so they must not change between
+	 * builds or depend on the compiler.
+	 *
+	 * @return name
+	 */
+	virtual const char *get_name() const = 0;
+
 	/**
 	 * Get the filter flags structure.
 	 *
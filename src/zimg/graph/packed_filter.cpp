@@ -0,0 +1,568 @@
+#include <cstdint>
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "common/zassert.h"
+#include "depth/quantize.h"
+#include "image_filter.h"
+#include "packed_filter.h"
+
+#ifdef ZIMG_X86
+  #include "x86/packed_filter_x86.h"
+#endif
+
+namespace zimg {
+namespace graph {
+
+namespace {
+
+template <class T, unsigned N>
+void unpack_line(const T *src, T * const dst[3], const unsigned offset[4], unsigned left, unsigned right)
+{
+	const unsigned r = offset[0];
+	const unsigned g = offset[1];
+	const unsigned b = offset[2];
+
+	for (unsigned j = left; j < right; ++j) {
+		const T *pixel = src + static_cast<size_t>(j) * N;
+
+		dst[0][j] = pixel[r];
+		dst[1][j] = pixel[g];
+		dst[2][j] = pixel[b];
+	}
+}
+
+template <class T, unsigned N>
+void pack_line(const T * const src[3], T *dst, const unsigned offset[4], T alpha, unsigned left, unsigned right)
+{
+	const unsigned r = offset[0];
+	const unsigned g = offset[1];
+	const unsigned b = offset[2];
+	const unsigned a = offset[3];
+
+	for (unsigned j = left; j < right; ++j) {
+		T *pixel = dst + static_cast<size_t>(j) * N;
+
+		pixel[r] = src[0][j];
+		pixel[g] = src[1][j];
+		pixel[b] = src[2][j];
+
+		if (N == 4)
+			pixel[a] = alpha;
+	}
+}
+
+template <class T, unsigned Stride>
+void deinterleave_line(const T *src, T *dst, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		dst[j] = src[static_cast<size_t>(j) * Stride];
+	}
+}
+
+template <class T, unsigned Stride>
+void interleave_line(const T *src, T *dst, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		dst[static_cast<size_t>(j) * Stride] = src[j];
+	}
+}
+
+// Index of the n-th sample of a channel within a v210 group.
+unsigned v210_sample_index(unsigned channel, unsigned n)
+{
+	return channel ? n * 4 + (channel - 1) * 2 : n * 2 + 1;
+}
+
+void v210_unpack_line(const uint32_t *src, uint16_t *dst, unsigned channel, unsigned left, unsigned right)
+{
+	unsigned group_size = channel ? 3 : 6;
+
+	for (unsigned j = left; j < right; ++j) {
+		const uint32_t *group = src + static_cast<size_t>(j / group_size) * 4;
+		unsigned k = v210_sample_index(channel, j % group_size);
+
+		dst[j] = static_cast<uint16_t>((group[k / 3] >> (k % 3 * 10)) & 0x3FF);
+	}
+}
+
+void v210_pack_line(const uint16_t *src, uint32_t *dst, unsigned channel, unsigned left, unsigned right)
+{
+	unsigned group_size = channel ? 3 : 6;
+
+	for (unsigned j = left; j < right; ++j) {
+		uint32_t *group = dst + static_cast<size_t>(j / group_size) * 4;
+		unsigned k = v210_sample_index(channel, j % group_size);
+		unsigned shift = k % 3 * 10;
+
+		group[k / 3] = (group[k / 3] & ~(UINT32_C(0x3FF) << shift) & UINT32_C(0x3FFFFFFF)) | (static_cast<uint32_t>(src[j] & 0x3FF) << shift);
+	}
+}
+
+void y410_unpack_line(const uint32_t *src, uint16_t * const dst[3], unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		uint32_t x = src[j];
+
+		dst[0][j] = static_cast<uint16_t>((x >> 10) & 0x3FF);
+		dst[1][j] = static_cast<uint16_t>(x & 0x3FF);
+		dst[2][j] = static_cast<uint16_t>((x >> 20) & 0x3FF);
+	}
+}
+
+void y410_pack_line(const uint16_t * const src[3], uint32_t *dst, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		uint32_t y = src[0][j] & 0x3FF;
+		uint32_t u = src[1][j] & 0x3FF;
+		uint32_t v = src[2][j] & 0x3FF;
+
+		dst[j] = u | (y << 10) | (v << 20) | UINT32_C(0xC0000000);
+	}
+}
+
+
+// Samples are copied without interpretation, so types of equal size share a kernel.
+template <class T, unsigned N>
+class UnpackFilter_C final : public PackedFilterBase {
+public:
+	UnpackFilter_C(const PackedLayout &layout, unsigned width, unsigned height, PixelType type) :
+		PackedFilterBase(layout, width, height, type)
+	{}
+
+	const char *get_name() const override { return "unpack_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const T *src_p = static_cast<const T *>(src[0][i]);
+		T *dst_p[3] = { static_cast<T *>(dst[0][i]), static_cast<T *>(dst[1][i]), static_cast<T *>(dst[2][i]) };
+
+		unpack_line<T, N>(src_p, dst_p, m_layout.offset, left, right);
+	}
+};
+
+template <class T, unsigned N>
+class PackFilter_C final : public PackFilterBase {
+public:
+	PackFilter_C(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha) :
+		PackFilterBase(layout, width, height, type, alpha)
+	{}
+
+	const char *get_name() const override { return "pack_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const T *src_p[3] = { static_cast<const T *>(src[0][i]), static_cast<const T *>(src[1][i]), static_cast<const T *>(src[2][i]) };
+		T *dst_p = static_cast<T *>(dst[0][i]);
+
+		pack_line<T, N>(src_p, dst_p, m_layout.offset, static_cast<T>(m_alpha), left, right);
+	}
+};
+
+template <class T, unsigned Stride>
+class DeinterleaveFilter_C final : public InterleavedFilterBase {
+public:
+	DeinterleaveFilter_C(unsigned width, unsigned height, PixelType type) :
+		InterleavedFilterBase(width, height, type, Stride)
+	{}
+
+	const char *get_name() const override { return "deinterleave_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		deinterleave_line<T, Stride>(static_cast<const T *>(src[0][i]), static_cast<T *>(dst[0][i]), left, right);
+	}
+};
+
+template <class T, unsigned Stride>
+class InterleaveFilter_C final : public InterleavedFilterBase {
+public:
+	InterleaveFilter_C(unsigned width, unsigned height, PixelType type) :
+		InterleavedFilterBase(width, height, type, Stride)
+	{}
+
+	const char *get_name() const override { return "interleave_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		interleave_line<T, Stride>(static_cast<const T *>(src[0][i]), static_cast<T *>(dst[0][i]), left, right);
+	}
+};
+
+class V210UnpackFilter_C final : public V210FilterBase {
+public:
+	V210UnpackFilter_C(unsigned width, unsigned height, unsigned channel) :
+		V210FilterBase(width, height, channel)
+	{}
+
+	const char *get_name() const override { return "v210_unpack_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		v210_unpack_line(static_cast<const uint32_t *>(src[0][i]), static_cast<uint16_t *>(dst[0][i]), m_channel, left, right);
+	}
+};
+
+class V210PackFilter_C final : public V210FilterBase {
+public:
+	V210PackFilter_C(unsigned width, unsigned height, unsigned channel) :
+		V210FilterBase(width, height, channel)
+	{}
+
+	const char *get_name() const override { return "v210_pack_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		v210_pack_line(static_cast<const uint16_t *>(src[0][i]), static_cast<uint32_t *>(dst[0][i]), m_channel, left, right);
+	}
+};
+
+class Y410UnpackFilter_C final : public Y410FilterBase {
+public:
+	Y410UnpackFilter_C(unsigned width, unsigned height) :
+		Y410FilterBase(width, height)
+	{}
+
+	const char *get_name() const override { return "y410_unpack_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		uint16_t *dst_p[3] = { static_cast<uint16_t *>(dst[0][i]), static_cast<uint16_t *>(dst[1][i]), static_cast<uint16_t *>(dst[2][i]) };
+		y410_unpack_line(static_cast<const uint32_t *>(src[0][i]), dst_p, left, right);
+	}
+};
+
+class Y410PackFilter_C final : public Y410FilterBase {
+public:
+	Y410PackFilter_C(unsigned width, unsigned height) :
+		Y410FilterBase(width, height)
+	{}
+
+	const char *get_name() const override { return "y410_pack_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const uint16_t *src_p[3] = { static_cast<const uint16_t *>(src[0][i]), static_cast<const uint16_t *>(src[1][i]), static_cast<const uint16_t *>(src[2][i]) };
+		y410_pack_line(src_p, static_cast<uint32_t *>(dst[0][i]), left, right);
+	}
+};
+
+
+template <template <class, unsigned> class Filter, class... Args>
+std::unique_ptr<ImageFilter> create_filter_c(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, Args... args)
+{
+	switch (pixel_size(type)) {
+	case 1:
+		return layout.channels == 4 ? std::unique_ptr<ImageFilter>(ztd::make_unique<Filter<uint8_t, 4>>(layout, width, height, type, args...)) :
+		                              std::unique_ptr<ImageFilter>(ztd::make_unique<Filter<uint8_t, 3>>(layout, width, height, type, args...));
+	case 2:
+		return layout.channels == 4 ? std::unique_ptr<ImageFilter>(ztd::make_unique<Filter<uint16_t, 4>>(layout, width, height, type, args...)) :
+		                              std::unique_ptr<ImageFilter>(ztd::make_unique<Filter<uint16_t, 3>>(layout, width, height, type, args...));
+	case 4:
+		return layout.channels == 4 ? std::unique_ptr<ImageFilter>(ztd::make_unique<Filter<uint32_t, 4>>(layout, width, height, type, args...)) :
+		                              std::unique_ptr<ImageFilter>(ztd::make_unique<Filter<uint32_t, 3>>(layout, width, height, type, args...));
+	default:
+		error::throw_<error::InternalError>("unsupported pixel type");
+	}
+}
+
+template <template <class, unsigned> class Filter, unsigned Stride>
+std::unique_ptr<ImageFilter> create_interleaved_filter_c(unsigned width, unsigned height, PixelType type)
+{
+	switch (pixel_size(type)) {
+	case 1:
+		return ztd::make_unique<Filter<uint8_t, Stride>>(width, height, type);
+	case 2:
+		return ztd::make_unique<Filter<uint16_t, Stride>>(width, height, type);
+	case 4:
+		return ztd::make_unique<Filter<uint32_t, Stride>>(width, height, type);
+	default:
+		error::throw_<error::InternalError>("unsupported pixel type");
+	}
+}
+
+template <template <class, unsigned> class Filter>
+std::unique_ptr<ImageFilter> create_interleaved_filter_c(unsigned width, unsigned height, PixelType type, unsigned stride)
+{
+	switch (stride) {
+	case 2:
+		return create_interleaved_filter_c<Filter, 2>(width, height, type);
+	case 4:
+		return create_interleaved_filter_c<Filter, 4>(width, height, type);
+	default:
+		error::throw_<error::InternalError>("unsupported stride");
+	}
+}
+
+// Bit pattern of an opaque alpha sample.
+uint32_t alpha_value(PixelType type, unsigned depth)
+{
+	switch (type) {
+	case PixelType::BYTE:
+	case PixelType::WORD:
+		return static_cast<uint32_t>(depth::numeric_max(depth));
+	case PixelType::HALF:
+		return 0x3C00U;
+	case PixelType::FLOAT:
+		return 0x3F800000U;
+	default:
+		error::throw_<error::InternalError>("unsupported pixel type");
+	}
+}
+
+} // namespace
+
+
+PackedLayout::PackedLayout(GraphBuilder::PixelPacking packing) : channels{}, offset{}
+{
+	typedef GraphBuilder::PixelPacking PixelPacking;
+
+	auto set_layout = [this](unsigned n, unsigned r, unsigned g, unsigned b, unsigned a)
+	{
+		channels = n;
+		offset[0] = r;
+		offset[1] = g;
+		offset[2] = b;
+		offset[3] = a;
+	};
+
+	switch (packing) {
+	case PixelPacking::RGB:
+		set_layout(3, 0, 1, 2, 3);
+		break;
+	case PixelPacking::BGR:
+		set_layout(3, 2, 1, 0, 3);
+		break;
+	case PixelPacking::RGBA:
+		set_layout(4, 0, 1, 2, 3);
+		break;
+	case PixelPacking::BGRA:
+		set_layout(4, 2, 1, 0, 3);
+		break;
+	case PixelPacking::ARGB:
+		set_layout(4, 1, 2, 3, 0);
+		break;
+	case PixelPacking::ABGR:
+		set_layout(4, 3, 2, 1, 0);
+		break;
+	default:
+		error::throw_<error::InternalError>("not a packed format");
+	}
+}
+
+PackedFilterBase::PackedFilterBase(const PackedLayout &layout, unsigned width, unsigned height, PixelType type) :
+	m_attr{ width, height, type },
+	m_layout(layout)
+{
+	zassert_d(width <= pixel_max_width(type) / layout.channels, "overflow");
+}
+
+auto PackedFilterBase::get_flags() const -> filter_flags
+{
+	filter_flags flags{};
+
+	flags.same_row = true;
+	flags.color = true;
+
+	return flags;
+}
+
+auto PackedFilterBase::get_image_attributes() const -> image_attributes
+{
+	return m_attr;
+}
+
+PackFilterBase::PackFilterBase(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha) :
+	PackedFilterBase(layout, width, height, type),
+	m_alpha{ alpha }
+{}
+
+InterleavedFilterBase::InterleavedFilterBase(unsigned width, unsigned height, PixelType type, unsigned stride) :
+	m_attr{ width, height, type }
+{
+	zassert_d(width <= pixel_max_width(type) / stride, "overflow");
+}
+
+auto InterleavedFilterBase::get_flags() const -> filter_flags
+{
+	filter_flags flags{};
+
+	flags.same_row = true;
+
+	return flags;
+}
+
+auto InterleavedFilterBase::get_image_attributes() const -> image_attributes
+{
+	return m_attr;
+}
+
+V210FilterBase::V210FilterBase(unsigned width, unsigned height, unsigned channel) :
+	m_attr{ width, height, PixelType::WORD },
+	m_channel{ channel }
+{
+	zassert_d(channel < 3, "bad channel");
+}
+
+auto V210FilterBase::get_flags() const -> filter_flags
+{
+	filter_flags flags{};
+
+	flags.same_row = true;
+
+	return flags;
+}
+
+auto V210FilterBase::get_image_attributes() const -> image_attributes
+{
+	return m_attr;
+}
+
+Y410FilterBase::Y410FilterBase(unsigned width, unsigned height) :
+	m_attr{ width, height, PixelType::WORD }
+{}
+
+auto Y410FilterBase::get_flags() const -> filter_flags
+{
+	filter_flags flags{};
+
+	flags.same_row = true;
+	flags.color = true;
+
+	return flags;
+}
+
+auto Y410FilterBase::get_image_attributes() const -> image_attributes
+{
+	return m_attr;
+}
+
+
+size_t packed_row_size(GraphBuilder::PixelPacking packing, unsigned width, PixelType type)
+{
+	typedef GraphBuilder::PixelPacking PixelPacking;
+
+	switch (packing) {
+	case PixelPacking::NV12:
+		return static_cast<size_t>(width) * pixel_size(type);
+	case PixelPacking::YUY2:
+		return static_cast<size_t>(width) * 2 * pixel_size(type);
+	case PixelPacking::V210:
+		return static_cast<size_t>((width + 5) / 6) * 16;
+	case PixelPacking::Y410:
+		return static_cast<size_t>(width) * 4;
+	default:
+		return static_cast<size_t>(width) * PackedLayout{ packing }.channels * pixel_size(type);
+	}
+}
+
+std::unique_ptr<ImageFilter> create_unpack_filter(const GraphBuilder::state &state, CPUClass cpu)
+{
+	PackedLayout layout{ state.packing };
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_unpack_filter_x86(layout, state.width, state.height, state.type, cpu);
+#endif
+	if (!ret)
+		ret = create_filter_c<UnpackFilter_C>(layout, state.width, state.height, state.type);
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_pack_filter(const GraphBuilder::state &state, CPUClass cpu)
+{
+	PackedLayout layout{ state.packing };
+	uint32_t alpha = alpha_value(state.type, state.depth);
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_pack_filter_x86(layout, state.width, state.height, state.type, alpha, cpu);
+#endif
+	if (!ret)
+		ret = create_filter_c<PackFilter_C>(layout, state.width, state.height, state.type, alpha);
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_deinterleave_filter(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu)
+{
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_deinterleave_filter_x86(width, height, type, stride, cpu);
+#endif
+	if (!ret)
+		ret = create_interleaved_filter_c<DeinterleaveFilter_C>(width, height, type, stride);
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_interleave_filter(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu)
+{
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_interleave_filter_x86(width, height, type, stride, cpu);
+#endif
+	if (!ret)
+		ret = create_interleaved_filter_c<InterleaveFilter_C>(width, height, type, stride);
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_v210_unpack_filter(unsigned width, unsigned height, unsigned channel, CPUClass cpu)
+{
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_v210_unpack_filter_x86(width, height, channel, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<V210UnpackFilter_C>(width, height, channel);
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_v210_pack_filter(unsigned width, unsigned height, unsigned channel, CPUClass cpu)
+{
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_v210_pack_filter_x86(width, height, channel, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<V210PackFilter_C>(width, height, channel);
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_y410_unpack_filter(unsigned width, unsigned height, CPUClass cpu)
+{
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_y410_unpack_filter_x86(width, height, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<Y410UnpackFilter_C>(width, height);
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_y410_pack_filter(unsigned width, unsigned height, CPUClass cpu)
+{
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_y410_pack_filter_x86(width, height, cpu);
+#endif
+	if (!ret)
+		ret = ztd::make_unique<Y410PackFilter_C>(width, height);
+
+	return ret;
+}
+
+} // namespace graph
+} // namespace zimg
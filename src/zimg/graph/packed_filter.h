@@ -0,0 +1,215 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_PACKED_FILTER_H_
+#define ZIMG_GRAPH_PACKED_FILTER_H_
+
+#include <cstdint>
+#include <memory>
+#include "graphbuilder.h"
+#include "image_filter.h"
+
+namespace zimg {
+
+enum class CPUClass;
+enum class PixelType;
+
+namespace graph {
+
+/**
+ * Position of the channels within a packed pixel.
+ */
+struct PackedLayout {
+	unsigned channels;  /**< samples per pixel, 3 or 4 */
+	unsigned offset[4]; /**< sample index of R, G, B, and alpha, if present */
+
+	/**
+	 * Construct the layout of a packed format.
+	 *
+	 * @param packing packed format, must not be planar
+	 */
+	explicit PackedLayout(GraphBuilder::PixelPacking packing);
+};
+
+/**
+ * Base class for conversions between packed and planar RGB.
+ *
+ * The packed pixels are stored in the first plane of the buffer, which is
+ * addressed in units of pixels. The other planes are not accessed.
+ */
+class PackedFilterBase : public ImageFilterBase {
+protected:
+	image_attributes m_attr;
+	PackedLayout m_layout;
+
+	PackedFilterBase(const PackedLayout &layout, unsigned width, unsigned height, PixelType type);
+public:
+	filter_flags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+};
+
+/**
+ * Base class for packing filters, which set alpha to a constant.
+ */
+class PackFilterBase : public PackedFilterBase {
+protected:
+	uint32_t m_alpha;
+
+	PackFilterBase(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha);
+};
+
+/**
+ * Base class for conversions between a plane and every second or fourth
+ * sample of an interleaved plane.
+ *
+ * The interleaved plane is addressed in units of samples. The filter reads or
+ * writes the samples at multiples of the stride, so the other samples are
+ * accessed by offsetting the plane.
+ */
+class InterleavedFilterBase : public ImageFilterBase {
+protected:
+	image_attributes m_attr;
+
+	InterleavedFilterBase(unsigned width, unsigned height, PixelType type, unsigned stride);
+public:
+	filter_flags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+};
+
+/**
+ * Base class for conversions between a plane and one channel of v210.
+ *
+ * A v210 row consists of groups of six 4:2:2 pixels, each stored in four
+ * 32-bit words holding three 10-bit samples. The samples of a group are
+ * ordered Cb Y Cr Y Cb Y Cr Y Cb Y Cr Y, from the low bits of the first word.
+ * All channels are read from and written to the first plane, which is
+ * addressed in units of bytes.
+ */
+class V210FilterBase : public ImageFilterBase {
+protected:
+	image_attributes m_attr;
+	unsigned m_channel;
+
+	V210FilterBase(unsigned width, unsigned height, unsigned channel);
+public:
+	filter_flags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+};
+
+/**
+ * Base class for conversions between planar YUV and Y410.
+ *
+ * Each pixel of Y410 is a 32-bit word holding 10-bit U, Y, and V samples and
+ * a 2-bit alpha channel, from the low bits. The packed pixels are stored in
+ * the first plane, which is addressed in units of pixels.
+ */
+class Y410FilterBase : public ImageFilterBase {
+protected:
+	image_attributes m_attr;
+
+	Y410FilterBase(unsigned width, unsigned height);
+public:
+	filter_flags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+};
+
+/**
+ * Get the number of bytes in the first plane of a row of packed pixels.
+ *
+ * @param packing packed format
+ * @param width image width
+ * @param type pixel type
+ * @return row size
+ */
+size_t packed_row_size(GraphBuilder::PixelPacking packing, unsigned width, PixelType type);
+
+/**
+ * Create a filter converting packed pixels to three planes.
+ *
+ * The alpha channel is discarded.
+ *
+ * @param state packed image format
+ * @param cpu cpu class
+ * @return filter
+ */
+std::unique_ptr<ImageFilter> create_unpack_filter(const GraphBuilder::state &state, CPUClass cpu);
+
+/**
+ * Create a filter converting three planes to packed pixels.
+ *
+ * The alpha channel is set to the maximum value of the pixel format.
+ *
+ * @see create_unpack_filter
+ */
+std::unique_ptr<ImageFilter> create_pack_filter(const GraphBuilder::state &state, CPUClass cpu);
+
+/**
+ * Create a filter reading a plane from every second or fourth sample.
+ *
+ * @param width width of the plane
+ * @param height height of the plane
+ * @param type pixel type
+ * @param stride distance between samples, 2 or 4
+ * @param cpu cpu class
+ * @return filter
+ */
+std::unique_ptr<ImageFilter> create_deinterleave_filter(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu);
+
+/**
+ * Create a filter writing a plane to every second or fourth sample.
+ *
+ * The samples in between are preserved.
+ *
+ * @see create_deinterleave_filter
+ */
+std::unique_ptr<ImageFilter> create_interleave_filter(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu);
+
+/**
+ * Create a filter reading one channel of v210 to a plane of WORD samples.
+ *
+ * @param width width of the plane, which is half the image width for chroma
+ * @param height height of the plane
+ * @param channel 0 for Y, 1 for Cb, or 2 for Cr
+ * @param cpu cpu class
+ * @return filter
+ */
+std::unique_ptr<ImageFilter> create_v210_unpack_filter(unsigned width, unsigned height, unsigned channel, CPUClass cpu);
+
+/**
+ * Create a filter writing a plane of WORD samples to one channel of v210.
+ *
+ * The samples of the other channels are preserved. The unused bits of each
+ * word written are cleared.
+ *
+ * @see create_v210_unpack_filter
+ */
+std::unique_ptr<ImageFilter> create_v210_pack_filter(unsigned width, unsigned height, unsigned channel, CPUClass cpu);
+
+/**
+ * Create a filter converting Y410 to three planes of WORD samples.
+ *
+ * The alpha channel is discarded.
+ *
+ * @param width image width
+ * @param height image height
+ * @param cpu cpu class
+ * @return filter
+ */
+std::unique_ptr<ImageFilter> create_y410_unpack_filter(unsigned width, unsigned height, CPUClass cpu);
+
+/**
+ * Create a filter converting three planes of WORD samples to Y410.
+ *
+ * The alpha channel is set to the maximum value.
+ *
+ * @see create_y410_unpack_filter
+ */
+std::unique_ptr<ImageFilter> create_y410_pack_filter(unsigned width, unsigned height, CPUClass cpu);
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_GRAPH_PACKED_FILTER_H_
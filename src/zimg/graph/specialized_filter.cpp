@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "common/cpuinfo.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "colorspace/colorspace_param.h"
+#include "colorspace/matrix3.h"
+#include "depth/quantize.h"
+#include "image_filter.h"
+#include "specialized_filter.h"
+
+#ifdef ZIMG_X86
+  #include "x86/specialized_filter_x86.h"
+#endif
+
+namespace zimg {
+namespace graph {
+
+namespace {
+
+template <class T, class U>
+void integer_matrix_line(const float (&coeffs)[3][3], const float (&bias)[3], float maxval,
+                         const T * const src[3], U * const dst[3], unsigned left, unsigned right)
+{
+	const float c00 = coeffs[0][0], c01 = coeffs[0][1], c02 = coeffs[0][2];
+	const float c10 = coeffs[1][0], c11 = coeffs[1][1], c12 = coeffs[1][2];
+	const float c20 = coeffs[2][0], c21 = coeffs[2][1], c22 = coeffs[2][2];
+	const float b0 = bias[0], b1 = bias[1], b2 = bias[2];
+
+	for (unsigned j = left; j < right; ++j) {
+		float a = static_cast<float>(src[0][j]);
+		float b = static_cast<float>(src[1][j]);
+		float c = static_cast<float>(src[2][j]);
+
+		float x = c00 * a + c01 * b + c02 * c + b0;
+		float y = c10 * a + c11 * b + c12 * c + b1;
+		float z = c20 * a + c21 * b + c22 * c + b2;
+
+		x = std::min(std::max(x, 0.0f), maxval);
+		y = std::min(std::max(y, 0.0f), maxval);
+		z = std::min(std::max(z, 0.0f), maxval);
+
+		dst[0][j] = static_cast<U>(std::lrint(x));
+		dst[1][j] = static_cast<U>(std::lrint(y));
+		dst[2][j] = static_cast<U>(std::lrint(z));
+	}
+}
+
+
+template <class T, class U>
+class IntegerMatrixFilter final : public IntegerMatrixFilterBase {
+public:
+	IntegerMatrixFilter(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height) :
+		IntegerMatrixFilterBase(m, format_in, format_out, width, height)
+	{}
+
+	const char *get_name() const override { return "integer_matrix_c"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const T *src_p[3];
+		U *dst_p[3];
+
+		for (unsigned p = 0; p < 3; ++p) {
+			src_p[p] = static_cast<const T *>(src[p][i]);
+			dst_p[p] = static_cast<U *>(dst[p][i]);
+		}
+
+		integer_matrix_line(m_coeffs, m_bias, m_maxval, src_p, dst_p, left, right);
+	}
+};
+
+
+bool is_ncl_yuv(const colorspace::ColorspaceDefinition &csp)
+{
+	switch (csp.matrix) {
+	case colorspace::MatrixCoefficients::REC_601:
+	case colorspace::MatrixCoefficients::REC_709:
+	case colorspace::MatrixCoefficients::FCC:
+	case colorspace::MatrixCoefficients::SMPTE_240M:
+	case colorspace::MatrixCoefficients::REC_2020_NCL:
+		return true;
+	case colorspace::MatrixCoefficients::CHROMATICITY_DERIVED_NCL:
+		return csp.primaries != colorspace::ColorPrimaries::UNSPECIFIED;
+	default:
+		return false;
+	}
+}
+
+bool is_integer_444(const GraphBuilder::state &state)
+{
+	return !pixel_is_float(state.type) &&
+		state.color != GraphBuilder::ColorFamily::GREY &&
+		!state.subsample_w && !state.subsample_h &&
+		state.active_left == 0.0 && state.active_top == 0.0 &&
+		state.active_width == state.width && state.active_height == state.height;
+}
+
+colorspace::Matrix3x3 ncl_yuv_to_rgb(const colorspace::ColorspaceDefinition &csp)
+{
+	return csp.matrix == colorspace::MatrixCoefficients::CHROMATICITY_DERIVED_NCL ?
+		colorspace::ncl_yuv_to_rgb_matrix_from_primaries(csp.primaries) : colorspace::ncl_yuv_to_rgb_matrix(csp.matrix);
+}
+
+colorspace::Matrix3x3 ncl_rgb_to_yuv(const colorspace::ColorspaceDefinition &csp)
+{
+	return csp.matrix == colorspace::MatrixCoefficients::CHROMATICITY_DERIVED_NCL ?
+		colorspace::ncl_rgb_to_yuv_matrix_from_primaries(csp.primaries) : colorspace::ncl_rgb_to_yuv_matrix(csp.matrix);
+}
+
+void get_plane_formats(const GraphBuilder::state &state, PixelFormat (&format)[3])
+{
+	for (unsigned p = 0; p < 3; ++p) {
+		format[p] = PixelFormat{ state.type, state.depth, state.fullrange, state.color == GraphBuilder::ColorFamily::YUV && p > 0 };
+	}
+}
+
+template <class T>
+std::unique_ptr<ImageFilter> create_integer_matrix_filter(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height)
+{
+	if (format_out[0].type == PixelType::BYTE)
+		return ztd::make_unique<IntegerMatrixFilter<T, uint8_t>>(m, format_in, format_out, width, height);
+	else
+		return ztd::make_unique<IntegerMatrixFilter<T, uint16_t>>(m, format_in, format_out, width, height);
+}
+
+std::unique_ptr<ImageFilter> create_integer_matrix_filter(const GraphBuilder::state &source, const GraphBuilder::state &target, CPUClass cpu)
+{
+	bool rgb_in = source.color == GraphBuilder::ColorFamily::RGB;
+	bool rgb_out = target.color == GraphBuilder::ColorFamily::RGB;
+
+	if (!is_integer_444(source) || !is_integer_444(target))
+		return nullptr;
+	if (source.width != target.width || source.height != target.height)
+		return nullptr;
+	if (source.colorspace.transfer != target.colorspace.transfer || source.colorspace.primaries != target.colorspace.primaries)
+		return nullptr;
+	if (rgb_in ? source.colorspace.matrix != colorspace::MatrixCoefficients::RGB : !is_ncl_yuv(source.colorspace))
+		return nullptr;
+	if (rgb_out ? target.colorspace.matrix != colorspace::MatrixCoefficients::RGB : !is_ncl_yuv(target.colorspace))
+		return nullptr;
+	if (source.colorspace == target.colorspace)
+		return nullptr;
+
+	colorspace::Matrix3x3 m;
+
+	if (rgb_in)
+		m = ncl_rgb_to_yuv(target.colorspace);
+	else if (rgb_out)
+		m = ncl_yuv_to_rgb(source.colorspace);
+	else
+		m = ncl_rgb_to_yuv(target.colorspace) * ncl_yuv_to_rgb(source.colorspace);
+
+	PixelFormat format_in[3];
+	PixelFormat format_out[3];
+	get_plane_formats(source, format_in);
+	get_plane_formats(target, format_out);
+
+	std::unique_ptr<ImageFilter> ret;
+
+#ifdef ZIMG_X86
+	ret = create_integer_matrix_filter_x86(m, format_in, format_out, source.width, source.height, cpu);
+#endif
+	// The scalar kernel is slower than the vectorized generic conversions.
+	if (!ret && cpu == CPUClass::NONE) {
+		if (source.type == PixelType::BYTE)
+			ret = create_integer_matrix_filter<uint8_t>(m, format_in, format_out, source.width, source.height);
+		else
+			ret = create_integer_matrix_filter<uint16_t>(m, format_in, format_out, source.width, source.height);
+	}
+
+	return ret;
+}
+
+} // namespace
+
+
+IntegerMatrixFilterBase::IntegerMatrixFilterBase(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height) :
+	m_coeffs{},
+	m_bias{},
+	m_maxval{ static_cast<float>(depth::numeric_max(format_out[0].depth)) },
+	m_width{ width },
+	m_height{ height },
+	m_type_in{ format_in[0].type },
+	m_type_out{ format_out[0].type }
+{
+	// Fold the range conversion of the input and output into the matrix:
+	// out = range_out * M * ((in - offset_in) / range_in) + offset_out
+	for (unsigned i = 0; i < 3; ++i) {
+		double bias = depth::integer_offset(format_out[i]);
+
+		for (unsigned j = 0; j < 3; ++j) {
+			double k = m[i][j] * depth::integer_range(format_out[i]) / depth::integer_range(format_in[j]);
+			bias -= k * depth::integer_offset(format_in[j]);
+			m_coeffs[i][j] = static_cast<float>(k);
+		}
+		m_bias[i] = static_cast<float>(bias);
+	}
+}
+
+auto IntegerMatrixFilterBase::get_flags() const -> filter_flags
+{
+	filter_flags flags{};
+
+	flags.same_row = true;
+	flags.in_place = pixel_size(m_type_in) == pixel_size(m_type_out);
+	flags.color = true;
+
+	return flags;
+}
+
+auto IntegerMatrixFilterBase::get_image_attributes() const -> image_attributes
+{
+	return{ m_width, m_height, m_type_out };
+}
+
+
+std::unique_ptr<ImageFilter> create_specialized_filter(const GraphBuilder::state &source, const GraphBuilder::state &target, const GraphBuilder::params *params)
+{
+	CPUClass cpu = params ? params->cpu : CPUClass::NONE;
+
+	// Specialized kernels round to nearest and do not support dithering.
+	if (params && (params->dither_type != depth::DitherType::NONE || params->unresize))
+		return nullptr;
+	if (source.parity != target.parity)
+		return nullptr;
+
+	return create_integer_matrix_filter(source, target, cpu);
+}
+
+} // namespace graph
+} // namespace zimg
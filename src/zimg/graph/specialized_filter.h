@@ -0,0 +1,68 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_SPECIALIZED_FILTER_H_
+#define ZIMG_GRAPH_SPECIALIZED_FILTER_H_
+
+#include <memory>
+#include "common/pixel.h"
+#include "graphbuilder.h"
+#include "image_filter.h"
+
+namespace zimg {
+
+enum class CPUClass;
+
+namespace colorspace {
+struct Matrix3x3;
+} // namespace colorspace
+
+namespace graph {
+
+/**
+ * Base class for single-pass matrix conversions between integer formats.
+ *
+ * The range conversion of the input and output is folded into the matrix.
+ * Samples are rounded to nearest after clamping.
+ */
+class IntegerMatrixFilterBase : public ImageFilterBase {
+protected:
+	float m_coeffs[3][3];
+	float m_bias[3];
+	float m_maxval;
+	unsigned m_width;
+	unsigned m_height;
+	PixelType m_type_in;
+	PixelType m_type_out;
+
+	IntegerMatrixFilterBase(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height);
+public:
+	filter_flags get_flags() const override;
+
+	image_attributes get_image_attributes() const override;
+};
+
+/**
+ * Create a single-pass filter for a known source and target format pair.
+ *
+ * Conversions between 4:4:4 integer RGB and non-constant luminance YUV at
+ * the same resolution, which otherwise require a depth conversion, a
+ * colorspace conversion, and a quantization, are performed by one kernel
+ * specialized for the pixel types with the range scaling folded into the
+ * matrix. No other conversions are specialized.
+ *
+ * A filter is only returned if it is faster than the generic conversions for
+ * the CPU selected by {@p params}, which requires a SIMD kernel unless SIMD is
+ * disabled altogether. Results may differ from the generic conversions by one
+ * code value.
+ *
+ * @param source input format
+ * @param target output format
+ * @param params filter creation parameters, may be null
+ * @return filter, or nullptr if no specialized kernel matches
+ */
+std::unique_ptr<ImageFilter> create_specialized_filter(const GraphBuilder::state &source, const GraphBuilder::state &target, const GraphBuilder::params *params);
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_GRAPH_SPECIALIZED_FILTER_H_
@@ -0,0 +1,108 @@
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include "common/cpuinfo.h"
+#include "common/version.h"
+#include "filtergraph.h"
+#include "tile_profile.h"
+
+namespace zimg {
+namespace graph {
+
+namespace {
+
+typedef std::pair<std::string, unsigned long long> profile_key;
+
+std::mutex g_profile_mutex;
+std::map<profile_key, unsigned> g_profile_cache;
+
+// Profile entries are stored one per line as "<signature> <tile width> <version> <cpu model>".
+unsigned read_profile(const std::string &path, const profile_key &key)
+{
+	std::FILE *file = std::fopen(path.c_str(), "r");
+	unsigned tile_width = 0;
+	char line[256];
+
+	if (!file)
+		return 0;
+
+	while (std::fgets(line, sizeof(line), file)) {
+		char *ptr = line;
+		char *end;
+
+		unsigned long long signature = std::strtoull(ptr, &end, 16);
+		if (end == ptr || *end != ' ')
+			continue;
+		ptr = end + 1;
+
+		unsigned long width = std::strtoul(ptr, &end, 10);
+		if (end == ptr || *end != ' ' || !width || width > UINT_MAX)
+			continue;
+		ptr = end + 1;
+
+		ptr[std::strcspn(ptr, "\r\n")] = '\0';
+
+		// Later entries take precedence.
+		if (signature == key.second && key.first == ptr)
+			tile_width = static_cast<unsigned>(width);
+	}
+
+	std::fclose(file);
+	return tile_width;
+}
+
+void write_profile(const std::string &path, const profile_key &key, unsigned tile_width)
+{
+	std::FILE *file = std::fopen(path.c_str(), "a");
+
+	if (!file)
+		return;
+
+	std::fprintf(file, "%016llx %u %s\n", key.second, tile_width, key.first.c_str());
+	std::fclose(file);
+}
+
+// Filter implementations and their tiling change between versions, so
+// results are not reused by a different version of the library.
+std::string profile_host()
+{
+	char version[32];
+	std::snprintf(version, sizeof(version), "%u.%u.%u ", VERSION_INFO[0], VERSION_INFO[1], VERSION_INFO[2]);
+	return version + std::string{ cpu_model_name() };
+}
+
+} // namespace
+
+
+unsigned autotune_tile_width(FilterGraph &graph, const std::string &profile)
+{
+	profile_key key{ profile_host(), graph.signature() };
+
+	// Benchmarks are serialized, so that concurrent measurements do not
+	// compete for processor resources.
+	std::lock_guard<std::mutex> lock{ g_profile_mutex };
+
+	auto it = g_profile_cache.find(key);
+	if (it != g_profile_cache.end())
+		return it->second;
+
+	unsigned tile_width = profile.empty() ? 0 : read_profile(profile, key);
+
+	if (!tile_width) {
+		tile_width = graph.benchmark_tile_width();
+
+		if (!profile.empty())
+			write_profile(profile, key, tile_width);
+	}
+
+	g_profile_cache.emplace(key, tile_width);
+	return tile_width;
+}
+
+} // namespace graph
+} // namespace zimg
@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef ZIMG_GRAPH_TILE_PROFILE_H_
+#define ZIMG_GRAPH_TILE_PROFILE_H_
+
+#include <string>
+
+namespace zimg {
+namespace graph {
+
+class FilterGraph;
+
+/**
+ * Select the tile width for a graph by measuring its execution speed.
+ *
+ * Results are keyed by the graph signature, library version, and processor
+ * model, and are retained for the lifetime of the process. If {@p profile}
+ * is not empty, results are also read from and appended to the named file,
+ * allowing them to be reused by later processes. Errors accessing the file
+ * are ignored.
+ *
+ * @param graph completed graph
+ * @param profile path to profile, may be empty
+ * @return tile width in output pixels
+ */
+unsigned autotune_tile_width(FilterGraph &graph, const std::string &profile);
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_GRAPH_TILE_PROFILE_H_
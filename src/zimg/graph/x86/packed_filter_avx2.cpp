@@ -0,0 +1,733 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/except.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "graph/image_filter.h"
+#include "graph/packed_filter.h"
+#include "packed_filter_x86.h"
+
+namespace zimg {
+namespace graph {
+
+namespace {
+
+// Each 128-bit lane processes a group of 16 bytes from every plane. The packed
+// pixels of a group occupy N consecutive vectors, which are combined by byte
+// shuffles computed from the layout when the filter is created.
+
+void make_unpack_shuffle(uint8_t shuffle[16], const PackedLayout &layout, unsigned size, unsigned c, unsigned v)
+{
+	for (unsigned k = 0; k < 16; ++k) {
+		unsigned byte = ((k / size) * layout.channels + layout.offset[c]) * size + k % size;
+		shuffle[k] = byte / 16 == v ? byte % 16 : 0x80;
+	}
+}
+
+void make_pack_shuffle(uint8_t shuffle[16], const PackedLayout &layout, unsigned size, unsigned c, unsigned v)
+{
+	for (unsigned k = 0; k < 16; ++k) {
+		unsigned byte = v * 16 + k;
+		unsigned sample = byte / size;
+		shuffle[k] = sample % layout.channels == layout.offset[c] ? (sample / layout.channels) * size + byte % size : 0x80;
+	}
+}
+
+void make_pack_alpha(uint8_t alpha_bytes[16], const PackedLayout &layout, unsigned size, uint32_t alpha, unsigned v)
+{
+	for (unsigned k = 0; k < 16; ++k) {
+		unsigned byte = v * 16 + k;
+		unsigned sample = byte / size;
+		alpha_bytes[k] = sample % layout.channels == layout.offset[3] ? static_cast<uint8_t>(alpha >> (8 * (byte % size))) : 0;
+	}
+}
+
+inline FORCE_INLINE __m256i load_shuffle(const uint8_t shuffle[16])
+{
+	return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shuffle));
+}
+
+
+template <unsigned N>
+class UnpackFilter_AVX2 final : public PackedFilterBase {
+	uint8_t m_shuffle[3][N][16];
+public:
+	UnpackFilter_AVX2(const PackedLayout &layout, unsigned width, unsigned height, PixelType type) :
+		PackedFilterBase(layout, width, height, type),
+		m_shuffle{}
+	{
+		for (unsigned c = 0; c < 3; ++c) {
+			for (unsigned v = 0; v < N; ++v) {
+				make_unpack_shuffle(m_shuffle[c][v], layout, pixel_size(type), c, v);
+			}
+		}
+	}
+
+	const char *get_name() const override { return "unpack_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const uint8_t *src_p = static_cast<const uint8_t *>(src[0][i]);
+		uint8_t *dst_p[3] = { static_cast<uint8_t *>(dst[0][i]), static_cast<uint8_t *>(dst[1][i]), static_cast<uint8_t *>(dst[2][i]) };
+
+		size_t size = pixel_size(m_attr.type);
+		unsigned step = static_cast<unsigned>(32 / size);
+		unsigned vec_right = left + floor_n(right - left, step);
+
+		__m256i shuffle[3][N];
+
+		for (unsigned c = 0; c < 3; ++c) {
+			for (unsigned v = 0; v < N; ++v) {
+				shuffle[c][v] = load_shuffle(m_shuffle[c][v]);
+			}
+		}
+
+		for (unsigned j = left; j < vec_right; j += step) {
+			const uint8_t *src_j = src_p + j * size * N;
+			__m256i x[N];
+
+			for (unsigned v = 0; v < N; ++v) {
+				x[v] = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(src_j + v * 16)));
+				x[v] = _mm256_inserti128_si256(x[v], _mm_loadu_si128((const __m128i *)(src_j + (N + v) * 16)), 1);
+			}
+
+			for (unsigned c = 0; c < 3; ++c) {
+				__m256i y = _mm256_shuffle_epi8(x[0], shuffle[c][0]);
+
+				for (unsigned v = 1; v < N; ++v) {
+					y = _mm256_or_si256(y, _mm256_shuffle_epi8(x[v], shuffle[c][v]));
+				}
+				_mm256_storeu_si256((__m256i *)(dst_p[c] + j * size), y);
+			}
+		}
+
+		for (unsigned j = vec_right; j < right; ++j) {
+			for (unsigned c = 0; c < 3; ++c) {
+				std::memcpy(dst_p[c] + j * size, src_p + (static_cast<size_t>(j) * N + m_layout.offset[c]) * size, size);
+			}
+		}
+	}
+};
+
+template <unsigned N>
+class PackFilter_AVX2 final : public PackFilterBase {
+	uint8_t m_shuffle[3][N][16];
+	uint8_t m_alpha_bytes[N][16];
+public:
+	PackFilter_AVX2(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha) :
+		PackFilterBase(layout, width, height, type, alpha),
+		m_shuffle{},
+		m_alpha_bytes{}
+	{
+		for (unsigned v = 0; v < N; ++v) {
+			for (unsigned c = 0; c < 3; ++c) {
+				make_pack_shuffle(m_shuffle[c][v], layout, pixel_size(type), c, v);
+			}
+			if (N == 4)
+				make_pack_alpha(m_alpha_bytes[v], layout, pixel_size(type), alpha, v);
+		}
+	}
+
+	const char *get_name() const override { return "pack_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const uint8_t *src_p[3] = { static_cast<const uint8_t *>(src[0][i]), static_cast<const uint8_t *>(src[1][i]), static_cast<const uint8_t *>(src[2][i]) };
+		uint8_t *dst_p = static_cast<uint8_t *>(dst[0][i]);
+
+		size_t size = pixel_size(m_attr.type);
+		unsigned step = static_cast<unsigned>(32 / size);
+		unsigned vec_right = left + floor_n(right - left, step);
+
+		__m256i shuffle[3][N];
+		__m256i alpha[N];
+
+		for (unsigned v = 0; v < N; ++v) {
+			for (unsigned c = 0; c < 3; ++c) {
+				shuffle[c][v] = load_shuffle(m_shuffle[c][v]);
+			}
+			alpha[v] = load_shuffle(m_alpha_bytes[v]);
+		}
+
+		for (unsigned j = left; j < vec_right; j += step) {
+			uint8_t *dst_j = dst_p + j * size * N;
+			__m256i x[3];
+
+			for (unsigned c = 0; c < 3; ++c) {
+				x[c] = _mm256_loadu_si256((const __m256i *)(src_p[c] + j * size));
+			}
+
+			for (unsigned v = 0; v < N; ++v) {
+				__m256i y = _mm256_shuffle_epi8(x[0], shuffle[0][v]);
+				y = _mm256_or_si256(y, _mm256_shuffle_epi8(x[1], shuffle[1][v]));
+				y = _mm256_or_si256(y, _mm256_shuffle_epi8(x[2], shuffle[2][v]));
+
+				if (N == 4)
+					y = _mm256_or_si256(y, alpha[v]);
+
+				_mm_storeu_si128((__m128i *)(dst_j + v * 16), _mm256_castsi256_si128(y));
+				_mm_storeu_si128((__m128i *)(dst_j + (N + v) * 16), _mm256_extracti128_si256(y, 1));
+			}
+		}
+
+		for (unsigned j = vec_right; j < right; ++j) {
+			for (unsigned c = 0; c < 3; ++c) {
+				std::memcpy(dst_p + (static_cast<size_t>(j) * N + m_layout.offset[c]) * size, src_p[c] + j * size, size);
+			}
+			if (N == 4)
+				std::memcpy(dst_p + (static_cast<size_t>(j) * N + m_layout.offset[3]) * size, &m_alpha, size);
+		}
+	}
+};
+
+
+// Mask selecting the even samples of a vector.
+template <unsigned Size>
+inline FORCE_INLINE __m256i even_mask()
+{
+	if (Size == 1)
+		return _mm256_set1_epi16(0x00FF);
+	else if (Size == 2)
+		return _mm256_set1_epi32(0x0000FFFF);
+	else
+		return _mm256_set1_epi64x(0x00000000FFFFFFFFLL);
+}
+
+template <unsigned Size>
+inline FORCE_INLINE __m256i deinterleave(__m256i a, __m256i b)
+{
+	__m256i x;
+
+	if (Size == 1)
+		x = _mm256_packus_epi16(_mm256_and_si256(a, even_mask<1>()), _mm256_and_si256(b, even_mask<1>()));
+	else if (Size == 2)
+		x = _mm256_packus_epi32(_mm256_and_si256(a, even_mask<2>()), _mm256_and_si256(b, even_mask<2>()));
+	else
+		x = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+
+	// The in-lane packs leave the halves of a and b in alternating quadwords.
+	return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+template <unsigned Size>
+inline FORCE_INLINE __m256i interleave_lo(__m256i x)
+{
+	if (Size == 1)
+		return _mm256_unpacklo_epi8(x, _mm256_setzero_si256());
+	else if (Size == 2)
+		return _mm256_unpacklo_epi16(x, _mm256_setzero_si256());
+	else
+		return _mm256_unpacklo_epi32(x, _mm256_setzero_si256());
+}
+
+template <unsigned Size>
+inline FORCE_INLINE __m256i interleave_hi(__m256i x)
+{
+	if (Size == 1)
+		return _mm256_unpackhi_epi8(x, _mm256_setzero_si256());
+	else if (Size == 2)
+		return _mm256_unpackhi_epi16(x, _mm256_setzero_si256());
+	else
+		return _mm256_unpackhi_epi32(x, _mm256_setzero_si256());
+}
+
+// Interleave the samples of x with zeros, in order.
+template <unsigned Size>
+inline FORCE_INLINE void interleave(__m256i x, __m256i &lo, __m256i &hi)
+{
+	// Order the quadwords so that the in-lane unpacks produce consecutive samples.
+	x = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 1, 2, 0));
+	lo = interleave_lo<Size>(x);
+	hi = interleave_hi<Size>(x);
+}
+
+// Mask selecting every second or fourth sample of a vector.
+template <unsigned Size, unsigned Stride>
+inline FORCE_INLINE __m256i stride_mask()
+{
+	return Stride == 4 ? interleave_lo<Size>(even_mask<Size>()) : even_mask<Size>();
+}
+
+// In the offset planes, the last vector of a span would access samples after
+// the span, so the vector loops stop one vector early.
+template <unsigned Size, unsigned Stride>
+void deinterleave_line_avx2(const uint8_t *src, uint8_t *dst, unsigned left, unsigned right)
+{
+	constexpr unsigned step = 32 / Size;
+	unsigned j = left;
+
+	for (; j + step < right; j += step) {
+		const uint8_t *src_j = src + static_cast<size_t>(j) * Stride * Size;
+
+		__m256i a = _mm256_loadu_si256((const __m256i *)(src_j + 0));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(src_j + 32));
+		__m256i x = deinterleave<Size>(a, b);
+
+		if (Stride == 4) {
+			__m256i c = _mm256_loadu_si256((const __m256i *)(src_j + 64));
+			__m256i d = _mm256_loadu_si256((const __m256i *)(src_j + 96));
+			x = deinterleave<Size>(x, deinterleave<Size>(c, d));
+		}
+
+		_mm256_storeu_si256((__m256i *)(dst + static_cast<size_t>(j) * Size), x);
+	}
+	for (; j < right; ++j) {
+		std::memcpy(dst + static_cast<size_t>(j) * Size, src + static_cast<size_t>(j) * Stride * Size, Size);
+	}
+}
+
+template <unsigned Size, unsigned Stride>
+void interleave_line_avx2(const uint8_t *src, uint8_t *dst, unsigned left, unsigned right)
+{
+	constexpr unsigned step = 32 / Size;
+	const __m256i mask = stride_mask<Size, Stride>();
+	unsigned j = left;
+
+	for (; j + step < right; j += step) {
+		uint8_t *dst_j = dst + static_cast<size_t>(j) * Stride * Size;
+
+		__m256i x = _mm256_loadu_si256((const __m256i *)(src + static_cast<size_t>(j) * Size));
+		__m256i v[4];
+
+		if (Stride == 4) {
+			__m256i lo, hi;
+
+			interleave<Size>(x, lo, hi);
+			interleave<Size>(lo, v[0], v[1]);
+			interleave<Size>(hi, v[2], v[3]);
+		} else {
+			interleave<Size>(x, v[0], v[1]);
+		}
+
+		for (unsigned n = 0; n < Stride; ++n) {
+			__m256i y = _mm256_loadu_si256((const __m256i *)(dst_j + n * 32));
+			y = _mm256_or_si256(_mm256_andnot_si256(mask, y), v[n]);
+			_mm256_storeu_si256((__m256i *)(dst_j + n * 32), y);
+		}
+	}
+	for (; j < right; ++j) {
+		std::memcpy(dst + static_cast<size_t>(j) * Stride * Size, src + static_cast<size_t>(j) * Size, Size);
+	}
+}
+
+
+template <unsigned Size, unsigned Stride>
+class DeinterleaveFilter_AVX2 final : public InterleavedFilterBase {
+public:
+	DeinterleaveFilter_AVX2(unsigned width, unsigned height, PixelType type) :
+		InterleavedFilterBase(width, height, type, Stride)
+	{}
+
+	const char *get_name() const override { return "deinterleave_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		deinterleave_line_avx2<Size, Stride>(static_cast<const uint8_t *>(src[0][i]), static_cast<uint8_t *>(dst[0][i]), left, right);
+	}
+};
+
+template <unsigned Size, unsigned Stride>
+class InterleaveFilter_AVX2 final : public InterleavedFilterBase {
+public:
+	InterleaveFilter_AVX2(unsigned width, unsigned height, PixelType type) :
+		InterleavedFilterBase(width, height, type, Stride)
+	{}
+
+	const char *get_name() const override { return "interleave_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		interleave_line_avx2<Size, Stride>(static_cast<const uint8_t *>(src[0][i]), static_cast<uint8_t *>(dst[0][i]), left, right);
+	}
+};
+
+
+template <template <unsigned, unsigned> class Filter, unsigned Stride>
+std::unique_ptr<ImageFilter> create_interleaved_filter_avx2(unsigned width, unsigned height, PixelType type)
+{
+	switch (pixel_size(type)) {
+	case 1:
+		return ztd::make_unique<Filter<1, Stride>>(width, height, type);
+	case 2:
+		return ztd::make_unique<Filter<2, Stride>>(width, height, type);
+	case 4:
+		return ztd::make_unique<Filter<4, Stride>>(width, height, type);
+	default:
+		error::throw_<error::InternalError>("unsupported pixel type");
+	}
+}
+
+template <template <unsigned, unsigned> class Filter>
+std::unique_ptr<ImageFilter> create_interleaved_filter_avx2(unsigned width, unsigned height, PixelType type, unsigned stride)
+{
+	switch (stride) {
+	case 2:
+		return create_interleaved_filter_avx2<Filter, 2>(width, height, type);
+	case 4:
+		return create_interleaved_filter_avx2<Filter, 4>(width, height, type);
+	default:
+		error::throw_<error::InternalError>("unsupported stride");
+	}
+}
+
+
+// Vector constants for one channel of v210. The words of two groups are
+// gathered by a cross-lane permutation so that each sample of the channel is
+// aligned to its own dword, after which a variable shift moves it to bit 0.
+// The constants are created on the stack, as the filter objects are not
+// allocated with 32-byte alignment.
+struct V210Constants {
+	__m256i unpack_index[2];
+	__m256i unpack_shift[2];
+	__m256i pack_index[2];
+	__m256i pack_shift[2];
+	__m256i keep_mask;
+};
+
+V210Constants make_v210_constants(unsigned channel)
+{
+	V210Constants c;
+
+	// Shifts of 32 produce zero, discarding unused dwords. The words holding no
+	// sample of the channel are kept intact by the pack mask.
+	if (channel == 0) {
+		// Y0..Y7 in the first vector and Y8..Y11 in the second.
+		c.unpack_index[0] = _mm256_setr_epi32(0, 1, 1, 2, 3, 3, 4, 5);
+		c.unpack_shift[0] = _mm256_setr_epi32(10, 0, 20, 10, 0, 20, 10, 0);
+		c.unpack_index[1] = _mm256_setr_epi32(5, 6, 7, 7, 0, 0, 0, 0);
+		c.unpack_shift[1] = _mm256_setr_epi32(20, 10, 0, 20, 32, 32, 32, 32);
+
+		// Each word holds one or two luma samples, from Y0..Y7 and Y8..Y11.
+		c.pack_index[0] = _mm256_setr_epi32(0, 1, 3, 4, 6, 7, 1, 2);
+		c.pack_shift[0] = _mm256_setr_epi32(10, 0, 10, 0, 10, 0, 10, 0);
+		c.pack_index[1] = _mm256_setr_epi32(0, 2, 0, 5, 0, 0, 0, 3);
+		c.pack_shift[1] = _mm256_setr_epi32(32, 20, 32, 20, 32, 20, 32, 20);
+
+		c.keep_mask = _mm256_set1_epi64x(0x000FFC003FF003FFLL);
+	} else if (channel == 1) {
+		c.unpack_index[0] = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 0, 0);
+		c.unpack_shift[0] = _mm256_setr_epi32(0, 10, 20, 0, 10, 20, 32, 32);
+		c.unpack_index[1] = _mm256_setzero_si256();
+		c.unpack_shift[1] = _mm256_set1_epi32(32);
+
+		c.pack_index[0] = _mm256_setr_epi32(0, 1, 2, 7, 3, 4, 5, 7);
+		c.pack_shift[0] = _mm256_setr_epi32(0, 10, 20, 32, 0, 10, 20, 32);
+		c.pack_index[1] = _mm256_setzero_si256();
+		c.pack_shift[1] = _mm256_set1_epi32(32);
+
+		c.keep_mask = _mm256_setr_epi32(0x3FFFFC00, 0x3FF003FF, 0x000FFFFF, -1, 0x3FFFFC00, 0x3FF003FF, 0x000FFFFF, -1);
+	} else {
+		c.unpack_index[0] = _mm256_setr_epi32(0, 2, 3, 4, 6, 7, 0, 0);
+		c.unpack_shift[0] = _mm256_setr_epi32(20, 0, 10, 20, 0, 10, 32, 32);
+		c.unpack_index[1] = _mm256_setzero_si256();
+		c.unpack_shift[1] = _mm256_set1_epi32(32);
+
+		c.pack_index[0] = _mm256_setr_epi32(0, 7, 1, 2, 3, 7, 4, 5);
+		c.pack_shift[0] = _mm256_setr_epi32(20, 32, 0, 10, 20, 32, 0, 10);
+		c.pack_index[1] = _mm256_setzero_si256();
+		c.pack_shift[1] = _mm256_set1_epi32(32);
+
+		c.keep_mask = _mm256_setr_epi32(0x000FFFFF, -1, 0x3FFFFC00, 0x3FF003FF, 0x000FFFFF, -1, 0x3FFFFC00, 0x3FF003FF);
+	}
+
+	return c;
+}
+
+// Index of the n-th sample of a channel within a v210 group.
+inline unsigned v210_sample_index(unsigned channel, unsigned n)
+{
+	return channel ? n * 4 + (channel - 1) * 2 : n * 2 + 1;
+}
+
+void v210_unpack_scalar(const uint8_t *src, uint8_t *dst, unsigned channel, unsigned left, unsigned right)
+{
+	unsigned group_size = channel ? 3 : 6;
+
+	for (unsigned j = left; j < right; ++j) {
+		const uint8_t *group = src + static_cast<size_t>(j / group_size) * 16;
+		unsigned k = v210_sample_index(channel, j % group_size);
+		uint32_t word;
+
+		std::memcpy(&word, group + k / 3 * 4, sizeof(word));
+		uint16_t x = static_cast<uint16_t>((word >> (k % 3 * 10)) & 0x3FF);
+		std::memcpy(dst + static_cast<size_t>(j) * 2, &x, sizeof(x));
+	}
+}
+
+void v210_pack_scalar(const uint8_t *src, uint8_t *dst, unsigned channel, unsigned left, unsigned right)
+{
+	unsigned group_size = channel ? 3 : 6;
+
+	for (unsigned j = left; j < right; ++j) {
+		uint8_t *group = dst + static_cast<size_t>(j / group_size) * 16;
+		unsigned k = v210_sample_index(channel, j % group_size);
+		unsigned shift = k % 3 * 10;
+		uint32_t word;
+		uint16_t x;
+
+		std::memcpy(&word, group + k / 3 * 4, sizeof(word));
+		std::memcpy(&x, src + static_cast<size_t>(j) * 2, sizeof(x));
+		word = (word & ~(UINT32_C(0x3FF) << shift) & UINT32_C(0x3FFFFFFF)) | (static_cast<uint32_t>(x & 0x3FF) << shift);
+		std::memcpy(group + k / 3 * 4, &word, sizeof(word));
+	}
+}
+
+// Process the groups entirely within the span two at a time, and the
+// partial groups at either end one sample at a time.
+template <class Vector, class Scalar>
+void v210_line_avx2(unsigned channel, unsigned left, unsigned right, Vector vector_func, Scalar scalar_func)
+{
+	unsigned group_size = channel ? 3 : 6;
+	unsigned g = (left + group_size - 1) / group_size;
+	unsigned j = std::min(g * group_size, right);
+
+	scalar_func(left, j);
+
+	for (; (g + 2) * group_size <= right; g += 2) {
+		vector_func(static_cast<size_t>(g) * 16, static_cast<size_t>(g) * group_size * 2);
+		j += group_size * 2;
+	}
+
+	scalar_func(j, right);
+}
+
+
+class V210UnpackFilter_AVX2 final : public V210FilterBase {
+public:
+	V210UnpackFilter_AVX2(unsigned width, unsigned height, unsigned channel) :
+		V210FilterBase(width, height, channel)
+	{}
+
+	const char *get_name() const override { return "v210_unpack_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const V210Constants c = make_v210_constants(m_channel);
+		const __m256i mask = _mm256_set1_epi32(0x3FF);
+		const uint8_t *src_p = static_cast<const uint8_t *>(src[0][i]);
+		uint8_t *dst_p = static_cast<uint8_t *>(dst[0][i]);
+
+		auto scalar = [=](unsigned left_, unsigned right_) { v210_unpack_scalar(src_p, dst_p, m_channel, left_, right_); };
+
+		if (m_channel) {
+			// Six chroma samples per pair of groups.
+			auto vector = [&](size_t src_offset, size_t dst_offset)
+			{
+				__m256i w = _mm256_loadu_si256((const __m256i *)(src_p + src_offset));
+				__m256i x = _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(w, c.unpack_index[0]), c.unpack_shift[0]), mask);
+				x = _mm256_permute4x64_epi64(_mm256_packus_epi32(x, x), _MM_SHUFFLE(3, 1, 2, 0));
+
+				__m128i y = _mm256_castsi256_si128(x);
+				uint32_t tail = static_cast<uint32_t>(_mm_extract_epi32(y, 2));
+
+				_mm_storel_epi64((__m128i *)(dst_p + dst_offset), y);
+				std::memcpy(dst_p + dst_offset + 8, &tail, sizeof(tail));
+			};
+			v210_line_avx2(m_channel, left, right, vector, scalar);
+		} else {
+			// Twelve luma samples per pair of groups.
+			auto vector = [&](size_t src_offset, size_t dst_offset)
+			{
+				__m256i w = _mm256_loadu_si256((const __m256i *)(src_p + src_offset));
+				__m256i lo = _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(w, c.unpack_index[0]), c.unpack_shift[0]), mask);
+				__m256i hi = _mm256_and_si256(_mm256_srlv_epi32(_mm256_permutevar8x32_epi32(w, c.unpack_index[1]), c.unpack_shift[1]), mask);
+				__m256i x = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+
+				_mm_storeu_si128((__m128i *)(dst_p + dst_offset), _mm256_castsi256_si128(x));
+				_mm_storel_epi64((__m128i *)(dst_p + dst_offset + 16), _mm256_extracti128_si256(x, 1));
+			};
+			v210_line_avx2(m_channel, left, right, vector, scalar);
+		}
+	}
+};
+
+class V210PackFilter_AVX2 final : public V210FilterBase {
+public:
+	V210PackFilter_AVX2(unsigned width, unsigned height, unsigned channel) :
+		V210FilterBase(width, height, channel)
+	{}
+
+	const char *get_name() const override { return "v210_pack_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const V210Constants c = make_v210_constants(m_channel);
+		const __m256i mask = _mm256_set1_epi32(0x3FF);
+		const uint8_t *src_p = static_cast<const uint8_t *>(src[0][i]);
+		uint8_t *dst_p = static_cast<uint8_t *>(dst[0][i]);
+
+		auto scalar = [=](unsigned left_, unsigned right_) { v210_pack_scalar(src_p, dst_p, m_channel, left_, right_); };
+		auto store = [&](size_t dst_offset, __m256i x)
+		{
+			__m256i w = _mm256_loadu_si256((const __m256i *)(dst_p + dst_offset));
+			w = _mm256_or_si256(_mm256_and_si256(w, c.keep_mask), x);
+			_mm256_storeu_si256((__m256i *)(dst_p + dst_offset), w);
+		};
+
+		if (m_channel) {
+			auto vector = [&](size_t dst_offset, size_t src_offset)
+			{
+				uint32_t tail;
+				std::memcpy(&tail, src_p + src_offset + 8, sizeof(tail));
+
+				__m128i y = _mm_insert_epi32(_mm_loadl_epi64((const __m128i *)(src_p + src_offset)), static_cast<int>(tail), 2);
+				__m256i x = _mm256_and_si256(_mm256_cvtepu16_epi32(y), mask);
+
+				store(dst_offset, _mm256_sllv_epi32(_mm256_permutevar8x32_epi32(x, c.pack_index[0]), c.pack_shift[0]));
+			};
+			v210_line_avx2(m_channel, left, right, vector, scalar);
+		} else {
+			auto vector = [&](size_t dst_offset, size_t src_offset)
+			{
+				__m256i lo = _mm256_and_si256(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src_p + src_offset))), mask);
+				__m256i hi = _mm256_and_si256(_mm256_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(src_p + src_offset + 16))), mask);
+
+				// The samples of the last two words come from Y8..Y11.
+				__m256i x = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(lo, c.pack_index[0]), _mm256_permutevar8x32_epi32(hi, c.pack_index[0]), 0xC0);
+				__m256i y = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(lo, c.pack_index[1]), _mm256_permutevar8x32_epi32(hi, c.pack_index[1]), 0xA0);
+
+				x = _mm256_sllv_epi32(x, c.pack_shift[0]);
+				y = _mm256_sllv_epi32(y, c.pack_shift[1]);
+				store(dst_offset, _mm256_or_si256(x, y));
+			};
+			v210_line_avx2(m_channel, left, right, vector, scalar);
+		}
+	}
+};
+
+
+class Y410UnpackFilter_AVX2 final : public Y410FilterBase {
+public:
+	Y410UnpackFilter_AVX2(unsigned width, unsigned height) :
+		Y410FilterBase(width, height)
+	{}
+
+	const char *get_name() const override { return "y410_unpack_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const uint32_t *src_p = static_cast<const uint32_t *>(src[0][i]);
+		uint16_t *dst_p[3] = { static_cast<uint16_t *>(dst[0][i]), static_cast<uint16_t *>(dst[1][i]), static_cast<uint16_t *>(dst[2][i]) };
+
+		const __m256i mask = _mm256_set1_epi32(0x3FF);
+		unsigned vec_right = left + floor_n(right - left, 16);
+
+		for (unsigned j = left; j < vec_right; j += 16) {
+			__m256i a = _mm256_loadu_si256((const __m256i *)(src_p + j + 0));
+			__m256i b = _mm256_loadu_si256((const __m256i *)(src_p + j + 8));
+
+			__m256i y = _mm256_packus_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), mask), _mm256_and_si256(_mm256_srli_epi32(b, 10), mask));
+			__m256i u = _mm256_packus_epi32(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+			__m256i v = _mm256_packus_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), mask), _mm256_and_si256(_mm256_srli_epi32(b, 20), mask));
+
+			_mm256_storeu_si256((__m256i *)(dst_p[0] + j), _mm256_permute4x64_epi64(y, _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm256_storeu_si256((__m256i *)(dst_p[1] + j), _mm256_permute4x64_epi64(u, _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm256_storeu_si256((__m256i *)(dst_p[2] + j), _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0)));
+		}
+		for (unsigned j = vec_right; j < right; ++j) {
+			uint32_t x = src_p[j];
+
+			dst_p[0][j] = static_cast<uint16_t>((x >> 10) & 0x3FF);
+			dst_p[1][j] = static_cast<uint16_t>(x & 0x3FF);
+			dst_p[2][j] = static_cast<uint16_t>((x >> 20) & 0x3FF);
+		}
+	}
+};
+
+class Y410PackFilter_AVX2 final : public Y410FilterBase {
+public:
+	Y410PackFilter_AVX2(unsigned width, unsigned height) :
+		Y410FilterBase(width, height)
+	{}
+
+	const char *get_name() const override { return "y410_pack_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const uint16_t *src_p[3] = { static_cast<const uint16_t *>(src[0][i]), static_cast<const uint16_t *>(src[1][i]), static_cast<const uint16_t *>(src[2][i]) };
+		uint32_t *dst_p = static_cast<uint32_t *>(dst[0][i]);
+
+		const __m256i mask = _mm256_set1_epi32(0x3FF);
+		const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xC0000000U));
+		unsigned vec_right = left + floor_n(right - left, 8);
+
+		for (unsigned j = left; j < vec_right; j += 8) {
+			__m256i y = _mm256_and_si256(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src_p[0] + j))), mask);
+			__m256i u = _mm256_and_si256(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src_p[1] + j))), mask);
+			__m256i v = _mm256_and_si256(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src_p[2] + j))), mask);
+
+			__m256i x = _mm256_or_si256(u, _mm256_slli_epi32(y, 10));
+			x = _mm256_or_si256(x, _mm256_slli_epi32(v, 20));
+			x = _mm256_or_si256(x, alpha);
+
+			_mm256_storeu_si256((__m256i *)(dst_p + j), x);
+		}
+		for (unsigned j = vec_right; j < right; ++j) {
+			uint32_t y = src_p[0][j] & 0x3FF;
+			uint32_t u = src_p[1][j] & 0x3FF;
+			uint32_t v = src_p[2][j] & 0x3FF;
+
+			dst_p[j] = u | (y << 10) | (v << 20) | UINT32_C(0xC0000000);
+		}
+	}
+};
+
+} // namespace
+
+
+std::unique_ptr<ImageFilter> create_unpack_filter_avx2(const PackedLayout &layout, unsigned width, unsigned height, PixelType type)
+{
+	if (layout.channels == 4)
+		return ztd::make_unique<UnpackFilter_AVX2<4>>(layout, width, height, type);
+	else
+		return ztd::make_unique<UnpackFilter_AVX2<3>>(layout, width, height, type);
+}
+
+std::unique_ptr<ImageFilter> create_pack_filter_avx2(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha)
+{
+	if (layout.channels == 4)
+		return ztd::make_unique<PackFilter_AVX2<4>>(layout, width, height, type, alpha);
+	else
+		return ztd::make_unique<PackFilter_AVX2<3>>(layout, width, height, type, alpha);
+}
+
+std::unique_ptr<ImageFilter> create_deinterleave_filter_avx2(unsigned width, unsigned height, PixelType type, unsigned stride)
+{
+	return create_interleaved_filter_avx2<DeinterleaveFilter_AVX2>(width, height, type, stride);
+}
+
+std::unique_ptr<ImageFilter> create_interleave_filter_avx2(unsigned width, unsigned height, PixelType type, unsigned stride)
+{
+	return create_interleaved_filter_avx2<InterleaveFilter_AVX2>(width, height, type, stride);
+}
+
+std::unique_ptr<ImageFilter> create_v210_unpack_filter_avx2(unsigned width, unsigned height, unsigned channel)
+{
+	return ztd::make_unique<V210UnpackFilter_AVX2>(width, height, channel);
+}
+
+std::unique_ptr<ImageFilter> create_v210_pack_filter_avx2(unsigned width, unsigned height, unsigned channel)
+{
+	return ztd::make_unique<V210PackFilter_AVX2>(width, height, channel);
+}
+
+std::unique_ptr<ImageFilter> create_y410_unpack_filter_avx2(unsigned width, unsigned height)
+{
+	return ztd::make_unique<Y410UnpackFilter_AVX2>(width, height);
+}
+
+std::unique_ptr<ImageFilter> create_y410_pack_filter_avx2(unsigned width, unsigned height)
+{
+	return ztd::make_unique<Y410PackFilter_AVX2>(width, height);
+}
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_X86
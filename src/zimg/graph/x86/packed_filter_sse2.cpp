@@ -0,0 +1,218 @@
+#ifdef ZIMG_X86
+
+#include <cstdint>
+#include <cstring>
+#include <emmintrin.h>
+#include "common/ccdep.h"
+#include "common/except.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "graph/image_filter.h"
+#include "graph/packed_filter.h"
+#include "packed_filter_x86.h"
+
+namespace zimg {
+namespace graph {
+
+namespace {
+
+// Mask selecting the even samples of a vector.
+template <unsigned Size>
+inline FORCE_INLINE __m128i even_mask()
+{
+	if (Size == 1)
+		return _mm_set1_epi16(0x00FF);
+	else if (Size == 2)
+		return _mm_set1_epi32(0x0000FFFF);
+	else
+		return _mm_set_epi32(0, -1, 0, -1);
+}
+
+template <unsigned Size>
+inline FORCE_INLINE __m128i deinterleave(__m128i a, __m128i b)
+{
+	if (Size == 1) {
+		a = _mm_and_si128(a, even_mask<1>());
+		b = _mm_and_si128(b, even_mask<1>());
+		return _mm_packus_epi16(a, b);
+	} else if (Size == 2) {
+		// Sign extension makes the signed saturation of packs_epi32 exact.
+		a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+		b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+		return _mm_packs_epi32(a, b);
+	} else {
+		return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+}
+
+template <unsigned Size>
+inline FORCE_INLINE __m128i interleave_lo(__m128i x)
+{
+	if (Size == 1)
+		return _mm_unpacklo_epi8(x, _mm_setzero_si128());
+	else if (Size == 2)
+		return _mm_unpacklo_epi16(x, _mm_setzero_si128());
+	else
+		return _mm_unpacklo_epi32(x, _mm_setzero_si128());
+}
+
+template <unsigned Size>
+inline FORCE_INLINE __m128i interleave_hi(__m128i x)
+{
+	if (Size == 1)
+		return _mm_unpackhi_epi8(x, _mm_setzero_si128());
+	else if (Size == 2)
+		return _mm_unpackhi_epi16(x, _mm_setzero_si128());
+	else
+		return _mm_unpackhi_epi32(x, _mm_setzero_si128());
+}
+
+// Mask selecting every second or fourth sample of a vector.
+template <unsigned Size, unsigned Stride>
+inline FORCE_INLINE __m128i stride_mask()
+{
+	return Stride == 4 ? interleave_lo<Size>(even_mask<Size>()) : even_mask<Size>();
+}
+
+// In the offset planes, the last vector of a span would access samples after
+// the span, so the vector loops stop one vector early.
+template <unsigned Size, unsigned Stride>
+void deinterleave_line_sse2(const uint8_t *src, uint8_t *dst, unsigned left, unsigned right)
+{
+	constexpr unsigned step = 16 / Size;
+	unsigned j = left;
+
+	for (; j + step < right; j += step) {
+		const uint8_t *src_j = src + static_cast<size_t>(j) * Stride * Size;
+
+		__m128i a = _mm_loadu_si128((const __m128i *)(src_j + 0));
+		__m128i b = _mm_loadu_si128((const __m128i *)(src_j + 16));
+		__m128i x = deinterleave<Size>(a, b);
+
+		if (Stride == 4) {
+			__m128i c = _mm_loadu_si128((const __m128i *)(src_j + 32));
+			__m128i d = _mm_loadu_si128((const __m128i *)(src_j + 48));
+			x = deinterleave<Size>(x, deinterleave<Size>(c, d));
+		}
+
+		_mm_storeu_si128((__m128i *)(dst + static_cast<size_t>(j) * Size), x);
+	}
+	for (; j < right; ++j) {
+		std::memcpy(dst + static_cast<size_t>(j) * Size, src + static_cast<size_t>(j) * Stride * Size, Size);
+	}
+}
+
+template <unsigned Size, unsigned Stride>
+void interleave_line_sse2(const uint8_t *src, uint8_t *dst, unsigned left, unsigned right)
+{
+	constexpr unsigned step = 16 / Size;
+	const __m128i mask = stride_mask<Size, Stride>();
+	unsigned j = left;
+
+	for (; j + step < right; j += step) {
+		uint8_t *dst_j = dst + static_cast<size_t>(j) * Stride * Size;
+
+		__m128i x = _mm_loadu_si128((const __m128i *)(src + static_cast<size_t>(j) * Size));
+		__m128i v[4];
+
+		if (Stride == 4) {
+			__m128i lo = interleave_lo<Size>(x);
+			__m128i hi = interleave_hi<Size>(x);
+
+			v[0] = interleave_lo<Size>(lo);
+			v[1] = interleave_hi<Size>(lo);
+			v[2] = interleave_lo<Size>(hi);
+			v[3] = interleave_hi<Size>(hi);
+		} else {
+			v[0] = interleave_lo<Size>(x);
+			v[1] = interleave_hi<Size>(x);
+		}
+
+		for (unsigned n = 0; n < Stride; ++n) {
+			__m128i y = _mm_loadu_si128((const __m128i *)(dst_j + n * 16));
+			y = _mm_or_si128(_mm_andnot_si128(mask, y), v[n]);
+			_mm_storeu_si128((__m128i *)(dst_j + n * 16), y);
+		}
+	}
+	for (; j < right; ++j) {
+		std::memcpy(dst + static_cast<size_t>(j) * Stride * Size, src + static_cast<size_t>(j) * Size, Size);
+	}
+}
+
+
+template <unsigned Size, unsigned Stride>
+class DeinterleaveFilter_SSE2 final : public InterleavedFilterBase {
+public:
+	DeinterleaveFilter_SSE2(unsigned width, unsigned height, PixelType type) :
+		InterleavedFilterBase(width, height, type, Stride)
+	{}
+
+	const char *get_name() const override { return "deinterleave_sse2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		deinterleave_line_sse2<Size, Stride>(static_cast<const uint8_t *>(src[0][i]), static_cast<uint8_t *>(dst[0][i]), left, right);
+	}
+};
+
+template <unsigned Size, unsigned Stride>
+class InterleaveFilter_SSE2 final : public InterleavedFilterBase {
+public:
+	InterleaveFilter_SSE2(unsigned width, unsigned height, PixelType type) :
+		InterleavedFilterBase(width, height, type, Stride)
+	{}
+
+	const char *get_name() const override { return "interleave_sse2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		interleave_line_sse2<Size, Stride>(static_cast<const uint8_t *>(src[0][i]), static_cast<uint8_t *>(dst[0][i]), left, right);
+	}
+};
+
+
+template <template <unsigned, unsigned> class Filter, unsigned Stride>
+std::unique_ptr<ImageFilter> create_interleaved_filter_sse2(unsigned width, unsigned height, PixelType type)
+{
+	switch (pixel_size(type)) {
+	case 1:
+		return ztd::make_unique<Filter<1, Stride>>(width, height, type);
+	case 2:
+		return ztd::make_unique<Filter<2, Stride>>(width, height, type);
+	case 4:
+		return ztd::make_unique<Filter<4, Stride>>(width, height, type);
+	default:
+		error::throw_<error::InternalError>("unsupported pixel type");
+	}
+}
+
+template <template <unsigned, unsigned> class Filter>
+std::unique_ptr<ImageFilter> create_interleaved_filter_sse2(unsigned width, unsigned height, PixelType type, unsigned stride)
+{
+	switch (stride) {
+	case 2:
+		return create_interleaved_filter_sse2<Filter, 2>(width, height, type);
+	case 4:
+		return create_interleaved_filter_sse2<Filter, 4>(width, height, type);
+	default:
+		error::throw_<error::InternalError>("unsupported stride");
+	}
+}
+
+} // namespace
+
+
+std::unique_ptr<ImageFilter> create_deinterleave_filter_sse2(unsigned width, unsigned height, PixelType type, unsigned stride)
+{
+	return create_interleaved_filter_sse2<DeinterleaveFilter_SSE2>(width, height, type, stride);
+}
+
+std::unique_ptr<ImageFilter> create_interleave_filter_sse2(unsigned width, unsigned height, PixelType type, unsigned stride)
+{
+	return create_interleaved_filter_sse2<InterleaveFilter_SSE2>(width, height, type, stride);
+}
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_X86
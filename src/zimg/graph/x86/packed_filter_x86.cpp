@@ -0,0 +1,150 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/image_filter.h"
+#include "packed_filter_x86.h"
+
+namespace zimg {
+namespace graph {
+
+std::unique_ptr<ImageFilter> create_unpack_filter_x86(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_unpack_filter_avx2(layout, width, height, type);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_unpack_filter_avx2(layout, width, height, type);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_pack_filter_x86(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_pack_filter_avx2(layout, width, height, type, alpha);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_pack_filter_avx2(layout, width, height, type, alpha);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_deinterleave_filter_x86(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_deinterleave_filter_avx2(width, height, type, stride);
+		if (!ret && caps.sse2)
+			ret = create_deinterleave_filter_sse2(width, height, type, stride);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_deinterleave_filter_avx2(width, height, type, stride);
+		if (!ret && cpu >= CPUClass::X86_SSE2)
+			ret = create_deinterleave_filter_sse2(width, height, type, stride);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_interleave_filter_x86(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_interleave_filter_avx2(width, height, type, stride);
+		if (!ret && caps.sse2)
+			ret = create_interleave_filter_sse2(width, height, type, stride);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_interleave_filter_avx2(width, height, type, stride);
+		if (!ret && cpu >= CPUClass::X86_SSE2)
+			ret = create_interleave_filter_sse2(width, height, type, stride);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_v210_unpack_filter_x86(unsigned width, unsigned height, unsigned channel, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_v210_unpack_filter_avx2(width, height, channel);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_v210_unpack_filter_avx2(width, height, channel);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_v210_pack_filter_x86(unsigned width, unsigned height, unsigned channel, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_v210_pack_filter_avx2(width, height, channel);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_v210_pack_filter_avx2(width, height, channel);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_y410_unpack_filter_x86(unsigned width, unsigned height, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_y410_unpack_filter_avx2(width, height);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_y410_unpack_filter_avx2(width, height);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<ImageFilter> create_y410_pack_filter_x86(unsigned width, unsigned height, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_y410_pack_filter_avx2(width, height);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_y410_pack_filter_avx2(width, height);
+	}
+
+	return ret;
+}
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_X86
@@ -0,0 +1,86 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_GRAPH_X86_PACKED_FILTER_X86_H_
+#define ZIMG_GRAPH_X86_PACKED_FILTER_X86_H_
+
+#include <cstdint>
+#include <memory>
+
+namespace zimg {
+
+enum class CPUClass;
+enum class PixelType;
+
+namespace graph {
+
+class ImageFilter;
+struct PackedLayout;
+
+#define DECLARE_UNPACK(cpu) \
+std::unique_ptr<ImageFilter> create_unpack_filter_##cpu(const PackedLayout &layout, unsigned width, unsigned height, PixelType type)
+#define DECLARE_PACK(cpu) \
+std::unique_ptr<ImageFilter> create_pack_filter_##cpu(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha)
+#define DECLARE_DEINTERLEAVE(cpu) \
+std::unique_ptr<ImageFilter> create_deinterleave_filter_##cpu(unsigned width, unsigned height, PixelType type, unsigned stride)
+#define DECLARE_INTERLEAVE(cpu) \
+std::unique_ptr<ImageFilter> create_interleave_filter_##cpu(unsigned width, unsigned height, PixelType type, unsigned stride)
+#define DECLARE_V210_UNPACK(cpu) \
+std::unique_ptr<ImageFilter> create_v210_unpack_filter_##cpu(unsigned width, unsigned height, unsigned channel)
+#define DECLARE_V210_PACK(cpu) \
+std::unique_ptr<ImageFilter> create_v210_pack_filter_##cpu(unsigned width, unsigned height, unsigned channel)
+#define DECLARE_Y410_UNPACK(cpu) \
+std::unique_ptr<ImageFilter> create_y410_unpack_filter_##cpu(unsigned width, unsigned height)
+#define DECLARE_Y410_PACK(cpu) \
+std::unique_ptr<ImageFilter> create_y410_pack_filter_##cpu(unsigned width, unsigned height)
+
+DECLARE_UNPACK(avx2);
+
+DECLARE_PACK(avx2);
+
+DECLARE_DEINTERLEAVE(sse2);
+DECLARE_DEINTERLEAVE(avx2);
+
+DECLARE_INTERLEAVE(sse2);
+DECLARE_INTERLEAVE(avx2);
+
+DECLARE_V210_UNPACK(avx2);
+
+DECLARE_V210_PACK(avx2);
+
+DECLARE_Y410_UNPACK(avx2);
+
+DECLARE_Y410_PACK(avx2);
+
+#undef DECLARE_UNPACK
+#undef DECLARE_PACK
+#undef DECLARE_DEINTERLEAVE
+#undef DECLARE_INTERLEAVE
+#undef DECLARE_V210_UNPACK
+#undef DECLARE_V210_PACK
+#undef DECLARE_Y410_UNPACK
+#undef DECLARE_Y410_PACK
+
+std::unique_ptr<ImageFilter> create_unpack_filter_x86(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, CPUClass cpu);
+
+std::unique_ptr<ImageFilter> create_pack_filter_x86(const PackedLayout &layout, unsigned width, unsigned height, PixelType type, uint32_t alpha, CPUClass cpu);
+
+std::unique_ptr<ImageFilter> create_deinterleave_filter_x86(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu);
+
+std::unique_ptr<ImageFilter> create_interleave_filter_x86(unsigned width, unsigned height, PixelType type, unsigned stride, CPUClass cpu);
+
+std::unique_ptr<ImageFilter> create_v210_unpack_filter_x86(unsigned width, unsigned height, unsigned channel, CPUClass cpu);
+
+std::unique_ptr<ImageFilter> create_v210_pack_filter_x86(unsigned width, unsigned height, unsigned channel, CPUClass cpu);
+
+std::unique_ptr<ImageFilter> create_y410_unpack_filter_x86(unsigned width, unsigned height, CPUClass cpu);
+
+std::unique_ptr<ImageFilter> create_y410_pack_filter_x86(unsigned width, unsigned height, CPUClass cpu);
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_GRAPH_X86_PACKED_FILTER_X86_H_
+
+#endif // ZIMG_X86
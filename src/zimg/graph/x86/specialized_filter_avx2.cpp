@@ -0,0 +1,161 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include "common/ccdep.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "graph/image_filter.h"
+#include "graph/specialized_filter.h"
+#include "specialized_filter_x86.h"
+
+namespace zimg {
+namespace graph {
+
+namespace {
+
+inline FORCE_INLINE void load16(const uint8_t *ptr, __m256 &lo, __m256 &hi)
+{
+	__m128i x = _mm_loadu_si128((const __m128i *)ptr);
+	lo = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(x));
+	hi = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(x, 8)));
+}
+
+inline FORCE_INLINE void load16(const uint16_t *ptr, __m256 &lo, __m256 &hi)
+{
+	__m256i x = _mm256_loadu_si256((const __m256i *)ptr);
+	lo = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(x)));
+	hi = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1)));
+}
+
+inline FORCE_INLINE void store16(uint8_t *ptr, __m256i lo, __m256i hi)
+{
+	__m256i x = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+	_mm_storeu_si128((__m128i *)ptr, _mm_packus_epi16(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+}
+
+inline FORCE_INLINE void store16(uint16_t *ptr, __m256i lo, __m256i hi)
+{
+	__m256i x = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+	_mm256_storeu_si256((__m256i *)ptr, x);
+}
+
+
+struct MatrixConstants {
+	__m256 c[3][3];
+	__m256 bias[3];
+	__m256 maxval;
+};
+
+inline FORCE_INLINE __m256i matrix_row(const MatrixConstants &k, unsigned i, __m256 a, __m256 b, __m256 c)
+{
+	__m256 x = _mm256_fmadd_ps(k.c[i][0], a, k.bias[i]);
+	x = _mm256_fmadd_ps(k.c[i][1], b, x);
+	x = _mm256_fmadd_ps(k.c[i][2], c, x);
+	x = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), k.maxval);
+	return _mm256_cvtps_epi32(x);
+}
+
+template <class T, class U>
+inline FORCE_INLINE void integer_matrix16(const MatrixConstants &k, const T * const src[3], U * const dst[3], unsigned j)
+{
+	__m256 a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+
+	load16(src[0] + j, a_lo, a_hi);
+	load16(src[1] + j, b_lo, b_hi);
+	load16(src[2] + j, c_lo, c_hi);
+
+	for (unsigned i = 0; i < 3; ++i) {
+		store16(dst[i] + j, matrix_row(k, i, a_lo, b_lo, c_lo), matrix_row(k, i, a_hi, b_hi, c_hi));
+	}
+}
+
+template <class T, class U>
+void integer_matrix_line_avx2(const float (&coeffs)[3][3], const float (&bias)[3], float maxval,
+                              const T * const src[3], U * const dst[3], unsigned left, unsigned right)
+{
+	MatrixConstants k;
+
+	for (unsigned i = 0; i < 3; ++i) {
+		for (unsigned j = 0; j < 3; ++j) {
+			k.c[i][j] = _mm256_set1_ps(coeffs[i][j]);
+		}
+		k.bias[i] = _mm256_set1_ps(bias[i]);
+	}
+	k.maxval = _mm256_set1_ps(maxval);
+
+	unsigned j = left;
+
+	for (; j + 16 <= right; j += 16) {
+		integer_matrix16(k, src, dst, j);
+	}
+
+	// Process the remaining pixels through a temporary buffer, so that the
+	// results do not depend on the span.
+	if (j < right) {
+		unsigned n = right - j;
+		T src_tmp[3][16] = {};
+		U dst_tmp[3][16];
+		const T *src_tmp_p[3] = { src_tmp[0], src_tmp[1], src_tmp[2] };
+		U *dst_tmp_p[3] = { dst_tmp[0], dst_tmp[1], dst_tmp[2] };
+
+		for (unsigned p = 0; p < 3; ++p) {
+			std::copy_n(src[p] + j, n, src_tmp[p]);
+		}
+		integer_matrix16(k, src_tmp_p, dst_tmp_p, 0);
+		for (unsigned p = 0; p < 3; ++p) {
+			std::copy_n(dst_tmp[p], n, dst[p] + j);
+		}
+	}
+}
+
+
+template <class T, class U>
+class IntegerMatrixFilter_AVX2 final : public IntegerMatrixFilterBase {
+public:
+	IntegerMatrixFilter_AVX2(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height) :
+		IntegerMatrixFilterBase(m, format_in, format_out, width, height)
+	{}
+
+	const char *get_name() const override { return "integer_matrix_avx2"; }
+
+	void process(void *, const ImageBuffer<const void> src[], const ImageBuffer<void> dst[], void *, unsigned i, unsigned left, unsigned right) const override
+	{
+		const T *src_p[3];
+		U *dst_p[3];
+
+		for (unsigned p = 0; p < 3; ++p) {
+			src_p[p] = static_cast<const T *>(src[p][i]);
+			dst_p[p] = static_cast<U *>(dst[p][i]);
+		}
+
+		integer_matrix_line_avx2(m_coeffs, m_bias, m_maxval, src_p, dst_p, left, right);
+	}
+};
+
+template <class T>
+std::unique_ptr<ImageFilter> create_integer_matrix_filter_avx2_t(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height)
+{
+	if (format_out[0].type == PixelType::BYTE)
+		return ztd::make_unique<IntegerMatrixFilter_AVX2<T, uint8_t>>(m, format_in, format_out, width, height);
+	else
+		return ztd::make_unique<IntegerMatrixFilter_AVX2<T, uint16_t>>(m, format_in, format_out, width, height);
+}
+
+} // namespace
+
+
+std::unique_ptr<ImageFilter> create_integer_matrix_filter_avx2(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height)
+{
+	if (format_in[0].type == PixelType::BYTE)
+		return create_integer_matrix_filter_avx2_t<uint8_t>(m, format_in, format_out, width, height);
+	else
+		return create_integer_matrix_filter_avx2_t<uint16_t>(m, format_in, format_out, width, height);
+}
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_X86
@@ -0,0 +1,30 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/image_filter.h"
+#include "specialized_filter_x86.h"
+
+namespace zimg {
+namespace graph {
+
+std::unique_ptr<ImageFilter> create_integer_matrix_filter_x86(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_integer_matrix_filter_avx2(m, format_in, format_out, width, height);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_integer_matrix_filter_avx2(m, format_in, format_out, width, height);
+	}
+
+	return ret;
+}
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_X86
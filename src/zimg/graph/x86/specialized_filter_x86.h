@@ -0,0 +1,37 @@
+#pragma once
+
+#ifdef ZIMG_X86
+
+#ifndef ZIMG_GRAPH_X86_SPECIALIZED_FILTER_X86_H_
+#define ZIMG_GRAPH_X86_SPECIALIZED_FILTER_X86_H_
+
+#include <memory>
+
+namespace zimg {
+
+enum class CPUClass;
+struct PixelFormat;
+
+namespace colorspace {
+struct Matrix3x3;
+} // namespace colorspace
+
+namespace graph {
+
+class ImageFilter;
+
+#define DECLARE_INTEGER_MATRIX(cpu) \
+std::unique_ptr<ImageFilter> create_integer_matrix_filter_##cpu(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height)
+
+DECLARE_INTEGER_MATRIX(avx2);
+
+#undef DECLARE_INTEGER_MATRIX
+
+std::unique_ptr<ImageFilter> create_integer_matrix_filter_x86(const colorspace::Matrix3x3 &m, const PixelFormat (&format_in)[3], const PixelFormat (&format_out)[3], unsigned width, unsigned height, CPUClass cpu);
+
+} // namespace graph
+} // namespace zimg
+
+#endif // ZIMG_GRAPH_X86_SPECIALIZED_FILTER_X86_H_
+
+#endif // ZIMG_X86
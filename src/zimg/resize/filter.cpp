@@ -3,8 +3,17 @@
 #include <climits>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 #include "common/except.h"
 #include "common/libm_wrapper.h"
@@ -129,6 +138,61 @@ FilterContext matrix_to_filter(const RowMatrix<double> &m)
 	return e;
 }
 
+
+class FilterCache {
+	typedef std::tuple<std::type_index, uint64_t, uint64_t, unsigned, unsigned, uint64_t, uint64_t> key_type;
+
+	std::map<key_type, std::weak_ptr<const FilterContext>> m_cache;
+	std::mutex m_mutex;
+
+	// Compare floating point values by representation, so that NaN can be a key.
+	static uint64_t bits(double x) noexcept
+	{
+		uint64_t ret;
+		std::memcpy(&ret, &x, sizeof(ret));
+		return ret;
+	}
+
+	void remove_expired()
+	{
+		for (auto it = m_cache.begin(); it != m_cache.end();) {
+			if (it->second.expired())
+				it = m_cache.erase(it);
+			else
+				++it;
+		}
+	}
+public:
+	std::shared_ptr<const FilterContext> get(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width)
+	{
+		std::pair<double, double> params = f.parameters();
+		key_type key{ typeid(f), bits(params.first), bits(params.second), src_dim, dst_dim, bits(shift), bits(width) };
+
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			auto it = m_cache.find(key);
+			if (it != m_cache.end()) {
+				if (std::shared_ptr<const FilterContext> ret = it->second.lock())
+					return ret;
+			}
+		}
+
+		// Compute the filter without holding the lock. A concurrent caller may
+		// compute the same filter, in which case the first result is kept.
+		std::shared_ptr<const FilterContext> filter = std::make_shared<FilterContext>(compute_filter(f, src_dim, dst_dim, shift, width));
+
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		std::weak_ptr<const FilterContext> &entry = m_cache[key];
+
+		if (std::shared_ptr<const FilterContext> ret = entry.lock())
+			return ret;
+
+		entry = filter;
+		remove_expired();
+		return filter;
+	}
+};
+
 } // namespace
 
 
@@ -138,6 +202,8 @@ unsigned PointFilter::support() const { return 0; }
 
 double PointFilter::operator()(double x) const { return 1.0; }
 
+std::pair<double, double> PointFilter::parameters() const { return{}; }
+
 
 unsigned BilinearFilter::support() const { return 1; }
 
@@ -146,8 +212,12 @@ double BilinearFilter::operator()(double x) const
 	return std::max(1.0 - std::abs(x), 0.0);
 }
 
+std::pair<double, double> BilinearFilter::parameters() const { return{}; }
+
 
 BicubicFilter::BicubicFilter(double b, double c) :
+	b{ b },
+	c{ c },
 	p0{ (  6.0 -  2.0 * b           ) / 6.0 },
 	p2{ (-18.0 + 12.0 * b +  6.0 * c) / 6.0 },
 	p3{ ( 12.0 -  9.0 * b -  6.0 * c) / 6.0 },
@@ -171,6 +241,8 @@ double BicubicFilter::operator()(double x) const
 		return 0.0;
 }
 
+std::pair<double, double> BicubicFilter::parameters() const { return{ b, c }; }
+
 
 unsigned Spline16Filter::support() const { return 2; }
 
@@ -188,6 +260,8 @@ double Spline16Filter::operator()(double x) const
 	}
 }
 
+std::pair<double, double> Spline16Filter::parameters() const { return{}; }
+
 
 unsigned Spline36Filter::support() const { return 3; }
 
@@ -208,6 +282,8 @@ double Spline36Filter::operator()(double x) const
 	}
 }
 
+std::pair<double, double> Spline36Filter::parameters() const { return{}; }
+
 
 LanczosFilter::LanczosFilter(unsigned taps) : taps{ taps }
 {
@@ -223,6 +299,8 @@ double LanczosFilter::operator()(double x) const
 	return x < taps ? sinc(x) * sinc(x / taps) : 0.0;
 }
 
+std::pair<double, double> LanczosFilter::parameters() const { return{ taps, 0.0 }; }
+
 
 FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width)
 {
@@ -275,5 +353,11 @@ FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim
 	}
 }
 
+std::shared_ptr<const FilterContext> compute_filter_shared(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width)
+{
+	static FilterCache cache;
+	return cache.get(f, src_dim, dst_dim, shift, width);
+}
+
 } // namespace resize
 } // namespace zimg
@@ -4,6 +4,8 @@
 #define ZIMG_RESIZE_FILTER_H_
 
 #include <cstddef>
+#include <memory>
+#include <utility>
 #include "common/alloc.h"
 
 namespace zimg {
@@ -29,6 +31,14 @@ public:
 	 * @return filter coefficient at position
 	 */
 	virtual double operator()(double x) const = 0;
+
+	/**
+	 * Get the parameters of the filter. Filters of the same type with equal
+	 * parameters must compute the same coefficients.
+	 *
+	 * @return filter parameters
+	 */
+	virtual std::pair<double, double> parameters() const = 0;
 };
 
 /**
@@ -39,6 +49,8 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::pair<double, double> parameters() const override;
 };
 
 /**
@@ -49,12 +61,15 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::pair<double, double> parameters() const override;
 };
 
 /**
  * Bicubic (a.k.a. Mitchell-Netravali) filter.
  */
 class BicubicFilter : public Filter {
+	double b, c;
 	double p0, p2, p3;
 	double q0, q1, q2, q3;
 public:
@@ -69,6 +84,8 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::pair<double, double> parameters() const override;
 };
 
 /**
@@ -79,6 +96,8 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::pair<double, double> parameters() const override;
 };
 
 /**
@@ -89,6 +108,8 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::pair<double, double> parameters() const override;
 };
 
 /**
@@ -107,6 +128,8 @@ public:
 	unsigned support() const override;
 
 	double operator()(double x) const override;
+
+	std::pair<double, double> parameters() const override;
 };
 
 /**
@@ -159,6 +182,17 @@ struct FilterContext {
  */
 FilterContext compute_filter(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width);
 
+/**
+ * Get the resizing function for a filter, scale, and shift, sharing the
+ * result with all other users of the same parameters.
+ *
+ * Computed filters are kept in a process-wide cache for as long as they are
+ * referenced, so that identical resizers store their coefficients only once.
+ *
+ * @see compute_filter
+ */
+std::shared_ptr<const FilterContext> compute_filter_shared(const Filter &f, unsigned src_dim, unsigned dst_dim, double shift, double width);
+
 } // namespace resize
 } // namespace zimg
 
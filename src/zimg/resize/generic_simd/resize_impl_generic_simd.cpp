@@ -0,0 +1,323 @@
+#ifdef ZIMG_GENERIC_SIMD
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/checked_int.h"
+#include "common/cpuinfo.h"
+#include "common/except.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "graph/image_filter.h"
+#include "resize/filter.h"
+#include "resize/resize_impl.h"
+#include "resize_impl_generic_simd.h"
+
+#include "common/generic_simd/generic_simd_util.h"
+
+namespace zimg {
+namespace resize {
+
+namespace {
+
+inline FORCE_INLINE vi32x8 export_i30_u16(vi32x8 x, const vi32x8 &pixel_max)
+{
+	x = ((x + vec8_set1_i32(1 << 13)) >> 14) - vec8_set1_i32(INT16_MIN);
+	x = vec8_min_i32(x, pixel_max);
+	x = vec8_max_i32(x, vec8_set1_i32(0));
+	return x;
+}
+
+
+template <class T>
+void transpose_line_8_i32(int32_t *dst, const T * const *src, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		for (unsigned n = 0; n < 8; ++n) {
+			dst[n] = static_cast<int32_t>(src[n][j]) + INT16_MIN;
+		}
+		dst += 8;
+	}
+}
+
+void transpose_line_8_f32(float *dst, const float * const *src, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		for (unsigned n = 0; n < 8; ++n) {
+			dst[n] = src[n][j];
+		}
+		dst += 8;
+	}
+}
+
+template <class T, class V>
+inline FORCE_INLINE void scatter_8(T * const *dst, unsigned j, V x)
+{
+	T tmp[8];
+	vec8_store(tmp, x);
+
+	for (unsigned n = 0; n < 8; ++n) {
+		dst[n][j] = tmp[n];
+	}
+}
+
+
+template <class T>
+void resize_line8_h_u16_generic_simd(const FilterContext &filter, const int32_t * RESTRICT src, T * const *dst, unsigned src_base, unsigned left, unsigned right, int32_t pixel_max)
+{
+	const vi32x8 lim = vec8_set1_i32(pixel_max);
+
+	for (unsigned j = left; j < right; ++j) {
+		const int16_t *filter_coeffs = filter.data_i16.data() + j * filter.stride_i16;
+		const int32_t *src_p = src + (filter.left[j] - src_base) * 8;
+		vi32x8 accum = vec8_set1_i32(0);
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			accum += vec8_set1_i32(filter_coeffs[k]) * vec8_load_i32(src_p + k * 8);
+		}
+
+		scatter_8(dst, j, export_i30_u16(accum, lim));
+	}
+}
+
+void resize_line8_h_f32_generic_simd(const FilterContext &filter, const float * RESTRICT src, float * const *dst, unsigned src_base, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; ++j) {
+		const float *filter_coeffs = filter.data.data() + j * filter.stride;
+		const float *src_p = src + (filter.left[j] - src_base) * 8;
+		vf32x8 accum = vec8_set1_f32(0.0f);
+
+		for (unsigned k = 0; k < filter.filter_width; ++k) {
+			accum += vec8_set1_f32(filter_coeffs[k]) * vec8_load_f32(src_p + k * 8);
+		}
+
+		scatter_8(dst, j, accum);
+	}
+}
+
+
+template <bool Partial, class T>
+inline FORCE_INLINE void resize_line_v_u16_generic_simd_xiter(unsigned j, unsigned n, const int16_t *filter_data, unsigned filter_width,
+                                                              const T * const *src_lines, T * RESTRICT dst, const vi32x8 &lim)
+{
+	const vi32x8 i16_min = vec8_set1_i32(INT16_MIN);
+	vi32x8 accum = vec8_set1_i32(0);
+
+	for (unsigned k = 0; k < filter_width; ++k) {
+		vi32x8 x = Partial ? vec8_load_i32_n(src_lines[k] + j, n) : vec8_load_i32(src_lines[k] + j);
+		accum += vec8_set1_i32(filter_data[k]) * (x + i16_min);
+	}
+
+	accum = export_i30_u16(accum, lim);
+
+	if (Partial)
+		vec8_store_n(dst + j, accum, n);
+	else
+		vec8_store(dst + j, accum);
+}
+
+template <class T>
+void resize_line_v_u16_generic_simd(const int16_t *filter_data, unsigned filter_width, const T * const *src_lines, T *dst, unsigned left, unsigned right, int32_t pixel_max)
+{
+	const vi32x8 lim = vec8_set1_i32(pixel_max);
+	unsigned vec_right = left + floor_n(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		resize_line_v_u16_generic_simd_xiter<false>(j, 8, filter_data, filter_width, src_lines, dst, lim);
+	}
+	if (right != vec_right)
+		resize_line_v_u16_generic_simd_xiter<true>(vec_right, right - vec_right, filter_data, filter_width, src_lines, dst, lim);
+}
+
+template <bool Partial>
+inline FORCE_INLINE void resize_line_v_f32_generic_simd_xiter(unsigned j, unsigned n, const float *filter_data, unsigned filter_width,
+                                                              const float * const *src_lines, float * RESTRICT dst)
+{
+	vf32x8 accum = vec8_set1_f32(0.0f);
+
+	for (unsigned k = 0; k < filter_width; ++k) {
+		vf32x8 x = Partial ? vec8_load_f32_n(src_lines[k] + j, n) : vec8_load_f32(src_lines[k] + j);
+		accum += vec8_set1_f32(filter_data[k]) * x;
+	}
+
+	if (Partial)
+		vec8_store_n(dst + j, accum, n);
+	else
+		vec8_store(dst + j, accum);
+}
+
+void resize_line_v_f32_generic_simd(const float *filter_data, unsigned filter_width, const float * const *src_lines, float *dst, unsigned left, unsigned right)
+{
+	unsigned vec_right = left + floor_n(right - left, 8);
+
+	for (unsigned j = left; j < vec_right; j += 8) {
+		resize_line_v_f32_generic_simd_xiter<false>(j, 8, filter_data, filter_width, src_lines, dst);
+	}
+	if (right != vec_right)
+		resize_line_v_f32_generic_simd_xiter<true>(vec_right, right - vec_right, filter_data, filter_width, src_lines, dst);
+}
+
+
+template <class T>
+class ResizeImplH_GenericSIMD final : public ResizeImplH {
+	typedef typename std::conditional<std::is_same<T, float>::value, float, int32_t>::type transpose_type;
+
+	int32_t m_pixel_max;
+public:
+	ResizeImplH_GenericSIMD(const std::shared_ptr<const FilterContext> &filter, unsigned height, PixelType type, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, type }),
+		m_pixel_max{ static_cast<int32_t>(1UL << depth) - 1 }
+	{}
+
+	const char *get_name() const override { return "resize_h_generic_simd"; }
+
+	unsigned get_simultaneous_lines() const override { return 8; }
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		try {
+			checked_size_t size = (static_cast<checked_size_t>(range.second) - range.first) * sizeof(transpose_type) * 8;
+			return size.get();
+		} catch (const std::overflow_error &) {
+			error::throw_<error::OutOfMemory>();
+		}
+	}
+
+	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		const auto &src_buf = graph::static_buffer_cast<const T>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<T>(*dst);
+		auto range = get_required_col_range(left, right);
+
+		const T *src_ptr[8] = { 0 };
+		T *dst_ptr[8] = { 0 };
+		transpose_type *transpose_buf = static_cast<transpose_type *>(tmp);
+		unsigned height = get_image_attributes().height;
+
+		for (unsigned n = 0; n < 8; ++n) {
+			src_ptr[n] = src_buf[std::min(i + n, height - 1)];
+			dst_ptr[n] = dst_buf[std::min(i + n, height - 1)];
+		}
+
+		process_lines(src_ptr, dst_ptr, transpose_buf, range.first, range.second, left, right);
+	}
+private:
+	template <class U = T>
+	typename std::enable_if<!std::is_same<U, float>::value>::type
+	process_lines(const T * const *src_ptr, T * const *dst_ptr, int32_t *transpose_buf, unsigned col_left, unsigned col_right, unsigned left, unsigned right) const
+	{
+		transpose_line_8_i32(transpose_buf, src_ptr, col_left, col_right);
+		resize_line8_h_u16_generic_simd(*m_filter, transpose_buf, dst_ptr, col_left, left, right, m_pixel_max);
+	}
+
+	template <class U = T>
+	typename std::enable_if<std::is_same<U, float>::value>::type
+	process_lines(const T * const *src_ptr, T * const *dst_ptr, float *transpose_buf, unsigned col_left, unsigned col_right, unsigned left, unsigned right) const
+	{
+		transpose_line_8_f32(transpose_buf, src_ptr, col_left, col_right);
+		resize_line8_h_f32_generic_simd(*m_filter, transpose_buf, dst_ptr, col_left, left, right);
+	}
+};
+
+
+template <class T>
+class ResizeImplV_GenericSIMD final : public ResizeImplV {
+	int32_t m_pixel_max;
+public:
+	ResizeImplV_GenericSIMD(const std::shared_ptr<const FilterContext> &filter, unsigned width, PixelType type, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, type }),
+		m_pixel_max{ static_cast<int32_t>(1UL << depth) - 1 }
+	{}
+
+	const char *get_name() const override { return "resize_v_generic_simd"; }
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		try {
+			checked_size_t size = static_cast<checked_size_t>(m_filter->filter_width) * sizeof(const T *);
+			return size.get();
+		} catch (const std::overflow_error &) {
+			error::throw_<error::OutOfMemory>();
+		}
+	}
+
+	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		const auto &src_buf = graph::static_buffer_cast<const T>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<T>(*dst);
+
+		unsigned filter_width = m_filter->filter_width;
+		unsigned top = m_filter->left[i];
+		const T **src_lines = static_cast<const T **>(tmp);
+
+		for (unsigned k = 0; k < filter_width; ++k) {
+			src_lines[k] = src_buf[top + k];
+		}
+
+		process_line(i, src_lines, dst_buf[i], left, right);
+	}
+private:
+	template <class U = T>
+	typename std::enable_if<!std::is_same<U, float>::value>::type
+	process_line(unsigned i, const T * const *src_lines, T *dst_line, unsigned left, unsigned right) const
+	{
+		const int16_t *filter_data = m_filter->data_i16.data() + i * m_filter->stride_i16;
+		resize_line_v_u16_generic_simd(filter_data, m_filter->filter_width, src_lines, dst_line, left, right, m_pixel_max);
+	}
+
+	template <class U = T>
+	typename std::enable_if<std::is_same<U, float>::value>::type
+	process_line(unsigned i, const T * const *src_lines, T *dst_line, unsigned left, unsigned right) const
+	{
+		const float *filter_data = m_filter->data.data() + i * m_filter->stride;
+		resize_line_v_f32_generic_simd(filter_data, m_filter->filter_width, src_lines, dst_line, left, right);
+	}
+};
+
+} // namespace
+
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_generic_simd(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
+{
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return ret;
+
+	if (type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplH_GenericSIMD<uint8_t>>(context, height, type, depth);
+	else if (type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplH_GenericSIMD<uint16_t>>(context, height, type, depth);
+	else if (type == PixelType::FLOAT)
+		ret = ztd::make_unique<ResizeImplH_GenericSIMD<float>>(context, height, type, depth);
+
+	return ret;
+}
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_generic_simd(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu)
+{
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (!cpu_is_autodetect(cpu) && cpu != CPUClass::GENERIC_SIMD)
+		return ret;
+
+	if (type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplV_GenericSIMD<uint8_t>>(context, width, type, depth);
+	else if (type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplV_GenericSIMD<uint16_t>>(context, width, type, depth);
+	else if (type == PixelType::FLOAT)
+		ret = ztd::make_unique<ResizeImplV_GenericSIMD<float>>(context, width, type, depth);
+
+	return ret;
+}
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_GENERIC_SIMD
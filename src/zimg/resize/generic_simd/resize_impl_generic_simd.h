@@ -0,0 +1,35 @@
+#pragma once
+
+#ifdef ZIMG_GENERIC_SIMD
+
+#ifndef ZIMG_RESIZE_GENERIC_SIMD_RESIZE_IMPL_GENERIC_SIMD_H_
+#define ZIMG_RESIZE_GENERIC_SIMD_RESIZE_IMPL_GENERIC_SIMD_H_
+
+#include <memory>
+
+namespace zimg {
+
+enum class CPUClass;
+enum class PixelType;
+
+namespace graph {
+
+class ImageFilter;
+
+} // namespace graph
+
+
+namespace resize {
+
+struct FilterContext;
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_generic_simd(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_generic_simd(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
+
+} // namespace resize
+} // namespace zimg
+
+#endif // ZIMG_RESIZE_GENERIC_SIMD_RESIZE_IMPL_GENERIC_SIMD_H_
+
+#endif // ZIMG_GENERIC_SIMD
@@ -8,6 +8,10 @@
 #include "resize.h"
 #include "resize_impl.h"
 
+#ifdef ZIMG_X86
+  #include "x86/resize_impl_x86.h"
+#endif
+
 namespace zimg {
 namespace resize {
 
@@ -36,6 +40,9 @@ ResizeConversion::ResizeConversion(unsigned src_width, unsigned src_height, Pixe
 	shift_h{},
 	subwidth{ static_cast<double>(src_width) },
 	subheight{ static_cast<double>(src_height) },
+	src_type{ type },
+	src_scale{ 1.0f },
+	src_offset{ 0.0f },
 	cpu{ CPUClass::NONE }
 {}
 
@@ -47,12 +54,23 @@ auto ResizeConversion::create() const -> filter_pair try
 	bool skip_h = (src_width == dst_width && shift_w == 0 && subwidth == src_width);
 	bool skip_v = (src_height == dst_height && shift_h == 0 && subheight == src_height);
 
-	if (skip_h && skip_v)
+	if (src_type != type && (type != PixelType::FLOAT || pixel_is_float(src_type)))
+		error::throw_<error::InternalError>("only integer to float conversion is supported");
+
+	if (skip_h && skip_v) {
+		if (src_type != type)
+			error::throw_<error::InternalError>("cannot convert pixel type without resizing");
+
 		return{ ztd::make_unique<graph::CopyFilter>(src_width, src_height, type), nullptr };
+	}
 
+	// Integer input is converted to float by the first pass.
 	auto builder = ResizeImplBuilder{ src_width, src_height, type }
 		.set_depth(depth)
 		.set_filter(filter)
+		.set_src_type(src_type)
+		.set_src_scale(src_scale)
+		.set_src_offset(src_offset)
 		.set_cpu(cpu);
 	filter_pair ret{};
 
@@ -79,6 +97,7 @@ auto ResizeConversion::create() const -> filter_pair try
 			                   .create();
 
 			builder.src_width = dst_width;
+			builder.src_type = type;
 			ret.second = builder.set_horizontal(false)
 			                    .set_dst_dim(dst_height)
 			                    .set_shift(shift_h)
@@ -92,6 +111,7 @@ auto ResizeConversion::create() const -> filter_pair try
 			                   .create();
 
 			builder.src_height = dst_height;
+			builder.src_type = type;
 			ret.second = builder.set_horizontal(true)
 			                    .set_dst_dim(dst_width)
 			                    .set_shift(shift_w)
@@ -105,5 +125,23 @@ auto ResizeConversion::create() const -> filter_pair try
 	error::throw_<error::OutOfMemory>();
 }
 
+bool resize_supports_half(CPUClass cpu) noexcept
+{
+	bool ret = false;
+#ifdef ZIMG_X86
+	ret = resize_supports_half_x86(cpu);
+#endif
+	return ret;
+}
+
+bool resize_supports_integer_load(CPUClass cpu) noexcept
+{
+	bool ret = false;
+#ifdef ZIMG_X86
+	ret = resize_supports_integer_load_x86(cpu);
+#endif
+	return ret;
+}
+
 } // namespace resize
 } // namespace zimg
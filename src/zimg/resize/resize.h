@@ -38,6 +38,9 @@ struct ResizeConversion {
 	BUILDER_MEMBER(double, shift_h)
 	BUILDER_MEMBER(double, subwidth)
 	BUILDER_MEMBER(double, subheight)
+	BUILDER_MEMBER(PixelType, src_type)
+	BUILDER_MEMBER(float, src_scale)
+	BUILDER_MEMBER(float, src_offset)
 	BUILDER_MEMBER(CPUClass, cpu)
 #undef BUILDER_MEMBER
 
@@ -46,6 +49,12 @@ struct ResizeConversion {
 	filter_pair create() const;
 };
 
+// Check if HALF images can be resized without converting them to FLOAT.
+bool resize_supports_half(CPUClass cpu) noexcept;
+
+// Check if BYTE and WORD images can be converted to FLOAT while loading the first pass.
+bool resize_supports_integer_load(CPUClass cpu) noexcept;
+
 } // namespace resize
 } // namespace zimg
 
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <climits>
 #include <cstdint>
+#include <memory>
+#include <utility>
 #include "common/cpuinfo.h"
 #include "common/except.h"
 #include "common/make_unique.h"
@@ -14,25 +16,43 @@
   #include "x86/resize_impl_x86.h"
 #endif
 
+#ifdef ZIMG_GENERIC_SIMD
+  #include "generic_simd/resize_impl_generic_simd.h"
+#endif
+
 namespace zimg {
 namespace resize {
 
 namespace {
 
-int32_t unpack_pixel_u16(uint16_t x) noexcept
+template <class T>
+int32_t unpack_pixel_u16(T x) noexcept
 {
 	return static_cast<int32_t>(x) + INT16_MIN;
 }
 
-uint16_t pack_pixel_u16(int32_t x, int32_t pixel_max) noexcept
+template <class T>
+T pack_pixel_u16(int32_t x, int32_t pixel_max) noexcept
 {
 	x = ((x + (1 << 13)) >> 14) - INT16_MIN;
 	x = std::max(std::min(x, pixel_max), static_cast<int32_t>(0));
 
-	return static_cast<uint16_t>(x);
+	return static_cast<T>(x);
+}
+
+inline float load_pixel_f32(float x, float, float) noexcept
+{
+	return x;
 }
 
-void resize_line_h_u16_c(const FilterContext &filter, const uint16_t *src, uint16_t *dst, unsigned left, unsigned right, unsigned pixel_max)
+template <class T>
+float load_pixel_f32(T x, float scale, float offset) noexcept
+{
+	return static_cast<float>(x) * scale + offset;
+}
+
+template <class T>
+void resize_line_h_u16_c(const FilterContext &filter, const T *src, T *dst, unsigned left, unsigned right, unsigned pixel_max)
 {
 	for (unsigned j = left; j < right; ++j) {
 		unsigned left = filter.left[j];
@@ -45,11 +65,12 @@ void resize_line_h_u16_c(const FilterContext &filter, const uint16_t *src, uint1
 			accum += coeff * x;
 		}
 
-		dst[j] = pack_pixel_u16(accum, pixel_max);
+		dst[j] = pack_pixel_u16<T>(accum, pixel_max);
 	}
 }
 
-void resize_line_h_f32_c(const FilterContext &filter, const float *src, float *dst, unsigned left, unsigned right)
+template <class T>
+void resize_line_h_f32_c(const FilterContext &filter, const T *src, float *dst, float scale, float offset, unsigned left, unsigned right)
 {
 	for (unsigned j = left; j < right; ++j) {
 		unsigned top = filter.left[j];
@@ -57,7 +78,7 @@ void resize_line_h_f32_c(const FilterContext &filter, const float *src, float *d
 
 		for (unsigned k = 0; k < filter.filter_width; ++k) {
 			float coeff = filter.data[j * filter.stride + k];
-			float x = src[top + k];
+			float x = load_pixel_f32(src[top + k], scale, offset);
 
 			accum += coeff * x;
 		}
@@ -66,7 +87,8 @@ void resize_line_h_f32_c(const FilterContext &filter, const float *src, float *d
 	}
 }
 
-void resize_line_v_u16_c(const FilterContext &filter, const graph::ImageBuffer<const uint16_t> &src, const graph::ImageBuffer<uint16_t> &dst, unsigned i, unsigned left, unsigned right, unsigned pixel_max)
+template <class T>
+void resize_line_v_u16_c(const FilterContext &filter, const graph::ImageBuffer<const T> &src, const graph::ImageBuffer<T> &dst, unsigned i, unsigned left, unsigned right, unsigned pixel_max)
 {
 	const int16_t *filter_coeffs = &filter.data_i16[i * filter.stride_i16];
 	unsigned top = filter.left[i];
@@ -81,11 +103,13 @@ void resize_line_v_u16_c(const FilterContext &filter, const graph::ImageBuffer<c
 			accum += coeff * x;
 		}
 
-		dst[i][j] = pack_pixel_u16(accum, pixel_max);
+		dst[i][j] = pack_pixel_u16<T>(accum, pixel_max);
 	}
 }
 
-void resize_line_v_f32_c(const FilterContext &filter, const graph::ImageBuffer<const float> &src, const graph::ImageBuffer<float> &dst, unsigned i, unsigned left, unsigned right)
+template <class T>
+void resize_line_v_f32_c(const FilterContext &filter, const graph::ImageBuffer<const T> &src, const graph::ImageBuffer<float> &dst, float scale, float offset,
+                         unsigned i, unsigned left, unsigned right)
 {
 	const float *filter_coeffs = &filter.data[i * filter.stride];
 	unsigned top = filter.left[i];
@@ -95,7 +119,7 @@ void resize_line_v_f32_c(const FilterContext &filter, const graph::ImageBuffer<c
 
 		for (unsigned k = 0; k < filter.filter_width; ++k) {
 			float coeff = filter_coeffs[k];
-			float x = src[top + k][j];
+			float x = load_pixel_f32(src[top + k][j], scale, offset);
 
 			accum += coeff * x;
 		}
@@ -107,57 +131,91 @@ void resize_line_v_f32_c(const FilterContext &filter, const graph::ImageBuffer<c
 
 class ResizeImplH_C : public ResizeImplH {
 	PixelType m_type;
+	PixelType m_src_type;
 	int32_t m_pixel_max;
+	float m_src_scale;
+	float m_src_offset;
 public:
-	ResizeImplH_C(const FilterContext &filter, unsigned height, PixelType type, unsigned depth) :
-		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, type }),
+	ResizeImplH_C(const std::shared_ptr<const FilterContext> &filter, unsigned height, PixelType type, unsigned depth,
+	              PixelType src_type, float src_scale, float src_offset) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, type }),
 		m_type{ type },
-		m_pixel_max{ static_cast<int32_t>(1UL << depth) - 1 }
+		m_src_type{ src_type },
+		m_pixel_max{ static_cast<int32_t>(1UL << depth) - 1 },
+		m_src_scale{ src_scale },
+		m_src_offset{ src_offset }
 	{
-		if (m_type != PixelType::WORD && m_type != PixelType::FLOAT)
+		if (m_type != PixelType::BYTE && m_type != PixelType::WORD && m_type != PixelType::FLOAT)
+			error::throw_<error::InternalError>("pixel type not supported");
+		if (m_src_type != m_type && (m_type != PixelType::FLOAT || (m_src_type != PixelType::BYTE && m_src_type != PixelType::WORD)))
 			error::throw_<error::InternalError>("pixel type not supported");
 	}
 
+	const char *get_name() const override { return "resize_h_c"; }
+
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *, unsigned i, unsigned left, unsigned right) const override
 	{
-		if (m_type == PixelType::WORD)
-			resize_line_h_u16_c(m_filter, static_cast<const uint16_t *>((*src)[i]), static_cast<uint16_t *>((*dst)[i]), left, right, m_pixel_max);
+		if (m_type == PixelType::BYTE)
+			resize_line_h_u16_c(*m_filter, static_cast<const uint8_t *>((*src)[i]), static_cast<uint8_t *>((*dst)[i]), left, right, m_pixel_max);
+		else if (m_type == PixelType::WORD)
+			resize_line_h_u16_c(*m_filter, static_cast<const uint16_t *>((*src)[i]), static_cast<uint16_t *>((*dst)[i]), left, right, m_pixel_max);
+		else if (m_src_type == PixelType::BYTE)
+			resize_line_h_f32_c(*m_filter, static_cast<const uint8_t *>((*src)[i]), static_cast<float *>((*dst)[i]), m_src_scale, m_src_offset, left, right);
+		else if (m_src_type == PixelType::WORD)
+			resize_line_h_f32_c(*m_filter, static_cast<const uint16_t *>((*src)[i]), static_cast<float *>((*dst)[i]), m_src_scale, m_src_offset, left, right);
 		else
-			resize_line_h_f32_c(m_filter, static_cast<const float *>((*src)[i]), static_cast<float *>((*dst)[i]), left, right);
+			resize_line_h_f32_c(*m_filter, static_cast<const float *>((*src)[i]), static_cast<float *>((*dst)[i]), 1.0f, 0.0f, left, right);
 	}
 };
 
 class ResizeImplV_C : public ResizeImplV {
 	PixelType m_type;
+	PixelType m_src_type;
 	int32_t m_pixel_max;
+	float m_src_scale;
+	float m_src_offset;
 public:
-	ResizeImplV_C(const FilterContext &filter, unsigned width, PixelType type, unsigned depth) :
-		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, type}),
+	ResizeImplV_C(const std::shared_ptr<const FilterContext> &filter, unsigned width, PixelType type, unsigned depth,
+	              PixelType src_type, float src_scale, float src_offset) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, type}),
 		m_type{ type },
-		m_pixel_max{ static_cast<int32_t>(1UL << depth) - 1 }
+		m_src_type{ src_type },
+		m_pixel_max{ static_cast<int32_t>(1UL << depth) - 1 },
+		m_src_scale{ src_scale },
+		m_src_offset{ src_offset }
 	{
-		if (m_type != PixelType::WORD && m_type != PixelType::FLOAT)
+		if (m_type != PixelType::BYTE && m_type != PixelType::WORD && m_type != PixelType::FLOAT)
+			error::throw_<error::InternalError>("pixel type not supported");
+		if (m_src_type != m_type && (m_type != PixelType::FLOAT || (m_src_type != PixelType::BYTE && m_src_type != PixelType::WORD)))
 			error::throw_<error::InternalError>("pixel type not supported");
 	}
 
+	const char *get_name() const override { return "resize_v_c"; }
+
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *, unsigned i, unsigned left, unsigned right) const override
 	{
-		if (m_type == PixelType::WORD)
-			resize_line_v_u16_c(m_filter, graph::static_buffer_cast<const uint16_t>(*src), graph::static_buffer_cast<uint16_t>(*dst), i, left, right, m_pixel_max);
+		if (m_type == PixelType::BYTE)
+			resize_line_v_u16_c(*m_filter, graph::static_buffer_cast<const uint8_t>(*src), graph::static_buffer_cast<uint8_t>(*dst), i, left, right, m_pixel_max);
+		else if (m_type == PixelType::WORD)
+			resize_line_v_u16_c(*m_filter, graph::static_buffer_cast<const uint16_t>(*src), graph::static_buffer_cast<uint16_t>(*dst), i, left, right, m_pixel_max);
+		else if (m_src_type == PixelType::BYTE)
+			resize_line_v_f32_c(*m_filter, graph::static_buffer_cast<const uint8_t>(*src), graph::static_buffer_cast<float>(*dst), m_src_scale, m_src_offset, i, left, right);
+		else if (m_src_type == PixelType::WORD)
+			resize_line_v_f32_c(*m_filter, graph::static_buffer_cast<const uint16_t>(*src), graph::static_buffer_cast<float>(*dst), m_src_scale, m_src_offset, i, left, right);
 		else
-			resize_line_v_f32_c(m_filter, graph::static_buffer_cast<const float>(*src), graph::static_buffer_cast<float>(*dst), i, left, right);
+			resize_line_v_f32_c(*m_filter, graph::static_buffer_cast<const float>(*src), graph::static_buffer_cast<float>(*dst), 1.0f, 0.0f, i, left, right);
 	}
 };
 
 } // namespace
 
 
-ResizeImplH::ResizeImplH(const FilterContext &filter, const image_attributes &attr) :
-	m_filter(filter),
+ResizeImplH::ResizeImplH(std::shared_ptr<const FilterContext> filter, const image_attributes &attr) :
+	m_filter{ std::move(filter) },
 	m_attr(attr),
-	m_is_sorted{ std::is_sorted(m_filter.left.begin(), m_filter.left.end()) }
+	m_is_sorted{ std::is_sorted(m_filter->left.begin(), m_filter->left.end()) }
 {
-	zassert_d(m_filter.input_width <= pixel_max_width(attr.type), "overflow");
+	zassert_d(m_filter->input_width <= pixel_max_width(attr.type), "overflow");
 	zassert_d(attr.width <= pixel_max_width(attr.type), "overflow");
 }
 
@@ -184,12 +242,12 @@ graph::ImageFilter::pair_unsigned ResizeImplH::get_required_row_range(unsigned i
 graph::ImageFilter::pair_unsigned ResizeImplH::get_required_col_range(unsigned left, unsigned right) const
 {
 	if (m_is_sorted) {
-		unsigned col_left = m_filter.left[left];
-		unsigned col_right = m_filter.left[right - 1] + m_filter.filter_width;
+		unsigned col_left = m_filter->left[left];
+		unsigned col_right = m_filter->left[right - 1] + m_filter->filter_width;
 
 		return{ col_left, col_right };
 	} else {
-		return{ 0, m_filter.input_width };
+		return{ 0, m_filter->input_width };
 	}
 }
 
@@ -199,12 +257,12 @@ unsigned ResizeImplH::get_max_buffering() const
 }
 
 
-ResizeImplV::ResizeImplV(const FilterContext &filter, const image_attributes &attr) :
-	m_filter(filter),
+ResizeImplV::ResizeImplV(std::shared_ptr<const FilterContext> filter, const image_attributes &attr) :
+	m_filter{ std::move(filter) },
 	m_attr(attr),
-	m_is_sorted{ std::is_sorted(m_filter.left.begin(), m_filter.left.end()) }
+	m_is_sorted{ std::is_sorted(m_filter->left.begin(), m_filter->left.end()) }
 {
-	zassert_d(m_filter.input_width <= pixel_max_width(attr.type), "overflow");
+	zassert_d(m_filter->input_width <= pixel_max_width(attr.type), "overflow");
 	zassert_d(attr.width <= pixel_max_width(attr.type), "overflow");
 }
 
@@ -226,14 +284,14 @@ graph::ImageFilter::pair_unsigned ResizeImplV::get_required_row_range(unsigned i
 		unsigned last = std::min(i, UINT_MAX - lines) + lines;
 		unsigned bot = std::min(last, get_image_attributes().height);
 
-		unsigned row_top = m_filter.left[i];
-		unsigned row_bot = m_filter.left[bot - 1];
+		unsigned row_top = m_filter->left[i];
+		unsigned row_bot = m_filter->left[bot - 1];
 
-		zassert_d(row_bot <= UINT_MAX - m_filter.filter_width, "overflow");
+		zassert_d(row_bot <= UINT_MAX - m_filter->filter_width, "overflow");
 
-		return{ row_top, row_bot + m_filter.filter_width };
+		return{ row_top, row_bot + m_filter->filter_width };
 	} else {
-		return{ 0, m_filter.input_width };
+		return{ 0, m_filter->input_width };
 	}
 }
 
@@ -261,6 +319,9 @@ ResizeImplBuilder::ResizeImplBuilder(unsigned src_width, unsigned src_height, Pi
 	filter{},
 	shift{},
 	subwidth{},
+	src_type{ type },
+	src_scale{ 1.0f },
+	src_offset{ 0.0f },
 	cpu{ CPUClass::NONE }
 {}
 
@@ -269,17 +330,31 @@ std::unique_ptr<graph::ImageFilter> ResizeImplBuilder::create() const
 	std::unique_ptr<graph::ImageFilter> ret;
 
 	unsigned src_dim = horizontal ? src_width : src_height;
-	FilterContext filter_ctx = compute_filter(*filter, src_dim, dst_dim, shift, subwidth);
+	std::shared_ptr<const FilterContext> filter_ctx = compute_filter_shared(*filter, src_dim, dst_dim, shift, subwidth);
 
+	if (src_type != type) {
+#ifdef ZIMG_X86
+		ret = horizontal ?
+			create_resize_impl_h_from_int_x86(filter_ctx, src_height, src_type, src_scale, src_offset, cpu) :
+			create_resize_impl_v_from_int_x86(filter_ctx, src_width, src_type, src_scale, src_offset, cpu);
+#endif
+	} else {
 #ifdef ZIMG_X86
-	ret = horizontal ?
-		create_resize_impl_h_x86(filter_ctx, src_height, type, depth, cpu) :
-		create_resize_impl_v_x86(filter_ctx, src_width, type, depth, cpu);
+		ret = horizontal ?
+			create_resize_impl_h_x86(filter_ctx, src_height, type, depth, cpu) :
+			create_resize_impl_v_x86(filter_ctx, src_width, type, depth, cpu);
 #endif
+#ifdef ZIMG_GENERIC_SIMD
+		if (!ret && horizontal)
+			ret = create_resize_impl_h_generic_simd(filter_ctx, src_height, type, depth, cpu);
+		if (!ret && !horizontal)
+			ret = create_resize_impl_v_generic_simd(filter_ctx, src_width, type, depth, cpu);
+#endif
+	}
 	if (!ret && horizontal)
-		ret = ztd::make_unique<ResizeImplH_C>(filter_ctx, src_height, type, depth);
+		ret = ztd::make_unique<ResizeImplH_C>(filter_ctx, src_height, type, depth, src_type, src_scale, src_offset);
 	if (!ret && !horizontal)
-		ret = ztd::make_unique<ResizeImplV_C>(filter_ctx, src_width, type, depth);
+		ret = ztd::make_unique<ResizeImplV_C>(filter_ctx, src_width, type, depth, src_type, src_scale, src_offset);
 
 	return ret;
 }
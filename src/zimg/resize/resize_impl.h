@@ -16,11 +16,11 @@ namespace resize {
 
 class ResizeImplH : public graph::ImageFilterBase {
 protected:
-	FilterContext m_filter;
+	std::shared_ptr<const FilterContext> m_filter;
 	image_attributes m_attr;
 	bool m_is_sorted;
 
-	ResizeImplH(const FilterContext &filter, const image_attributes &attr);
+	ResizeImplH(std::shared_ptr<const FilterContext> filter, const image_attributes &attr);
 public:
 	filter_flags get_flags() const override;
 
@@ -35,11 +35,11 @@ public:
 
 class ResizeImplV : public graph::ImageFilterBase {
 protected:
-	FilterContext m_filter;
+	std::shared_ptr<const FilterContext> m_filter;
 	image_attributes m_attr;
 	bool m_is_sorted;
 
-	ResizeImplV(const FilterContext &filter, const image_attributes &attr);
+	ResizeImplV(std::shared_ptr<const FilterContext> filter, const image_attributes &attr);
 public:
 	filter_flags get_flags() const override;
 
@@ -62,6 +62,9 @@ struct ResizeImplBuilder {
 	BUILDER_MEMBER(const Filter *, filter)
 	BUILDER_MEMBER(double, shift)
 	BUILDER_MEMBER(double, subwidth)
+	BUILDER_MEMBER(PixelType, src_type)
+	BUILDER_MEMBER(float, src_scale)
+	BUILDER_MEMBER(float, src_offset)
 	BUILDER_MEMBER(CPUClass, cpu)
 #undef BUILDER_MEMBER
 
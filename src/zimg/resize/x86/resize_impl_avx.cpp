@@ -337,16 +337,18 @@ const decltype(&resize_line_v_f32_avx<0, false>) resize_line_v_f32_avx_jt_b[] =
 class ResizeImplH_F32_AVX final : public ResizeImplH {
 	decltype(&resize_line8_h_f32_avx<0, 0>) m_func;
 public:
-	ResizeImplH_F32_AVX(const FilterContext &filter, unsigned height) :
-		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, PixelType::FLOAT }),
+	ResizeImplH_F32_AVX(const std::shared_ptr<const FilterContext> &filter, unsigned height) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, PixelType::FLOAT }),
 		m_func{}
 	{
-		if (filter.filter_width <= 8)
-			m_func = resize_line8_h_f32_avx_jt_small[filter.filter_width - 1];
+		if (filter->filter_width <= 8)
+			m_func = resize_line8_h_f32_avx_jt_small[filter->filter_width - 1];
 		else
-			m_func = resize_line8_h_f32_avx_jt_large[filter.filter_width % 4];
+			m_func = resize_line8_h_f32_avx_jt_large[filter->filter_width % 4];
 	}
 
+	const char *get_name() const override { return "resize_h_f32_avx"; }
+
 	unsigned get_simultaneous_lines() const override { return 8; }
 
 	size_t get_tmp_size(unsigned left, unsigned right) const override
@@ -393,7 +395,7 @@ public:
 		dst_ptr[6] = dst_buf[std::min(i + 6, height - 1)];
 		dst_ptr[7] = dst_buf[std::min(i + 7, height - 1)];
 
-		m_func(m_filter.left.data(), m_filter.data.data(), m_filter.stride, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
 			   transpose_buf, dst_ptr, floor_n(range.first, 8), left, right);
 	}
 };
@@ -401,25 +403,27 @@ public:
 
 class ResizeImplV_F32_AVX final : public ResizeImplV {
 public:
-	ResizeImplV_F32_AVX(const FilterContext &filter, unsigned width) :
-		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, zimg::PixelType::FLOAT })
+	ResizeImplV_F32_AVX(const std::shared_ptr<const FilterContext> &filter, unsigned width) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, zimg::PixelType::FLOAT })
 	{}
 
+	const char *get_name() const override { return "resize_v_f32_avx"; }
+
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *, unsigned i, unsigned left, unsigned right) const override
 	{
 		const auto &src_buf = graph::static_buffer_cast<const float>(*src);
 		const auto &dst_buf = graph::static_buffer_cast<float>(*dst);
 
-		const float *filter_data = m_filter.data.data() + i * m_filter.stride;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const float *filter_data = m_filter->data.data() + i * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
 		const float *src_lines[8] = { 0 };
 		float *dst_line = dst_buf[i];
 
 		{
 			unsigned taps_remain = std::min(filter_width - 0, 8U);
-			unsigned top = m_filter.left[i] + 0;
+			unsigned top = m_filter->left[i] + 0;
 
 			src_lines[0] = src_buf[std::min(top + 0, src_height - 1)];
 			src_lines[1] = src_buf[std::min(top + 1, src_height - 1)];
@@ -435,7 +439,7 @@ public:
 
 		for (unsigned k = 8; k < filter_width; k += 8) {
 			unsigned taps_remain = std::min(filter_width - k, 8U);
-			unsigned top = m_filter.left[i] + k;
+			unsigned top = m_filter->left[i] + k;
 
 			src_lines[0] = src_buf[std::min(top + 0, src_height - 1)];
 			src_lines[1] = src_buf[std::min(top + 1, src_height - 1)];
@@ -454,7 +458,7 @@ public:
 } // namespace
 
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
@@ -464,7 +468,7 @@ std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx(const FilterContext
 	return ret;
 }
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_v_avx(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_avx(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
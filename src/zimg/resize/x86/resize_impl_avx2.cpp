@@ -126,6 +126,50 @@ struct f32_traits {
 	}
 };
 
+// Integer pixels converted to float on load. Stores produce float.
+template <class T>
+struct int_to_f32_traits {
+	typedef __m256 vec8_type;
+	typedef T pixel_type;
+
+	float scale;
+	float offset;
+
+	static inline FORCE_INLINE __m256 load8_int(const uint8_t *ptr)
+	{
+		return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)ptr)));
+	}
+
+	static inline FORCE_INLINE __m256 load8_int(const uint16_t *ptr)
+	{
+		return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)ptr)));
+	}
+
+	inline FORCE_INLINE vec8_type load8_raw(const pixel_type *ptr) const
+	{
+		return load8(ptr);
+	}
+
+	static inline FORCE_INLINE void store8_raw(float *ptr, vec8_type x)
+	{
+		_mm256_store_ps(ptr, x);
+	}
+
+	inline FORCE_INLINE __m256 load8(const pixel_type *ptr) const
+	{
+		return _mm256_fmadd_ps(_mm256_set1_ps(scale), load8_int(ptr), _mm256_set1_ps(offset));
+	}
+
+	static inline FORCE_INLINE void transpose8(vec8_type &x0, vec8_type &x1, vec8_type &x2, vec8_type &x3,
+	                                           vec8_type &x4, vec8_type &x5, vec8_type &x6, vec8_type &x7)
+	{
+		mm256_transpose8_ps(x0, x1, x2, x3, x4, x5, x6, x7);
+	}
+};
+
+typedef int_to_f32_traits<uint8_t> u8_to_f32_traits;
+typedef int_to_f32_traits<uint16_t> u16_to_f32_traits;
+
 
 inline FORCE_INLINE __m256i export_i30_u16(__m256i lo, __m256i hi)
 {
@@ -143,25 +187,87 @@ inline FORCE_INLINE __m256i export_i30_u16(__m256i lo, __m256i hi)
 }
 
 
-template <class Traits, class T>
-void transpose_line_8x8(T *dst,
+inline FORCE_INLINE __m256i load_16_epi16(const uint8_t *ptr)
+{
+	return _mm256_cvtepu8_epi16(_mm_load_si128((const __m128i *)ptr));
+}
+
+inline FORCE_INLINE __m256i load_16_epi16(const uint16_t *ptr)
+{
+	return _mm256_load_si256((const __m256i *)ptr);
+}
+
+inline FORCE_INLINE __m128i pack_16_epi16(__m256i x)
+{
+	return _mm_packus_epi16(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+}
+
+inline FORCE_INLINE void store_16_epi16(uint8_t *ptr, __m256i x)
+{
+	_mm_store_si128((__m128i *)ptr, pack_16_epi16(x));
+}
+
+inline FORCE_INLINE void store_16_epi16(uint16_t *ptr, __m256i x)
+{
+	_mm256_store_si256((__m256i *)ptr, x);
+}
+
+inline FORCE_INLINE void store_idxlo_16_epi16(uint8_t *ptr, __m256i x, unsigned idx)
+{
+	mm_store_idxlo_epi8((__m128i *)ptr, pack_16_epi16(x), idx);
+}
+
+inline FORCE_INLINE void store_idxlo_16_epi16(uint16_t *ptr, __m256i x, unsigned idx)
+{
+	mm256_store_idxlo_epi16((__m256i *)ptr, x, idx);
+}
+
+inline FORCE_INLINE void store_idxhi_16_epi16(uint8_t *ptr, __m256i x, unsigned idx)
+{
+	mm_store_idxhi_epi8((__m128i *)ptr, pack_16_epi16(x), idx);
+}
+
+inline FORCE_INLINE void store_idxhi_16_epi16(uint16_t *ptr, __m256i x, unsigned idx)
+{
+	mm256_store_idxhi_epi16((__m256i *)ptr, x, idx);
+}
+
+inline FORCE_INLINE void scatter_16_epi16(uint8_t * const *dst_ptr, unsigned j, __m256i x)
+{
+	uint16_t tmp alignas(32)[16];
+	_mm256_store_si256((__m256i *)tmp, x);
+
+	for (unsigned n = 0; n < 16; ++n) {
+		dst_ptr[n][j] = static_cast<uint8_t>(tmp[n]);
+	}
+}
+
+inline FORCE_INLINE void scatter_16_epi16(uint16_t * const *dst_ptr, unsigned j, __m256i x)
+{
+	mm_scatter_epi16(dst_ptr[0] + j, dst_ptr[1] + j, dst_ptr[2] + j, dst_ptr[3] + j, dst_ptr[4] + j, dst_ptr[5] + j, dst_ptr[6] + j, dst_ptr[7] + j, _mm256_castsi256_si128(x));
+	mm_scatter_epi16(dst_ptr[8] + j, dst_ptr[9] + j, dst_ptr[10] + j, dst_ptr[11] + j, dst_ptr[12] + j, dst_ptr[13] + j, dst_ptr[14] + j, dst_ptr[15] + j, _mm256_extractf128_si256(x, 1));
+}
+
+
+template <class Traits, class T, class U>
+void transpose_line_8x8(U *dst,
                         const T *src_p0, const T *src_p1, const T *src_p2, const T *src_p3,
                         const T *src_p4, const T *src_p5, const T *src_p6, const T *src_p7,
-                        unsigned left, unsigned right)
+                        unsigned left, unsigned right, const Traits &traits = Traits{})
 {
 	typedef typename Traits::vec8_type vec8_type;
 
 	for (unsigned j = left; j < right; j += 8) {
 		vec8_type x0, x1, x2, x3, x4, x5, x6, x7;
 
-		x0 = Traits::load8_raw(src_p0 + j);
-		x1 = Traits::load8_raw(src_p1 + j);
-		x2 = Traits::load8_raw(src_p2 + j);
-		x3 = Traits::load8_raw(src_p3 + j);
-		x4 = Traits::load8_raw(src_p4 + j);
-		x5 = Traits::load8_raw(src_p5 + j);
-		x6 = Traits::load8_raw(src_p6 + j);
-		x7 = Traits::load8_raw(src_p7 + j);
+		x0 = traits.load8_raw(src_p0 + j);
+		x1 = traits.load8_raw(src_p1 + j);
+		x2 = traits.load8_raw(src_p2 + j);
+		x3 = traits.load8_raw(src_p3 + j);
+		x4 = traits.load8_raw(src_p4 + j);
+		x5 = traits.load8_raw(src_p5 + j);
+		x6 = traits.load8_raw(src_p6 + j);
+		x7 = traits.load8_raw(src_p7 + j);
 
 		Traits::transpose8(x0, x1, x2, x3, x4, x5, x6, x7);
 
@@ -178,27 +284,28 @@ void transpose_line_8x8(T *dst,
 	}
 }
 
-void transpose_line_16x16_epi16(uint16_t *dst, const uint16_t * const *src, unsigned left, unsigned right)
+template <class T>
+void transpose_line_16x16_epi16(uint16_t *dst, const T * const *src, unsigned left, unsigned right)
 {
 	for (unsigned j = left; j < right; j += 16) {
 		__m256i x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
 
-		x0 = _mm256_load_si256((const __m256i *)(src[0] + j));
-		x1 = _mm256_load_si256((const __m256i *)(src[1] + j));
-		x2 = _mm256_load_si256((const __m256i *)(src[2] + j));
-		x3 = _mm256_load_si256((const __m256i *)(src[3] + j));
-		x4 = _mm256_load_si256((const __m256i *)(src[4] + j));
-		x5 = _mm256_load_si256((const __m256i *)(src[5] + j));
-		x6 = _mm256_load_si256((const __m256i *)(src[6] + j));
-		x7 = _mm256_load_si256((const __m256i *)(src[7] + j));
-		x8 = _mm256_load_si256((const __m256i *)(src[8] + j));
-		x9 = _mm256_load_si256((const __m256i *)(src[9] + j));
-		x10 = _mm256_load_si256((const __m256i *)(src[10] + j));
-		x11 = _mm256_load_si256((const __m256i *)(src[11] + j));
-		x12 = _mm256_load_si256((const __m256i *)(src[12] + j));
-		x13 = _mm256_load_si256((const __m256i *)(src[13] + j));
-		x14 = _mm256_load_si256((const __m256i *)(src[14] + j));
-		x15 = _mm256_load_si256((const __m256i *)(src[15] + j));
+		x0 = load_16_epi16(src[0] + j);
+		x1 = load_16_epi16(src[1] + j);
+		x2 = load_16_epi16(src[2] + j);
+		x3 = load_16_epi16(src[3] + j);
+		x4 = load_16_epi16(src[4] + j);
+		x5 = load_16_epi16(src[5] + j);
+		x6 = load_16_epi16(src[6] + j);
+		x7 = load_16_epi16(src[7] + j);
+		x8 = load_16_epi16(src[8] + j);
+		x9 = load_16_epi16(src[9] + j);
+		x10 = load_16_epi16(src[10] + j);
+		x11 = load_16_epi16(src[11] + j);
+		x12 = load_16_epi16(src[12] + j);
+		x13 = load_16_epi16(src[13] + j);
+		x14 = load_16_epi16(src[14] + j);
+		x15 = load_16_epi16(src[15] + j);
 
 		mm256_transpose16_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15);
 
@@ -373,9 +480,9 @@ inline FORCE_INLINE __m256i resize_line8_h_u16_avx2_xiter(unsigned j,
 	return accum_lo;
 }
 
-template <bool DoLoop, unsigned Tail>
+template <class T, bool DoLoop, unsigned Tail>
 void resize_line8_h_u16_avx2(const unsigned *filter_left, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
-                             const uint16_t * RESTRICT src_ptr, uint16_t * const *dst_ptr, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
+                             const uint16_t * RESTRICT src_ptr, T * const *dst_ptr, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
 {
 	unsigned vec_left = ceil_n(left, 16);
 	unsigned vec_right = floor_n(right, 16);
@@ -385,8 +492,7 @@ void resize_line8_h_u16_avx2(const unsigned *filter_left, const int16_t * RESTRI
 	for (unsigned j = left; j < vec_left; ++j) {
 		__m256i x = XITER(j, XARGS);
 
-		mm_scatter_epi16(dst_ptr[0] + j, dst_ptr[1] + j, dst_ptr[2] + j, dst_ptr[3] + j, dst_ptr[4] + j, dst_ptr[5] + j, dst_ptr[6] + j, dst_ptr[7] + j, _mm256_castsi256_si128(x));
-		mm_scatter_epi16(dst_ptr[8] + j, dst_ptr[9] + j, dst_ptr[10] + j, dst_ptr[11] + j, dst_ptr[12] + j, dst_ptr[13] + j, dst_ptr[14] + j, dst_ptr[15] + j, _mm256_extractf128_si256(x, 1));
+		scatter_16_epi16(dst_ptr, j, x);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 16) {
@@ -417,54 +523,63 @@ void resize_line8_h_u16_avx2(const unsigned *filter_left, const int16_t * RESTRI
 
 		mm256_transpose16_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15);
 
-		_mm256_store_si256((__m256i *)(dst_ptr[0] + j), x0);
-		_mm256_store_si256((__m256i *)(dst_ptr[1] + j), x1);
-		_mm256_store_si256((__m256i *)(dst_ptr[2] + j), x2);
-		_mm256_store_si256((__m256i *)(dst_ptr[3] + j), x3);
-		_mm256_store_si256((__m256i *)(dst_ptr[4] + j), x4);
-		_mm256_store_si256((__m256i *)(dst_ptr[5] + j), x5);
-		_mm256_store_si256((__m256i *)(dst_ptr[6] + j), x6);
-		_mm256_store_si256((__m256i *)(dst_ptr[7] + j), x7);
-		_mm256_store_si256((__m256i *)(dst_ptr[8] + j), x8);
-		_mm256_store_si256((__m256i *)(dst_ptr[9] + j), x9);
-		_mm256_store_si256((__m256i *)(dst_ptr[10] + j), x10);
-		_mm256_store_si256((__m256i *)(dst_ptr[11] + j), x11);
-		_mm256_store_si256((__m256i *)(dst_ptr[12] + j), x12);
-		_mm256_store_si256((__m256i *)(dst_ptr[13] + j), x13);
-		_mm256_store_si256((__m256i *)(dst_ptr[14] + j), x14);
-		_mm256_store_si256((__m256i *)(dst_ptr[15] + j), x15);
+		store_16_epi16(dst_ptr[0] + j, x0);
+		store_16_epi16(dst_ptr[1] + j, x1);
+		store_16_epi16(dst_ptr[2] + j, x2);
+		store_16_epi16(dst_ptr[3] + j, x3);
+		store_16_epi16(dst_ptr[4] + j, x4);
+		store_16_epi16(dst_ptr[5] + j, x5);
+		store_16_epi16(dst_ptr[6] + j, x6);
+		store_16_epi16(dst_ptr[7] + j, x7);
+		store_16_epi16(dst_ptr[8] + j, x8);
+		store_16_epi16(dst_ptr[9] + j, x9);
+		store_16_epi16(dst_ptr[10] + j, x10);
+		store_16_epi16(dst_ptr[11] + j, x11);
+		store_16_epi16(dst_ptr[12] + j, x12);
+		store_16_epi16(dst_ptr[13] + j, x13);
+		store_16_epi16(dst_ptr[14] + j, x14);
+		store_16_epi16(dst_ptr[15] + j, x15);
 	}
 
 	for (unsigned j = vec_right; j < right; ++j) {
 		__m256i x = XITER(j, XARGS);
 
-		mm_scatter_epi16(dst_ptr[0] + j, dst_ptr[1] + j, dst_ptr[2] + j, dst_ptr[3] + j, dst_ptr[4] + j, dst_ptr[5] + j, dst_ptr[6] + j, dst_ptr[7] + j, _mm256_castsi256_si128(x));
-		mm_scatter_epi16(dst_ptr[8] + j, dst_ptr[9] + j, dst_ptr[10] + j, dst_ptr[11] + j, dst_ptr[12] + j, dst_ptr[13] + j, dst_ptr[14] + j, dst_ptr[15] + j, _mm256_extractf128_si256(x, 1));
+		scatter_16_epi16(dst_ptr, j, x);
 	}
 #undef XITER
 #undef XARGS
 }
 
-const decltype(&resize_line8_h_u16_avx2<false, 0>) resize_line8_h_u16_avx2_jt_small[] = {
-	resize_line8_h_u16_avx2<false, 2>,
-	resize_line8_h_u16_avx2<false, 2>,
-	resize_line8_h_u16_avx2<false, 4>,
-	resize_line8_h_u16_avx2<false, 4>,
-	resize_line8_h_u16_avx2<false, 6>,
-	resize_line8_h_u16_avx2<false, 6>,
-	resize_line8_h_u16_avx2<false, 8>,
-	resize_line8_h_u16_avx2<false, 8>,
+template <class T>
+struct resize_line8_h_u16_avx2_jt {
+	typedef decltype(&resize_line8_h_u16_avx2<T, false, 0>) func_type;
+
+	static const func_type small[8];
+	static const func_type large[8];
 };
 
-const decltype(&resize_line8_h_u16_avx2<false, 0>) resize_line8_h_u16_avx2_jt_large[] = {
-	resize_line8_h_u16_avx2<true, 0>,
-	resize_line8_h_u16_avx2<true, 2>,
-	resize_line8_h_u16_avx2<true, 2>,
-	resize_line8_h_u16_avx2<true, 4>,
-	resize_line8_h_u16_avx2<true, 4>,
-	resize_line8_h_u16_avx2<true, 6>,
-	resize_line8_h_u16_avx2<true, 6>,
-	resize_line8_h_u16_avx2<true, 0>,
+template <class T>
+const typename resize_line8_h_u16_avx2_jt<T>::func_type resize_line8_h_u16_avx2_jt<T>::small[8] = {
+	resize_line8_h_u16_avx2<T, false, 2>,
+	resize_line8_h_u16_avx2<T, false, 2>,
+	resize_line8_h_u16_avx2<T, false, 4>,
+	resize_line8_h_u16_avx2<T, false, 4>,
+	resize_line8_h_u16_avx2<T, false, 6>,
+	resize_line8_h_u16_avx2<T, false, 6>,
+	resize_line8_h_u16_avx2<T, false, 8>,
+	resize_line8_h_u16_avx2<T, false, 8>,
+};
+
+template <class T>
+const typename resize_line8_h_u16_avx2_jt<T>::func_type resize_line8_h_u16_avx2_jt<T>::large[8] = {
+	resize_line8_h_u16_avx2<T, true, 0>,
+	resize_line8_h_u16_avx2<T, true, 2>,
+	resize_line8_h_u16_avx2<T, true, 2>,
+	resize_line8_h_u16_avx2<T, true, 4>,
+	resize_line8_h_u16_avx2<T, true, 4>,
+	resize_line8_h_u16_avx2<T, true, 6>,
+	resize_line8_h_u16_avx2<T, true, 6>,
+	resize_line8_h_u16_avx2<T, true, 0>,
 };
 
 template <class Traits, unsigned FWidth, unsigned Tail>
@@ -872,10 +987,10 @@ const typename resize_line_h_perm_fp_avx2_jt<Traits>::func_type resize_line_h_pe
 };
 
 
-template <unsigned N, bool ReadAccum, bool WriteToAccum>
+template <class T, unsigned N, bool ReadAccum, bool WriteToAccum>
 inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned accum_base,
-                                                         const uint16_t * RESTRICT src_p0, const uint16_t * RESTRICT src_p1, const uint16_t * RESTRICT src_p2, const uint16_t * RESTRICT src_p3,
-                                                         const uint16_t * RESTRICT src_p4, const uint16_t * RESTRICT src_p5, const uint16_t * RESTRICT src_p6, const uint16_t * RESTRICT src_p7,
+                                                         const T * RESTRICT src_p0, const T * RESTRICT src_p1, const T * RESTRICT src_p2, const T * RESTRICT src_p3,
+                                                         const T * RESTRICT src_p4, const T * RESTRICT src_p5, const T * RESTRICT src_p6, const T * RESTRICT src_p7,
                                                          uint32_t *accum_p, const __m256i &c01, const __m256i &c23, const __m256i &c45, const __m256i &c67, uint16_t limit)
 {
 	const __m256i i16_min = _mm256_set1_epi16(INT16_MIN);
@@ -886,8 +1001,8 @@ inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned ac
 	__m256i x0, x1, xl, xh;
 
 	if (N >= 0) {
-		x0 = _mm256_load_si256((const __m256i *)(src_p0 + j));
-		x1 = _mm256_load_si256((const __m256i *)(src_p1 + j));
+		x0 = load_16_epi16(src_p0 + j);
+		x1 = load_16_epi16(src_p1 + j);
 		x0 = _mm256_add_epi16(x0, i16_min);
 		x1 = _mm256_add_epi16(x1, i16_min);
 
@@ -905,8 +1020,8 @@ inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned ac
 		}
 	}
 	if (N >= 2) {
-		x0 = _mm256_load_si256((const __m256i *)(src_p2 + j));
-		x1 = _mm256_load_si256((const __m256i *)(src_p3 + j));
+		x0 = load_16_epi16(src_p2 + j);
+		x1 = load_16_epi16(src_p3 + j);
 		x0 = _mm256_add_epi16(x0, i16_min);
 		x1 = _mm256_add_epi16(x1, i16_min);
 
@@ -919,8 +1034,8 @@ inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned ac
 		accum_hi = _mm256_add_epi32(accum_hi, xh);
 	}
 	if (N >= 4) {
-		x0 = _mm256_load_si256((const __m256i *)(src_p4 + j));
-		x1 = _mm256_load_si256((const __m256i *)(src_p5 + j));
+		x0 = load_16_epi16(src_p4 + j);
+		x1 = load_16_epi16(src_p5 + j);
 		x0 = _mm256_add_epi16(x0, i16_min);
 		x1 = _mm256_add_epi16(x1, i16_min);
 
@@ -933,8 +1048,8 @@ inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned ac
 		accum_hi = _mm256_add_epi32(accum_hi, xh);
 	}
 	if (N >= 6) {
-		x0 = _mm256_load_si256((const __m256i *)(src_p6 + j));
-		x1 = _mm256_load_si256((const __m256i *)(src_p7 + j));
+		x0 = load_16_epi16(src_p6 + j);
+		x1 = load_16_epi16(src_p7 + j);
 		x0 = _mm256_add_epi16(x0, i16_min);
 		x1 = _mm256_add_epi16(x1, i16_min);
 
@@ -960,18 +1075,18 @@ inline FORCE_INLINE __m256i resize_line_v_u16_avx2_xiter(unsigned j, unsigned ac
 	}
 }
 
-template <unsigned N, bool ReadAccum, bool WriteToAccum>
-void resize_line_v_u16_avx2(const int16_t *filter_data, const uint16_t * const *src_lines, uint16_t *dst, uint32_t *accum, unsigned left, unsigned right, uint16_t limit)
+template <class T, unsigned N, bool ReadAccum, bool WriteToAccum>
+void resize_line_v_u16_avx2(const int16_t *filter_data, const T * const *src_lines, T *dst, uint32_t *accum, unsigned left, unsigned right, uint16_t limit)
 {
-	const uint16_t * RESTRICT src_p0 = src_lines[0];
-	const uint16_t * RESTRICT src_p1 = src_lines[1];
-	const uint16_t * RESTRICT src_p2 = src_lines[2];
-	const uint16_t * RESTRICT src_p3 = src_lines[3];
-	const uint16_t * RESTRICT src_p4 = src_lines[4];
-	const uint16_t * RESTRICT src_p5 = src_lines[5];
-	const uint16_t * RESTRICT src_p6 = src_lines[6];
-	const uint16_t * RESTRICT src_p7 = src_lines[7];
-	uint16_t * RESTRICT dst_p = dst;
+	const T * RESTRICT src_p0 = src_lines[0];
+	const T * RESTRICT src_p1 = src_lines[1];
+	const T * RESTRICT src_p2 = src_lines[2];
+	const T * RESTRICT src_p3 = src_lines[3];
+	const T * RESTRICT src_p4 = src_lines[4];
+	const T * RESTRICT src_p5 = src_lines[5];
+	const T * RESTRICT src_p6 = src_lines[6];
+	const T * RESTRICT src_p7 = src_lines[7];
+	T * RESTRICT dst_p = dst;
 	uint32_t * RESTRICT accum_p = accum;
 
 	unsigned vec_left = ceil_n(left, 16);
@@ -985,100 +1100,110 @@ void resize_line_v_u16_avx2(const int16_t *filter_data, const uint16_t * const *
 
 	__m256i out;
 
-#define XITER resize_line_v_u16_avx2_xiter<N, ReadAccum, WriteToAccum>
+#define XITER resize_line_v_u16_avx2_xiter<T, N, ReadAccum, WriteToAccum>
 #define XARGS accum_base, src_p0, src_p1, src_p2, src_p3, src_p4, src_p5, src_p6, src_p7, accum_p, c01, c23, c45, c67, limit
 	if (left != vec_left) {
 		out = XITER(vec_left - 16, XARGS);
 
 		if (!WriteToAccum)
-			mm256_store_idxhi_epi16((__m256i *)(dst_p + vec_left - 16), out, left % 16);
+			store_idxhi_16_epi16(dst_p + vec_left - 16, out, left % 16);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 16) {
 		out = XITER(j, XARGS);
 
 		if (!WriteToAccum)
-			_mm256_store_si256((__m256i *)(dst_p + j), out);
+			store_16_epi16(dst_p + j, out);
 	}
 
 	if (right != vec_right) {
 		out = XITER(vec_right, XARGS);
 
 		if (!WriteToAccum)
-			mm256_store_idxlo_epi16((__m256i *)(dst_p + vec_right), out, right % 16);
+			store_idxlo_16_epi16(dst_p + vec_right, out, right % 16);
 	}
 #undef XITER
 #undef XARGS
 }
 
-const decltype(&resize_line_v_u16_avx2<0, false, false>) resize_line_v_u16_avx2_jt_a[] = {
-	resize_line_v_u16_avx2<0, false, false>,
-	resize_line_v_u16_avx2<0, false, false>,
-	resize_line_v_u16_avx2<2, false, false>,
-	resize_line_v_u16_avx2<2, false, false>,
-	resize_line_v_u16_avx2<4, false, false>,
-	resize_line_v_u16_avx2<4, false, false>,
-	resize_line_v_u16_avx2<6, false, false>,
-	resize_line_v_u16_avx2<6, false, false>,
+template <class T>
+struct resize_line_v_u16_avx2_jt {
+	typedef decltype(&resize_line_v_u16_avx2<T, 0, false, false>) func_type;
+
+	static const func_type table_a[8];
+	static const func_type table_b[8];
+};
+
+template <class T>
+const typename resize_line_v_u16_avx2_jt<T>::func_type resize_line_v_u16_avx2_jt<T>::table_a[8] = {
+	resize_line_v_u16_avx2<T, 0, false, false>,
+	resize_line_v_u16_avx2<T, 0, false, false>,
+	resize_line_v_u16_avx2<T, 2, false, false>,
+	resize_line_v_u16_avx2<T, 2, false, false>,
+	resize_line_v_u16_avx2<T, 4, false, false>,
+	resize_line_v_u16_avx2<T, 4, false, false>,
+	resize_line_v_u16_avx2<T, 6, false, false>,
+	resize_line_v_u16_avx2<T, 6, false, false>,
 };
 
-const decltype(&resize_line_v_u16_avx2<0, false, false>) resize_line_v_u16_avx2_jt_b[] = {
-	resize_line_v_u16_avx2<0, true, false>,
-	resize_line_v_u16_avx2<0, true, false>,
-	resize_line_v_u16_avx2<2, true, false>,
-	resize_line_v_u16_avx2<2, true, false>,
-	resize_line_v_u16_avx2<4, true, false>,
-	resize_line_v_u16_avx2<4, true, false>,
-	resize_line_v_u16_avx2<6, true, false>,
-	resize_line_v_u16_avx2<6, true, false>,
+template <class T>
+const typename resize_line_v_u16_avx2_jt<T>::func_type resize_line_v_u16_avx2_jt<T>::table_b[8] = {
+	resize_line_v_u16_avx2<T, 0, true, false>,
+	resize_line_v_u16_avx2<T, 0, true, false>,
+	resize_line_v_u16_avx2<T, 2, true, false>,
+	resize_line_v_u16_avx2<T, 2, true, false>,
+	resize_line_v_u16_avx2<T, 4, true, false>,
+	resize_line_v_u16_avx2<T, 4, true, false>,
+	resize_line_v_u16_avx2<T, 6, true, false>,
+	resize_line_v_u16_avx2<T, 6, true, false>,
 };
 
-template <class Traits, unsigned N, bool UpdateAccum, class T = typename Traits::pixel_type>
-inline FORCE_INLINE __m256 resize_line_v_fp_avx2_xiter(unsigned j,
+template <class Traits, class SrcTraits, unsigned N, bool UpdateAccum, class T = typename SrcTraits::pixel_type, class U = typename Traits::pixel_type>
+inline FORCE_INLINE __m256 resize_line_v_fp_avx2_xiter(unsigned j, const SrcTraits &src_traits,
                                                        const T * RESTRICT src_p0, const T * RESTRICT src_p1,
                                                        const T * RESTRICT src_p2, const T * RESTRICT src_p3,
                                                        const T * RESTRICT src_p4, const T * RESTRICT src_p5,
-                                                       const T * RESTRICT src_p6, const T * RESTRICT src_p7, T * RESTRICT dst_p,
+                                                       const T * RESTRICT src_p6, const T * RESTRICT src_p7, U * RESTRICT dst_p,
                                                        const __m256 &c0, const __m256 &c1, const __m256 &c2, const __m256 &c3,
                                                        const __m256 &c4, const __m256 &c5, const __m256 &c6, const __m256 &c7)
 {
-	typedef typename Traits::pixel_type pixel_type;
-	static_assert(std::is_same<pixel_type, T>::value, "must not specify T");
+	static_assert(std::is_same<typename SrcTraits::pixel_type, T>::value, "must not specify T");
+	static_assert(std::is_same<typename Traits::pixel_type, U>::value, "must not specify U");
 
 	__m256 accum0 = _mm256_setzero_ps();
 	__m256 accum1 = _mm256_setzero_ps();
 	__m256 x;
 
 	if (N >= 0) {
-		x = Traits::load8(src_p0 + j);
+		x = src_traits.load8(src_p0 + j);
 		accum0 = UpdateAccum ? _mm256_fmadd_ps(c0, x, Traits::load8(dst_p + j)) : _mm256_mul_ps(c0, x);
 	}
 	if (N >= 1) {
-		x = Traits::load8(src_p1 + j);
+		x = src_traits.load8(src_p1 + j);
 		accum1 = _mm256_mul_ps(c1, x);
 	}
 	if (N >= 2) {
-		x = Traits::load8(src_p2 + j);
+		x = src_traits.load8(src_p2 + j);
 		accum0 = _mm256_fmadd_ps(c2, x, accum0);
 	}
 	if (N >= 3) {
-		x = Traits::load8(src_p3 + j);
+		x = src_traits.load8(src_p3 + j);
 		accum1 = _mm256_fmadd_ps(c3, x, accum1);
 	}
 	if (N >= 4) {
-		x = Traits::load8(src_p4 + j);
+		x = src_traits.load8(src_p4 + j);
 		accum0 = _mm256_fmadd_ps(c4, x, accum0);
 	}
 	if (N >= 5) {
-		x = Traits::load8(src_p5 + j);
+		x = src_traits.load8(src_p5 + j);
 		accum1 = _mm256_fmadd_ps(c5, x, accum1);
 	}
 	if (N >= 6) {
-		x = Traits::load8(src_p6 + j);
+		x = src_traits.load8(src_p6 + j);
 		accum0 = _mm256_fmadd_ps(c6, x, accum0);
 	}
 	if (N >= 7) {
-		x = Traits::load8(src_p7 + j);
+		x = src_traits.load8(src_p7 + j);
 		accum1 = _mm256_fmadd_ps(c7, x, accum1);
 	}
 
@@ -1086,19 +1211,21 @@ inline FORCE_INLINE __m256 resize_line_v_fp_avx2_xiter(unsigned j,
 	return accum0;
 }
 
-template <class Traits, unsigned N, bool UpdateAccum>
-void resize_line_v_fp_avx2(const float *filter_data, const typename Traits::pixel_type * const *src_lines, typename Traits::pixel_type *dst, unsigned left, unsigned right)
+template <class Traits, class SrcTraits, unsigned N, bool UpdateAccum>
+void resize_line_v_fp_avx2(const float *filter_data, const typename SrcTraits::pixel_type * const *src_lines, typename Traits::pixel_type *dst,
+                           const SrcTraits &src_traits, unsigned left, unsigned right)
 {
 	typedef typename Traits::pixel_type pixel_type;
-
-	const pixel_type * RESTRICT src_p0 = src_lines[0];
-	const pixel_type * RESTRICT src_p1 = src_lines[1];
-	const pixel_type * RESTRICT src_p2 = src_lines[2];
-	const pixel_type * RESTRICT src_p3 = src_lines[3];
-	const pixel_type * RESTRICT src_p4 = src_lines[4];
-	const pixel_type * RESTRICT src_p5 = src_lines[5];
-	const pixel_type * RESTRICT src_p6 = src_lines[6];
-	const pixel_type * RESTRICT src_p7 = src_lines[7];
+	typedef typename SrcTraits::pixel_type src_pixel_type;
+
+	const src_pixel_type * RESTRICT src_p0 = src_lines[0];
+	const src_pixel_type * RESTRICT src_p1 = src_lines[1];
+	const src_pixel_type * RESTRICT src_p2 = src_lines[2];
+	const src_pixel_type * RESTRICT src_p3 = src_lines[3];
+	const src_pixel_type * RESTRICT src_p4 = src_lines[4];
+	const src_pixel_type * RESTRICT src_p5 = src_lines[5];
+	const src_pixel_type * RESTRICT src_p6 = src_lines[6];
+	const src_pixel_type * RESTRICT src_p7 = src_lines[7];
 	pixel_type * RESTRICT dst_p = dst;
 
 	unsigned vec_left = ceil_n(left, 8);
@@ -1115,8 +1242,8 @@ void resize_line_v_fp_avx2(const float *filter_data, const typename Traits::pixe
 
 	__m256 accum;
 
-#define XITER resize_line_v_fp_avx2_xiter<Traits, N, UpdateAccum>
-#define XARGS src_p0, src_p1, src_p2, src_p3, src_p4, src_p5, src_p6, src_p7, dst_p, c0, c1, c2, c3, c4, c5, c6, c7
+#define XITER resize_line_v_fp_avx2_xiter<Traits, SrcTraits, N, UpdateAccum>
+#define XARGS src_traits, src_p0, src_p1, src_p2, src_p3, src_p4, src_p5, src_p6, src_p7, dst_p, c0, c1, c2, c3, c4, c5, c6, c7
 	if (left != vec_left) {
 		accum = XITER(vec_left - 8, XARGS);
 		Traits::store_idxhi(dst_p + vec_left - 8, accum, left % 8);
@@ -1135,54 +1262,59 @@ void resize_line_v_fp_avx2(const float *filter_data, const typename Traits::pixe
 #undef XARGS
 }
 
-template <class Traits>
+template <class Traits, class SrcTraits = Traits>
 struct resize_line_v_fp_avx2_jt {
-	typedef decltype(&resize_line_v_fp_avx2<Traits, 0, false>) func_type;
+	typedef decltype(&resize_line_v_fp_avx2<Traits, SrcTraits, 0, false>) func_type;
 
 	static const func_type table_a[8];
 	static const func_type table_b[8];
 };
 
-template <class Traits>
-const typename resize_line_v_fp_avx2_jt<Traits>::func_type resize_line_v_fp_avx2_jt<Traits>::table_a[8] = {
-	resize_line_v_fp_avx2<Traits, 0, false>,
-	resize_line_v_fp_avx2<Traits, 1, false>,
-	resize_line_v_fp_avx2<Traits, 2, false>,
-	resize_line_v_fp_avx2<Traits, 3, false>,
-	resize_line_v_fp_avx2<Traits, 4, false>,
-	resize_line_v_fp_avx2<Traits, 5, false>,
-	resize_line_v_fp_avx2<Traits, 6, false>,
-	resize_line_v_fp_avx2<Traits, 7, false>,
+template <class Traits, class SrcTraits>
+const typename resize_line_v_fp_avx2_jt<Traits, SrcTraits>::func_type resize_line_v_fp_avx2_jt<Traits, SrcTraits>::table_a[8] = {
+	resize_line_v_fp_avx2<Traits, SrcTraits, 0, false>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 1, false>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 2, false>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 3, false>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 4, false>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 5, false>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 6, false>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 7, false>,
 };
 
-template <class Traits>
-const typename resize_line_v_fp_avx2_jt<Traits>::func_type resize_line_v_fp_avx2_jt<Traits>::table_b[8] = {
-	resize_line_v_fp_avx2<Traits, 0, true>,
-	resize_line_v_fp_avx2<Traits, 1, true>,
-	resize_line_v_fp_avx2<Traits, 2, true>,
-	resize_line_v_fp_avx2<Traits, 3, true>,
-	resize_line_v_fp_avx2<Traits, 4, true>,
-	resize_line_v_fp_avx2<Traits, 5, true>,
-	resize_line_v_fp_avx2<Traits, 6, true>,
-	resize_line_v_fp_avx2<Traits, 7, true>,
+template <class Traits, class SrcTraits>
+const typename resize_line_v_fp_avx2_jt<Traits, SrcTraits>::func_type resize_line_v_fp_avx2_jt<Traits, SrcTraits>::table_b[8] = {
+	resize_line_v_fp_avx2<Traits, SrcTraits, 0, true>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 1, true>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 2, true>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 3, true>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 4, true>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 5, true>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 6, true>,
+	resize_line_v_fp_avx2<Traits, SrcTraits, 7, true>,
 };
 
 
+template <class T>
 class ResizeImplH_U16_AVX2 final : public ResizeImplH {
-	decltype(&resize_line8_h_u16_avx2<false, 0>) m_func;
+	typedef typename resize_line8_h_u16_avx2_jt<T>::func_type func_type;
+
+	func_type m_func;
 	uint16_t m_pixel_max;
 public:
-	ResizeImplH_U16_AVX2(const FilterContext &filter, unsigned height, unsigned depth) :
-		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, PixelType::WORD }),
+	ResizeImplH_U16_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned height, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
 		m_func{},
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
-		if (filter.filter_width > 8)
-			m_func = resize_line8_h_u16_avx2_jt_large[filter.filter_width % 8];
+		if (filter->filter_width > 8)
+			m_func = resize_line8_h_u16_avx2_jt<T>::large[filter->filter_width % 8];
 		else
-			m_func = resize_line8_h_u16_avx2_jt_small[filter.filter_width - 1];
+			m_func = resize_line8_h_u16_avx2_jt<T>::small[filter->filter_width - 1];
 	}
 
+	const char *get_name() const override { return "resize_h_u16_avx2"; }
+
 	unsigned get_simultaneous_lines() const override { return 16; }
 
 	size_t get_tmp_size(unsigned left, unsigned right) const override
@@ -1199,12 +1331,12 @@ public:
 
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
 	{
-		const auto &src_buf = graph::static_buffer_cast<const uint16_t>(*src);
-		const auto &dst_buf = graph::static_buffer_cast<uint16_t>(*dst);
+		const auto &src_buf = graph::static_buffer_cast<const T>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<T>(*dst);
 		auto range = get_required_col_range(left, right);
 
-		const uint16_t *src_ptr[16] = { 0 };
-		uint16_t *dst_ptr[16] = { 0 };
+		const T *src_ptr[16] = { 0 };
+		T *dst_ptr[16] = { 0 };
 		uint16_t *transpose_buf = static_cast<uint16_t *>(tmp);
 		unsigned height = get_image_attributes().height;
 
@@ -1218,28 +1350,33 @@ public:
 			dst_ptr[n] = dst_buf[std::min(i + n, height - 1)];
 		}
 
-		m_func(m_filter.left.data(), m_filter.data_i16.data(), m_filter.stride_i16, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->data_i16.data(), m_filter->stride_i16, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 16), left, right, m_pixel_max);
 	}
 };
 
-template <class Traits>
+template <class Traits, class SrcTraits = Traits>
 class ResizeImplH_FP_AVX2 final : public ResizeImplH {
 	typedef typename Traits::pixel_type pixel_type;
+	typedef typename SrcTraits::pixel_type src_pixel_type;
 	typedef typename resize_line8_h_fp_avx2_jt<Traits>::func_type func_type;
 
 	func_type m_func;
+	SrcTraits m_src_traits;
 public:
-	ResizeImplH_FP_AVX2(const FilterContext &filter, unsigned height) :
-		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, Traits::type_constant }),
-		m_func{}
+	ResizeImplH_FP_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned height, const SrcTraits &src_traits = SrcTraits{}) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, Traits::type_constant }),
+		m_func{},
+		m_src_traits(src_traits)
 	{
-		if (filter.filter_width <= 8)
-			m_func = resize_line8_h_fp_avx2_jt<Traits>::small[filter.filter_width - 1];
+		if (filter->filter_width <= 8)
+			m_func = resize_line8_h_fp_avx2_jt<Traits>::small[filter->filter_width - 1];
 		else
-			m_func = resize_line8_h_fp_avx2_jt<Traits>::large[filter.filter_width % 4];
+			m_func = resize_line8_h_fp_avx2_jt<Traits>::large[filter->filter_width % 4];
 	}
 
+	const char *get_name() const override { return "resize_h_fp_avx2"; }
+
 	unsigned get_simultaneous_lines() const override { return 8; }
 
 	size_t get_tmp_size(unsigned left, unsigned right) const override
@@ -1256,11 +1393,11 @@ public:
 
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
 	{
-		const auto &src_buf = graph::static_buffer_cast<const pixel_type>(*src);
+		const auto &src_buf = graph::static_buffer_cast<const src_pixel_type>(*src);
 		const auto &dst_buf = graph::static_buffer_cast<pixel_type>(*dst);
 		auto range = get_required_col_range(left, right);
 
-		const pixel_type *src_ptr[8] = { 0 };
+		const src_pixel_type *src_ptr[8] = { 0 };
 		pixel_type *dst_ptr[8] = { 0 };
 		pixel_type *transpose_buf = static_cast<pixel_type *>(tmp);
 		unsigned height = get_image_attributes().height;
@@ -1274,8 +1411,8 @@ public:
 		src_ptr[6] = src_buf[std::min(i + 6, height - 1)];
 		src_ptr[7] = src_buf[std::min(i + 7, height - 1)];
 
-		transpose_line_8x8<Traits>(transpose_buf, src_ptr[0], src_ptr[1], src_ptr[2], src_ptr[3], src_ptr[4], src_ptr[5], src_ptr[6], src_ptr[7],
-		                           floor_n(range.first, 8), ceil_n(range.second, 8));
+		transpose_line_8x8<SrcTraits>(transpose_buf, src_ptr[0], src_ptr[1], src_ptr[2], src_ptr[3], src_ptr[4], src_ptr[5], src_ptr[6], src_ptr[7],
+		                              floor_n(range.first, 8), ceil_n(range.second, 8), m_src_traits);
 
 		dst_ptr[0] = dst_buf[std::min(i + 0, height - 1)];
 		dst_ptr[1] = dst_buf[std::min(i + 1, height - 1)];
@@ -1286,7 +1423,7 @@ public:
 		dst_ptr[6] = dst_buf[std::min(i + 6, height - 1)];
 		dst_ptr[7] = dst_buf[std::min(i + 7, height - 1)];
 
-		m_func(m_filter.left.data(), m_filter.data.data(), m_filter.stride, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 8), left, right);
 	}
 };
@@ -1371,6 +1508,8 @@ public:
 		return ret;
 	}
 
+	const char *get_name() const override { return "resize_h_permute_u16_avx2"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -1478,6 +1617,8 @@ public:
 		return ret;
 	}
 
+	const char *get_name() const override { return "resize_h_permute_fp_avx2"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -1515,20 +1656,23 @@ public:
 	}
 };
 
+template <class T>
 class ResizeImplV_U16_AVX2 final : public ResizeImplV {
 	uint16_t m_pixel_max;
 public:
-	ResizeImplV_U16_AVX2(const FilterContext &filter, unsigned width, unsigned depth) :
-		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::WORD }),
+	ResizeImplV_U16_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned width, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{}
 
+	const char *get_name() const override { return "resize_v_u16_avx2"; }
+
 	size_t get_tmp_size(unsigned left, unsigned right) const override
 	{
 		checked_size_t size = 0;
 
 		try {
-			if (m_filter.filter_width > 8)
+			if (m_filter->filter_width > 8)
 				size += (ceil_n(checked_size_t{ right }, 16) - floor_n(left, 16)) * sizeof(uint32_t);
 		} catch (const std::overflow_error &) {
 			error::throw_<error::OutOfMemory>();
@@ -1539,70 +1683,76 @@ public:
 
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
 	{
-		const auto &src_buf = graph::static_buffer_cast<const uint16_t>(*src);
-		const auto &dst_buf = graph::static_buffer_cast<uint16_t>(*dst);
+		const auto &src_buf = graph::static_buffer_cast<const T>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<T>(*dst);
 
-		const int16_t *filter_data = m_filter.data_i16.data() + i * m_filter.stride_i16;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const int16_t *filter_data = m_filter->data_i16.data() + i * m_filter->stride_i16;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
-		const uint16_t *src_lines[8] = { 0 };
-		uint16_t *dst_line = dst_buf[i];
+		const T *src_lines[8] = { 0 };
+		T *dst_line = dst_buf[i];
 		uint32_t *accum_buf = static_cast<uint32_t *>(tmp);
 
-		unsigned top = m_filter.left[i];
+		unsigned top = m_filter->left[i];
 
 		if (filter_width <= 8) {
 			for (unsigned n = 0; n < 8; ++n) {
 				src_lines[n] = src_buf[std::min(top + n, src_height - 1)];
 			}
-			resize_line_v_u16_avx2_jt_a[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx2_jt<T>::table_a[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		} else {
 			unsigned k_end = ceil_n(filter_width, 8) - 8;
 
 			for (unsigned n = 0; n < 8; ++n) {
 				src_lines[n] = src_buf[std::min(top + 0 + n, src_height - 1)];
 			}
-			resize_line_v_u16_avx2<6, false, true>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx2<T, 6, false, true>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 
 			for (unsigned k = 8; k < k_end; k += 8) {
 				for (unsigned n = 0; n < 8; ++n) {
 					src_lines[n] = src_buf[std::min(top + k + n, src_height - 1)];
 				}
-				resize_line_v_u16_avx2<6, true, true>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+				resize_line_v_u16_avx2<T, 6, true, true>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 			}
 
 			for (unsigned n = 0; n < 8; ++n) {
 				src_lines[n] = src_buf[std::min(top + k_end + n, src_height - 1)];
 			}
-			resize_line_v_u16_avx2_jt_b[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx2_jt<T>::table_b[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		}
 	}
 };
 
-template <class Traits>
+template <class Traits, class SrcTraits = Traits>
 class ResizeImplV_FP_AVX2 final : public ResizeImplV {
 	typedef typename Traits::pixel_type pixel_type;
+	typedef typename SrcTraits::pixel_type src_pixel_type;
+
+	SrcTraits m_src_traits;
 public:
-	ResizeImplV_FP_AVX2(const FilterContext &filter, unsigned width) :
-		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, Traits::type_constant })
+	ResizeImplV_FP_AVX2(const std::shared_ptr<const FilterContext> &filter, unsigned width, const SrcTraits &src_traits = SrcTraits{}) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, Traits::type_constant }),
+		m_src_traits(src_traits)
 	{}
 
+	const char *get_name() const override { return "resize_v_fp_avx2"; }
+
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *, unsigned i, unsigned left, unsigned right) const override
 	{
-		const auto &src_buf = graph::static_buffer_cast<const pixel_type>(*src);
+		const auto &src_buf = graph::static_buffer_cast<const src_pixel_type>(*src);
 		const auto &dst_buf = graph::static_buffer_cast<pixel_type>(*dst);
 
-		const float *filter_data = m_filter.data.data() + i * m_filter.stride;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const float *filter_data = m_filter->data.data() + i * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
-		const pixel_type *src_lines[8] = { 0 };
+		const src_pixel_type *src_lines[8] = { 0 };
 		pixel_type *dst_line = dst_buf[i];
 
 		{
 			unsigned taps_remain = std::min(filter_width - 0, 8U);
-			unsigned top = m_filter.left[i] + 0;
+			unsigned top = m_filter->left[i] + 0;
 
 			src_lines[0] = src_buf[std::min(top + 0, src_height - 1)];
 			src_lines[1] = src_buf[std::min(top + 1, src_height - 1)];
@@ -1613,12 +1763,12 @@ public:
 			src_lines[6] = src_buf[std::min(top + 6, src_height - 1)];
 			src_lines[7] = src_buf[std::min(top + 7, src_height - 1)];
 
-			resize_line_v_fp_avx2_jt<Traits>::table_a[taps_remain - 1](filter_data + 0, src_lines, dst_line, left, right);
+			resize_line_v_fp_avx2_jt<Traits, SrcTraits>::table_a[taps_remain - 1](filter_data + 0, src_lines, dst_line, m_src_traits, left, right);
 		}
 
 		for (unsigned k = 8; k < filter_width; k += 8) {
 			unsigned taps_remain = std::min(filter_width - k, 8U);
-			unsigned top = m_filter.left[i] + k;
+			unsigned top = m_filter->left[i] + k;
 
 			src_lines[0] = src_buf[std::min(top + 0, src_height - 1)];
 			src_lines[1] = src_buf[std::min(top + 1, src_height - 1)];
@@ -1629,7 +1779,7 @@ public:
 			src_lines[6] = src_buf[std::min(top + 6, src_height - 1)];
 			src_lines[7] = src_buf[std::min(top + 7, src_height - 1)];
 
-			resize_line_v_fp_avx2_jt<Traits>::table_b[taps_remain - 1](filter_data + k, src_lines, dst_line, left, right);
+			resize_line_v_fp_avx2_jt<Traits, SrcTraits>::table_b[taps_remain - 1](filter_data + k, src_lines, dst_line, m_src_traits, left, right);
 		}
 	}
 };
@@ -1637,22 +1787,24 @@ public:
 } // namespace
 
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx2(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx2(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
 #ifndef ZIMG_RESIZE_NO_PERMUTE
 	if (type == PixelType::WORD)
-		ret = ResizeImplH_Permute_U16_AVX2::create(context, height, depth);
+		ret = ResizeImplH_Permute_U16_AVX2::create(*context, height, depth);
 	else if (type == PixelType::HALF)
-		ret = ResizeImplH_Permute_FP_AVX2<f16_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX2<f16_traits>::create(*context, height);
 	else if (type == PixelType::FLOAT)
-		ret = ResizeImplH_Permute_FP_AVX2<f32_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX2<f32_traits>::create(*context, height);
 #endif
 
 	if (!ret) {
-		if (type == PixelType::WORD)
-			ret = ztd::make_unique<ResizeImplH_U16_AVX2>(context, height, depth);
+		if (type == PixelType::BYTE)
+			ret = ztd::make_unique<ResizeImplH_U16_AVX2<uint8_t>>(context, height, depth);
+		else if (type == PixelType::WORD)
+			ret = ztd::make_unique<ResizeImplH_U16_AVX2<uint16_t>>(context, height, depth);
 		else if (type == PixelType::HALF)
 			ret = ztd::make_unique<ResizeImplH_FP_AVX2<f16_traits>>(context, height);
 		else if (type == PixelType::FLOAT)
@@ -1662,12 +1814,14 @@ std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx2(const FilterContex
 	return ret;
 }
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_v_avx2(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_avx2(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
-	if (type == PixelType::WORD)
-		ret = ztd::make_unique<ResizeImplV_U16_AVX2>(context, width, depth);
+	if (type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplV_U16_AVX2<uint8_t>>(context, width, depth);
+	else if (type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplV_U16_AVX2<uint16_t>>(context, width, depth);
 	else if (type == PixelType::HALF)
 		ret = ztd::make_unique<ResizeImplV_FP_AVX2<f16_traits>>(context, width);
 	else if (type == PixelType::FLOAT)
@@ -1676,6 +1830,30 @@ std::unique_ptr<graph::ImageFilter> create_resize_impl_v_avx2(const FilterContex
 	return ret;
 }
 
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_from_int_avx2(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType src_type, float scale, float offset)
+{
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (src_type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplH_FP_AVX2<f32_traits, u8_to_f32_traits>>(context, height, u8_to_f32_traits{ scale, offset });
+	else if (src_type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplH_FP_AVX2<f32_traits, u16_to_f32_traits>>(context, height, u16_to_f32_traits{ scale, offset });
+
+	return ret;
+}
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_from_int_avx2(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType src_type, float scale, float offset)
+{
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (src_type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplV_FP_AVX2<f32_traits, u8_to_f32_traits>>(context, width, u8_to_f32_traits{ scale, offset });
+	else if (src_type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplV_FP_AVX2<f32_traits, u16_to_f32_traits>>(context, width, u16_to_f32_traits{ scale, offset });
+
+	return ret;
+}
+
 } // namespace resize
 } // namespace zimg
 
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
 #include <immintrin.h>
 #include "common/align.h"
 #include "common/ccdep.h"
@@ -164,6 +165,55 @@ inline FORCE_INLINE __m512i export2_i30_u16(__m512i lo, __m512i hi)
 }
 
 
+inline FORCE_INLINE __m512i load_32_epi16(const uint8_t *ptr)
+{
+	return _mm512_cvtepu8_epi16(_mm256_load_si256((const __m256i *)ptr));
+}
+
+inline FORCE_INLINE __m512i load_32_epi16(const uint16_t *ptr)
+{
+	return _mm512_load_si512(ptr);
+}
+
+inline FORCE_INLINE void store_32_epi16(uint8_t *ptr, __m512i x)
+{
+	_mm256_store_si256((__m256i *)ptr, _mm512_cvtepi16_epi8(x));
+}
+
+inline FORCE_INLINE void store_32_epi16(uint16_t *ptr, __m512i x)
+{
+	_mm512_store_si512(ptr, x);
+}
+
+inline FORCE_INLINE void mask_store_32_epi16(uint8_t *ptr, __mmask32 mask, __m512i x)
+{
+	_mm256_mask_storeu_epi8(ptr, mask, _mm512_cvtepi16_epi8(x));
+}
+
+inline FORCE_INLINE void mask_store_32_epi16(uint16_t *ptr, __mmask32 mask, __m512i x)
+{
+	_mm512_mask_storeu_epi16(ptr, mask, x);
+}
+
+inline FORCE_INLINE void scatter_32_epi16(uint8_t * const *dst_ptr, unsigned j, __m512i x)
+{
+	uint16_t tmp alignas(64)[32];
+	_mm512_store_si512(tmp, x);
+
+	for (unsigned n = 0; n < 32; ++n) {
+		dst_ptr[n][j] = static_cast<uint8_t>(tmp[n]);
+	}
+}
+
+inline FORCE_INLINE void scatter_32_epi16(uint16_t * const *dst_ptr, unsigned j, __m512i x)
+{
+	mm_scatter_epi16(dst_ptr[0] + j, dst_ptr[1] + j, dst_ptr[2] + j, dst_ptr[3] + j, dst_ptr[4] + j, dst_ptr[5] + j, dst_ptr[6] + j, dst_ptr[7] + j, _mm512_castsi512_si128(x));
+	mm_scatter_epi16(dst_ptr[8] + j, dst_ptr[9] + j, dst_ptr[10] + j, dst_ptr[11] + j, dst_ptr[12] + j, dst_ptr[13] + j, dst_ptr[14] + j, dst_ptr[15] + j, _mm512_extracti32x4_epi32(x, 1));
+	mm_scatter_epi16(dst_ptr[16] + j, dst_ptr[17] + j, dst_ptr[18] + j, dst_ptr[19] + j, dst_ptr[20] + j, dst_ptr[21] + j, dst_ptr[22] + j, dst_ptr[23] + j, _mm512_extracti32x4_epi32(x, 2));
+	mm_scatter_epi16(dst_ptr[24] + j, dst_ptr[25] + j, dst_ptr[26] + j, dst_ptr[27] + j, dst_ptr[28] + j, dst_ptr[29] + j, dst_ptr[30] + j, dst_ptr[31] + j, _mm512_extracti32x4_epi32(x, 3));
+}
+
+
 template <class Traits, class T>
 void transpose_line_16x16(T *dst, const T *src_p[16], unsigned left, unsigned right)
 {
@@ -229,44 +279,45 @@ void transpose_line_16x16(T *dst, const T *src_p[16], unsigned left, unsigned ri
 	}
 }
 
-void transpose_line_32x32_epi16(uint16_t *dst, const uint16_t * const *src, unsigned left, unsigned right)
+template <class T>
+void transpose_line_32x32_epi16(uint16_t *dst, const T * const *src, unsigned left, unsigned right)
 {
 	for (unsigned j = left; j < right; j += 32) {
 		__m512i x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
 		__m512i x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31;
 
-		x0 = _mm512_load_si512(src[0] + j);
-		x1 = _mm512_load_si512(src[1] + j);
-		x2 = _mm512_load_si512(src[2] + j);
-		x3 = _mm512_load_si512(src[3] + j);
-		x4 = _mm512_load_si512(src[4] + j);
-		x5 = _mm512_load_si512(src[5] + j);
-		x6 = _mm512_load_si512(src[6] + j);
-		x7 = _mm512_load_si512(src[7] + j);
-		x8 = _mm512_load_si512(src[8] + j);
-		x9 = _mm512_load_si512(src[9] + j);
-		x10 = _mm512_load_si512(src[10] + j);
-		x11 = _mm512_load_si512(src[11] + j);
-		x12 = _mm512_load_si512(src[12] + j);
-		x13 = _mm512_load_si512(src[13] + j);
-		x14 = _mm512_load_si512(src[14] + j);
-		x15 = _mm512_load_si512(src[15] + j);
-		x16 = _mm512_load_si512(src[16] + j);
-		x17 = _mm512_load_si512(src[17] + j);
-		x18 = _mm512_load_si512(src[18] + j);
-		x19 = _mm512_load_si512(src[19] + j);
-		x20 = _mm512_load_si512(src[20] + j);
-		x21 = _mm512_load_si512(src[21] + j);
-		x22 = _mm512_load_si512(src[22] + j);
-		x23 = _mm512_load_si512(src[23] + j);
-		x24 = _mm512_load_si512(src[24] + j);
-		x25 = _mm512_load_si512(src[25] + j);
-		x26 = _mm512_load_si512(src[26] + j);
-		x27 = _mm512_load_si512(src[27] + j);
-		x28 = _mm512_load_si512(src[28] + j);
-		x29 = _mm512_load_si512(src[29] + j);
-		x30 = _mm512_load_si512(src[30] + j);
-		x31 = _mm512_load_si512(src[31] + j);
+		x0 = load_32_epi16(src[0] + j);
+		x1 = load_32_epi16(src[1] + j);
+		x2 = load_32_epi16(src[2] + j);
+		x3 = load_32_epi16(src[3] + j);
+		x4 = load_32_epi16(src[4] + j);
+		x5 = load_32_epi16(src[5] + j);
+		x6 = load_32_epi16(src[6] + j);
+		x7 = load_32_epi16(src[7] + j);
+		x8 = load_32_epi16(src[8] + j);
+		x9 = load_32_epi16(src[9] + j);
+		x10 = load_32_epi16(src[10] + j);
+		x11 = load_32_epi16(src[11] + j);
+		x12 = load_32_epi16(src[12] + j);
+		x13 = load_32_epi16(src[13] + j);
+		x14 = load_32_epi16(src[14] + j);
+		x15 = load_32_epi16(src[15] + j);
+		x16 = load_32_epi16(src[16] + j);
+		x17 = load_32_epi16(src[17] + j);
+		x18 = load_32_epi16(src[18] + j);
+		x19 = load_32_epi16(src[19] + j);
+		x20 = load_32_epi16(src[20] + j);
+		x21 = load_32_epi16(src[21] + j);
+		x22 = load_32_epi16(src[22] + j);
+		x23 = load_32_epi16(src[23] + j);
+		x24 = load_32_epi16(src[24] + j);
+		x25 = load_32_epi16(src[25] + j);
+		x26 = load_32_epi16(src[26] + j);
+		x27 = load_32_epi16(src[27] + j);
+		x28 = load_32_epi16(src[28] + j);
+		x29 = load_32_epi16(src[29] + j);
+		x30 = load_32_epi16(src[30] + j);
+		x31 = load_32_epi16(src[31] + j);
 
 		mm512_transpose32_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15,
 		                        x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31);
@@ -458,22 +509,19 @@ inline FORCE_INLINE __m512i resize_line16_h_u16_avx512_xiter(unsigned j,
 	return accum_lo;
 }
 
-template <bool DoLoop, unsigned Tail>
+template <class T, bool DoLoop, unsigned Tail>
 void resize_line16_h_u16_avx512(const unsigned *filter_left, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
-                                const uint16_t * RESTRICT src_ptr, uint16_t * const *dst_ptr, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
+                                const uint16_t * RESTRICT src_ptr, T * const *dst_ptr, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
 {
-	unsigned vec_left = ceil_n(left, 16);
-	unsigned vec_right = floor_n(right, 16);
+	unsigned vec_left = ceil_n(left, 32);
+	unsigned vec_right = floor_n(right, 32);
 
 #define XITER resize_line16_h_u16_avx512_xiter<DoLoop, Tail>
 #define XARGS filter_left, filter_data, filter_stride, filter_width, src_ptr, src_base, limit
 	for (unsigned j = left; j < vec_left; ++j) {
 		__m512i x = XITER(j, XARGS);
 
-		mm_scatter_epi16(dst_ptr[0] + j, dst_ptr[1] + j, dst_ptr[2] + j, dst_ptr[3] + j, dst_ptr[4] + j, dst_ptr[5] + j, dst_ptr[6] + j, dst_ptr[7] + j, _mm512_castsi512_si128(x));
-		mm_scatter_epi16(dst_ptr[8] + j, dst_ptr[9] + j, dst_ptr[10] + j, dst_ptr[11] + j, dst_ptr[12] + j, dst_ptr[13] + j, dst_ptr[14] + j, dst_ptr[15] + j, _mm512_extracti32x4_epi32(x, 1));
-		mm_scatter_epi16(dst_ptr[16] + j, dst_ptr[17] + j, dst_ptr[18] + j, dst_ptr[19] + j, dst_ptr[20] + j, dst_ptr[21] + j, dst_ptr[22] + j, dst_ptr[23] + j, _mm512_extracti32x4_epi32(x, 2));
-		mm_scatter_epi16(dst_ptr[24] + j, dst_ptr[25] + j, dst_ptr[26] + j, dst_ptr[27] + j, dst_ptr[28] + j, dst_ptr[29] + j, dst_ptr[30] + j, dst_ptr[31] + j, _mm512_extracti32x4_epi32(x, 3));
+		scatter_32_epi16(dst_ptr, j, x);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 32) {
@@ -522,72 +570,79 @@ void resize_line16_h_u16_avx512(const unsigned *filter_left, const int16_t * RES
 		mm512_transpose32_epi16(x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15,
 		                        x16, x17, x18, x19, x20, x21, x22, x23, x24, x25, x26, x27, x28, x29, x30, x31);
 
-		_mm512_store_si512(dst_ptr[0] + j, x0);
-		_mm512_store_si512(dst_ptr[1] + j, x1);
-		_mm512_store_si512(dst_ptr[2] + j, x2);
-		_mm512_store_si512(dst_ptr[3] + j, x3);
-		_mm512_store_si512(dst_ptr[4] + j, x4);
-		_mm512_store_si512(dst_ptr[5] + j, x5);
-		_mm512_store_si512(dst_ptr[6] + j, x6);
-		_mm512_store_si512(dst_ptr[7] + j, x7);
-		_mm512_store_si512(dst_ptr[8] + j, x8);
-		_mm512_store_si512(dst_ptr[9] + j, x9);
-		_mm512_store_si512(dst_ptr[10] + j, x10);
-		_mm512_store_si512(dst_ptr[11] + j, x11);
-		_mm512_store_si512(dst_ptr[12] + j, x12);
-		_mm512_store_si512(dst_ptr[13] + j, x13);
-		_mm512_store_si512(dst_ptr[14] + j, x14);
-		_mm512_store_si512(dst_ptr[15] + j, x15);
-		_mm512_store_si512(dst_ptr[16] + j, x16);
-		_mm512_store_si512(dst_ptr[17] + j, x17);
-		_mm512_store_si512(dst_ptr[18] + j, x18);
-		_mm512_store_si512(dst_ptr[19] + j, x19);
-		_mm512_store_si512(dst_ptr[20] + j, x20);
-		_mm512_store_si512(dst_ptr[21] + j, x21);
-		_mm512_store_si512(dst_ptr[22] + j, x22);
-		_mm512_store_si512(dst_ptr[23] + j, x23);
-		_mm512_store_si512(dst_ptr[24] + j, x24);
-		_mm512_store_si512(dst_ptr[25] + j, x25);
-		_mm512_store_si512(dst_ptr[26] + j, x26);
-		_mm512_store_si512(dst_ptr[27] + j, x27);
-		_mm512_store_si512(dst_ptr[28] + j, x28);
-		_mm512_store_si512(dst_ptr[29] + j, x29);
-		_mm512_store_si512(dst_ptr[30] + j, x30);
-		_mm512_store_si512(dst_ptr[31] + j, x31);
+		store_32_epi16(dst_ptr[0] + j, x0);
+		store_32_epi16(dst_ptr[1] + j, x1);
+		store_32_epi16(dst_ptr[2] + j, x2);
+		store_32_epi16(dst_ptr[3] + j, x3);
+		store_32_epi16(dst_ptr[4] + j, x4);
+		store_32_epi16(dst_ptr[5] + j, x5);
+		store_32_epi16(dst_ptr[6] + j, x6);
+		store_32_epi16(dst_ptr[7] + j, x7);
+		store_32_epi16(dst_ptr[8] + j, x8);
+		store_32_epi16(dst_ptr[9] + j, x9);
+		store_32_epi16(dst_ptr[10] + j, x10);
+		store_32_epi16(dst_ptr[11] + j, x11);
+		store_32_epi16(dst_ptr[12] + j, x12);
+		store_32_epi16(dst_ptr[13] + j, x13);
+		store_32_epi16(dst_ptr[14] + j, x14);
+		store_32_epi16(dst_ptr[15] + j, x15);
+		store_32_epi16(dst_ptr[16] + j, x16);
+		store_32_epi16(dst_ptr[17] + j, x17);
+		store_32_epi16(dst_ptr[18] + j, x18);
+		store_32_epi16(dst_ptr[19] + j, x19);
+		store_32_epi16(dst_ptr[20] + j, x20);
+		store_32_epi16(dst_ptr[21] + j, x21);
+		store_32_epi16(dst_ptr[22] + j, x22);
+		store_32_epi16(dst_ptr[23] + j, x23);
+		store_32_epi16(dst_ptr[24] + j, x24);
+		store_32_epi16(dst_ptr[25] + j, x25);
+		store_32_epi16(dst_ptr[26] + j, x26);
+		store_32_epi16(dst_ptr[27] + j, x27);
+		store_32_epi16(dst_ptr[28] + j, x28);
+		store_32_epi16(dst_ptr[29] + j, x29);
+		store_32_epi16(dst_ptr[30] + j, x30);
+		store_32_epi16(dst_ptr[31] + j, x31);
 	}
 
 	for (unsigned j = vec_right; j < right; ++j) {
 		__m512i x = XITER(j, XARGS);
 
-		mm_scatter_epi16(dst_ptr[0] + j, dst_ptr[1] + j, dst_ptr[2] + j, dst_ptr[3] + j, dst_ptr[4] + j, dst_ptr[5] + j, dst_ptr[6] + j, dst_ptr[7] + j, _mm512_castsi512_si128(x));
-		mm_scatter_epi16(dst_ptr[8] + j, dst_ptr[9] + j, dst_ptr[10] + j, dst_ptr[11] + j, dst_ptr[12] + j, dst_ptr[13] + j, dst_ptr[14] + j, dst_ptr[15] + j, _mm512_extracti32x4_epi32(x, 1));
-		mm_scatter_epi16(dst_ptr[16] + j, dst_ptr[17] + j, dst_ptr[18] + j, dst_ptr[19] + j, dst_ptr[20] + j, dst_ptr[21] + j, dst_ptr[22] + j, dst_ptr[23] + j, _mm512_extracti32x4_epi32(x, 2));
-		mm_scatter_epi16(dst_ptr[24] + j, dst_ptr[25] + j, dst_ptr[26] + j, dst_ptr[27] + j, dst_ptr[28] + j, dst_ptr[29] + j, dst_ptr[30] + j, dst_ptr[31] + j, _mm512_extracti32x4_epi32(x, 3));
+		scatter_32_epi16(dst_ptr, j, x);
 	}
 #undef XITER
 #undef XARGS
 }
 
-const decltype(&resize_line16_h_u16_avx512<false, 0>) resize_line16_h_u16_avx512_jt_small[] = {
-	resize_line16_h_u16_avx512<false, 2>,
-	resize_line16_h_u16_avx512<false, 2>,
-	resize_line16_h_u16_avx512<false, 4>,
-	resize_line16_h_u16_avx512<false, 4>,
-	resize_line16_h_u16_avx512<false, 6>,
-	resize_line16_h_u16_avx512<false, 6>,
-	resize_line16_h_u16_avx512<false, 8>,
-	resize_line16_h_u16_avx512<false, 8>,
+template <class T>
+struct resize_line16_h_u16_avx512_jt {
+	typedef decltype(&resize_line16_h_u16_avx512<T, false, 0>) func_type;
+
+	static const func_type small[8];
+	static const func_type large[8];
+};
+
+template <class T>
+const typename resize_line16_h_u16_avx512_jt<T>::func_type resize_line16_h_u16_avx512_jt<T>::small[8] = {
+	resize_line16_h_u16_avx512<T, false, 2>,
+	resize_line16_h_u16_avx512<T, false, 2>,
+	resize_line16_h_u16_avx512<T, false, 4>,
+	resize_line16_h_u16_avx512<T, false, 4>,
+	resize_line16_h_u16_avx512<T, false, 6>,
+	resize_line16_h_u16_avx512<T, false, 6>,
+	resize_line16_h_u16_avx512<T, false, 8>,
+	resize_line16_h_u16_avx512<T, false, 8>,
 };
 
-const decltype(&resize_line16_h_u16_avx512<false, 0>) resize_line16_h_u16_avx512_jt_large[] = {
-	resize_line16_h_u16_avx512<true, 0>,
-	resize_line16_h_u16_avx512<true, 2>,
-	resize_line16_h_u16_avx512<true, 2>,
-	resize_line16_h_u16_avx512<true, 4>,
-	resize_line16_h_u16_avx512<true, 4>,
-	resize_line16_h_u16_avx512<true, 6>,
-	resize_line16_h_u16_avx512<true, 6>,
-	resize_line16_h_u16_avx512<true, 0>,
+template <class T>
+const typename resize_line16_h_u16_avx512_jt<T>::func_type resize_line16_h_u16_avx512_jt<T>::large[8] = {
+	resize_line16_h_u16_avx512<T, true, 0>,
+	resize_line16_h_u16_avx512<T, true, 2>,
+	resize_line16_h_u16_avx512<T, true, 2>,
+	resize_line16_h_u16_avx512<T, true, 4>,
+	resize_line16_h_u16_avx512<T, true, 4>,
+	resize_line16_h_u16_avx512<T, true, 6>,
+	resize_line16_h_u16_avx512<T, true, 6>,
+	resize_line16_h_u16_avx512<T, true, 0>,
 };
 
 
@@ -1092,10 +1147,10 @@ const typename resize_line_h_perm_fp_avx512_jt<Traits>::func_type resize_line_h_
 };
 
 
-template <unsigned N, bool ReadAccum, bool WriteToAccum>
+template <class T, unsigned N, bool ReadAccum, bool WriteToAccum>
 inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned accum_base,
-                                                           const uint16_t * RESTRICT src_p0, const uint16_t * RESTRICT src_p1, const uint16_t * RESTRICT src_p2, const uint16_t * RESTRICT src_p3,
-                                                           const uint16_t * RESTRICT src_p4, const uint16_t * RESTRICT src_p5, const uint16_t * RESTRICT src_p6, const uint16_t * RESTRICT src_p7,
+                                                           const T * RESTRICT src_p0, const T * RESTRICT src_p1, const T * RESTRICT src_p2, const T * RESTRICT src_p3,
+                                                           const T * RESTRICT src_p4, const T * RESTRICT src_p5, const T * RESTRICT src_p6, const T * RESTRICT src_p7,
                                                            uint32_t *accum_p, const __m512i &c01, const __m512i &c23, const __m512i &c45, const __m512i &c67, uint16_t limit)
 {
 	const __m512i i16_min = _mm512_set1_epi16(INT16_MIN);
@@ -1106,8 +1161,8 @@ inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned
 	__m512i x0, x1, xl, xh;
 
 	if (N >= 0) {
-		x0 = _mm512_load_si512(src_p0 + j);
-		x1 = _mm512_load_si512(src_p1 + j);
+		x0 = load_32_epi16(src_p0 + j);
+		x1 = load_32_epi16(src_p1 + j);
 		x0 = _mm512_add_epi16(x0, i16_min);
 		x1 = _mm512_add_epi16(x1, i16_min);
 
@@ -1125,8 +1180,8 @@ inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned
 		}
 	}
 	if (N >= 2) {
-		x0 = _mm512_load_si512(src_p2 + j);
-		x1 = _mm512_load_si512(src_p3 + j);
+		x0 = load_32_epi16(src_p2 + j);
+		x1 = load_32_epi16(src_p3 + j);
 		x0 = _mm512_add_epi16(x0, i16_min);
 		x1 = _mm512_add_epi16(x1, i16_min);
 
@@ -1139,8 +1194,8 @@ inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned
 		accum_hi = _mm512_add_epi32(accum_hi, xh);
 	}
 	if (N >= 4) {
-		x0 = _mm512_load_si512(src_p4 + j);
-		x1 = _mm512_load_si512(src_p5 + j);
+		x0 = load_32_epi16(src_p4 + j);
+		x1 = load_32_epi16(src_p5 + j);
 		x0 = _mm512_add_epi16(x0, i16_min);
 		x1 = _mm512_add_epi16(x1, i16_min);
 
@@ -1153,8 +1208,8 @@ inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned
 		accum_hi = _mm512_add_epi32(accum_hi, xh);
 	}
 	if (N >= 6) {
-		x0 = _mm512_load_si512(src_p6 + j);
-		x1 = _mm512_load_si512(src_p7 + j);
+		x0 = load_32_epi16(src_p6 + j);
+		x1 = load_32_epi16(src_p7 + j);
 		x0 = _mm512_add_epi16(x0, i16_min);
 		x1 = _mm512_add_epi16(x1, i16_min);
 
@@ -1180,18 +1235,18 @@ inline FORCE_INLINE __m512i resize_line_v_u16_avx512_xiter(unsigned j, unsigned
 	}
 }
 
-template <unsigned N, bool ReadAccum, bool WriteToAccum>
-void resize_line_v_u16_avx512(const int16_t *filter_data, const uint16_t * const *src_lines, uint16_t *dst, uint32_t *accum, unsigned left, unsigned right, uint16_t limit)
+template <class T, unsigned N, bool ReadAccum, bool WriteToAccum>
+void resize_line_v_u16_avx512(const int16_t *filter_data, const T * const *src_lines, T *dst, uint32_t *accum, unsigned left, unsigned right, uint16_t limit)
 {
-	const uint16_t * RESTRICT src_p0 = src_lines[0];
-	const uint16_t * RESTRICT src_p1 = src_lines[1];
-	const uint16_t * RESTRICT src_p2 = src_lines[2];
-	const uint16_t * RESTRICT src_p3 = src_lines[3];
-	const uint16_t * RESTRICT src_p4 = src_lines[4];
-	const uint16_t * RESTRICT src_p5 = src_lines[5];
-	const uint16_t * RESTRICT src_p6 = src_lines[6];
-	const uint16_t * RESTRICT src_p7 = src_lines[7];
-	uint16_t * RESTRICT dst_p = dst;
+	const T * RESTRICT src_p0 = src_lines[0];
+	const T * RESTRICT src_p1 = src_lines[1];
+	const T * RESTRICT src_p2 = src_lines[2];
+	const T * RESTRICT src_p3 = src_lines[3];
+	const T * RESTRICT src_p4 = src_lines[4];
+	const T * RESTRICT src_p5 = src_lines[5];
+	const T * RESTRICT src_p6 = src_lines[6];
+	const T * RESTRICT src_p7 = src_lines[7];
+	T * RESTRICT dst_p = dst;
 	uint32_t * RESTRICT accum_p = accum;
 
 	unsigned vec_left = ceil_n(left, 32);
@@ -1205,52 +1260,62 @@ void resize_line_v_u16_avx512(const int16_t *filter_data, const uint16_t * const
 
 	__m512i out;
 
-#define XITER resize_line_v_u16_avx512_xiter<N, ReadAccum, WriteToAccum>
+#define XITER resize_line_v_u16_avx512_xiter<T, N, ReadAccum, WriteToAccum>
 #define XARGS accum_base, src_p0, src_p1, src_p2, src_p3, src_p4, src_p5, src_p6, src_p7, accum_p, c01, c23, c45, c67, limit
 	if (left != vec_left) {
 		out = XITER(vec_left - 32, XARGS);
 
 		if (!WriteToAccum)
-			_mm512_mask_storeu_epi16(dst + vec_left - 32, mmask32_set_hi(vec_left - left), out);
+			mask_store_32_epi16(dst + vec_left - 32, mmask32_set_hi(vec_left - left), out);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 32) {
 		out = XITER(j, XARGS);
 
 		if (!WriteToAccum)
-			_mm512_store_si512(dst_p + j, out);
+			store_32_epi16(dst_p + j, out);
 	}
 
 	if (right != vec_right) {
 		out = XITER(vec_right, XARGS);
 
 		if (!WriteToAccum)
-			_mm512_mask_storeu_epi16(dst + vec_right, mmask32_set_lo(right - vec_right), out);
+			mask_store_32_epi16(dst + vec_right, mmask32_set_lo(right - vec_right), out);
 	}
 #undef XITER
 #undef XARGS
 }
 
-const decltype(&resize_line_v_u16_avx512<0, false, false>) resize_line_v_u16_avx512_jt_a[] = {
-	resize_line_v_u16_avx512<0, false, false>,
-	resize_line_v_u16_avx512<0, false, false>,
-	resize_line_v_u16_avx512<2, false, false>,
-	resize_line_v_u16_avx512<2, false, false>,
-	resize_line_v_u16_avx512<4, false, false>,
-	resize_line_v_u16_avx512<4, false, false>,
-	resize_line_v_u16_avx512<6, false, false>,
-	resize_line_v_u16_avx512<6, false, false>,
+template <class T>
+struct resize_line_v_u16_avx512_jt {
+	typedef decltype(&resize_line_v_u16_avx512<T, 0, false, false>) func_type;
+
+	static const func_type table_a[8];
+	static const func_type table_b[8];
 };
 
-const decltype(&resize_line_v_u16_avx512<0, false, false>) resize_line_v_u16_avx512_jt_b[] = {
-	resize_line_v_u16_avx512<0, true, false>,
-	resize_line_v_u16_avx512<0, true, false>,
-	resize_line_v_u16_avx512<2, true, false>,
-	resize_line_v_u16_avx512<2, true, false>,
-	resize_line_v_u16_avx512<4, true, false>,
-	resize_line_v_u16_avx512<4, true, false>,
-	resize_line_v_u16_avx512<6, true, false>,
-	resize_line_v_u16_avx512<6, true, false>,
+template <class T>
+const typename resize_line_v_u16_avx512_jt<T>::func_type resize_line_v_u16_avx512_jt<T>::table_a[8] = {
+	resize_line_v_u16_avx512<T, 0, false, false>,
+	resize_line_v_u16_avx512<T, 0, false, false>,
+	resize_line_v_u16_avx512<T, 2, false, false>,
+	resize_line_v_u16_avx512<T, 2, false, false>,
+	resize_line_v_u16_avx512<T, 4, false, false>,
+	resize_line_v_u16_avx512<T, 4, false, false>,
+	resize_line_v_u16_avx512<T, 6, false, false>,
+	resize_line_v_u16_avx512<T, 6, false, false>,
+};
+
+template <class T>
+const typename resize_line_v_u16_avx512_jt<T>::func_type resize_line_v_u16_avx512_jt<T>::table_b[8] = {
+	resize_line_v_u16_avx512<T, 0, true, false>,
+	resize_line_v_u16_avx512<T, 0, true, false>,
+	resize_line_v_u16_avx512<T, 2, true, false>,
+	resize_line_v_u16_avx512<T, 2, true, false>,
+	resize_line_v_u16_avx512<T, 4, true, false>,
+	resize_line_v_u16_avx512<T, 4, true, false>,
+	resize_line_v_u16_avx512<T, 6, true, false>,
+	resize_line_v_u16_avx512<T, 6, true, false>,
 };
 
 
@@ -1407,21 +1472,26 @@ inline FORCE_INLINE void calculate_line_address(void *dst, const void *src, ptrd
 }
 
 
+template <class T>
 class ResizeImplH_U16_AVX512 final : public ResizeImplH {
-	decltype(&resize_line16_h_u16_avx512<false, 0>) m_func;
+	typedef typename resize_line16_h_u16_avx512_jt<T>::func_type func_type;
+
+	func_type m_func;
 	uint16_t m_pixel_max;
 public:
-	ResizeImplH_U16_AVX512(const FilterContext &filter, unsigned height, unsigned depth) :
-		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, PixelType::WORD }),
+	ResizeImplH_U16_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned height, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
 		m_func{},
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
-		if (filter.filter_width > 8)
-			m_func = resize_line16_h_u16_avx512_jt_large[filter.filter_width % 8];
+		if (filter->filter_width > 8)
+			m_func = resize_line16_h_u16_avx512_jt<T>::large[filter->filter_width % 8];
 		else
-			m_func = resize_line16_h_u16_avx512_jt_small[filter.filter_width - 1];
+			m_func = resize_line16_h_u16_avx512_jt<T>::small[filter->filter_width - 1];
 	}
 
+	const char *get_name() const override { return "resize_h_u16_avx512"; }
+
 	unsigned get_simultaneous_lines() const override { return 32; }
 
 	size_t get_tmp_size(unsigned left, unsigned right) const override
@@ -1440,8 +1510,8 @@ public:
 	{
 		auto range = get_required_col_range(left, right);
 
-		alignas(64) const uint16_t *src_ptr[32];
-		alignas(64) uint16_t *dst_ptr[32];
+		alignas(64) const T *src_ptr[32];
+		alignas(64) T *dst_ptr[32];
 		uint16_t *transpose_buf = static_cast<uint16_t *>(tmp);
 		unsigned height = get_image_attributes().height;
 
@@ -1457,7 +1527,7 @@ public:
 		calculate_line_address(dst_ptr + 16, dst->data(), dst->stride(), dst->mask(), i + std::min(16U, height - i - 1), height);
 		calculate_line_address(dst_ptr + 24, dst->data(), dst->stride(), dst->mask(), i + std::min(24U, height - i - 1), height);
 
-		m_func(m_filter.left.data(), m_filter.data_i16.data(), m_filter.stride_i16, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->data_i16.data(), m_filter->stride_i16, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 32), left, right, m_pixel_max);
 	}
 };
@@ -1469,16 +1539,18 @@ class ResizeImplH_FP_AVX512 final : public ResizeImplH {
 
 	func_type m_func;
 public:
-	ResizeImplH_FP_AVX512(const FilterContext &filter, unsigned height) :
-		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, Traits::type_constant }),
+	ResizeImplH_FP_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned height) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, Traits::type_constant }),
 		m_func{}
 	{
-		if (filter.filter_width <= 8)
-			m_func = resize_line16_h_fp_avx512_jt<Traits>::small[filter.filter_width - 1];
+		if (filter->filter_width <= 8)
+			m_func = resize_line16_h_fp_avx512_jt<Traits>::small[filter->filter_width - 1];
 		else
-			m_func = resize_line16_h_fp_avx512_jt<Traits>::large[filter.filter_width % 4];
+			m_func = resize_line16_h_fp_avx512_jt<Traits>::large[filter->filter_width % 4];
 	}
 
+	const char *get_name() const override { return "resize_h_fp_avx512"; }
+
 	unsigned get_simultaneous_lines() const override { return 16; }
 
 	size_t get_tmp_size(unsigned left, unsigned right) const override
@@ -1510,7 +1582,7 @@ public:
 		calculate_line_address(dst_ptr + 0, dst->data(), dst->stride(), dst->mask(), i + 0, height);
 		calculate_line_address(dst_ptr + 8, dst->data(), dst->stride(), dst->mask(), i + std::min(8U, height - i - 1), height);
 
-		m_func(m_filter.left.data(), m_filter.data.data(), m_filter.stride, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 16), left, right);
 	}
 };
@@ -1589,6 +1661,8 @@ public:
 		return ret;
 	}
 
+	const char *get_name() const override { return "resize_h_permute_u16_avx512"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -1696,6 +1770,8 @@ public:
 		return ret;
 	}
 
+	const char *get_name() const override { return "resize_h_permute_fp_avx512"; }
+
 	filter_flags get_flags() const override
 	{
 		filter_flags flags{};
@@ -1733,20 +1809,23 @@ public:
 	}
 };
 
+template <class T>
 class ResizeImplV_U16_AVX512 final : public ResizeImplV {
 	uint16_t m_pixel_max;
 public:
-	ResizeImplV_U16_AVX512(const FilterContext &filter, unsigned width, unsigned depth) :
-		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::WORD }),
+	ResizeImplV_U16_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned width, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{}
 
+	const char *get_name() const override { return "resize_v_u16_avx512"; }
+
 	size_t get_tmp_size(unsigned left, unsigned right) const override
 	{
 		checked_size_t size = 0;
 
 		try {
-			if (m_filter.filter_width > 8)
+			if (m_filter->filter_width > 8)
 				size += (ceil_n(checked_size_t{ right }, 32) - floor_n(left, 32)) * sizeof(uint32_t);
 		} catch (const std::overflow_error &) {
 			error::throw_<error::OutOfMemory>();
@@ -1757,34 +1836,34 @@ public:
 
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
 	{
-		const auto &dst_buf = graph::static_buffer_cast<uint16_t>(*dst);
+		const auto &dst_buf = graph::static_buffer_cast<T>(*dst);
 
-		const int16_t *filter_data = m_filter.data_i16.data() + i * m_filter.stride_i16;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const int16_t *filter_data = m_filter->data_i16.data() + i * m_filter->stride_i16;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
-		alignas(64) const uint16_t *src_lines[8];
-		uint16_t *dst_line = dst_buf[i];
+		alignas(64) const T *src_lines[8];
+		T *dst_line = dst_buf[i];
 		uint32_t *accum_buf = static_cast<uint32_t *>(tmp);
 
-		unsigned top = m_filter.left[i];
+		unsigned top = m_filter->left[i];
 
 		if (filter_width <= 8) {
 			calculate_line_address(src_lines, src->data(), src->stride(), src->mask(), top + 0, src_height);
-			resize_line_v_u16_avx512_jt_a[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx512_jt<T>::table_a[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		} else {
 			unsigned k_end = ceil_n(filter_width, 8) - 8;
 
 			calculate_line_address(src_lines, src->data(), src->stride(), src->mask(), top + 0, src_height);
-			resize_line_v_u16_avx512<6, false, true>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx512<T, 6, false, true>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 
 			for (unsigned k = 8; k < k_end; k += 8) {
 				calculate_line_address(src_lines, src->data(), src->stride(), src->mask(), top + k, src_height);
-				resize_line_v_u16_avx512<6, true, true>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+				resize_line_v_u16_avx512<T, 6, true, true>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 			}
 
 			calculate_line_address(src_lines, src->data(), src->stride(), src->mask(), top + k_end, src_height);
-			resize_line_v_u16_avx512_jt_b[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_avx512_jt<T>::table_b[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		}
 	}
 };
@@ -1793,24 +1872,26 @@ template <class Traits>
 class ResizeImplV_FP_AVX512 final : public ResizeImplV {
 	typedef typename Traits::pixel_type pixel_type;
 public:
-	ResizeImplV_FP_AVX512(const FilterContext &filter, unsigned width) :
-		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, Traits::type_constant })
+	ResizeImplV_FP_AVX512(const std::shared_ptr<const FilterContext> &filter, unsigned width) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, Traits::type_constant })
 	{}
 
+	const char *get_name() const override { return "resize_v_fp_avx512"; }
+
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *, unsigned i, unsigned left, unsigned right) const override
 	{
 		const auto &dst_buf = graph::static_buffer_cast<pixel_type>(*dst);
 
-		const float *filter_data = m_filter.data.data() + i * m_filter.stride;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const float *filter_data = m_filter->data.data() + i * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
 		alignas(64) const pixel_type *src_lines[8];
 		pixel_type *dst_line = dst_buf[i];
 
 		{
 			unsigned taps_remain = std::min(filter_width - 0, 8U);
-			unsigned top = m_filter.left[i] + 0;
+			unsigned top = m_filter->left[i] + 0;
 
 			calculate_line_address(src_lines, src->data(), src->stride(), src->mask(), top, src_height);
 			resize_line_v_fp_avx512_jt<Traits>::table_a[taps_remain - 1](filter_data + 0, src_lines, dst_line, left, right);
@@ -1818,7 +1899,7 @@ public:
 
 		for (unsigned k = 8; k < filter_width; k += 8) {
 			unsigned taps_remain = std::min(filter_width - k, 8U);
-			unsigned top = m_filter.left[i] + k;
+			unsigned top = m_filter->left[i] + k;
 
 			calculate_line_address(src_lines, src->data(), src->stride(), src->mask(), top, src_height);
 			resize_line_v_fp_avx512_jt<Traits>::table_b[taps_remain - 1](filter_data + k, src_lines, dst_line, left, right);
@@ -1829,22 +1910,24 @@ public:
 } // namespace
 
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx512(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx512(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
 #ifndef ZIMG_RESIZE_NO_PERMUTE
 	if (type == PixelType::WORD)
-		ret = ResizeImplH_Permute_U16_AVX512::create(context, height, depth);
+		ret = ResizeImplH_Permute_U16_AVX512::create(*context, height, depth);
 	else if (type == PixelType::HALF)
-		ret = ResizeImplH_Permute_FP_AVX512<f16_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX512<f16_traits>::create(*context, height);
 	else if (type == PixelType::FLOAT)
-		ret = ResizeImplH_Permute_FP_AVX512<f32_traits>::create(context, height);
+		ret = ResizeImplH_Permute_FP_AVX512<f32_traits>::create(*context, height);
 #endif
 
 	if (!ret) {
-		if (type == PixelType::WORD)
-			ret = ztd::make_unique<ResizeImplH_U16_AVX512>(context, height, depth);
+		if (type == PixelType::BYTE)
+			ret = ztd::make_unique<ResizeImplH_U16_AVX512<uint8_t>>(context, height, depth);
+		else if (type == PixelType::WORD)
+			ret = ztd::make_unique<ResizeImplH_U16_AVX512<uint16_t>>(context, height, depth);
 		else if (type == PixelType::HALF)
 			ret = ztd::make_unique<ResizeImplH_FP_AVX512<f16_traits>>(context, height);
 		else if (type == PixelType::FLOAT)
@@ -1854,12 +1937,14 @@ std::unique_ptr<graph::ImageFilter> create_resize_impl_h_avx512(const FilterCont
 	return ret;
 }
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_v_avx512(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_avx512(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
-	if (type == PixelType::WORD)
-		ret = ztd::make_unique<ResizeImplV_U16_AVX512>(context, width, depth);
+	if (type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplV_U16_AVX512<uint8_t>>(context, width, depth);
+	else if (type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplV_U16_AVX512<uint16_t>>(context, width, depth);
 	else if (type == PixelType::HALF)
 		ret = ztd::make_unique<ResizeImplV_FP_AVX512<f16_traits>>(context, width);
 	else if (type == PixelType::FLOAT)
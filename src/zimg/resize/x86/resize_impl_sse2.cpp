@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <stdexcept>
+#include <type_traits>
 #include <emmintrin.h>
 #include "common/align.h"
 #include "common/ccdep.h"
@@ -20,21 +21,92 @@ namespace resize {
 
 namespace {
 
-void transpose_line_8x8_epi16(uint16_t *dst, const uint16_t *src_p0, const uint16_t *src_p1, const uint16_t *src_p2, const uint16_t *src_p3,
-                              const uint16_t *src_p4, const uint16_t *src_p5, const uint16_t *src_p6, const uint16_t *src_p7,
+inline FORCE_INLINE __m128i load_8_epi16(const uint8_t *ptr)
+{
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ptr), _mm_setzero_si128());
+}
+
+inline FORCE_INLINE __m128i load_8_epi16(const uint16_t *ptr)
+{
+	return _mm_load_si128((const __m128i *)ptr);
+}
+
+inline FORCE_INLINE void store_8_epi16(uint8_t *ptr, __m128i x)
+{
+	_mm_storel_epi64((__m128i *)ptr, _mm_packus_epi16(x, x));
+}
+
+inline FORCE_INLINE void store_8_epi16(uint16_t *ptr, __m128i x)
+{
+	_mm_store_si128((__m128i *)ptr, x);
+}
+
+inline FORCE_INLINE void store_idxlo_8_epi16(uint8_t *ptr, __m128i x, unsigned idx)
+{
+	__m128i orig = _mm_loadl_epi64((const __m128i *)ptr);
+	__m128i mask = _mm_load_si128((const __m128i *)(&xmm_mask_table[idx]));
+
+	x = _mm_packus_epi16(x, x);
+	orig = _mm_andnot_si128(mask, orig);
+	x = _mm_and_si128(mask, x);
+	x = _mm_or_si128(x, orig);
+
+	_mm_storel_epi64((__m128i *)ptr, x);
+}
+
+inline FORCE_INLINE void store_idxlo_8_epi16(uint16_t *ptr, __m128i x, unsigned idx)
+{
+	mm_store_idxlo_epi16((__m128i *)ptr, x, idx);
+}
+
+inline FORCE_INLINE void store_idxhi_8_epi16(uint8_t *ptr, __m128i x, unsigned idx)
+{
+	__m128i orig = _mm_loadl_epi64((const __m128i *)ptr);
+	__m128i mask = _mm_load_si128((const __m128i *)(&xmm_mask_table[idx]));
+
+	x = _mm_packus_epi16(x, x);
+	orig = _mm_and_si128(mask, orig);
+	x = _mm_andnot_si128(mask, x);
+	x = _mm_or_si128(x, orig);
+
+	_mm_storel_epi64((__m128i *)ptr, x);
+}
+
+inline FORCE_INLINE void store_idxhi_8_epi16(uint16_t *ptr, __m128i x, unsigned idx)
+{
+	mm_store_idxhi_epi16((__m128i *)ptr, x, idx);
+}
+
+template <class T>
+inline FORCE_INLINE void scatter_8_epi16(T *dst0, T *dst1, T *dst2, T *dst3, T *dst4, T *dst5, T *dst6, T *dst7, __m128i x)
+{
+	*dst0 = static_cast<T>(_mm_extract_epi16(x, 0));
+	*dst1 = static_cast<T>(_mm_extract_epi16(x, 1));
+	*dst2 = static_cast<T>(_mm_extract_epi16(x, 2));
+	*dst3 = static_cast<T>(_mm_extract_epi16(x, 3));
+	*dst4 = static_cast<T>(_mm_extract_epi16(x, 4));
+	*dst5 = static_cast<T>(_mm_extract_epi16(x, 5));
+	*dst6 = static_cast<T>(_mm_extract_epi16(x, 6));
+	*dst7 = static_cast<T>(_mm_extract_epi16(x, 7));
+}
+
+
+template <class T>
+void transpose_line_8x8_epi16(uint16_t *dst, const T *src_p0, const T *src_p1, const T *src_p2, const T *src_p3,
+                              const T *src_p4, const T *src_p5, const T *src_p6, const T *src_p7,
                               unsigned left, unsigned right)
 {
 	for (unsigned j = left; j < right; j += 8) {
 		__m128i x0, x1, x2, x3, x4, x5, x6, x7;
 
-		x0 = _mm_load_si128((const __m128i *)(src_p0 + j));
-		x1 = _mm_load_si128((const __m128i *)(src_p1 + j));
-		x2 = _mm_load_si128((const __m128i *)(src_p2 + j));
-		x3 = _mm_load_si128((const __m128i *)(src_p3 + j));
-		x4 = _mm_load_si128((const __m128i *)(src_p4 + j));
-		x5 = _mm_load_si128((const __m128i *)(src_p5 + j));
-		x6 = _mm_load_si128((const __m128i *)(src_p6 + j));
-		x7 = _mm_load_si128((const __m128i *)(src_p7 + j));
+		x0 = load_8_epi16(src_p0 + j);
+		x1 = load_8_epi16(src_p1 + j);
+		x2 = load_8_epi16(src_p2 + j);
+		x3 = load_8_epi16(src_p3 + j);
+		x4 = load_8_epi16(src_p4 + j);
+		x5 = load_8_epi16(src_p5 + j);
+		x6 = load_8_epi16(src_p6 + j);
+		x7 = load_8_epi16(src_p7 + j);
 
 		mm_transpose8_epi16(x0, x1, x2, x3, x4, x5, x6, x7);
 
@@ -216,27 +288,27 @@ inline FORCE_INLINE __m128i resize_line8_h_u16_sse2_xiter(unsigned j,
 	return accum_lo;
 }
 
-template <bool DoLoop, unsigned Tail>
+template <class T, bool DoLoop, unsigned Tail>
 void resize_line8_h_u16_sse2(const unsigned *filter_left, const int16_t * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
-                             const uint16_t * RESTRICT src_ptr, uint16_t * const *dst_ptr, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
+                             const uint16_t * RESTRICT src_ptr, T * const *dst_ptr, unsigned src_base, unsigned left, unsigned right, uint16_t limit)
 {
 	unsigned vec_left = ceil_n(left, 8);
 	unsigned vec_right = floor_n(right, 8);
 
-	uint16_t * RESTRICT dst_p0 = dst_ptr[0];
-	uint16_t * RESTRICT dst_p1 = dst_ptr[1];
-	uint16_t * RESTRICT dst_p2 = dst_ptr[2];
-	uint16_t * RESTRICT dst_p3 = dst_ptr[3];
-	uint16_t * RESTRICT dst_p4 = dst_ptr[4];
-	uint16_t * RESTRICT dst_p5 = dst_ptr[5];
-	uint16_t * RESTRICT dst_p6 = dst_ptr[6];
-	uint16_t * RESTRICT dst_p7 = dst_ptr[7];
+	T * RESTRICT dst_p0 = dst_ptr[0];
+	T * RESTRICT dst_p1 = dst_ptr[1];
+	T * RESTRICT dst_p2 = dst_ptr[2];
+	T * RESTRICT dst_p3 = dst_ptr[3];
+	T * RESTRICT dst_p4 = dst_ptr[4];
+	T * RESTRICT dst_p5 = dst_ptr[5];
+	T * RESTRICT dst_p6 = dst_ptr[6];
+	T * RESTRICT dst_p7 = dst_ptr[7];
 
 #define XITER resize_line8_h_u16_sse2_xiter<DoLoop, Tail>
 #define XARGS filter_left, filter_data, filter_stride, filter_width, src_ptr, src_base, limit
 	for (unsigned j = left; j < vec_left; ++j) {
 		__m128i x = XITER(j, XARGS);
-		mm_scatter_epi16(dst_p0 + j, dst_p1 + j, dst_p2 + j, dst_p3 + j, dst_p4 + j, dst_p5 + j, dst_p6 + j, dst_p7 + j, x);
+		scatter_8_epi16(dst_p0 + j, dst_p1 + j, dst_p2 + j, dst_p3 + j, dst_p4 + j, dst_p5 + j, dst_p6 + j, dst_p7 + j, x);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 8) {
@@ -253,51 +325,61 @@ void resize_line8_h_u16_sse2(const unsigned *filter_left, const int16_t * RESTRI
 
 		mm_transpose8_epi16(x0, x1, x2, x3, x4, x5, x6, x7);
 
-		_mm_store_si128((__m128i *)(dst_p0 + j), x0);
-		_mm_store_si128((__m128i *)(dst_p1 + j), x1);
-		_mm_store_si128((__m128i *)(dst_p2 + j), x2);
-		_mm_store_si128((__m128i *)(dst_p3 + j), x3);
-		_mm_store_si128((__m128i *)(dst_p4 + j), x4);
-		_mm_store_si128((__m128i *)(dst_p5 + j), x5);
-		_mm_store_si128((__m128i *)(dst_p6 + j), x6);
-		_mm_store_si128((__m128i *)(dst_p7 + j), x7);
+		store_8_epi16(dst_p0 + j, x0);
+		store_8_epi16(dst_p1 + j, x1);
+		store_8_epi16(dst_p2 + j, x2);
+		store_8_epi16(dst_p3 + j, x3);
+		store_8_epi16(dst_p4 + j, x4);
+		store_8_epi16(dst_p5 + j, x5);
+		store_8_epi16(dst_p6 + j, x6);
+		store_8_epi16(dst_p7 + j, x7);
 	}
 
 	for (unsigned j = vec_right; j < right; ++j) {
 		__m128i x = XITER(j, XARGS);
-		mm_scatter_epi16(dst_p0 + j, dst_p1 + j, dst_p2 + j, dst_p3 + j, dst_p4 + j, dst_p5 + j, dst_p6 + j, dst_p7 + j, x);
+		scatter_8_epi16(dst_p0 + j, dst_p1 + j, dst_p2 + j, dst_p3 + j, dst_p4 + j, dst_p5 + j, dst_p6 + j, dst_p7 + j, x);
 	}
 #undef XITER
 #undef XARGS
 }
 
-const decltype(&resize_line8_h_u16_sse2<false, 0>) resize_line8_h_u16_sse2_jt_small[] = {
-	resize_line8_h_u16_sse2<false, 2>,
-	resize_line8_h_u16_sse2<false, 2>,
-	resize_line8_h_u16_sse2<false, 4>,
-	resize_line8_h_u16_sse2<false, 4>,
-	resize_line8_h_u16_sse2<false, 6>,
-	resize_line8_h_u16_sse2<false, 6>,
-	resize_line8_h_u16_sse2<false, 8>,
-	resize_line8_h_u16_sse2<false, 8>
+template <class T>
+struct resize_line8_h_u16_sse2_jt {
+	typedef decltype(&resize_line8_h_u16_sse2<T, false, 0>) func_type;
+
+	static const func_type small[8];
+	static const func_type large[8];
 };
 
-const decltype(&resize_line8_h_u16_sse2<false, 0>) resize_line8_h_u16_sse2_jt_large[] = {
-	resize_line8_h_u16_sse2<true, 0>,
-	resize_line8_h_u16_sse2<true, 2>,
-	resize_line8_h_u16_sse2<true, 2>,
-	resize_line8_h_u16_sse2<true, 4>,
-	resize_line8_h_u16_sse2<true, 4>,
-	resize_line8_h_u16_sse2<true, 6>,
-	resize_line8_h_u16_sse2<true, 6>,
-	resize_line8_h_u16_sse2<true, 0>,
+template <class T>
+const typename resize_line8_h_u16_sse2_jt<T>::func_type resize_line8_h_u16_sse2_jt<T>::small[8] = {
+	resize_line8_h_u16_sse2<T, false, 2>,
+	resize_line8_h_u16_sse2<T, false, 2>,
+	resize_line8_h_u16_sse2<T, false, 4>,
+	resize_line8_h_u16_sse2<T, false, 4>,
+	resize_line8_h_u16_sse2<T, false, 6>,
+	resize_line8_h_u16_sse2<T, false, 6>,
+	resize_line8_h_u16_sse2<T, false, 8>,
+	resize_line8_h_u16_sse2<T, false, 8>
 };
 
+template <class T>
+const typename resize_line8_h_u16_sse2_jt<T>::func_type resize_line8_h_u16_sse2_jt<T>::large[8] = {
+	resize_line8_h_u16_sse2<T, true, 0>,
+	resize_line8_h_u16_sse2<T, true, 2>,
+	resize_line8_h_u16_sse2<T, true, 2>,
+	resize_line8_h_u16_sse2<T, true, 4>,
+	resize_line8_h_u16_sse2<T, true, 4>,
+	resize_line8_h_u16_sse2<T, true, 6>,
+	resize_line8_h_u16_sse2<T, true, 6>,
+	resize_line8_h_u16_sse2<T, true, 0>,
+};
 
-template <unsigned N, bool ReadAccum, bool WriteToAccum>
+
+template <class T, unsigned N, bool ReadAccum, bool WriteToAccum>
 inline FORCE_INLINE __m128i resize_line_v_u16_sse2_xiter(unsigned j, unsigned accum_base,
-                                                         const uint16_t * RESTRICT src_p0, const uint16_t * RESTRICT src_p1, const uint16_t * RESTRICT src_p2, const uint16_t * RESTRICT src_p3,
-                                                         const uint16_t * RESTRICT src_p4, const uint16_t * RESTRICT src_p5, const uint16_t * RESTRICT src_p6, const uint16_t * RESTRICT src_p7,
+                                                         const T * RESTRICT src_p0, const T * RESTRICT src_p1, const T * RESTRICT src_p2, const T * RESTRICT src_p3,
+                                                         const T * RESTRICT src_p4, const T * RESTRICT src_p5, const T * RESTRICT src_p6, const T * RESTRICT src_p7,
                                                          uint32_t *accum_p, const __m128i &c01, const __m128i &c23, const __m128i &c45, const __m128i &c67, uint16_t limit)
 {
 	const __m128i i16_min = _mm_set1_epi16(INT16_MIN);
@@ -308,8 +390,8 @@ inline FORCE_INLINE __m128i resize_line_v_u16_sse2_xiter(unsigned j, unsigned ac
 	__m128i x0, x1, xl, xh;
 
 	if (N >= 0) {
-		x0 = _mm_load_si128((const __m128i *)(src_p0 + j));
-		x1 = _mm_load_si128((const __m128i *)(src_p1 + j));
+		x0 = load_8_epi16(src_p0 + j);
+		x1 = load_8_epi16(src_p1 + j);
 		x0 = _mm_add_epi16(x0, i16_min);
 		x1 = _mm_add_epi16(x1, i16_min);
 
@@ -327,8 +409,8 @@ inline FORCE_INLINE __m128i resize_line_v_u16_sse2_xiter(unsigned j, unsigned ac
 		}
 	}
 	if (N >= 2) {
-		x0 = _mm_load_si128((const __m128i *)(src_p2 + j));
-		x1 = _mm_load_si128((const __m128i *)(src_p3 + j));
+		x0 = load_8_epi16(src_p2 + j);
+		x1 = load_8_epi16(src_p3 + j);
 		x0 = _mm_add_epi16(x0, i16_min);
 		x1 = _mm_add_epi16(x1, i16_min);
 
@@ -341,8 +423,8 @@ inline FORCE_INLINE __m128i resize_line_v_u16_sse2_xiter(unsigned j, unsigned ac
 		accum_hi = _mm_add_epi32(accum_hi, xh);
 	}
 	if (N >= 4) {
-		x0 = _mm_load_si128((const __m128i *)(src_p4 + j));
-		x1 = _mm_load_si128((const __m128i *)(src_p5 + j));
+		x0 = load_8_epi16(src_p4 + j);
+		x1 = load_8_epi16(src_p5 + j);
 		x0 = _mm_add_epi16(x0, i16_min);
 		x1 = _mm_add_epi16(x1, i16_min);
 
@@ -355,8 +437,8 @@ inline FORCE_INLINE __m128i resize_line_v_u16_sse2_xiter(unsigned j, unsigned ac
 		accum_hi = _mm_add_epi32(accum_hi, xh);
 	}
 	if (N >= 6) {
-		x0 = _mm_load_si128((const __m128i *)(src_p6 + j));
-		x1 = _mm_load_si128((const __m128i *)(src_p7 + j));
+		x0 = load_8_epi16(src_p6 + j);
+		x1 = load_8_epi16(src_p7 + j);
 		x0 = _mm_add_epi16(x0, i16_min);
 		x1 = _mm_add_epi16(x1, i16_min);
 
@@ -382,18 +464,18 @@ inline FORCE_INLINE __m128i resize_line_v_u16_sse2_xiter(unsigned j, unsigned ac
 	}
 }
 
-template <unsigned N, bool ReadAccum, bool WriteToAccum>
-void resize_line_v_u16_sse2(const int16_t *filter_data, const uint16_t * const *src_lines, uint16_t *dst, uint32_t *accum, unsigned left, unsigned right, uint16_t limit)
+template <class T, unsigned N, bool ReadAccum, bool WriteToAccum>
+void resize_line_v_u16_sse2(const int16_t *filter_data, const T * const *src_lines, T *dst, uint32_t *accum, unsigned left, unsigned right, uint16_t limit)
 {
-	const uint16_t * RESTRICT src_p0 = src_lines[0];
-	const uint16_t * RESTRICT src_p1 = src_lines[1];
-	const uint16_t * RESTRICT src_p2 = src_lines[2];
-	const uint16_t * RESTRICT src_p3 = src_lines[3];
-	const uint16_t * RESTRICT src_p4 = src_lines[4];
-	const uint16_t * RESTRICT src_p5 = src_lines[5];
-	const uint16_t * RESTRICT src_p6 = src_lines[6];
-	const uint16_t * RESTRICT src_p7 = src_lines[7];
-	uint16_t * RESTRICT dst_p = dst;
+	const T * RESTRICT src_p0 = src_lines[0];
+	const T * RESTRICT src_p1 = src_lines[1];
+	const T * RESTRICT src_p2 = src_lines[2];
+	const T * RESTRICT src_p3 = src_lines[3];
+	const T * RESTRICT src_p4 = src_lines[4];
+	const T * RESTRICT src_p5 = src_lines[5];
+	const T * RESTRICT src_p6 = src_lines[6];
+	const T * RESTRICT src_p7 = src_lines[7];
+	T * RESTRICT dst_p = dst;
 	uint32_t * RESTRICT accum_p = accum;
 
 	unsigned vec_left = ceil_n(left, 8);
@@ -407,70 +489,379 @@ void resize_line_v_u16_sse2(const int16_t *filter_data, const uint16_t * const *
 
 	__m128i out;
 
-#define XITER resize_line_v_u16_sse2_xiter<N, ReadAccum, WriteToAccum>
+#define XITER resize_line_v_u16_sse2_xiter<T, N, ReadAccum, WriteToAccum>
 #define XARGS accum_base, src_p0, src_p1, src_p2, src_p3, src_p4, src_p5, src_p6, src_p7, accum_p, c01, c23, c45, c67, limit
 	if (left != vec_left) {
 		out = XITER(vec_left - 8, XARGS);
 
 		if (!WriteToAccum)
-			mm_store_idxhi_epi16((__m128i *)(dst_p + vec_left - 8), out, left % 8);
+			store_idxhi_8_epi16(dst_p + vec_left - 8, out, left % 8);
 	}
 
 	for (unsigned j = vec_left; j < vec_right; j += 8) {
 		out = XITER(j, XARGS);
 
 		if (!WriteToAccum)
-			_mm_store_si128((__m128i *)(dst_p + j), out);
+			store_8_epi16(dst_p + j, out);
 	}
 
 	if (right != vec_right) {
 		out = XITER(vec_right, XARGS);
 
 		if (!WriteToAccum)
-			mm_store_idxlo_epi16((__m128i *)(dst_p + vec_right), out, right % 8);
+			store_idxlo_8_epi16(dst_p + vec_right, out, right % 8);
 	}
 #undef XITER
 #undef XARGS
 }
 
-const decltype(&resize_line_v_u16_sse2<0, false, false>) resize_line_v_u16_sse2_jt_a[] = {
-	resize_line_v_u16_sse2<0, false, false>,
-	resize_line_v_u16_sse2<0, false, false>,
-	resize_line_v_u16_sse2<2, false, false>,
-	resize_line_v_u16_sse2<2, false, false>,
-	resize_line_v_u16_sse2<4, false, false>,
-	resize_line_v_u16_sse2<4, false, false>,
-	resize_line_v_u16_sse2<6, false, false>,
-	resize_line_v_u16_sse2<6, false, false>,
+template <class T>
+struct resize_line_v_u16_sse2_jt {
+	typedef decltype(&resize_line_v_u16_sse2<T, 0, false, false>) func_type;
+
+	static const func_type table_a[8];
+	static const func_type table_b[8];
+};
+
+template <class T>
+const typename resize_line_v_u16_sse2_jt<T>::func_type resize_line_v_u16_sse2_jt<T>::table_a[8] = {
+	resize_line_v_u16_sse2<T, 0, false, false>,
+	resize_line_v_u16_sse2<T, 0, false, false>,
+	resize_line_v_u16_sse2<T, 2, false, false>,
+	resize_line_v_u16_sse2<T, 2, false, false>,
+	resize_line_v_u16_sse2<T, 4, false, false>,
+	resize_line_v_u16_sse2<T, 4, false, false>,
+	resize_line_v_u16_sse2<T, 6, false, false>,
+	resize_line_v_u16_sse2<T, 6, false, false>,
 };
 
-const decltype(&resize_line_v_u16_sse2<0, false, false>) resize_line_v_u16_sse2_jt_b[] = {
-	resize_line_v_u16_sse2<0, true, false>,
-	resize_line_v_u16_sse2<0, true, false>,
-	resize_line_v_u16_sse2<2, true, false>,
-	resize_line_v_u16_sse2<2, true, false>,
-	resize_line_v_u16_sse2<4, true, false>,
-	resize_line_v_u16_sse2<4, true, false>,
-	resize_line_v_u16_sse2<6, true, false>,
-	resize_line_v_u16_sse2<6, true, false>,
+template <class T>
+const typename resize_line_v_u16_sse2_jt<T>::func_type resize_line_v_u16_sse2_jt<T>::table_b[8] = {
+	resize_line_v_u16_sse2<T, 0, true, false>,
+	resize_line_v_u16_sse2<T, 0, true, false>,
+	resize_line_v_u16_sse2<T, 2, true, false>,
+	resize_line_v_u16_sse2<T, 2, true, false>,
+	resize_line_v_u16_sse2<T, 4, true, false>,
+	resize_line_v_u16_sse2<T, 4, true, false>,
+	resize_line_v_u16_sse2<T, 6, true, false>,
+	resize_line_v_u16_sse2<T, 6, true, false>,
 };
 
 
+inline FORCE_INLINE void store_idxlo_4_f16(uint16_t *ptr, __m128 x, unsigned idx)
+{
+	__m128i orig = _mm_loadl_epi64((const __m128i *)ptr);
+	__m128i mask = _mm_load_si128((const __m128i *)(&xmm_mask_table[idx * 2]));
+	__m128i y = mm_cvtps_ph(x);
+
+	orig = _mm_andnot_si128(mask, orig);
+	y = _mm_and_si128(mask, y);
+	y = _mm_or_si128(y, orig);
+
+	_mm_storel_epi64((__m128i *)ptr, y);
+}
+
+inline FORCE_INLINE void store_idxhi_4_f16(uint16_t *ptr, __m128 x, unsigned idx)
+{
+	__m128i orig = _mm_loadl_epi64((const __m128i *)ptr);
+	__m128i mask = _mm_load_si128((const __m128i *)(&xmm_mask_table[idx * 2]));
+	__m128i y = mm_cvtps_ph(x);
+
+	orig = _mm_and_si128(mask, orig);
+	y = _mm_andnot_si128(mask, y);
+	y = _mm_or_si128(y, orig);
+
+	_mm_storel_epi64((__m128i *)ptr, y);
+}
+
+inline FORCE_INLINE void scatter_4_f16(uint16_t *dst0, uint16_t *dst1, uint16_t *dst2, uint16_t *dst3, __m128 x)
+{
+	__m128i y = mm_cvtps_ph(x);
+
+	*dst0 = static_cast<uint16_t>(_mm_extract_epi16(y, 0));
+	*dst1 = static_cast<uint16_t>(_mm_extract_epi16(y, 1));
+	*dst2 = static_cast<uint16_t>(_mm_extract_epi16(y, 2));
+	*dst3 = static_cast<uint16_t>(_mm_extract_epi16(y, 3));
+}
+
+
+// Half-precision lines are widened to single-precision during transposition,
+// so that each input sample is converted only once per line.
+void transpose_line_4x4_f16(float *dst, const uint16_t *src_p0, const uint16_t *src_p1, const uint16_t *src_p2, const uint16_t *src_p3, unsigned left, unsigned right)
+{
+	for (unsigned j = left; j < right; j += 4) {
+		__m128 x0, x1, x2, x3;
+
+		x0 = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p0 + j)));
+		x1 = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p1 + j)));
+		x2 = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p2 + j)));
+		x3 = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p3 + j)));
+
+		_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+
+		_mm_store_ps(dst + 0, x0);
+		_mm_store_ps(dst + 4, x1);
+		_mm_store_ps(dst + 8, x2);
+		_mm_store_ps(dst + 12, x3);
+
+		dst += 16;
+	}
+}
+
+
+template <unsigned FWidth, unsigned Tail>
+inline FORCE_INLINE __m128 resize_line4_h_f16_sse2_xiter(unsigned j,
+                                                         const unsigned *filter_left, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                                                         const float * RESTRICT src_ptr, unsigned src_base)
+{
+	const float *filter_coeffs = filter_data + j * filter_stride;
+	const float *src_p = src_ptr + (filter_left[j] - src_base) * 4;
+
+	__m128 accum0 = _mm_setzero_ps();
+	__m128 accum1 = _mm_setzero_ps();
+	__m128 x, c, coeffs;
+
+	unsigned k_end = FWidth ? FWidth - Tail : floor_n(filter_width, 4);
+
+	for (unsigned k = 0; k < k_end; k += 4) {
+		coeffs = _mm_load_ps(filter_coeffs + k);
+
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(0, 0, 0, 0));
+		x = _mm_load_ps(src_p + (k + 0) * 4);
+		x = _mm_mul_ps(c, x);
+		accum0 = _mm_add_ps(accum0, x);
+
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(1, 1, 1, 1));
+		x = _mm_load_ps(src_p + (k + 1) * 4);
+		x = _mm_mul_ps(c, x);
+		accum1 = _mm_add_ps(accum1, x);
+
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(2, 2, 2, 2));
+		x = _mm_load_ps(src_p + (k + 2) * 4);
+		x = _mm_mul_ps(c, x);
+		accum0 = _mm_add_ps(accum0, x);
+
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(3, 3, 3, 3));
+		x = _mm_load_ps(src_p + (k + 3) * 4);
+		x = _mm_mul_ps(c, x);
+		accum1 = _mm_add_ps(accum1, x);
+	}
+
+	if (Tail >= 1) {
+		coeffs = _mm_load_ps(filter_coeffs + k_end);
+
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(0, 0, 0, 0));
+		x = _mm_load_ps(src_p + (k_end + 0) * 4);
+		x = _mm_mul_ps(c, x);
+		accum0 = _mm_add_ps(accum0, x);
+	}
+	if (Tail >= 2) {
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(1, 1, 1, 1));
+		x = _mm_load_ps(src_p + (k_end + 1) * 4);
+		x = _mm_mul_ps(c, x);
+		accum1 = _mm_add_ps(accum1, x);
+	}
+	if (Tail >= 3) {
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(2, 2, 2, 2));
+		x = _mm_load_ps(src_p + (k_end + 2) * 4);
+		x = _mm_mul_ps(c, x);
+		accum0 = _mm_add_ps(accum0, x);
+	}
+	if (Tail >= 4) {
+		c = _mm_shuffle_ps(coeffs, coeffs, _MM_SHUFFLE(3, 3, 3, 3));
+		x = _mm_load_ps(src_p + (k_end + 3) * 4);
+		x = _mm_mul_ps(c, x);
+		accum1 = _mm_add_ps(accum1, x);
+	}
+
+	if (!FWidth || FWidth >= 2)
+		accum0 = _mm_add_ps(accum0, accum1);
+
+	return accum0;
+}
+
+template <unsigned FWidth, unsigned Tail>
+void resize_line4_h_f16_sse2(const unsigned *filter_left, const float * RESTRICT filter_data, unsigned filter_stride, unsigned filter_width,
+                             const float * RESTRICT src_ptr, uint16_t * const *dst_ptr, unsigned src_base, unsigned left, unsigned right)
+{
+	unsigned vec_left = ceil_n(left, 4);
+	unsigned vec_right = floor_n(right, 4);
+
+	uint16_t * RESTRICT dst_p0 = dst_ptr[0];
+	uint16_t * RESTRICT dst_p1 = dst_ptr[1];
+	uint16_t * RESTRICT dst_p2 = dst_ptr[2];
+	uint16_t * RESTRICT dst_p3 = dst_ptr[3];
+#define XITER resize_line4_h_f16_sse2_xiter<FWidth, Tail>
+#define XARGS filter_left, filter_data, filter_stride, filter_width, src_ptr, src_base
+	for (unsigned j = left; j < vec_left; ++j) {
+		__m128 x = XITER(j, XARGS);
+		scatter_4_f16(dst_p0 + j, dst_p1 + j, dst_p2 + j, dst_p3 + j, x);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		__m128 x0, x1, x2, x3;
+
+		x0 = XITER(j + 0, XARGS);
+		x1 = XITER(j + 1, XARGS);
+		x2 = XITER(j + 2, XARGS);
+		x3 = XITER(j + 3, XARGS);
+
+		_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+
+		_mm_storel_epi64((__m128i *)(dst_p0 + j), mm_cvtps_ph(x0));
+		_mm_storel_epi64((__m128i *)(dst_p1 + j), mm_cvtps_ph(x1));
+		_mm_storel_epi64((__m128i *)(dst_p2 + j), mm_cvtps_ph(x2));
+		_mm_storel_epi64((__m128i *)(dst_p3 + j), mm_cvtps_ph(x3));
+	}
+
+	for (unsigned j = vec_right; j < right; ++j) {
+		__m128 x = XITER(j, XARGS);
+		scatter_4_f16(dst_p0 + j, dst_p1 + j, dst_p2 + j, dst_p3 + j, x);
+	}
+#undef XITER
+#undef XARGS
+}
+
+const decltype(&resize_line4_h_f16_sse2<0, 0>) resize_line4_h_f16_sse2_jt_small[] = {
+	resize_line4_h_f16_sse2<1, 1>,
+	resize_line4_h_f16_sse2<2, 2>,
+	resize_line4_h_f16_sse2<3, 3>,
+	resize_line4_h_f16_sse2<4, 4>,
+	resize_line4_h_f16_sse2<5, 1>,
+	resize_line4_h_f16_sse2<6, 2>,
+	resize_line4_h_f16_sse2<7, 3>,
+	resize_line4_h_f16_sse2<8, 4>
+};
+
+const decltype(&resize_line4_h_f16_sse2<0, 0>) resize_line4_h_f16_sse2_jt_large[] = {
+	resize_line4_h_f16_sse2<0, 0>,
+	resize_line4_h_f16_sse2<0, 1>,
+	resize_line4_h_f16_sse2<0, 2>,
+	resize_line4_h_f16_sse2<0, 3>
+};
+
+
+template <unsigned N, bool ReadAccum, bool WriteToAccum>
+inline FORCE_INLINE __m128 resize_line_v_f16_sse2_xiter(unsigned j, unsigned accum_base,
+                                                        const uint16_t * RESTRICT src_p0, const uint16_t * RESTRICT src_p1,
+                                                        const uint16_t * RESTRICT src_p2, const uint16_t * RESTRICT src_p3, float * RESTRICT accum_p,
+                                                        const __m128 &c0, const __m128 &c1, const __m128 &c2, const __m128 &c3)
+{
+	__m128 accum0 = _mm_setzero_ps();
+	__m128 accum1 = _mm_setzero_ps();
+	__m128 x;
+
+	if (N >= 0) {
+		x = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p0 + j)));
+		x = _mm_mul_ps(c0, x);
+		accum0 = ReadAccum ? _mm_add_ps(_mm_load_ps(accum_p + j - accum_base), x) : x;
+	}
+	if (N >= 1) {
+		x = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p1 + j)));
+		x = _mm_mul_ps(c1, x);
+		accum1 = x;
+	}
+	if (N >= 2) {
+		x = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p2 + j)));
+		x = _mm_mul_ps(c2, x);
+		accum0 = _mm_add_ps(accum0, x);
+	}
+	if (N >= 3) {
+		x = mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(src_p3 + j)));
+		x = _mm_mul_ps(c3, x);
+		accum1 = _mm_add_ps(accum1, x);
+	}
+
+	accum0 = (N >= 1) ? _mm_add_ps(accum0, accum1) : accum0;
+
+	if (WriteToAccum)
+		_mm_store_ps(accum_p + j - accum_base, accum0);
+
+	return accum0;
+}
+
+template <unsigned N, bool ReadAccum, bool WriteToAccum>
+void resize_line_v_f16_sse2(const float *filter_data, const uint16_t * const *src_lines, uint16_t *dst, float *accum, unsigned left, unsigned right)
+{
+	const uint16_t * RESTRICT src_p0 = src_lines[0];
+	const uint16_t * RESTRICT src_p1 = src_lines[1];
+	const uint16_t * RESTRICT src_p2 = src_lines[2];
+	const uint16_t * RESTRICT src_p3 = src_lines[3];
+	uint16_t * RESTRICT dst_p = dst;
+	float * RESTRICT accum_p = accum;
+
+	unsigned vec_left = ceil_n(left, 4);
+	unsigned vec_right = floor_n(right, 4);
+	unsigned accum_base = floor_n(left, 4);
+
+	const __m128 c0 = _mm_set_ps1(filter_data[0]);
+	const __m128 c1 = _mm_set_ps1(filter_data[1]);
+	const __m128 c2 = _mm_set_ps1(filter_data[2]);
+	const __m128 c3 = _mm_set_ps1(filter_data[3]);
+
+	__m128 out;
+
+#define XITER resize_line_v_f16_sse2_xiter<N, ReadAccum, WriteToAccum>
+#define XARGS accum_base, src_p0, src_p1, src_p2, src_p3, accum_p, c0, c1, c2, c3
+	if (left != vec_left) {
+		out = XITER(vec_left - 4, XARGS);
+
+		if (!WriteToAccum)
+			store_idxhi_4_f16(dst_p + vec_left - 4, out, left % 4);
+	}
+
+	for (unsigned j = vec_left; j < vec_right; j += 4) {
+		out = XITER(j, XARGS);
+
+		if (!WriteToAccum)
+			_mm_storel_epi64((__m128i *)(dst_p + j), mm_cvtps_ph(out));
+	}
+
+	if (right != vec_right) {
+		out = XITER(vec_right, XARGS);
+
+		if (!WriteToAccum)
+			store_idxlo_4_f16(dst_p + vec_right, out, right % 4);
+	}
+#undef XITER
+#undef XARGS
+}
+
+const decltype(&resize_line_v_f16_sse2<0, false, false>) resize_line_v_f16_sse2_jt_a[] = {
+	resize_line_v_f16_sse2<0, false, false>,
+	resize_line_v_f16_sse2<1, false, false>,
+	resize_line_v_f16_sse2<2, false, false>,
+	resize_line_v_f16_sse2<3, false, false>,
+};
+
+const decltype(&resize_line_v_f16_sse2<0, false, false>) resize_line_v_f16_sse2_jt_b[] = {
+	resize_line_v_f16_sse2<0, true, false>,
+	resize_line_v_f16_sse2<1, true, false>,
+	resize_line_v_f16_sse2<2, true, false>,
+	resize_line_v_f16_sse2<3, true, false>,
+};
+
+
+template <class T>
 class ResizeImplH_U16_SSE2 final : public ResizeImplH {
-	decltype(&resize_line8_h_u16_sse2<false, 0>) m_func;
+	typedef typename resize_line8_h_u16_sse2_jt<T>::func_type func_type;
+
+	func_type m_func;
 	uint16_t m_pixel_max;
 public:
-	ResizeImplH_U16_SSE2(const FilterContext &filter, unsigned height, unsigned depth) :
-		ResizeImplH(filter, image_attributes{ filter.filter_rows, height, PixelType::WORD }),
+	ResizeImplH_U16_SSE2(const std::shared_ptr<const FilterContext> &filter, unsigned height, unsigned depth) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
 		m_func{},
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{
-		if (filter.filter_width > 8)
-			m_func = resize_line8_h_u16_sse2_jt_large[filter.filter_width % 8];
+		if (filter->filter_width > 8)
+			m_func = resize_line8_h_u16_sse2_jt<T>::large[filter->filter_width % 8];
 		else
-			m_func = resize_line8_h_u16_sse2_jt_small[filter.filter_width - 1];
+			m_func = resize_line8_h_u16_sse2_jt<T>::small[filter->filter_width - 1];
 	}
 
+	const char *get_name() const override { return "resize_h_u16_sse2"; }
+
 	unsigned get_simultaneous_lines() const override { return 8; }
 
 	size_t get_tmp_size(unsigned left, unsigned right) const override
@@ -487,12 +878,12 @@ public:
 
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
 	{
-		const auto &src_buf = graph::static_buffer_cast<const uint16_t>(*src);
-		const auto &dst_buf = graph::static_buffer_cast<uint16_t>(*dst);
+		const auto &src_buf = graph::static_buffer_cast<const T>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<T>(*dst);
 		auto range = get_required_col_range(left, right);
 
-		const uint16_t *src_ptr[8] = { 0 };
-		uint16_t *dst_ptr[8] = { 0 };
+		const T *src_ptr[8] = { 0 };
+		T *dst_ptr[8] = { 0 };
 		uint16_t *transpose_buf = static_cast<uint16_t *>(tmp);
 		unsigned height = get_image_attributes().height;
 
@@ -507,26 +898,29 @@ public:
 			dst_ptr[n] = dst_buf[std::min(i + n, height - 1)];
 		}
 
-		m_func(m_filter.left.data(), m_filter.data_i16.data(), m_filter.stride_i16, m_filter.filter_width,
+		m_func(m_filter->left.data(), m_filter->data_i16.data(), m_filter->stride_i16, m_filter->filter_width,
 		       transpose_buf, dst_ptr, floor_n(range.first, 8), left, right, m_pixel_max);
 	}
 };
 
 
+template <class T>
 class ResizeImplV_U16_SSE2 final : public ResizeImplV {
 	uint16_t m_pixel_max;
 public:
-	ResizeImplV_U16_SSE2(const FilterContext &filter, unsigned width, unsigned depth) :
-		ResizeImplV(filter, image_attributes{ width, filter.filter_rows, PixelType::WORD }),
+	ResizeImplV_U16_SSE2(const std::shared_ptr<const FilterContext> &filter, unsigned width, unsigned depth) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, std::is_same<T, uint8_t>::value ? PixelType::BYTE : PixelType::WORD }),
 		m_pixel_max{ static_cast<uint16_t>((1UL << depth) - 1) }
 	{}
 
+	const char *get_name() const override { return "resize_v_u16_sse2"; }
+
 	size_t get_tmp_size(unsigned left, unsigned right) const override
 	{
 		checked_size_t size = 0;
 
 		try {
-			if (m_filter.filter_width > 8)
+			if (m_filter->filter_width > 8)
 				size += (ceil_n(checked_size_t{ right }, 8) - floor_n(left, 8)) * sizeof(uint32_t);
 		} catch (const std::overflow_error &) {
 			error::throw_<error::OutOfMemory>();
@@ -537,43 +931,166 @@ public:
 
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
 	{
-		const auto &src_buf = graph::static_buffer_cast<const uint16_t>(*src);
-		const auto &dst_buf = graph::static_buffer_cast<uint16_t>(*dst);
+		const auto &src_buf = graph::static_buffer_cast<const T>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<T>(*dst);
 
-		const int16_t *filter_data = m_filter.data_i16.data() + i * m_filter.stride_i16;
-		unsigned filter_width = m_filter.filter_width;
-		unsigned src_height = m_filter.input_width;
+		const int16_t *filter_data = m_filter->data_i16.data() + i * m_filter->stride_i16;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
 
-		const uint16_t *src_lines[8] = { 0 };
-		uint16_t *dst_line = dst_buf[i];
+		const T *src_lines[8] = { 0 };
+		T *dst_line = dst_buf[i];
 		uint32_t *accum_buf = static_cast<uint32_t *>(tmp);
 
-		unsigned top = m_filter.left[i];
+		unsigned top = m_filter->left[i];
 
 		if (filter_width <= 8) {
 			for (unsigned n = 0; n < 8; ++n) {
 				src_lines[n] = src_buf[std::min(top + n, src_height - 1)];
 			}
-			resize_line_v_u16_sse2_jt_a[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_sse2_jt<T>::table_a[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 		} else {
 			unsigned k_end = ceil_n(filter_width, 8) - 8;
 
 			for (unsigned n = 0; n < 8; ++n) {
 				src_lines[n] = src_buf[std::min(top + 0 + n, src_height - 1)];
 			}
-			resize_line_v_u16_sse2<6, false, true>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_sse2<T, 6, false, true>(filter_data + 0, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 
 			for (unsigned k = 8; k < k_end; k += 8) {
 				for (unsigned n = 0; n < 8; ++n) {
 					src_lines[n] = src_buf[std::min(top + k + n, src_height - 1)];
 				}
-				resize_line_v_u16_sse2<6, true, true>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+				resize_line_v_u16_sse2<T, 6, true, true>(filter_data + k, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
 			}
 
 			for (unsigned n = 0; n < 8; ++n) {
 				src_lines[n] = src_buf[std::min(top + k_end + n, src_height - 1)];
 			}
-			resize_line_v_u16_sse2_jt_b[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+			resize_line_v_u16_sse2_jt<T>::table_b[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right, m_pixel_max);
+		}
+	}
+};
+
+
+class ResizeImplH_F16_SSE2 final : public ResizeImplH {
+	decltype(&resize_line4_h_f16_sse2<0, 0>) m_func;
+public:
+	ResizeImplH_F16_SSE2(const std::shared_ptr<const FilterContext> &filter, unsigned height) :
+		ResizeImplH(filter, image_attributes{ filter->filter_rows, height, PixelType::HALF }),
+		m_func{}
+	{
+		if (filter->filter_width <= 8)
+			m_func = resize_line4_h_f16_sse2_jt_small[filter->filter_width - 1];
+		else
+			m_func = resize_line4_h_f16_sse2_jt_large[filter->filter_width % 4];
+	}
+
+	const char *get_name() const override { return "resize_h_f16_sse2"; }
+
+	unsigned get_simultaneous_lines() const override { return 4; }
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		auto range = get_required_col_range(left, right);
+
+		try {
+			checked_size_t size = (static_cast<checked_size_t>(range.second) - floor_n(range.first, 4) + 4) * sizeof(float) * 4;
+			return size.get();
+		} catch (const std::overflow_error &) {
+			error::throw_<error::OutOfMemory>();
+		}
+	}
+
+	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		const auto &src_buf = graph::static_buffer_cast<const uint16_t>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<uint16_t>(*dst);
+		auto range = get_required_col_range(left, right);
+
+		const uint16_t *src_ptr[4] = { 0 };
+		uint16_t *dst_ptr[4] = { 0 };
+		float *transpose_buf = static_cast<float *>(tmp);
+		unsigned height = get_image_attributes().height;
+
+		for (unsigned n = 0; n < 4; ++n) {
+			src_ptr[n] = src_buf[std::min(i + n, height - 1)];
+		}
+
+		transpose_line_4x4_f16(transpose_buf, src_ptr[0], src_ptr[1], src_ptr[2], src_ptr[3], floor_n(range.first, 4), ceil_n(range.second, 4));
+
+		for (unsigned n = 0; n < 4; ++n) {
+			dst_ptr[n] = dst_buf[std::min(i + n, height - 1)];
+		}
+
+		m_func(m_filter->left.data(), m_filter->data.data(), m_filter->stride, m_filter->filter_width,
+		       transpose_buf, dst_ptr, floor_n(range.first, 4), left, right);
+	}
+};
+
+
+class ResizeImplV_F16_SSE2 final : public ResizeImplV {
+public:
+	ResizeImplV_F16_SSE2(const std::shared_ptr<const FilterContext> &filter, unsigned width) :
+		ResizeImplV(filter, image_attributes{ width, filter->filter_rows, PixelType::HALF })
+	{}
+
+	const char *get_name() const override { return "resize_v_f16_sse2"; }
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override
+	{
+		checked_size_t size = 0;
+
+		try {
+			if (m_filter->filter_width > 4)
+				size += (ceil_n(checked_size_t{ right }, 4) - floor_n(left, 4)) * sizeof(float);
+		} catch (const std::overflow_error &) {
+			error::throw_<error::OutOfMemory>();
+		}
+
+		return size.get();
+	}
+
+	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override
+	{
+		const auto &src_buf = graph::static_buffer_cast<const uint16_t>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<uint16_t>(*dst);
+
+		const float *filter_data = m_filter->data.data() + i * m_filter->stride;
+		unsigned filter_width = m_filter->filter_width;
+		unsigned src_height = m_filter->input_width;
+
+		const uint16_t *src_lines[4] = { 0 };
+		uint16_t *dst_line = dst_buf[i];
+		float *accum_buf = static_cast<float *>(tmp);
+
+		unsigned top = m_filter->left[i];
+
+		// Partial sums are kept in single-precision until the final pass.
+		if (filter_width <= 4) {
+			for (unsigned n = 0; n < 4; ++n) {
+				src_lines[n] = src_buf[std::min(top + n, src_height - 1)];
+			}
+			resize_line_v_f16_sse2_jt_a[filter_width - 1](filter_data, src_lines, dst_line, accum_buf, left, right);
+		} else {
+			unsigned k_end = ceil_n(filter_width, 4) - 4;
+
+			for (unsigned n = 0; n < 4; ++n) {
+				src_lines[n] = src_buf[std::min(top + 0 + n, src_height - 1)];
+			}
+			resize_line_v_f16_sse2<3, false, true>(filter_data + 0, src_lines, dst_line, accum_buf, left, right);
+
+			for (unsigned k = 4; k < k_end; k += 4) {
+				for (unsigned n = 0; n < 4; ++n) {
+					src_lines[n] = src_buf[std::min(top + k + n, src_height - 1)];
+				}
+				resize_line_v_f16_sse2<3, true, true>(filter_data + k, src_lines, dst_line, accum_buf, left, right);
+			}
+
+			for (unsigned n = 0; n < 4; ++n) {
+				src_lines[n] = src_buf[std::min(top + k_end + n, src_height - 1)];
+			}
+			resize_line_v_f16_sse2_jt_b[filter_width - k_end - 1](filter_data + k_end, src_lines, dst_line, accum_buf, left, right);
 		}
 	}
 };
@@ -581,22 +1098,30 @@ public:
 } // namespace
 
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_h_sse2(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_sse2(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
-	if (type == PixelType::WORD)
-		ret = ztd::make_unique<ResizeImplH_U16_SSE2>(context, height, depth);
+	if (type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplH_U16_SSE2<uint8_t>>(context, height, depth);
+	else if (type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplH_U16_SSE2<uint16_t>>(context, height, depth);
+	else if (type == PixelType::HALF)
+		ret = ztd::make_unique<ResizeImplH_F16_SSE2>(context, height);
 
 	return ret;
 }
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_v_sse2(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_sse2(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 {
 	std::unique_ptr<graph::ImageFilter> ret;
 
-	if (type == PixelType::WORD)
-		ret = ztd::make_unique<ResizeImplV_U16_SSE2>(context, width, depth);
+	if (type == PixelType::BYTE)
+		ret = ztd::make_unique<ResizeImplV_U16_SSE2<uint8_t>>(context, width, depth);
+	else if (type == PixelType::WORD)
+		ret = ztd::make_unique<ResizeImplV_U16_SSE2<uint16_t>>(context, width, depth);
+	else if (type == PixelType::HALF)
+		ret = ztd::make_unique<ResizeImplV_F16_SSE2>(context, width);
 
 	return ret;
 }
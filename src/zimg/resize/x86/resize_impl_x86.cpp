@@ -8,7 +8,7 @@
 namespace zimg {
 namespace resize {
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_h_x86(const FilterContext &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu)
 {
 	X86Capabilities caps = query_x86_capabilities();
 	std::unique_ptr<graph::ImageFilter> ret;
@@ -44,7 +44,7 @@ std::unique_ptr<graph::ImageFilter> create_resize_impl_h_x86(const FilterContext
 	return ret;
 }
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_v_x86(const FilterContext &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_x86(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu)
 {
 	X86Capabilities caps = query_x86_capabilities();
 	std::unique_ptr<graph::ImageFilter> ret;
@@ -80,6 +80,56 @@ std::unique_ptr<graph::ImageFilter> create_resize_impl_v_x86(const FilterContext
 	return ret;
 }
 
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_from_int_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType src_type, float scale, float offset, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_resize_impl_h_from_int_avx2(context, height, src_type, scale, offset);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_resize_impl_h_from_int_avx2(context, height, src_type, scale, offset);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_from_int_x86(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType src_type, float scale, float offset, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+		if (!ret && caps.avx2)
+			ret = create_resize_impl_v_from_int_avx2(context, width, src_type, scale, offset);
+	} else {
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_resize_impl_v_from_int_avx2(context, width, src_type, scale, offset);
+	}
+
+	return ret;
+}
+
+bool resize_supports_half_x86(CPUClass cpu) noexcept
+{
+	// HALF resizers exist from SSE2 onwards, converting in software where F16C is absent.
+	if (cpu_is_autodetect(cpu))
+		return !!query_x86_capabilities().sse2;
+	else
+		return cpu >= CPUClass::X86_SSE2;
+}
+
+bool resize_supports_integer_load_x86(CPUClass cpu) noexcept
+{
+	// Only the AVX2 resizers convert integers while loading. AVX-512 hosts use them too.
+	if (cpu_is_autodetect(cpu))
+		return !!query_x86_capabilities().avx2;
+	else
+		return cpu >= CPUClass::X86_AVX2;
+}
+
 } // namespace resize
 } // namespace zimg
 
@@ -24,9 +24,9 @@ namespace resize {
 struct FilterContext;
 
 #define DECLARE_IMPL_H(cpu) \
-std::unique_ptr<graph::ImageFilter> create_resize_impl_h_##cpu(const FilterContext &context, unsigned height, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_##cpu(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth)
 #define DECLARE_IMPL_V(cpu) \
-std::unique_ptr<graph::ImageFilter> create_resize_impl_v_##cpu(const FilterContext &context, unsigned width, PixelType type, unsigned depth)
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_##cpu(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth)
 
 DECLARE_IMPL_H(sse);
 DECLARE_IMPL_H(sse2);
@@ -43,9 +43,21 @@ DECLARE_IMPL_V(avx512);
 #undef DECLARE_IMPL_H
 #undef DECLARE_IMPL_V
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_h_x86(const FilterContext &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_from_int_avx2(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType src_type, float scale, float offset);
 
-std::unique_ptr<graph::ImageFilter> create_resize_impl_v_x86(const FilterContext &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_from_int_avx2(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType src_type, float scale, float offset);
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType type, unsigned depth, CPUClass cpu);
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_x86(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType type, unsigned depth, CPUClass cpu);
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_h_from_int_x86(const std::shared_ptr<const FilterContext> &context, unsigned height, PixelType src_type, float scale, float offset, CPUClass cpu);
+
+std::unique_ptr<graph::ImageFilter> create_resize_impl_v_from_int_x86(const std::shared_ptr<const FilterContext> &context, unsigned width, PixelType src_type, float scale, float offset, CPUClass cpu);
+
+bool resize_supports_half_x86(CPUClass cpu) noexcept;
+
+bool resize_supports_integer_load_x86(CPUClass cpu) noexcept;
 
 } // namespace resize
 } // namespace zimg
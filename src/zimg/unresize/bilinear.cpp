@@ -159,6 +159,21 @@ BilinearContext create_bilinear_context(unsigned in, unsigned out, double shift)
 			ctx.lu_l[i] = static_cast<float>((1.0 / (lu.l[i] + epsilon<float>()))); // Pre-invert this value, as it is used in division.
 			ctx.lu_u[i] = static_cast<float>(lu.u[i]);
 		}
+
+		// The influence of x(i + k) on x(i) is the product of the k preceding
+		// elements of u, which is zero past the last row.
+		size_t decay = 1;
+		for (size_t i = 0; i < rows; ++i) {
+			double prod = 1.0;
+			size_t k = 0;
+
+			while (i + k < rows && prod >= epsilon<float>()) {
+				prod *= std::fabs(lu.u[i + k]);
+				++k;
+			}
+			decay = std::max(decay, k);
+		}
+		ctx.lu_decay = static_cast<unsigned>(decay);
 	} catch (const std::length_error &) {
 		error::throw_<error::OutOfMemory>();
 	}
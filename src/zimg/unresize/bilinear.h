@@ -60,6 +60,14 @@ struct BilinearContext {
 	AlignedVector<float> lu_c;
 	AlignedVector<float> lu_l;
 	AlignedVector<float> lu_u;
+
+	/**
+	 * Number of rows (K) over which the back substitution decays below single
+	 * precision. The product |u(i)| * ... * |u(i + K - 1)| is below epsilon for
+	 * every (i), so the back substitution can be started from zero at row
+	 * (i + K) and still produce x(i) to within rounding.
+	 */
+	unsigned lu_decay;
 };
 
 /**
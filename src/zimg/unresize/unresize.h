@@ -77,6 +77,12 @@
  * dimensions N and M. Execution is done by first computing y' and then
  * performing the tridiagonal algorithm to obtain x.
  *
+ * Since |u(i)| < 1, the influence of x(i + k) on x(i) decays geometrically
+ * with k. In the vertical direction, the back substitution for a block of rows
+ * is started from zero a fixed number of rows below the block, beyond which
+ * the contribution of later rows is below single precision. This allows rows
+ * to be produced from a bounded window of input instead of the entire plane.
+ *
  * Generalization to two dimensions is done by processing each dimension.
  */
 
@@ -1,5 +1,8 @@
 #include <algorithm>
 #include <climits>
+#include <stdexcept>
+#include "common/alloc.h"
+#include "common/checked_int.h"
 #include "common/cpuinfo.h"
 #include "common/except.h"
 #include "common/make_unique.h"
@@ -7,11 +10,18 @@
 #include "common/zassert.h"
 #include "unresize_impl.h"
 
+#ifdef ZIMG_X86
+  #include "x86/unresize_impl_x86.h"
+#endif
+
 namespace zimg {
 namespace unresize {
 
 namespace {
 
+// Number of rows produced by each call to the vertical unresizer.
+constexpr unsigned V_BLOCK_LINES = 16;
+
 void unresize_line_h_f32_c(const BilinearContext &ctx, const float *src, float *dst)
 {
 	const float *c = ctx.lu_c.data();
@@ -66,15 +76,15 @@ void unresize_line_forward_v_f32_c(const BilinearContext &ctx, const graph::Imag
 	}
 }
 
-void unresize_line_back_v_f32_c(const BilinearContext &ctx, const graph::ImageBuffer<float> &dst, unsigned i, unsigned width)
+void unresize_line_back_v_f32_c(const BilinearContext &ctx, const float *src, const float *next, float *dst, unsigned i, unsigned width)
 {
-	const float *u = ctx.lu_u.data();
+	float u = ctx.lu_u[i];
 
 	for (unsigned j = 0; j < width; ++j) {
-		float w = i < ctx.output_width ? dst[i][j] : 0.0f;
+		float w = next ? next[j] : 0.0f;
 
-		w = dst[i - 1][j] - u[i - 1] * w;
-		dst[i - 1][j] = w;
+		w = src[j] - u * w;
+		dst[j] = w;
 	}
 }
 
@@ -91,6 +101,8 @@ public:
 			error::throw_<error::InternalError>("pixel type not supported");
 	}
 
+	const char *get_name() const override { return "unresize_h_c"; }
+
 	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *, unsigned i, unsigned, unsigned) const override
 	{
 		unresize_line_h_f32_c(m_context, static_cast<const float *>((*src)[i]), static_cast<float *>((*dst)[i]));
@@ -109,20 +121,17 @@ public:
 			error::throw_<error::InternalError>("pixel type not supported");
 	}
 
-	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *, unsigned, unsigned, unsigned) const override
-	{
-		const auto &src_buf = graph::static_buffer_cast<const float>(*src);
-		const auto &dst_buf = graph::static_buffer_cast<float>(*dst);
+protected:
+	const char *get_name() const override { return "unresize_v_c"; }
 
-		unsigned width = get_image_attributes().width;
-		unsigned height = get_image_attributes().height;
+	void process_forward(const graph::ImageBuffer<const float> &src, const graph::ImageBuffer<float> &dst, unsigned i) const override
+	{
+		unresize_line_forward_v_f32_c(m_context, src, dst, i, get_image_attributes().width);
+	}
 
-		for (unsigned i = 0; i < height; ++i) {
-			unresize_line_forward_v_f32_c(m_context, src_buf, dst_buf, i, width);
-		}
-		for (unsigned i = height; i != 0; --i) {
-			unresize_line_back_v_f32_c(m_context, dst_buf, i, width);
-		}
+	void process_back(const float *src, const float *next, float *dst, unsigned i) const override
+	{
+		unresize_line_back_v_f32_c(m_context, src, next, dst, i, get_image_attributes().width);
 	}
 };
 
@@ -155,7 +164,7 @@ auto UnresizeImplH::get_required_row_range(unsigned i) const -> pair_unsigned
 
 auto UnresizeImplH::get_required_col_range(unsigned left, unsigned right) const -> pair_unsigned
 {
-	return{ 0, get_image_attributes().width };
+	return{ 0, m_context.input_width };
 }
 
 unsigned UnresizeImplH::get_max_buffering() const
@@ -166,8 +175,34 @@ unsigned UnresizeImplH::get_max_buffering() const
 
 UnresizeImplV::UnresizeImplV(const BilinearContext &context, const image_attributes &attr) :
 	m_context(context),
-	m_attr(attr)
-{}
+	m_attr(attr),
+	m_buffering{}
+{
+	zassert_d(context.lu_decay <= context.output_width, "bad decay");
+
+	for (unsigned i = 0; i < attr.height; i += V_BLOCK_LINES) {
+		auto range = get_required_row_range(i);
+		m_buffering = std::max(m_buffering, range.second - range.first);
+	}
+}
+
+unsigned UnresizeImplV::get_forward_end(unsigned i) const
+{
+	unsigned height = get_image_attributes().height;
+	unsigned last = std::min(i + V_BLOCK_LINES, height);
+	return last + std::min(m_context.lu_decay, height - last);
+}
+
+graph::ImageBuffer<float> UnresizeImplV::get_forward_buffer(void *ctx) const
+{
+	unsigned height = get_image_attributes().height;
+	unsigned lines = V_BLOCK_LINES + m_context.lu_decay;
+	ptrdiff_t stride = ceil_n(get_image_attributes().width * sizeof(float), ALIGNMENT);
+
+	// The forward substitution is stored after the row counter.
+	float *data = reinterpret_cast<float *>(static_cast<unsigned char *>(ctx) + ALIGNMENT);
+	return{ data, stride, lines >= height ? graph::BUFFER_MAX : graph::select_zimg_buffer_mask(lines) };
+}
 
 auto UnresizeImplV::get_flags() const -> filter_flags
 {
@@ -175,16 +210,19 @@ auto UnresizeImplV::get_flags() const -> filter_flags
 
 	flags.has_state = true;
 	flags.entire_row = true;
-	flags.entire_plane = true;
 
 	return flags;
 }
 
 auto UnresizeImplV::get_image_attributes() const -> image_attributes { return m_attr; }
 
-auto UnresizeImplV::get_required_row_range(unsigned) const -> pair_unsigned
+auto UnresizeImplV::get_required_row_range(unsigned i) const -> pair_unsigned
 {
-	return{ 0, m_context.input_width };
+	// Only the rows not yet included in the forward substitution are needed.
+	unsigned end = get_forward_end(i);
+	unsigned first = i >= V_BLOCK_LINES ? std::min(get_forward_end(i - V_BLOCK_LINES), end - 1) : 0;
+
+	return{ m_context.matrix_row_offsets[first], m_context.matrix_row_offsets[end - 1] + m_context.matrix_row_size };
 }
 
 auto UnresizeImplV::get_required_col_range(unsigned, unsigned) const -> pair_unsigned
@@ -192,9 +230,66 @@ auto UnresizeImplV::get_required_col_range(unsigned, unsigned) const -> pair_uns
 	return{ 0, get_image_attributes().width };
 }
 
-unsigned UnresizeImplV::get_simultaneous_lines() const { return graph::BUFFER_MAX; }
+unsigned UnresizeImplV::get_simultaneous_lines() const { return V_BLOCK_LINES; }
+
+unsigned UnresizeImplV::get_max_buffering() const { return m_buffering; }
+
+size_t UnresizeImplV::get_context_size() const
+{
+	unsigned height = get_image_attributes().height;
+	unsigned lines = V_BLOCK_LINES + m_context.lu_decay;
+	lines = lines >= height ? height : graph::select_zimg_buffer_mask(lines) + 1;
+
+	try {
+		checked_size_t size = ceil_n(static_cast<checked_size_t>(get_image_attributes().width) * sizeof(float), ALIGNMENT) * lines;
+		size += ALIGNMENT;
+		return size.get();
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+}
+
+size_t UnresizeImplV::get_tmp_size(unsigned, unsigned) const
+{
+	try {
+		checked_size_t size = ceil_n(static_cast<checked_size_t>(get_image_attributes().width) * sizeof(float), ALIGNMENT);
+		return size.get();
+	} catch (const std::overflow_error &) {
+		error::throw_<error::OutOfMemory>();
+	}
+}
+
+void UnresizeImplV::init_context(void *ctx) const
+{
+	*static_cast<unsigned *>(ctx) = 0;
+}
+
+void UnresizeImplV::process(void *ctx, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned, unsigned) const
+{
+	const auto &src_buf = graph::static_buffer_cast<const float>(*src);
+	const auto &dst_buf = graph::static_buffer_cast<float>(*dst);
+	graph::ImageBuffer<float> forward_buf = get_forward_buffer(ctx);
+
+	unsigned *pos = static_cast<unsigned *>(ctx);
+	unsigned last = std::min(i + V_BLOCK_LINES, get_image_attributes().height);
+	unsigned end = get_forward_end(i);
 
-unsigned UnresizeImplV::get_max_buffering() const { return graph::BUFFER_MAX; }
+	for (; *pos < end; ++*pos) {
+		process_forward(src_buf, forward_buf, *pos);
+	}
+
+	// Rows below the block only serve to converge the back substitution.
+	const float *next = nullptr;
+
+	for (unsigned ii = end; ii != last; --ii) {
+		process_back(forward_buf[ii - 1], next, static_cast<float *>(tmp), ii - 1);
+		next = static_cast<const float *>(tmp);
+	}
+	for (unsigned ii = last; ii != i; --ii) {
+		process_back(forward_buf[ii - 1], next, dst_buf[ii - 1], ii - 1);
+		next = dst_buf[ii - 1];
+	}
+}
 
 
 UnresizeImplBuilder::UnresizeImplBuilder(unsigned up_width, unsigned up_height, PixelType type) :
@@ -214,6 +309,11 @@ std::unique_ptr<graph::ImageFilter> UnresizeImplBuilder::create() const
 	unsigned up_dim = horizontal ? up_width : up_height;
 	BilinearContext context = create_bilinear_context(orig_dim, up_dim, shift);
 
+#ifdef ZIMG_X86
+	ret = horizontal ?
+		create_unresize_impl_h_x86(context, up_height, type, cpu) :
+		create_unresize_impl_v_x86(context, up_width, type, cpu);
+#endif
 	if (!ret && horizontal)
 		ret = ztd::make_unique<UnresizeImplH_C>(context, up_height, type);
 	if (!ret && !horizontal)
@@ -32,12 +32,44 @@ public:
 	unsigned get_max_buffering() const override;
 };
 
+/**
+ * Vertical unresize.
+ *
+ * Rows are produced in blocks. The forward substitution is streamed into a
+ * ring buffer in the filter context, and the back substitution of each block
+ * is started {@link BilinearContext::lu_decay} rows below it, so that only a
+ * bounded window of rows is held instead of the entire plane.
+ */
 class UnresizeImplV : public graph::ImageFilterBase {
 protected:
 	BilinearContext m_context;
 	image_attributes m_attr;
+	unsigned m_buffering;
 
 	UnresizeImplV(const BilinearContext &context, const image_attributes &attr);
+
+	unsigned get_forward_end(unsigned i) const;
+
+	graph::ImageBuffer<float> get_forward_buffer(void *ctx) const;
+
+	/**
+	 * Compute a row of the forward substitution.
+	 *
+	 * @param src upscaled input
+	 * @param dst forward substitution, including the previous row
+	 * @param i row index
+	 */
+	virtual void process_forward(const graph::ImageBuffer<const float> &src, const graph::ImageBuffer<float> &dst, unsigned i) const = 0;
+
+	/**
+	 * Compute a row of the back substitution.
+	 *
+	 * @param src forward substitution at row i
+	 * @param next back substitution at row i + 1, or nullptr if zero
+	 * @param dst back substitution at row i, may alias next
+	 * @param i row index
+	 */
+	virtual void process_back(const float *src, const float *next, float *dst, unsigned i) const = 0;
 public:
 	filter_flags get_flags() const override;
 
@@ -50,6 +82,14 @@ public:
 	unsigned get_simultaneous_lines() const override;
 
 	unsigned get_max_buffering() const override;
+
+	size_t get_context_size() const override;
+
+	size_t get_tmp_size(unsigned left, unsigned right) const override;
+
+	void init_context(void *ctx) const override;
+
+	void process(void *ctx, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned left, unsigned right) const override;
 };
 
 struct UnresizeImplBuilder {
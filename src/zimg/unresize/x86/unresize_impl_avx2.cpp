@@ -0,0 +1,259 @@
+#ifdef ZIMG_X86
+
+#include <algorithm>
+#include <stdexcept>
+#include <immintrin.h>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/checked_int.h"
+#include "common/except.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "common/zassert.h"
+#include "graph/image_filter.h"
+#include "unresize/unresize_impl.h"
+#include "unresize_impl_x86.h"
+
+#include "common/x86/avx_util.h"
+
+namespace zimg {
+namespace unresize {
+
+namespace {
+
+void transpose_line_8x8_ps(float *dst, const float * const src[8], unsigned width)
+{
+	for (unsigned j = 0; j < ceil_n(width, 8); j += 8) {
+		__m256 x0, x1, x2, x3, x4, x5, x6, x7;
+
+		x0 = _mm256_load_ps(src[0] + j);
+		x1 = _mm256_load_ps(src[1] + j);
+		x2 = _mm256_load_ps(src[2] + j);
+		x3 = _mm256_load_ps(src[3] + j);
+		x4 = _mm256_load_ps(src[4] + j);
+		x5 = _mm256_load_ps(src[5] + j);
+		x6 = _mm256_load_ps(src[6] + j);
+		x7 = _mm256_load_ps(src[7] + j);
+
+		mm256_transpose8_ps(x0, x1, x2, x3, x4, x5, x6, x7);
+
+		_mm256_store_ps(dst + (j + 0) * 8, x0);
+		_mm256_store_ps(dst + (j + 1) * 8, x1);
+		_mm256_store_ps(dst + (j + 2) * 8, x2);
+		_mm256_store_ps(dst + (j + 3) * 8, x3);
+		_mm256_store_ps(dst + (j + 4) * 8, x4);
+		_mm256_store_ps(dst + (j + 5) * 8, x5);
+		_mm256_store_ps(dst + (j + 6) * 8, x6);
+		_mm256_store_ps(dst + (j + 7) * 8, x7);
+	}
+}
+
+void scatter_line_8x8_ps(float * const dst[8], const float *src, unsigned width)
+{
+	unsigned vec_end = floor_n(width, 8);
+
+	for (unsigned j = 0; j < ceil_n(width, 8); j += 8) {
+		__m256 x0, x1, x2, x3, x4, x5, x6, x7;
+
+		x0 = _mm256_load_ps(src + (j + 0) * 8);
+		x1 = _mm256_load_ps(src + (j + 1) * 8);
+		x2 = _mm256_load_ps(src + (j + 2) * 8);
+		x3 = _mm256_load_ps(src + (j + 3) * 8);
+		x4 = _mm256_load_ps(src + (j + 4) * 8);
+		x5 = _mm256_load_ps(src + (j + 5) * 8);
+		x6 = _mm256_load_ps(src + (j + 6) * 8);
+		x7 = _mm256_load_ps(src + (j + 7) * 8);
+
+		mm256_transpose8_ps(x0, x1, x2, x3, x4, x5, x6, x7);
+
+		if (j < vec_end) {
+			_mm256_store_ps(dst[0] + j, x0);
+			_mm256_store_ps(dst[1] + j, x1);
+			_mm256_store_ps(dst[2] + j, x2);
+			_mm256_store_ps(dst[3] + j, x3);
+			_mm256_store_ps(dst[4] + j, x4);
+			_mm256_store_ps(dst[5] + j, x5);
+			_mm256_store_ps(dst[6] + j, x6);
+			_mm256_store_ps(dst[7] + j, x7);
+		} else {
+			mm256_store_idxlo_ps(dst[0] + j, x0, width % 8);
+			mm256_store_idxlo_ps(dst[1] + j, x1, width % 8);
+			mm256_store_idxlo_ps(dst[2] + j, x2, width % 8);
+			mm256_store_idxlo_ps(dst[3] + j, x3, width % 8);
+			mm256_store_idxlo_ps(dst[4] + j, x4, width % 8);
+			mm256_store_idxlo_ps(dst[5] + j, x5, width % 8);
+			mm256_store_idxlo_ps(dst[6] + j, x6, width % 8);
+			mm256_store_idxlo_ps(dst[7] + j, x7, width % 8);
+		}
+	}
+}
+
+void unresize_line8_h_f32_avx2(const BilinearContext &ctx, const float *src, float *dst)
+{
+	const float *c = ctx.lu_c.data();
+	const float *l = ctx.lu_l.data();
+	const float *u = ctx.lu_u.data();
+
+	__m256 z = _mm256_setzero_ps();
+	__m256 w = _mm256_setzero_ps();
+
+	for (unsigned j = 0; j < ctx.output_width; ++j) {
+		const float *coeffs = &ctx.matrix_coefficients[j * ctx.matrix_row_stride];
+		const float *src_p = src + static_cast<size_t>(ctx.matrix_row_offsets[j]) * 8;
+		__m256 accum = _mm256_setzero_ps();
+
+		for (unsigned k = 0; k < ctx.matrix_row_size; ++k) {
+			__m256 coeff = _mm256_broadcast_ss(coeffs + k);
+			__m256 x = _mm256_load_ps(src_p + k * 8);
+
+			accum = _mm256_fmadd_ps(coeff, x, accum);
+		}
+
+		z = _mm256_fnmadd_ps(_mm256_broadcast_ss(c + j), z, accum);
+		z = _mm256_mul_ps(z, _mm256_broadcast_ss(l + j));
+		_mm256_store_ps(dst + j * 8, z);
+	}
+
+	for (unsigned j = ctx.output_width; j != 0; --j) {
+		w = _mm256_fnmadd_ps(_mm256_broadcast_ss(u + j - 1), w, _mm256_load_ps(dst + (j - 1) * 8));
+		_mm256_store_ps(dst + (j - 1) * 8, w);
+	}
+}
+
+void unresize_line_forward_v_f32_avx2(const BilinearContext &ctx, const graph::ImageBuffer<const float> &src, const graph::ImageBuffer<float> &dst, unsigned i, unsigned width)
+{
+	const __m256 c = _mm256_broadcast_ss(&ctx.lu_c[i]);
+	const __m256 l = _mm256_broadcast_ss(&ctx.lu_l[i]);
+
+	const float *coeffs = &ctx.matrix_coefficients[i * ctx.matrix_row_stride];
+	unsigned top = ctx.matrix_row_offsets[i];
+
+	const float *prev_p = i ? dst[i - 1] : nullptr;
+	float *dst_p = dst[i];
+
+	for (unsigned j = 0; j < ceil_n(width, 8); j += 8) {
+		__m256 z = prev_p ? _mm256_load_ps(prev_p + j) : _mm256_setzero_ps();
+		__m256 accum = _mm256_setzero_ps();
+
+		for (unsigned k = 0; k < ctx.matrix_row_size; ++k) {
+			__m256 coeff = _mm256_broadcast_ss(coeffs + k);
+			__m256 x = _mm256_load_ps(src[top + k] + j);
+
+			accum = _mm256_fmadd_ps(coeff, x, accum);
+		}
+
+		z = _mm256_fnmadd_ps(c, z, accum);
+		z = _mm256_mul_ps(z, l);
+		_mm256_store_ps(dst_p + j, z);
+	}
+}
+
+void unresize_line_back_v_f32_avx2(const BilinearContext &ctx, const float *src, const float *next, float *dst, unsigned i, unsigned width)
+{
+	const __m256 u = _mm256_broadcast_ss(&ctx.lu_u[i]);
+	unsigned vec_end = floor_n(width, 8);
+
+	for (unsigned j = 0; j < vec_end; j += 8) {
+		__m256 w = next ? _mm256_load_ps(next + j) : _mm256_setzero_ps();
+
+		w = _mm256_fnmadd_ps(u, w, _mm256_load_ps(src + j));
+		_mm256_store_ps(dst + j, w);
+	}
+	if (width != vec_end) {
+		__m256 w = next ? _mm256_load_ps(next + vec_end) : _mm256_setzero_ps();
+
+		w = _mm256_fnmadd_ps(u, w, _mm256_load_ps(src + vec_end));
+		mm256_store_idxlo_ps(dst + vec_end, w, width % 8);
+	}
+}
+
+
+class UnresizeImplH_F32_AVX2 final : public UnresizeImplH {
+public:
+	UnresizeImplH_F32_AVX2(const BilinearContext &context, unsigned height) :
+		UnresizeImplH(context, image_attributes{ context.output_width, height, PixelType::FLOAT })
+	{}
+
+	const char *get_name() const override { return "unresize_h_f32_avx2"; }
+
+	unsigned get_simultaneous_lines() const override { return 8; }
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		try {
+			checked_size_t size = (ceil_n(static_cast<checked_size_t>(m_context.input_width), 8) + ceil_n(static_cast<checked_size_t>(m_context.output_width), 8)) * sizeof(float) * 8;
+			return size.get();
+		} catch (const std::overflow_error &) {
+			error::throw_<error::OutOfMemory>();
+		}
+	}
+
+	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned, unsigned) const override
+	{
+		const auto &src_buf = graph::static_buffer_cast<const float>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<float>(*dst);
+
+		const float *src_ptr[8];
+		float *dst_ptr[8];
+		float *transpose_buf = static_cast<float *>(tmp);
+		float *result_buf = transpose_buf + ceil_n(static_cast<size_t>(m_context.input_width), 8) * 8;
+		unsigned height = get_image_attributes().height;
+
+		for (unsigned n = 0; n < 8; ++n) {
+			src_ptr[n] = src_buf[std::min(i + n, height - 1)];
+			dst_ptr[n] = dst_buf[std::min(i + n, height - 1)];
+		}
+
+		transpose_line_8x8_ps(transpose_buf, src_ptr, m_context.input_width);
+		unresize_line8_h_f32_avx2(m_context, transpose_buf, result_buf);
+		scatter_line_8x8_ps(dst_ptr, result_buf, m_context.output_width);
+	}
+};
+
+class UnresizeImplV_F32_AVX2 final : public UnresizeImplV {
+protected:
+	const char *get_name() const override { return "unresize_v_f32_avx2"; }
+
+	void process_forward(const graph::ImageBuffer<const float> &src, const graph::ImageBuffer<float> &dst, unsigned i) const override
+	{
+		unresize_line_forward_v_f32_avx2(m_context, src, dst, i, get_image_attributes().width);
+	}
+
+	void process_back(const float *src, const float *next, float *dst, unsigned i) const override
+	{
+		unresize_line_back_v_f32_avx2(m_context, src, next, dst, i, get_image_attributes().width);
+	}
+public:
+	UnresizeImplV_F32_AVX2(const BilinearContext &context, unsigned width) :
+		UnresizeImplV(context, image_attributes{ width, context.output_width, PixelType::FLOAT })
+	{}
+};
+
+} // namespace
+
+
+std::unique_ptr<graph::ImageFilter> create_unresize_impl_h_avx2(const BilinearContext &context, unsigned height, PixelType type)
+{
+	zassert_d(context.input_width <= pixel_max_width(type), "overflow");
+	zassert_d(context.output_width <= pixel_max_width(type), "overflow");
+
+	if (type != PixelType::FLOAT)
+		return nullptr;
+
+	return ztd::make_unique<UnresizeImplH_F32_AVX2>(context, height);
+}
+
+std::unique_ptr<graph::ImageFilter> create_unresize_impl_v_avx2(const BilinearContext &context, unsigned width, PixelType type)
+{
+	zassert_d(width <= pixel_max_width(type), "overflow");
+
+	if (type != PixelType::FLOAT)
+		return nullptr;
+
+	return ztd::make_unique<UnresizeImplV_F32_AVX2>(context, width);
+}
+
+} // namespace unresize
+} // namespace zimg
+
+#endif // ZIMG_X86
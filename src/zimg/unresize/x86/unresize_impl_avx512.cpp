@@ -0,0 +1,231 @@
+#include "common/x86/avx512_msvc_compat.h"
+
+#ifdef ZIMG_X86_AVX512
+
+#include <algorithm>
+#include <stdexcept>
+#include <immintrin.h>
+#include "common/align.h"
+#include "common/ccdep.h"
+#include "common/checked_int.h"
+#include "common/except.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "common/zassert.h"
+#include "graph/image_filter.h"
+#include "unresize/unresize_impl.h"
+#include "unresize_impl_x86.h"
+
+#include "common/x86/avx512_util.h"
+
+namespace zimg {
+namespace unresize {
+
+namespace {
+
+void transpose_line_16x16_ps(float *dst, const float * const src[16], unsigned width)
+{
+	for (unsigned j = 0; j < ceil_n(width, 16); j += 16) {
+		__m512 x[16];
+
+		for (unsigned n = 0; n < 16; ++n) {
+			x[n] = _mm512_load_ps(src[n] + j);
+		}
+
+		mm512_transpose16_ps(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8], x[9], x[10], x[11], x[12], x[13], x[14], x[15]);
+
+		for (unsigned n = 0; n < 16; ++n) {
+			_mm512_store_ps(dst + (j + n) * 16, x[n]);
+		}
+	}
+}
+
+void scatter_line_16x16_ps(float * const dst[16], const float *src, unsigned width)
+{
+	unsigned vec_end = floor_n(width, 16);
+
+	for (unsigned j = 0; j < ceil_n(width, 16); j += 16) {
+		__mmask16 mask = j < vec_end ? 0xFFFFU : mmask16_set_lo(width % 16);
+		__m512 x[16];
+
+		for (unsigned n = 0; n < 16; ++n) {
+			x[n] = _mm512_load_ps(src + (j + n) * 16);
+		}
+
+		mm512_transpose16_ps(x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8], x[9], x[10], x[11], x[12], x[13], x[14], x[15]);
+
+		for (unsigned n = 0; n < 16; ++n) {
+			_mm512_mask_store_ps(dst[n] + j, mask, x[n]);
+		}
+	}
+}
+
+void unresize_line16_h_f32_avx512(const BilinearContext &ctx, const float *src, float *dst)
+{
+	const float *c = ctx.lu_c.data();
+	const float *l = ctx.lu_l.data();
+	const float *u = ctx.lu_u.data();
+
+	__m512 z = _mm512_setzero_ps();
+	__m512 w = _mm512_setzero_ps();
+
+	for (unsigned j = 0; j < ctx.output_width; ++j) {
+		const float *coeffs = &ctx.matrix_coefficients[j * ctx.matrix_row_stride];
+		const float *src_p = src + static_cast<size_t>(ctx.matrix_row_offsets[j]) * 16;
+		__m512 accum = _mm512_setzero_ps();
+
+		for (unsigned k = 0; k < ctx.matrix_row_size; ++k) {
+			__m512 coeff = _mm512_set1_ps(coeffs[k]);
+			__m512 x = _mm512_load_ps(src_p + k * 16);
+
+			accum = _mm512_fmadd_ps(coeff, x, accum);
+		}
+
+		z = _mm512_fnmadd_ps(_mm512_set1_ps(c[j]), z, accum);
+		z = _mm512_mul_ps(z, _mm512_set1_ps(l[j]));
+		_mm512_store_ps(dst + j * 16, z);
+	}
+
+	for (unsigned j = ctx.output_width; j != 0; --j) {
+		w = _mm512_fnmadd_ps(_mm512_set1_ps(u[j - 1]), w, _mm512_load_ps(dst + (j - 1) * 16));
+		_mm512_store_ps(dst + (j - 1) * 16, w);
+	}
+}
+
+void unresize_line_forward_v_f32_avx512(const BilinearContext &ctx, const graph::ImageBuffer<const float> &src, const graph::ImageBuffer<float> &dst, unsigned i, unsigned width)
+{
+	const __m512 c = _mm512_set1_ps(ctx.lu_c[i]);
+	const __m512 l = _mm512_set1_ps(ctx.lu_l[i]);
+
+	const float *coeffs = &ctx.matrix_coefficients[i * ctx.matrix_row_stride];
+	unsigned top = ctx.matrix_row_offsets[i];
+
+	const float *prev_p = i ? dst[i - 1] : nullptr;
+	float *dst_p = dst[i];
+
+	for (unsigned j = 0; j < ceil_n(width, 16); j += 16) {
+		__m512 z = prev_p ? _mm512_load_ps(prev_p + j) : _mm512_setzero_ps();
+		__m512 accum = _mm512_setzero_ps();
+
+		for (unsigned k = 0; k < ctx.matrix_row_size; ++k) {
+			__m512 coeff = _mm512_set1_ps(coeffs[k]);
+			__m512 x = _mm512_load_ps(src[top + k] + j);
+
+			accum = _mm512_fmadd_ps(coeff, x, accum);
+		}
+
+		z = _mm512_fnmadd_ps(c, z, accum);
+		z = _mm512_mul_ps(z, l);
+		_mm512_store_ps(dst_p + j, z);
+	}
+}
+
+void unresize_line_back_v_f32_avx512(const BilinearContext &ctx, const float *src, const float *next, float *dst, unsigned i, unsigned width)
+{
+	const __m512 u = _mm512_set1_ps(ctx.lu_u[i]);
+	unsigned vec_end = floor_n(width, 16);
+
+	for (unsigned j = 0; j < vec_end; j += 16) {
+		__m512 w = next ? _mm512_load_ps(next + j) : _mm512_setzero_ps();
+
+		w = _mm512_fnmadd_ps(u, w, _mm512_load_ps(src + j));
+		_mm512_store_ps(dst + j, w);
+	}
+	if (width != vec_end) {
+		__m512 w = next ? _mm512_load_ps(next + vec_end) : _mm512_setzero_ps();
+
+		w = _mm512_fnmadd_ps(u, w, _mm512_load_ps(src + vec_end));
+		_mm512_mask_store_ps(dst + vec_end, mmask16_set_lo(width % 16), w);
+	}
+}
+
+
+class UnresizeImplH_F32_AVX512 final : public UnresizeImplH {
+public:
+	UnresizeImplH_F32_AVX512(const BilinearContext &context, unsigned height) :
+		UnresizeImplH(context, image_attributes{ context.output_width, height, PixelType::FLOAT })
+	{}
+
+	const char *get_name() const override { return "unresize_h_f32_avx512"; }
+
+	unsigned get_simultaneous_lines() const override { return 16; }
+
+	size_t get_tmp_size(unsigned, unsigned) const override
+	{
+		try {
+			checked_size_t size = (ceil_n(static_cast<checked_size_t>(m_context.input_width), 16) + ceil_n(static_cast<checked_size_t>(m_context.output_width), 16)) * sizeof(float) * 16;
+			return size.get();
+		} catch (const std::overflow_error &) {
+			error::throw_<error::OutOfMemory>();
+		}
+	}
+
+	void process(void *, const graph::ImageBuffer<const void> *src, const graph::ImageBuffer<void> *dst, void *tmp, unsigned i, unsigned, unsigned) const override
+	{
+		const auto &src_buf = graph::static_buffer_cast<const float>(*src);
+		const auto &dst_buf = graph::static_buffer_cast<float>(*dst);
+
+		const float *src_ptr[16];
+		float *dst_ptr[16];
+		float *transpose_buf = static_cast<float *>(tmp);
+		float *result_buf = transpose_buf + ceil_n(static_cast<size_t>(m_context.input_width), 16) * 16;
+		unsigned height = get_image_attributes().height;
+
+		for (unsigned n = 0; n < 16; ++n) {
+			src_ptr[n] = src_buf[std::min(i + n, height - 1)];
+			dst_ptr[n] = dst_buf[std::min(i + n, height - 1)];
+		}
+
+		transpose_line_16x16_ps(transpose_buf, src_ptr, m_context.input_width);
+		unresize_line16_h_f32_avx512(m_context, transpose_buf, result_buf);
+		scatter_line_16x16_ps(dst_ptr, result_buf, m_context.output_width);
+	}
+};
+
+class UnresizeImplV_F32_AVX512 final : public UnresizeImplV {
+protected:
+	const char *get_name() const override { return "unresize_v_f32_avx512"; }
+
+	void process_forward(const graph::ImageBuffer<const float> &src, const graph::ImageBuffer<float> &dst, unsigned i) const override
+	{
+		unresize_line_forward_v_f32_avx512(m_context, src, dst, i, get_image_attributes().width);
+	}
+
+	void process_back(const float *src, const float *next, float *dst, unsigned i) const override
+	{
+		unresize_line_back_v_f32_avx512(m_context, src, next, dst, i, get_image_attributes().width);
+	}
+public:
+	UnresizeImplV_F32_AVX512(const BilinearContext &context, unsigned width) :
+		UnresizeImplV(context, image_attributes{ width, context.output_width, PixelType::FLOAT })
+	{}
+};
+
+} // namespace
+
+
+std::unique_ptr<graph::ImageFilter> create_unresize_impl_h_avx512(const BilinearContext &context, unsigned height, PixelType type)
+{
+	zassert_d(context.input_width <= pixel_max_width(type), "overflow");
+	zassert_d(context.output_width <= pixel_max_width(type), "overflow");
+
+	if (type != PixelType::FLOAT)
+		return nullptr;
+
+	return ztd::make_unique<UnresizeImplH_F32_AVX512>(context, height);
+}
+
+std::unique_ptr<graph::ImageFilter> create_unresize_impl_v_avx512(const BilinearContext &context, unsigned width, PixelType type)
+{
+	zassert_d(width <= pixel_max_width(type), "overflow");
+
+	if (type != PixelType::FLOAT)
+		return nullptr;
+
+	return ztd::make_unique<UnresizeImplV_F32_AVX512>(context, width);
+}
+
+} // namespace unresize
+} // namespace zimg
+
+#endif // ZIMG_X86_AVX512
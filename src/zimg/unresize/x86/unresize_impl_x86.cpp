@@ -0,0 +1,62 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/image_filter.h"
+#include "unresize_impl_x86.h"
+
+namespace zimg {
+namespace unresize {
+
+std::unique_ptr<graph::ImageFilter> create_unresize_impl_h_x86(const BilinearContext &context, unsigned height, PixelType type, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f && caps.avx512dq && caps.avx512bw && caps.avx512vl)
+			ret = create_unresize_impl_h_avx512(context, height, type);
+#endif
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_unresize_impl_h_avx2(context, height, type);
+	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_unresize_impl_h_avx512(context, height, type);
+#endif
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_unresize_impl_h_avx2(context, height, type);
+	}
+
+	return ret;
+}
+
+std::unique_ptr<graph::ImageFilter> create_unresize_impl_v_x86(const BilinearContext &context, unsigned width, PixelType type, CPUClass cpu)
+{
+	X86Capabilities caps = query_x86_capabilities();
+	std::unique_ptr<graph::ImageFilter> ret;
+
+	if (cpu_is_autodetect(cpu)) {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu == CPUClass::AUTO_64B && caps.avx512f && caps.avx512dq && caps.avx512bw && caps.avx512vl)
+			ret = create_unresize_impl_v_avx512(context, width, type);
+#endif
+		if (!ret && caps.avx2 && caps.fma)
+			ret = create_unresize_impl_v_avx2(context, width, type);
+	} else {
+#ifdef ZIMG_X86_AVX512
+		if (!ret && cpu >= CPUClass::X86_AVX512)
+			ret = create_unresize_impl_v_avx512(context, width, type);
+#endif
+		if (!ret && cpu >= CPUClass::X86_AVX2)
+			ret = create_unresize_impl_v_avx2(context, width, type);
+	}
+
+	return ret;
+}
+
+} // namespace unresize
+} // namespace zimg
+
+#endif // ZIMG_X86
@@ -1,7 +1,10 @@
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <random>
 #include "api/zimg.h"
+#include "common/alloc.h"
 
 #include "gtest/gtest.h"
 
@@ -54,3 +57,427 @@ TEST(APITest, test_api_2_1_compat)
 		EXPECT_EQ(0xCC, *(reinterpret_cast<unsigned char *>(&params) + i));
 	}
 }
+
+TEST(APITest, test_graph_cache)
+{
+	zimg_image_format src_format;
+	zimg_image_format dst_format;
+	zimg_image_format_default(&src_format, ZIMG_API_VERSION);
+	zimg_image_format_default(&dst_format, ZIMG_API_VERSION);
+
+	src_format.width = 640;
+	src_format.height = 480;
+	src_format.pixel_type = ZIMG_PIXEL_BYTE;
+
+	dst_format.width = 320;
+	dst_format.height = 240;
+	dst_format.pixel_type = ZIMG_PIXEL_BYTE;
+
+	zimg_graph_builder_params params;
+	zimg_graph_builder_params_default(&params, ZIMG_API_VERSION);
+
+	zimg_graph_cache *cache = zimg_graph_cache_create(2);
+	ASSERT_TRUE(cache);
+
+	zimg_filter_graph *graph1 = zimg_graph_cache_get(cache, &src_format, &dst_format, &params);
+	zimg_filter_graph *graph2 = zimg_graph_cache_get(cache, &src_format, &dst_format, &params);
+	EXPECT_TRUE(graph1);
+	EXPECT_TRUE(graph2);
+	EXPECT_NE(graph1, graph2);
+
+	// Parameters are part of the key.
+	params.resample_filter = ZIMG_RESIZE_LANCZOS;
+	zimg_filter_graph *graph3 = zimg_graph_cache_get(cache, &src_format, &dst_format, &params);
+	EXPECT_TRUE(graph3);
+
+	unsigned long long hits = 0;
+	unsigned long long misses = 0;
+	size_t entries = 0;
+	EXPECT_EQ(ZIMG_ERROR_SUCCESS, zimg_graph_cache_get_stats(cache, &hits, &misses, &entries));
+	EXPECT_EQ(1U, hits);
+	EXPECT_EQ(2U, misses);
+	EXPECT_EQ(2U, entries);
+
+	// Least recently used graphs are evicted.
+	dst_format.width = 160;
+	zimg_filter_graph *graph4 = zimg_graph_cache_get(cache, &src_format, &dst_format, &params);
+	EXPECT_TRUE(graph4);
+	EXPECT_EQ(ZIMG_ERROR_SUCCESS, zimg_graph_cache_get_stats(cache, &hits, &misses, &entries));
+	EXPECT_EQ(3U, misses);
+	EXPECT_EQ(2U, entries);
+
+	// Graphs outlive the cache.
+	zimg_graph_cache_free(cache);
+
+	size_t tmp_size1 = 0;
+	size_t tmp_size2 = 0;
+	EXPECT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size(graph1, &tmp_size1));
+	EXPECT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size(graph2, &tmp_size2));
+	EXPECT_EQ(tmp_size1, tmp_size2);
+
+	zimg_filter_graph_free(graph1);
+	zimg_filter_graph_free(graph2);
+	zimg_filter_graph_free(graph3);
+	zimg_filter_graph_free(graph4);
+}
+
+TEST(APITest, test_packed_rgb)
+{
+	const unsigned src_w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_w = 320;
+	const unsigned dst_h = 240;
+
+	zimg_image_format src_format;
+	zimg_image_format dst_format;
+	zimg_image_format_default(&src_format, ZIMG_API_VERSION);
+	zimg_image_format_default(&dst_format, ZIMG_API_VERSION);
+	EXPECT_EQ(ZIMG_PACKING_PLANAR, src_format.pixel_packing);
+
+	src_format.width = src_w;
+	src_format.height = src_h;
+	src_format.pixel_type = ZIMG_PIXEL_BYTE;
+	src_format.color_family = ZIMG_COLOR_RGB;
+	src_format.pixel_range = ZIMG_RANGE_FULL;
+
+	dst_format = src_format;
+	dst_format.width = dst_w;
+	dst_format.height = dst_h;
+
+	zimg::AlignedVector<uint8_t> planar_src[3];
+	zimg::AlignedVector<uint8_t> planar_dst[3];
+	zimg::AlignedVector<uint8_t> packed_src(src_w * src_h * 4);
+	zimg::AlignedVector<uint8_t> packed_dst(dst_w * dst_h * 3);
+	std::mt19937 engine;
+
+	zimg_image_buffer_const src_buf{ ZIMG_API_VERSION };
+	zimg_image_buffer dst_buf{ ZIMG_API_VERSION };
+
+	for (unsigned p = 0; p < 3; ++p) {
+		planar_src[p].resize(src_w * src_h);
+		planar_dst[p].resize(dst_w * dst_h);
+
+		for (uint8_t &x : planar_src[p]) {
+			x = static_cast<uint8_t>(engine());
+		}
+
+		src_buf.plane[p] = { planar_src[p].data(), src_w, ZIMG_BUFFER_MAX };
+		dst_buf.plane[p] = { planar_dst[p].data(), dst_w, ZIMG_BUFFER_MAX };
+	}
+
+	// BGRA input, with garbage in the alpha channel.
+	for (unsigned i = 0; i < src_w * src_h; ++i) {
+		packed_src[i * 4 + 0] = planar_src[2][i];
+		packed_src[i * 4 + 1] = planar_src[1][i];
+		packed_src[i * 4 + 2] = planar_src[0][i];
+		packed_src[i * 4 + 3] = static_cast<uint8_t>(engine());
+	}
+
+	zimg_filter_graph *planar_graph = zimg_filter_graph_build(&src_format, &dst_format, nullptr);
+	ASSERT_TRUE(planar_graph);
+
+	size_t tmp_size = 0;
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size(planar_graph, &tmp_size));
+	zimg::AlignedVector<uint8_t> tmp(tmp_size);
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_process(planar_graph, &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr));
+	zimg_filter_graph_free(planar_graph);
+
+	src_format.pixel_packing = ZIMG_PACKING_BGRA;
+	dst_format.pixel_packing = ZIMG_PACKING_RGB;
+
+	zimg_filter_graph *packed_graph = zimg_filter_graph_build(&src_format, &dst_format, nullptr);
+	ASSERT_TRUE(packed_graph);
+
+	// Only the first plane is accessed.
+	src_buf = zimg_image_buffer_const{ ZIMG_API_VERSION };
+	dst_buf = zimg_image_buffer{ ZIMG_API_VERSION };
+	src_buf.plane[0] = { packed_src.data(), src_w * 4, ZIMG_BUFFER_MAX };
+	dst_buf.plane[0] = { packed_dst.data(), dst_w * 3, ZIMG_BUFFER_MAX };
+
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size_mt(packed_graph, 4, &tmp_size));
+	tmp.resize(tmp_size);
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_process_mt(packed_graph, &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr, 4));
+	zimg_filter_graph_free(packed_graph);
+
+	for (unsigned i = 0; i < dst_w * dst_h; ++i) {
+		ASSERT_EQ(planar_dst[0][i], packed_dst[i * 3 + 0]) << i;
+		ASSERT_EQ(planar_dst[1][i], packed_dst[i * 3 + 1]) << i;
+		ASSERT_EQ(planar_dst[2][i], packed_dst[i * 3 + 2]) << i;
+	}
+
+	// Packed formats are limited to RGB.
+	src_format.color_family = ZIMG_COLOR_YUV;
+	EXPECT_FALSE(zimg_filter_graph_build(&src_format, &dst_format, nullptr));
+	EXPECT_EQ(ZIMG_ERROR_COLOR_FAMILY_MISMATCH, zimg_get_last_error(nullptr, 0));
+	zimg_clear_last_error();
+}
+
+TEST(APITest, test_semi_planar)
+{
+	const unsigned src_w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_w = 320;
+	const unsigned dst_h = 240;
+	const unsigned src_plane_w[3] = { src_w, src_w / 2, src_w / 2 };
+	const unsigned src_plane_h[3] = { src_h, src_h / 2, src_h / 2 };
+	const unsigned dst_plane_w[3] = { dst_w, dst_w / 2, dst_w / 2 };
+	const unsigned dst_plane_h[3] = { dst_h, dst_h / 2, dst_h / 2 };
+
+	zimg_image_format src_format;
+	zimg_image_format dst_format;
+	zimg_image_format_default(&src_format, ZIMG_API_VERSION);
+	zimg_image_format_default(&dst_format, ZIMG_API_VERSION);
+
+	// P016: 16-bit 4:2:0 with interleaved chroma.
+	src_format.width = src_w;
+	src_format.height = src_h;
+	src_format.pixel_type = ZIMG_PIXEL_WORD;
+	src_format.subsample_w = 1;
+	src_format.subsample_h = 1;
+	src_format.color_family = ZIMG_COLOR_YUV;
+	src_format.matrix_coefficients = ZIMG_MATRIX_709;
+
+	dst_format = src_format;
+	dst_format.width = dst_w;
+	dst_format.height = dst_h;
+
+	zimg::AlignedVector<uint16_t> planar_src[3];
+	zimg::AlignedVector<uint16_t> planar_dst[3];
+	zimg::AlignedVector<uint16_t> chroma_src(src_w * src_h / 2);
+	zimg::AlignedVector<uint16_t> chroma_dst(dst_w * dst_h / 2);
+	std::mt19937 engine;
+
+	zimg_image_buffer_const src_buf{ ZIMG_API_VERSION };
+	zimg_image_buffer dst_buf{ ZIMG_API_VERSION };
+
+	for (unsigned p = 0; p < 3; ++p) {
+		planar_src[p].resize(src_plane_w[p] * src_plane_h[p]);
+		planar_dst[p].resize(dst_plane_w[p] * dst_plane_h[p]);
+
+		for (uint16_t &x : planar_src[p]) {
+			x = static_cast<uint16_t>(engine());
+		}
+
+		src_buf.plane[p] = { planar_src[p].data(), static_cast<ptrdiff_t>(src_plane_w[p] * sizeof(uint16_t)), ZIMG_BUFFER_MAX };
+		dst_buf.plane[p] = { planar_dst[p].data(), static_cast<ptrdiff_t>(dst_plane_w[p] * sizeof(uint16_t)), ZIMG_BUFFER_MAX };
+	}
+
+	for (size_t i = 0; i < planar_src[1].size(); ++i) {
+		chroma_src[i * 2 + 0] = planar_src[1][i];
+		chroma_src[i * 2 + 1] = planar_src[2][i];
+	}
+
+	zimg_filter_graph *planar_graph = zimg_filter_graph_build(&src_format, &dst_format, nullptr);
+	ASSERT_TRUE(planar_graph);
+
+	size_t tmp_size = 0;
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size(planar_graph, &tmp_size));
+	zimg::AlignedVector<uint8_t> tmp(tmp_size);
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_process(planar_graph, &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr));
+	zimg_filter_graph_free(planar_graph);
+
+	src_format.pixel_packing = ZIMG_PACKING_NV12;
+	dst_format.pixel_packing = ZIMG_PACKING_NV12;
+
+	zimg_filter_graph *semi_planar_graph = zimg_filter_graph_build(&src_format, &dst_format, nullptr);
+	ASSERT_TRUE(semi_planar_graph);
+
+	// The third plane is not accessed.
+	src_buf.plane[1] = { chroma_src.data(), src_w * sizeof(uint16_t), ZIMG_BUFFER_MAX };
+	src_buf.plane[2] = {};
+	dst_buf.plane[1] = { chroma_dst.data(), dst_w * sizeof(uint16_t), ZIMG_BUFFER_MAX };
+	dst_buf.plane[2] = {};
+
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size_mt(semi_planar_graph, 4, &tmp_size));
+	tmp.resize(tmp_size);
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_process_mt(semi_planar_graph, &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr, 4));
+	zimg_filter_graph_free(semi_planar_graph);
+
+	for (size_t i = 0; i < planar_dst[1].size(); ++i) {
+		ASSERT_EQ(planar_dst[1][i], chroma_dst[i * 2 + 0]) << i;
+		ASSERT_EQ(planar_dst[2][i], chroma_dst[i * 2 + 1]) << i;
+	}
+
+	// Semi-planar formats are limited to YUV.
+	src_format.color_family = ZIMG_COLOR_RGB;
+	src_format.matrix_coefficients = ZIMG_MATRIX_RGB;
+	src_format.subsample_w = 0;
+	src_format.subsample_h = 0;
+	EXPECT_FALSE(zimg_filter_graph_build(&src_format, &dst_format, nullptr));
+	EXPECT_EQ(ZIMG_ERROR_COLOR_FAMILY_MISMATCH, zimg_get_last_error(nullptr, 0));
+	zimg_clear_last_error();
+}
+
+namespace {
+
+// Position of a sample within the first plane of a packed YUV row, in units
+// of the sample for YUY2 and Y410, or in 10-bit fields for v210.
+size_t packed_yuv_position(zimg_pixel_packing_e packing, unsigned p, unsigned j)
+{
+	switch (packing) {
+	case ZIMG_PACKING_YUY2:
+		return p ? j * 4 + p * 2 - 1 : j * 2;
+	case ZIMG_PACKING_V210:
+		return p ? j / 3 * 12 + j % 3 * 4 + (p - 1) * 2 : j / 6 * 12 + j % 6 * 2 + 1;
+	default:
+		return static_cast<size_t>(j) * 3 + (p == 0 ? 1 : p == 1 ? 0 : 2);
+	}
+}
+
+uint16_t read_packed_yuv(zimg_pixel_packing_e packing, const void *row, unsigned p, unsigned j)
+{
+	size_t pos = packed_yuv_position(packing, p, j);
+
+	if (packing == ZIMG_PACKING_YUY2)
+		return static_cast<const uint16_t *>(row)[pos];
+	else
+		return (static_cast<const uint32_t *>(row)[pos / 3] >> (pos % 3 * 10)) & 0x3FF;
+}
+
+void write_packed_yuv(zimg_pixel_packing_e packing, void *row, unsigned p, unsigned j, uint16_t x)
+{
+	size_t pos = packed_yuv_position(packing, p, j);
+
+	if (packing == ZIMG_PACKING_YUY2)
+		static_cast<uint16_t *>(row)[pos] = x;
+	else
+		static_cast<uint32_t *>(row)[pos / 3] |= static_cast<uint32_t>(x) << (pos % 3 * 10);
+}
+
+void test_packed_yuv(zimg_pixel_packing_e packing, unsigned subsample_w, unsigned depth)
+{
+	// The packed rows of v210 end with partial groups.
+	const unsigned src_w = 1024;
+	const unsigned src_h = 60;
+	const unsigned dst_w = 512;
+	const unsigned dst_h = 60;
+	const unsigned src_plane_w[3] = { src_w, src_w >> subsample_w, src_w >> subsample_w };
+	const unsigned dst_plane_w[3] = { dst_w, dst_w >> subsample_w, dst_w >> subsample_w };
+
+	auto packed_stride = [=](unsigned w)
+	{
+		size_t row_size = packing == ZIMG_PACKING_V210 ? (w + 5) / 6 * 16 : static_cast<size_t>(w) * 4;
+		return (row_size + 63) / 64 * 64;
+	};
+
+	zimg_image_format src_format;
+	zimg_image_format dst_format;
+	zimg_image_format_default(&src_format, ZIMG_API_VERSION);
+	zimg_image_format_default(&dst_format, ZIMG_API_VERSION);
+
+	src_format.width = src_w;
+	src_format.height = src_h;
+	src_format.pixel_type = ZIMG_PIXEL_WORD;
+	src_format.subsample_w = subsample_w;
+	src_format.color_family = ZIMG_COLOR_YUV;
+	src_format.matrix_coefficients = ZIMG_MATRIX_709;
+	src_format.depth = depth;
+
+	dst_format = src_format;
+	dst_format.width = dst_w;
+	dst_format.height = dst_h;
+
+	zimg::AlignedVector<uint16_t> planar_src[3];
+	zimg::AlignedVector<uint16_t> planar_dst[3];
+	zimg::AlignedVector<uint8_t> packed_src(packed_stride(src_w) * src_h);
+	zimg::AlignedVector<uint8_t> packed_dst(packed_stride(dst_w) * dst_h);
+	std::mt19937 engine;
+
+	zimg_image_buffer_const src_buf{ ZIMG_API_VERSION };
+	zimg_image_buffer dst_buf{ ZIMG_API_VERSION };
+
+	for (unsigned p = 0; p < 3; ++p) {
+		planar_src[p].resize(src_plane_w[p] * src_h);
+		planar_dst[p].resize(dst_plane_w[p] * dst_h);
+
+		for (unsigned i = 0; i < src_h; ++i) {
+			for (unsigned j = 0; j < src_plane_w[p]; ++j) {
+				uint16_t x = static_cast<uint16_t>(engine() & ((1U << depth) - 1));
+
+				planar_src[p][i * src_plane_w[p] + j] = x;
+				write_packed_yuv(packing, packed_src.data() + i * packed_stride(src_w), p, j, x);
+			}
+		}
+
+		src_buf.plane[p] = { planar_src[p].data(), static_cast<ptrdiff_t>(src_plane_w[p] * sizeof(uint16_t)), ZIMG_BUFFER_MAX };
+		dst_buf.plane[p] = { planar_dst[p].data(), static_cast<ptrdiff_t>(dst_plane_w[p] * sizeof(uint16_t)), ZIMG_BUFFER_MAX };
+	}
+
+	zimg_filter_graph *planar_graph = zimg_filter_graph_build(&src_format, &dst_format, nullptr);
+	ASSERT_TRUE(planar_graph);
+
+	size_t tmp_size = 0;
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size(planar_graph, &tmp_size));
+	zimg::AlignedVector<uint8_t> tmp(tmp_size);
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_process(planar_graph, &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr));
+	zimg_filter_graph_free(planar_graph);
+
+	src_format.pixel_packing = packing;
+	dst_format.pixel_packing = packing;
+
+	zimg_filter_graph *packed_graph = zimg_filter_graph_build(&src_format, &dst_format, nullptr);
+	ASSERT_TRUE(packed_graph);
+
+	// Only the first plane is accessed.
+	src_buf.plane[0] = { packed_src.data(), static_cast<ptrdiff_t>(packed_stride(src_w)), ZIMG_BUFFER_MAX };
+	src_buf.plane[1] = {};
+	src_buf.plane[2] = {};
+	dst_buf.plane[0] = { packed_dst.data(), static_cast<ptrdiff_t>(packed_stride(dst_w)), ZIMG_BUFFER_MAX };
+	dst_buf.plane[1] = {};
+	dst_buf.plane[2] = {};
+
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_get_tmp_size_mt(packed_graph, 4, &tmp_size));
+	tmp.resize(tmp_size);
+	ASSERT_EQ(ZIMG_ERROR_SUCCESS, zimg_filter_graph_process_mt(packed_graph, &src_buf, &dst_buf, tmp.data(), nullptr, nullptr, nullptr, nullptr, 4));
+	zimg_filter_graph_free(packed_graph);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned i = 0; i < dst_h; ++i) {
+			for (unsigned j = 0; j < dst_plane_w[p]; ++j) {
+				uint16_t x = read_packed_yuv(packing, packed_dst.data() + i * packed_stride(dst_w), p, j);
+				ASSERT_EQ(planar_dst[p][i * dst_plane_w[p] + j], x) << p << ' ' << i << ' ' << j;
+			}
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(APITest, test_packed_yuv)
+{
+	{
+		SCOPED_TRACE("Y216");
+		test_packed_yuv(ZIMG_PACKING_YUY2, 1, 16);
+	}
+	{
+		SCOPED_TRACE("v210");
+		test_packed_yuv(ZIMG_PACKING_V210, 1, 10);
+	}
+	{
+		SCOPED_TRACE("Y410");
+		test_packed_yuv(ZIMG_PACKING_Y410, 0, 10);
+	}
+
+	zimg_image_format format;
+	zimg_image_format_default(&format, ZIMG_API_VERSION);
+	format.width = 640;
+	format.height = 480;
+	format.pixel_type = ZIMG_PIXEL_WORD;
+	format.color_family = ZIMG_COLOR_YUV;
+	format.matrix_coefficients = ZIMG_MATRIX_709;
+	format.pixel_packing = ZIMG_PACKING_V210;
+	format.depth = 10;
+
+	// v210 is limited to 4:2:2.
+	EXPECT_FALSE(zimg_filter_graph_build(&format, &format, nullptr));
+	EXPECT_EQ(ZIMG_ERROR_UNSUPPORTED_SUBSAMPLING, zimg_get_last_error(nullptr, 0));
+	zimg_clear_last_error();
+
+	// v210 is limited to 10-bit samples.
+	format.subsample_w = 1;
+	format.depth = 16;
+	EXPECT_FALSE(zimg_filter_graph_build(&format, &format, nullptr));
+	EXPECT_EQ(ZIMG_ERROR_UNSUPPORTED_OPERATION, zimg_get_last_error(nullptr, 0));
+	zimg_clear_last_error();
+}
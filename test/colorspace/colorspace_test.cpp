@@ -58,9 +58,9 @@ TEST(ColorspaceConversionTest, test_matrix_only)
 			"99303773321c293b06ec49626c4753c6931f93b0"
 		},
 		{
-			"e73f69c76f158fb4d461d2d5ecd946096116f2b5",
-			"46aa18f98fa9ffed9bea83817a76cacaf28ed062",
-			"510cff5b3f97e26874cec2b8a986d0a205742b2a"
+			"0c8a00a2c47e20080c4b211c1213ae49a24fe4e3",
+			"90d31fcc4dbf668b52ec0d9806c4a8f87552f0b3",
+			"06094bd271027c69aca0b28bb12e3f5079d3b0da"
 		},
 		{
 			"83e39222105eab15a79601f196d491e993da2cd6",
@@ -369,3 +369,69 @@ TEST(ColorspaceConversionTest, test_rec2100_ictcp)
 	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
 	          expected_sha1[3]);
 }
+
+TEST(ColorspaceConversionTest, test_lut3d)
+{
+	using namespace zimg::colorspace;
+
+	const unsigned w = 640;
+	const unsigned h = 480;
+
+	const char *expected_sha1[3] = {
+		"29007f73e21bbef7faf4a9d26e0191def637bae2",
+		"ab4a30ab49a07c2999e19e8a0bb3a36e3e2da50c",
+		"d754141a6a2dccd0d9fc5100d1bca7c96d13c5e9"
+	};
+	const double expected_snr = 45.0;
+
+	const ColorspaceDefinition csp_in{ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 };
+	const ColorspaceDefinition csp_out{ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 };
+
+	auto builder = ColorspaceConversion{ w, h }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out);
+
+	auto filter_exact = builder.create();
+	auto filter_lut = builder.set_lut_size(33).create();
+
+	FilterValidator validator{ filter_lut.get(), w, h, zimg::PixelType::FLOAT };
+	validator.set_sha1(expected_sha1)
+	         .set_ref_filter(filter_exact.get(), expected_snr)
+	         .validate();
+
+	double error_33 = builder.set_lut_size(33).measure_lut_error();
+	double error_65 = builder.set_lut_size(65).measure_lut_error();
+
+	EXPECT_LT(error_65, error_33);
+	EXPECT_LT(error_33, 0.1);
+}
+
+TEST(ColorspaceConversionTest, test_lut3d_linear)
+{
+	using namespace zimg::colorspace;
+
+	const unsigned w = 640;
+	const unsigned h = 480;
+
+	const char *expected_sha1[3] = {
+		"d39fa08fda52893d294c2bf3c6563bc3035392a9",
+		"e99ba9e53c3b43e5babb580c279b2d1558a6ffa0",
+		"790eb9960fd57ff146029a0783b033e2bbdbd836"
+	};
+
+	const ColorspaceDefinition csp_in{ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_709 };
+	const ColorspaceDefinition csp_out{ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 };
+
+	auto builder = ColorspaceConversion{ w, h }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out);
+
+	// Linear input is not bounded, so the exact conversion is used.
+	auto filter_exact = builder.create();
+	auto filter_lut = builder.set_lut_size(33).create();
+
+	FilterValidator{ filter_exact.get(), w, h, zimg::PixelType::FLOAT }.set_sha1(expected_sha1).validate();
+	FilterValidator{ filter_lut.get(), w, h, zimg::PixelType::FLOAT }.set_sha1(expected_sha1).validate();
+
+	EXPECT_EQ(0.0, builder.measure_lut_error());
+}
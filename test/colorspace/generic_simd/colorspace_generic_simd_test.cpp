@@ -0,0 +1,114 @@
+#ifdef ZIMG_GENERIC_SIMD
+
+#include <cmath>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "graph/image_filter.h"
+#include "colorspace/colorspace.h"
+
+#include "gtest/gtest.h"
+#include "graph/filter_validator.h"
+
+namespace {
+
+void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out,
+               const char * const expected_sha1[3], double expected_snr, bool approximate_gamma)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+
+	zimg::PixelFormat format = zimg::PixelType::FLOAT;
+	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out)
+		.set_approximate_gamma(approximate_gamma);
+
+	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	auto filter_simd = builder.set_cpu(zimg::CPUClass::GENERIC_SIMD).create();
+
+	FilterValidator validator{ filter_simd.get(), w, h, format };
+	validator.set_sha1(expected_sha1)
+	         .set_ref_filter(filter_c.get(), expected_snr)
+	         .set_yuv(csp_in.matrix != zimg::colorspace::MatrixCoefficients::RGB)
+	         .validate();
+}
+
+} // namespace
+
+
+TEST(ColorspaceConversionGenericSIMDTest, test_matrix)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"875b201563afe82886613a0ec9ab3719bcf01636",
+			"8e8a0a1249d5fced3e483dbe463e58fd5ccce495",
+			"13a97d94dc4ac3fb09562cfd7b27c72eb7b3882a"
+		},
+		{
+			"0495adab9c82d98e73841e229a9b2041838fc0f2",
+			"ece7edb1118d4b3063ad80f5d8febb6db7e9633a",
+			"73a9ee951c7bde9ae0ada9b90afd1f7ce8b604df"
+		},
+	};
+	const double expected_snr = INFINITY;
+
+	SCOPED_TRACE("601 yuv->rgb");
+	test_case({ MatrixCoefficients::REC_601, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[0], expected_snr, false);
+	SCOPED_TRACE("709 rgb->yuv");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::REC_709, TransferCharacteristics::UNSPECIFIED, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[1], expected_snr, false);
+}
+
+TEST(ColorspaceConversionGenericSIMDTest, test_transfer_lut)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"3c7196b6a704e2f3d88c2a02143d77dbdefdb234",
+			"fa7ab9deaee4790fa49a1d9d8249e5d323674ec2",
+			"162687e701627cdc17283a32c36ea711d28a953e"
+		},
+		{
+			"ac27dc26b2cef34cc017155052ffb071d1d9e9d6",
+			"3b0694e9fbce61466cb5a575f300d784089b6cad",
+			"b68f103f52ccafae867d664d7f27fe56ae9208af"
+		},
+		{
+			"48c1ec7de50653817c678ea87ee6e1c84ef014d5",
+			"58eb1dde0eb88fff043364836e1844aa766b64c5",
+			"85a277a80dfca2e21789cedd76aaee307dbc4562"
+		},
+		{
+			"098e8372af7b8c64c3d0fb34ad8dd2165ec3ca3d",
+			"b4b84f60f3c6f1141a9e910cf8deda704a20e2ab",
+			"8192c78230f86f2ea5d39904ad84d51ea4b9cfe2"
+		},
+	};
+	const double expected_tolinear_snr = 80.0;
+	const double expected_togamma_snr = 40.0;
+
+	SCOPED_TRACE("tolinear 709");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[0], expected_tolinear_snr, true);
+	SCOPED_TRACE("togamma 709");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[1], expected_togamma_snr, true);
+	SCOPED_TRACE("tolinear st2084");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::ST_2084, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[2], expected_tolinear_snr, true);
+	SCOPED_TRACE("togamma st2084");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::ST_2084, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[3], expected_togamma_snr, true);
+}
+
+#endif // ZIMG_GENERIC_SIMD
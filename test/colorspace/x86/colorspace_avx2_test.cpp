@@ -1,11 +1,17 @@
 #ifdef ZIMG_X86
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include "common/alloc.h"
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "common/x86/cpuinfo_x86.h"
 #include "graph/image_filter.h"
 #include "colorspace/colorspace.h"
+#include "colorspace/gamma.h"
+#include "colorspace/operation.h"
+#include "colorspace/x86/operation_impl_x86.h"
 
 #include "gtest/gtest.h"
 #include "graph/filter_validator.h"
@@ -13,7 +19,7 @@
 namespace {
 
 void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out,
-			   const char * const expected_sha1[3], double expected_snr)
+			   const char * const expected_sha1[3], double expected_snr, unsigned lut_size = 0, bool approximate_gamma = true)
 {
 	const unsigned w = 640;
 	const unsigned h = 480;
@@ -27,7 +33,8 @@ void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg:
 	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
 		.set_csp_in(csp_in)
 		.set_csp_out(csp_out)
-		.set_approximate_gamma(true);
+		.set_lut_size(lut_size)
+		.set_approximate_gamma(approximate_gamma);
 
 	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
 	auto filter_avx2 = builder.set_cpu(zimg::CPUClass::X86_AVX2).create();
@@ -39,9 +46,111 @@ void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg:
 	         .validate();
 }
 
+// Without approximate gamma, the result must match the scalar operations.
+void test_exact(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	zimg::PixelFormat format = zimg::PixelType::FLOAT;
+	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out)
+		.set_approximate_gamma(false);
+
+	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	auto filter_avx2 = builder.set_cpu(zimg::CPUClass::X86_AVX2).create();
+
+	FilterValidator validator{ filter_avx2.get(), w, h, format };
+	validator.set_ref_filter(filter_c.get(), INFINITY)
+	         .set_yuv(csp_in.matrix != zimg::colorspace::MatrixCoefficients::RGB)
+	         .validate();
+}
+
+// Compare the polynomial transfer functions against the scalar functions.
+// The gamma-encoded error is absolute and the linear error is relative.
+void test_transfer_vector(zimg::colorspace::TransferCharacteristics transfer, double max_gamma_error, double max_linear_error, bool scene_referred = false)
+{
+	const unsigned w = 1021;
+	const unsigned stride = 1024;
+
+	zimg::X86Capabilities caps = zimg::query_x86_capabilities();
+	if (!caps.avx2 || !caps.f16c || !caps.fma) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	zimg::colorspace::TransferFunction func = zimg::colorspace::select_transfer_function(transfer, 100.0, scene_referred);
+	zimg::colorspace::OperationParams params;
+	params.set_approximate_gamma(true);
+
+	auto to_linear = zimg::colorspace::create_inverse_gamma_operation_avx2(func, params, false);
+	auto to_gamma = zimg::colorspace::create_gamma_operation_avx2(func, params, false);
+
+	zimg::AlignedVector<float> gamma(stride * 3);
+	zimg::AlignedVector<float> linear(stride * 3);
+	zimg::AlignedVector<float> result(stride * 3);
+
+	for (unsigned i = 0; i < w; ++i) {
+		gamma[i] = static_cast<float>(i) / (w - 1);
+		linear[i] = func.to_linear(gamma[i]) * func.to_linear_scale;
+	}
+	for (unsigned p = 1; p < 3; ++p) {
+		std::copy_n(gamma.data(), w, gamma.data() + p * stride);
+		std::copy_n(linear.data(), w, linear.data() + p * stride);
+	}
+
+	const float *src_gamma[3] = { gamma.data(), gamma.data() + stride, gamma.data() + stride * 2 };
+	const float *src_linear[3] = { linear.data(), linear.data() + stride, linear.data() + stride * 2 };
+	float *dst[3] = { result.data(), result.data() + stride, result.data() + stride * 2 };
+
+	double linear_error = 0.0;
+	double gamma_error = 0.0;
+
+	// Start and end within a vector to exercise the partial stores.
+	to_linear->process(src_gamma, dst, 3, w - 3);
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned i = 3; i < w - 3; ++i) {
+			double ref = linear[i];
+			linear_error = std::max(linear_error, std::fabs(dst[p][i] - ref) / std::max(std::fabs(ref), 1e-3));
+		}
+	}
+
+	to_gamma->process(src_linear, dst, 3, w - 3);
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned i = 3; i < w - 3; ++i) {
+			gamma_error = std::max(gamma_error, std::fabs(dst[p][i] - static_cast<double>(gamma[i])));
+		}
+	}
+
+	EXPECT_LE(linear_error, max_linear_error);
+	EXPECT_LE(gamma_error, max_gamma_error);
+}
+
 } // namespace
 
 
+TEST(ColorspaceConversionAVX2Test, test_transfer_vector)
+{
+	using namespace zimg::colorspace;
+
+	SCOPED_TRACE("709");
+	test_transfer_vector(TransferCharacteristics::REC_709, 5e-7, 1e-6);
+	SCOPED_TRACE("srgb");
+	test_transfer_vector(TransferCharacteristics::SRGB, 5e-7, 1e-6);
+	SCOPED_TRACE("470bg");
+	test_transfer_vector(TransferCharacteristics::REC_470_BG, 5e-7, 1e-6);
+	SCOPED_TRACE("log316");
+	test_transfer_vector(TransferCharacteristics::LOG_316, 5e-7, 1e-6);
+	SCOPED_TRACE("b67");
+	test_transfer_vector(TransferCharacteristics::ARIB_B67, 5e-7, 1e-6, true);
+}
+
 TEST(ColorspaceConversionAVX2Test, test_transfer_lut)
 {
 	using namespace zimg::colorspace;
@@ -89,4 +198,88 @@ TEST(ColorspaceConversionAVX2Test, test_transfer_lut)
 	          expected_sha1[3], expected_togamma_snr);
 }
 
+TEST(ColorspaceConversionAVX2Test, test_arib_b67)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"850238bac076fb7b2657b5a8c9ccf01357042fd8",
+			"92a49f7a7eceba5ae22a9d07611f4735b5ec5520",
+			"0a91d06bf1ed54db046ae883174c42db77ecebbf"
+		},
+		{
+			"4529a97142b4ace5640bddf91e6e5da9d515c8dc",
+			"14dca0d99834f4f5c6495ce1574e5ab266ffa1cb",
+			"4f092a53c088d8942eb59b380c96f1e62bcf9716"
+		},
+	};
+	const double expected_snr = 120.0;
+
+	SCOPED_TRACE("b67->linear");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::ARIB_B67, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          expected_sha1[0], expected_snr, 0, false);
+	SCOPED_TRACE("linear->b67");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::ARIB_B67, ColorPrimaries::REC_2020 },
+	          expected_sha1[1], expected_snr, 0, false);
+}
+
+TEST(ColorspaceConversionAVX2Test, test_rec2020_cl)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"8c367289bece33d894d0e9c22775c98642cc1461",
+			"2000fc717eb63dcb4c9cded11ec4f8fb84ec23b8",
+			"08231a3b970fe2531b9cbe0dce56872e05f9a2ad"
+		},
+		{
+			"ff395627bbb98f755fdac8959c33e851527af99b",
+			"4e2fe9abd5eae5fa6dd1737bfe10bb41e9cc98d7",
+			"5d49220e1469e7bd97170d609e94bfd5c1f004e5"
+		},
+	};
+	const double expected_snr = 120.0;
+
+	SCOPED_TRACE("2020cl->linear");
+	test_case({ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          expected_sha1[0], expected_snr, 0, true);
+	SCOPED_TRACE("linear->2020cl");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          expected_sha1[1], expected_snr, 0, true);
+}
+
+TEST(ColorspaceConversionAVX2Test, test_rec2020_cl_exact)
+{
+	using namespace zimg::colorspace;
+
+	SCOPED_TRACE("2020cl->linear");
+	test_exact({ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	           { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 });
+	SCOPED_TRACE("linear->2020cl");
+	test_exact({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	           { MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 });
+}
+
+TEST(ColorspaceConversionAVX2Test, test_lut3d)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[3] = {
+		"f7a9d4791cb9b4ef79b753f556c5e597c842a726",
+		"edea948d87d8eacbf82a6b8ed1c34d5da8d28aa2",
+		"0ecc169b51329f0a76021e666f6fecf5e962130f"
+	};
+	const double expected_snr = 80.0;
+
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 },
+	          expected_sha1, expected_snr, 33);
+}
+
 #endif // ZIMG_X86
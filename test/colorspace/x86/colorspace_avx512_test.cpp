@@ -13,7 +13,7 @@
 namespace {
 
 void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out,
-               const char * const expected_sha1[3], double expected_snr)
+               const char * const expected_sha1[3], double expected_snr, unsigned lut_size = 0, bool approximate_gamma = false)
 {
 	const unsigned w = 640;
 	const unsigned h = 480;
@@ -26,7 +26,9 @@ void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg:
 	zimg::PixelFormat format = zimg::PixelType::FLOAT;
 	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
 		.set_csp_in(csp_in)
-		.set_csp_out(csp_out);
+		.set_csp_out(csp_out)
+		.set_lut_size(lut_size)
+		.set_approximate_gamma(approximate_gamma);
 
 	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
 	auto filter_avx512 = builder.set_cpu(zimg::CPUClass::X86_AVX512).create();
@@ -38,6 +40,32 @@ void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg:
 	         .validate();
 }
 
+// Without approximate gamma, the result must match the scalar operations.
+void test_exact(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+
+	if (!zimg::query_x86_capabilities().avx512f) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	zimg::PixelFormat format = zimg::PixelType::FLOAT;
+	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out)
+		.set_approximate_gamma(false);
+
+	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	auto filter_avx512 = builder.set_cpu(zimg::CPUClass::X86_AVX512).create();
+
+	FilterValidator validator{ filter_avx512.get(), w, h, format };
+	validator.set_ref_filter(filter_c.get(), INFINITY)
+	         .set_yuv(csp_in.matrix != zimg::colorspace::MatrixCoefficients::RGB)
+	         .validate();
+}
+
 } // namespace
 
 
@@ -57,4 +85,135 @@ TEST(ColorspaceConversionAVX512Test, test_matrix)
 	          expected_sha1, expected_snr);
 }
 
+TEST(ColorspaceConversionAVX512Test, test_transfer)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"390b8964390241dfce0b194a256e5b00588f5c7e",
+			"53fddd42846ccbcc88a465de39afbe7000d64b37",
+			"605dd4399f01d01f27c04247503bcfcecec91f4c"
+		},
+		{
+			"2c2ee6dfcc5ac6f5ec08ecfe36a0e4052a6fdf31",
+			"732af19abca9ec6b1140462da33b75af9a4b4f85",
+			"036513bb049854f878472f68f66cff1191272280"
+		},
+		{
+			"9af3181c67031e8a33a4216707469f02852b32f3",
+			"75b0d935d30ebaa2b9fdc587f2cc836fe91788e4",
+			"cdf5de4d2c1594c34a13763aa812527b3e56f232"
+		},
+		{
+			"496a44c61c7effe153ac0fabe765bfc55664fec2",
+			"2ba689a3e94711598467e547eea92634d1a4a163",
+			"a562be577438bb4c77e9a37dc848f394fa052fb2"
+		},
+	};
+	const double expected_tolinear_snr = 80.0;
+	const double expected_togamma_snr = 80.0;
+
+	SCOPED_TRACE("tolinear 709");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[0], expected_tolinear_snr, 0, true);
+	SCOPED_TRACE("togamma 709");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[1], expected_togamma_snr, 0, true);
+	SCOPED_TRACE("tolinear st2084");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::ST_2084, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[2], expected_tolinear_snr, 0, true);
+	SCOPED_TRACE("togamma st2084");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::UNSPECIFIED },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::ST_2084, ColorPrimaries::UNSPECIFIED },
+	          expected_sha1[3], expected_togamma_snr, 0, true);
+}
+
+TEST(ColorspaceConversionAVX512Test, test_arib_b67)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"b5f1fd060674a2f21bcd038b30219235018fb3dd",
+			"b0ebd3f56e34af27fc24f00ea9ceed6fb149821e",
+			"b1a68bdc7e71d70ceef98d0be56225f86100b9c5"
+		},
+		{
+			"f693ff20155b23357c0910c17fd7277d3111ed4a",
+			"f6b88c5a3f9ef32e7012236abc6db7b3d7a71825",
+			"e629ea2f1c17f31eada3e91d172d47718a06618c"
+		},
+	};
+	const double expected_snr = 120.0;
+
+	SCOPED_TRACE("b67->linear");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::ARIB_B67, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          expected_sha1[0], expected_snr, 0, false);
+	SCOPED_TRACE("linear->b67");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::ARIB_B67, ColorPrimaries::REC_2020 },
+	          expected_sha1[1], expected_snr, 0, false);
+}
+
+TEST(ColorspaceConversionAVX512Test, test_rec2020_cl)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"410d665582e8f7ee3a0e5d33b3b4bc209bc5391b",
+			"d77c4086ac015233fc4b6bbbdd8f0b83460343eb",
+			"d248ab7d4d7142a2f94bb8d76a96bd48e1193624"
+		},
+		{
+			"637277a09dad7f4316bad49ba8147b904c8d45ee",
+			"7c30301e4a37e2df83c96315e23f053c1e4e88c4",
+			"df956f8ee50d47d4b4326c224d386eab5d2f9d4e"
+		},
+	};
+	const double expected_snr = 120.0;
+
+	SCOPED_TRACE("2020cl->linear");
+	test_case({ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          expected_sha1[0], expected_snr, 0, true);
+	SCOPED_TRACE("linear->2020cl");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          expected_sha1[1], expected_snr, 0, true);
+}
+
+TEST(ColorspaceConversionAVX512Test, test_rec2020_cl_exact)
+{
+	using namespace zimg::colorspace;
+
+	SCOPED_TRACE("2020cl->linear");
+	test_exact({ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	           { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 });
+	SCOPED_TRACE("linear->2020cl");
+	test_exact({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	           { MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 });
+}
+
+TEST(ColorspaceConversionAVX512Test, test_lut3d)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[3] = {
+		"580784510ffde2905b6fe9a91669a2ccecb0eb9c",
+		"3ee079d385392de7d627b81e66a8e9c22b1645b5",
+		"df3f2926c2d19486c17f4d1ab1c8e55dff4f88ec"
+	};
+	const double expected_snr = 120.0;
+
+	test_case({ MatrixCoefficients::REC_709, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::REC_709, ColorPrimaries::REC_709 },
+	          expected_sha1, expected_snr, 33);
+}
+
 #endif // ZIMG_X86_AVX512
@@ -13,7 +13,7 @@
 namespace {
 
 void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out,
-               const char * const expected_sha1[3], double expected_snr)
+               const char * const expected_sha1[3], double expected_snr, bool approximate_gamma = true)
 {
 	const unsigned w = 640;
 	const unsigned h = 480;
@@ -27,7 +27,7 @@ void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg:
 	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
 		.set_csp_in(csp_in)
 		.set_csp_out(csp_out)
-		.set_approximate_gamma(true);
+		.set_approximate_gamma(approximate_gamma);
 
 	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
 	auto filter_sse2 = builder.set_cpu(zimg::CPUClass::X86_SSE2).create();
@@ -39,6 +39,32 @@ void test_case(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg:
 	         .validate();
 }
 
+// Without approximate gamma, the result must match the scalar operations.
+void test_exact(const zimg::colorspace::ColorspaceDefinition &csp_in, const zimg::colorspace::ColorspaceDefinition &csp_out)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+
+	if (!zimg::query_x86_capabilities().sse2) {
+		SUCCEED() << "sse2 not available, skipping";
+		return;
+	}
+
+	zimg::PixelFormat format = zimg::PixelType::FLOAT;
+	auto builder = zimg::colorspace::ColorspaceConversion{ w, h }
+		.set_csp_in(csp_in)
+		.set_csp_out(csp_out)
+		.set_approximate_gamma(false);
+
+	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	auto filter_sse2 = builder.set_cpu(zimg::CPUClass::X86_SSE2).create();
+
+	FilterValidator validator{ filter_sse2.get(), w, h, format };
+	validator.set_ref_filter(filter_c.get(), INFINITY)
+	         .set_yuv(csp_in.matrix != zimg::colorspace::MatrixCoefficients::RGB)
+	         .validate();
+}
+
 } // namespace
 
 
@@ -89,4 +115,72 @@ TEST(ColorspaceConversionSSE2Test, test_transfer_lut)
 	          expected_sha1[3], expected_togamma_snr);
 }
 
+TEST(ColorspaceConversionSSE2Test, test_arib_b67)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"4644ae11b46f2d52bcdabb7013a50ea3ccdd060a",
+			"b7a5311228e6652753c225e5d39d491b68e3e746",
+			"80b58affcbc82f8981ebc17f3434379abc921b5e"
+		},
+		{
+			"14ec0ce30a142b2bf1c8d0ef2adfc6c0cc2d40b1",
+			"67152f230505c088eaeb8f3df245d7798960c53e",
+			"17b874746d84adf00e6211aef3a6917e24eac139"
+		},
+	};
+	const double expected_snr = 120.0;
+
+	SCOPED_TRACE("b67->linear");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::ARIB_B67, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          expected_sha1[0], expected_snr, false);
+	SCOPED_TRACE("linear->b67");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::ARIB_B67, ColorPrimaries::REC_2020 },
+	          expected_sha1[1], expected_snr, false);
+}
+
+TEST(ColorspaceConversionSSE2Test, test_rec2020_cl)
+{
+	using namespace zimg::colorspace;
+
+	const char *expected_sha1[][3] = {
+		{
+			"e25dd9711d631b963ce261a85ff299a7b3f1b391",
+			"668e0ecbb8316358082d4fa90d2a997ad290c51d",
+			"14a9376fc024e51f70cca2c2c65b0944e51f34e6"
+		},
+		{
+			"f55626ce88918a363045198179f4920d390b0fae",
+			"1b9d9d25a7ca5c45187145e6b5b025112a7b5edf",
+			"8987e5184ec98393eb4eafa09b37722c84c8403a"
+		},
+	};
+	const double expected_snr = 120.0;
+
+	SCOPED_TRACE("2020cl->linear");
+	test_case({ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          expected_sha1[0], expected_snr);
+	SCOPED_TRACE("linear->2020cl");
+	test_case({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	          { MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	          expected_sha1[1], expected_snr);
+}
+
+TEST(ColorspaceConversionSSE2Test, test_rec2020_cl_exact)
+{
+	using namespace zimg::colorspace;
+
+	SCOPED_TRACE("2020cl->linear");
+	test_exact({ MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 },
+	           { MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 });
+	SCOPED_TRACE("linear->2020cl");
+	test_exact({ MatrixCoefficients::RGB, TransferCharacteristics::LINEAR, ColorPrimaries::REC_2020 },
+	           { MatrixCoefficients::REC_2020_CL, TransferCharacteristics::REC_709, ColorPrimaries::REC_2020 });
+}
+
 #endif // ZIMG_X86
@@ -1,10 +1,15 @@
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "common/alloc.h"
 #include "common/except.h"
 #include "common/make_unique.h"
 #include "common/pixel.h"
+#include "graph/copy_filter.h"
 #include "graph/filtergraph.h"
 #include "graph/image_filter.h"
 
@@ -33,6 +38,33 @@ public:
 	}
 };
 
+// Scheduler running each task on a new thread, accepting up to max_tasks.
+struct thread_scheduler {
+	std::vector<std::thread> threads;
+	unsigned max_tasks;
+
+	static int submit(void *user, zimg::graph::FilterGraph::scheduler::task_func func, void *task)
+	{
+		thread_scheduler *self = static_cast<thread_scheduler *>(user);
+
+		if (self->threads.size() >= self->max_tasks)
+			return 1;
+
+		self->threads.emplace_back(func, task);
+		return 0;
+	}
+
+	static void wait(void *user)
+	{
+		thread_scheduler *self = static_cast<thread_scheduler *>(user);
+
+		for (auto &th : self->threads) {
+			th.join();
+		}
+		self->threads.clear();
+	}
+};
+
 }
 
 
@@ -462,6 +494,638 @@ TEST(FilterGraphTest, test_support)
 	}
 }
 
+TEST(FilterGraphTest, test_support_inplace)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::FLOAT;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+	const uint8_t test_byte4 = 0xCC;
+
+	zimg::graph::ImageFilter::filter_flags flags{};
+	flags.same_row = true;
+	flags.in_place = true;
+	flags.color = true;
+
+	// The chroma filter writes ahead of the color filter into the shared
+	// buffer, which must not overwrite rows still needed by the next filter.
+	auto filter1_uptr = ztd::make_unique<SplatFilter<float>>(w, h, type);
+	auto filter2_uptr = ztd::make_unique<SplatFilter<float>>(w, h, type);
+	auto filter3_uptr = ztd::make_unique<SplatFilter<float>>(w, h, type, flags);
+	auto filter4_uptr = ztd::make_unique<SplatFilter<float>>(w, h, type);
+	auto filter5_uptr = ztd::make_unique<SplatFilter<float>>(w, h, type);
+	SplatFilter<float> *filter1 = filter1_uptr.get();
+	SplatFilter<float> *filter2 = filter2_uptr.get();
+	SplatFilter<float> *filter3 = filter3_uptr.get();
+	SplatFilter<float> *filter4 = filter4_uptr.get();
+	SplatFilter<float> *filter5 = filter5_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+
+	filter2->set_input_val(test_byte1);
+	filter2->set_output_val(test_byte2);
+	filter2->set_simultaneous_lines(8);
+
+	filter3->set_input_val(test_byte2);
+	filter3->set_output_val(test_byte3);
+
+	filter4->set_input_val(test_byte3);
+	filter4->set_output_val(test_byte4);
+	filter4->set_vertical_support(6);
+
+	filter5->set_input_val(test_byte3);
+	filter5->set_output_val(test_byte4);
+	filter5->set_vertical_support(6);
+
+	zimg::graph::FilterGraph graph{ w, h, type, 0, 0, true };
+	graph.attach_filter(std::move(filter1_uptr));
+	graph.attach_filter_uv(std::move(filter2_uptr));
+	graph.attach_filter(std::move(filter3_uptr));
+	graph.attach_filter(std::move(filter4_uptr));
+	graph.attach_filter_uv(std::move(filter5_uptr));
+	graph.complete();
+
+	AuditImage<float> src_image{ AuditBufferType::COLOR_RGB, w, h, type, 0, 0 };
+	AuditImage<float> dst_image{ AuditBufferType::COLOR_RGB, w, h, type, 0, 0 };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+	graph.process(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr);
+	dst_image.set_fill_val(test_byte4);
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_fuse)
+{
+	const unsigned w = 1000;
+	const unsigned h = 120;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+	const uint8_t test_byte4 = 0xCC;
+
+	for (unsigned x = 0; x < 2; ++x) {
+		SCOPED_TRACE(!!x);
+
+		bool color = !!x;
+		AuditBufferType buffer_type = color ? AuditBufferType::COLOR_RGB : AuditBufferType::PLANE;
+
+		// Chains of per-pixel filters are merged and processed in column chunks.
+		zimg::graph::ImageFilter::filter_flags flags{};
+		flags.same_row = true;
+		flags.in_place = true;
+		flags.color = color;
+
+		auto filter1_uptr = ztd::make_unique<SplatFilter<uint16_t>>(w, h, type, flags);
+		auto filter2_uptr = ztd::make_unique<SplatFilter<uint16_t>>(w, h, type, flags);
+		auto filter3_uptr = ztd::make_unique<SplatFilter<uint16_t>>(w, h, type, flags);
+		SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+		SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+		SplatFilter<uint16_t> *filter3 = filter3_uptr.get();
+
+		filter1->set_input_val(test_byte1);
+		filter1->set_output_val(test_byte2);
+
+		filter2->set_input_val(test_byte2);
+		filter2->set_output_val(test_byte3);
+
+		filter3->set_input_val(test_byte3);
+		filter3->set_output_val(test_byte4);
+
+		zimg::graph::FilterGraph graph{ w, h, type, 0, 0, color };
+		graph.attach_filter(std::move(filter1_uptr));
+		graph.attach_filter(std::move(filter2_uptr));
+		graph.attach_filter(std::move(filter3_uptr));
+		graph.complete();
+
+		AuditImage<uint16_t> src_image{ buffer_type, w, h, type, 0, 0 };
+		AuditImage<uint16_t> dst_image{ buffer_type, w, h, type, 0, 0 };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		graph.process(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr);
+		dst_image.set_fill_val(test_byte4);
+
+		EXPECT_GE(filter1->get_total_calls(), h * 2);
+		EXPECT_EQ(filter1->get_total_calls(), filter2->get_total_calls());
+		EXPECT_EQ(filter1->get_total_calls(), filter3->get_total_calls());
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_fuse_support)
+{
+	const unsigned w = 1000;
+	const unsigned h = 121;
+	const zimg::PixelType type = zimg::PixelType::FLOAT;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	// A filter with support followed by a per-pixel filter is merged, e.g. resize and dither.
+	zimg::graph::ImageFilter::filter_flags flags{};
+	flags.same_row = true;
+	flags.in_place = true;
+
+	auto filter1_uptr = ztd::make_unique<SplatFilter<float>>(w, h, type);
+	auto filter2_uptr = ztd::make_unique<SplatFilter<float>>(w, h, type, flags);
+	SplatFilter<float> *filter1 = filter1_uptr.get();
+	SplatFilter<float> *filter2 = filter2_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+	filter1->set_simultaneous_lines(4);
+	filter1->set_horizontal_support(3);
+	filter1->set_vertical_support(2);
+
+	filter2->set_input_val(test_byte2);
+	filter2->set_output_val(test_byte3);
+
+	zimg::graph::FilterGraph graph{ w, h, type, 0, 0, false };
+	graph.attach_filter(std::move(filter1_uptr));
+	graph.attach_filter(std::move(filter2_uptr));
+	graph.complete();
+
+	AuditImage<float> src_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+	AuditImage<float> dst_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+	graph.process(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr);
+	dst_image.set_fill_val(test_byte3);
+
+	EXPECT_GE(filter1->get_total_calls(), (h + 3) / 4 * 2);
+	EXPECT_GE(filter2->get_total_calls(), h * 2);
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_parallel)
+{
+	const unsigned w = 1024;
+	const unsigned h = 576;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	for (unsigned x = 0; x < 2; ++x) {
+		SCOPED_TRACE(!!x);
+
+		zimg::graph::ImageFilter::filter_flags flags{};
+		flags.has_state = true;
+		flags.color = !!x;
+
+		auto filter1_uptr = ztd::make_unique<SplatFilter<uint16_t>>(w, h, type, flags);
+		auto filter2_uptr = ztd::make_unique<SplatFilter<uint16_t>>(w, h, type, flags);
+		auto filter3_uptr = ztd::make_unique<SplatFilter<uint16_t>>(w / 2, h / 2, type);
+		SplatFilter<uint16_t> *filter1 = filter1_uptr.get();
+		SplatFilter<uint16_t> *filter2 = filter2_uptr.get();
+		SplatFilter<uint16_t> *filter3 = filter3_uptr.get();
+
+		filter1->set_input_val(test_byte1);
+		filter1->set_output_val(test_byte2);
+		filter1->set_horizontal_support(5);
+
+		filter2->set_input_val(test_byte2);
+		filter2->set_output_val(test_byte3);
+		filter2->set_horizontal_support(3);
+		filter2->set_vertical_support(2);
+
+		filter3->set_input_val(test_byte1);
+		filter3->set_output_val(test_byte3);
+		filter3->set_horizontal_support(7);
+
+		zimg::graph::FilterGraph graph{ w, h, type, x ? 0U : 1U, x ? 0U : 1U, true };
+
+		graph.attach_filter(std::move(filter1_uptr));
+		graph.attach_filter(std::move(filter2_uptr));
+		if (!x)
+			graph.attach_filter_uv(std::move(filter3_uptr));
+		graph.complete();
+
+		AuditBufferType buffer_type = x ? AuditBufferType::COLOR_RGB : AuditBufferType::COLOR_YUV;
+		AuditImage<uint16_t> src_image{ buffer_type, w, h, type, x ? 0U : 1U, x ? 0U : 1U };
+		AuditImage<uint16_t> dst_image{ buffer_type, w, h, type, x ? 0U : 1U, x ? 0U : 1U };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(4));
+
+		EXPECT_GE(graph.get_tmp_size_mt(4), graph.get_tmp_size());
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		graph.process_mt(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr, 4);
+		dst_image.set_fill_val(test_byte3);
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_parallel_tile_width_hint)
+{
+	const unsigned w = 1024;
+	const unsigned h = 64;
+	const unsigned threads = 4;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+
+	for (unsigned x = 0; x < 2; ++x) {
+		SCOPED_TRACE(!!x);
+
+		zimg::graph::ImageFilter::filter_flags flags{};
+		flags.has_state = true;
+
+		auto filter_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w, h, type, flags);
+		SplatFilter<uint8_t> *filter = filter_uptr.get();
+
+		filter->set_input_val(test_byte1);
+		filter->set_output_val(test_byte2);
+
+		zimg::graph::FilterGraph graph{ w, h, type, 0, 0, false };
+		graph.attach_filter(std::move(filter_uptr));
+		graph.complete();
+
+		// A tile width hint is still divided among the threads, but an explicit
+		// tile width is not.
+		if (x)
+			graph.set_tile_width_hint(w);
+		else
+			graph.set_tile_width(w);
+
+		EXPECT_EQ(w, graph.tile_width());
+
+		AuditImage<uint8_t> src_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+		AuditImage<uint8_t> dst_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(threads));
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		graph.process_mt(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr, threads);
+		dst_image.set_fill_val(test_byte2);
+
+		EXPECT_EQ(h * (x ? threads : 1), filter->get_total_calls());
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_parallel_band)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+	const uint8_t test_byte4 = 0xCC;
+
+	// Whole-row filters prevent tiling, so the frame is divided into bands.
+	zimg::graph::ImageFilter::filter_flags flags1{};
+	flags1.entire_row = true;
+
+	zimg::graph::ImageFilter::filter_flags flags2{};
+	flags2.same_row = true;
+	flags2.in_place = true;
+
+	auto filter1_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w, h, type, flags1);
+	auto filter2_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w, h, type, flags1);
+	auto filter3_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w, h, type, flags2);
+	auto filter4_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w / 2, h / 2, type, flags1);
+	SplatFilter<uint8_t> *filter1 = filter1_uptr.get();
+	SplatFilter<uint8_t> *filter2 = filter2_uptr.get();
+	SplatFilter<uint8_t> *filter3 = filter3_uptr.get();
+	SplatFilter<uint8_t> *filter4 = filter4_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+
+	filter2->set_input_val(test_byte2);
+	filter2->set_output_val(test_byte3);
+	filter2->set_vertical_support(5);
+
+	filter3->set_input_val(test_byte3);
+	filter3->set_output_val(test_byte4);
+	filter3->set_simultaneous_lines(8);
+
+	filter4->set_input_val(test_byte1);
+	filter4->set_output_val(test_byte4);
+	filter4->set_simultaneous_lines(2);
+	filter4->set_vertical_support(3);
+
+	zimg::graph::FilterGraph graph{ w, h, type, 1, 1, true };
+	graph.attach_filter(std::move(filter1_uptr));
+	graph.attach_filter(std::move(filter2_uptr));
+	graph.attach_filter(std::move(filter3_uptr));
+	graph.attach_filter_uv(std::move(filter4_uptr));
+	graph.complete();
+
+	AuditImage<uint8_t> src_image{ AuditBufferType::COLOR_YUV, w, h, type, 1, 1 };
+	AuditImage<uint8_t> dst_image{ AuditBufferType::COLOR_YUV, w, h, type, 1, 1 };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(6));
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+	graph.process_mt(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr, 6);
+	dst_image.set_fill_val(test_byte4);
+
+	// Each band recomputes the rows needed by the vertical filter above it,
+	// but every output row is written exactly once.
+	EXPECT_GT(filter1->get_total_calls(), h);
+	EXPECT_EQ(h, filter2->get_total_calls());
+	EXPECT_EQ(h / 8, filter3->get_total_calls());
+	EXPECT_EQ(h / 2 / 2 * 2, filter4->get_total_calls());
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_parallel_band_callback)
+{
+	static const unsigned w = 640;
+	static const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	// Bands would invoke the callbacks again for the rows above each band.
+	auto cb = [](void *ptr, unsigned i, unsigned left, unsigned right) -> int
+	{
+		std::atomic_uint *call_count = static_cast<std::atomic_uint *>(ptr);
+
+		EXPECT_LT(i, h);
+		EXPECT_EQ(0U, left);
+		EXPECT_EQ(w, right);
+
+		++*call_count;
+		return 0;
+	};
+
+	zimg::graph::ImageFilter::filter_flags flags{};
+	flags.entire_row = true;
+
+	auto filter1_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w, h, type, flags);
+	auto filter2_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w, h, type, flags);
+	SplatFilter<uint8_t> *filter1 = filter1_uptr.get();
+	SplatFilter<uint8_t> *filter2 = filter2_uptr.get();
+
+	filter1->set_input_val(test_byte1);
+	filter1->set_output_val(test_byte2);
+
+	filter2->set_input_val(test_byte2);
+	filter2->set_output_val(test_byte3);
+	filter2->set_vertical_support(5);
+
+	zimg::graph::FilterGraph graph{ w, h, type, 0, 0, false };
+	graph.attach_filter(std::move(filter1_uptr));
+	graph.attach_filter(std::move(filter2_uptr));
+	graph.complete();
+
+	AuditImage<uint8_t> src_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+	AuditImage<uint8_t> dst_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(6));
+	std::atomic_uint unpack_calls{ 0 };
+	std::atomic_uint pack_calls{ 0 };
+
+	src_image.set_fill_val(test_byte1);
+	src_image.default_fill();
+	graph.process_mt(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), { cb, &unpack_calls }, { cb, &pack_calls }, 6);
+	dst_image.set_fill_val(test_byte3);
+
+	EXPECT_EQ(h, filter1->get_total_calls());
+	EXPECT_EQ(h, unpack_calls);
+	EXPECT_EQ(h, pack_calls);
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
+TEST(FilterGraphTest, test_concurrent)
+{
+	const unsigned w = 1024;
+	const unsigned h = 576;
+	const unsigned threads = 4;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+	const uint8_t test_byte3 = 0xDC;
+
+	auto build_graph = [&](unsigned concurrent)
+	{
+		auto filter1 = ztd::make_unique<SplatFilter<uint16_t>>(w, h, type);
+		auto filter2 = ztd::make_unique<SplatFilter<uint16_t>>(w, h, type);
+
+		filter1->set_input_val(test_byte1);
+		filter1->set_output_val(test_byte2);
+		filter1->set_horizontal_support(5);
+
+		filter2->set_input_val(test_byte2);
+		filter2->set_output_val(test_byte3);
+		filter2->set_vertical_support(3);
+
+		zimg::graph::FilterGraph graph{ w, h, type, 0, 0, false };
+		graph.attach_filter(std::move(filter1));
+		graph.attach_filter(std::move(filter2));
+		graph.set_concurrent_graphs(concurrent);
+		graph.complete();
+		return graph;
+	};
+
+	// Frames running concurrently share the processor caches, which may
+	// cause the graph to select narrower tiles.
+	zimg::graph::FilterGraph graph = build_graph(threads);
+	EXPECT_LE(graph.tile_width(), build_graph(1).tile_width());
+
+	std::vector<std::unique_ptr<AuditImage<uint16_t>>> src_images;
+	std::vector<std::unique_ptr<AuditImage<uint16_t>>> dst_images;
+	std::vector<zimg::AlignedVector<char>> tmp_buffers;
+	std::vector<std::thread> pool;
+
+	for (unsigned n = 0; n < threads; ++n) {
+		src_images.emplace_back(ztd::make_unique<AuditImage<uint16_t>>(AuditBufferType::PLANE, w, h, type, 0, 0));
+		dst_images.emplace_back(ztd::make_unique<AuditImage<uint16_t>>(AuditBufferType::PLANE, w, h, type, 0, 0));
+		tmp_buffers.emplace_back(graph.get_tmp_size());
+
+		src_images[n]->set_fill_val(test_byte1);
+		src_images[n]->default_fill();
+	}
+
+	for (unsigned n = 0; n < threads; ++n) {
+		pool.emplace_back([&, n]()
+		{
+			for (unsigned x = 0; x < 4; ++x) {
+				graph.process(src_images[n]->as_read_buffer(), dst_images[n]->as_write_buffer(), tmp_buffers[n].data(), nullptr, nullptr);
+			}
+		});
+	}
+	for (auto &th : pool) {
+		th.join();
+	}
+
+	for (unsigned n = 0; n < threads; ++n) {
+		SCOPED_TRACE(n);
+		dst_images[n]->set_fill_val(test_byte3);
+
+		SCOPED_TRACE("validating src");
+		src_images[n]->validate();
+		SCOPED_TRACE("validating dst");
+		dst_images[n]->validate();
+	}
+}
+
+TEST(FilterGraphTest, test_parallel_scheduler)
+{
+	const unsigned w = 1024;
+	const unsigned h = 576;
+	const zimg::PixelType type = zimg::PixelType::BYTE;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDC;
+
+	// Accept all tasks, some tasks, or no tasks.
+	for (unsigned x = 0; x < 3; ++x) {
+		SCOPED_TRACE(x);
+
+		auto filter_uptr = ztd::make_unique<SplatFilter<uint8_t>>(w, h, type);
+		SplatFilter<uint8_t> *filter = filter_uptr.get();
+
+		filter->set_input_val(test_byte1);
+		filter->set_output_val(test_byte2);
+		filter->set_horizontal_support(5);
+
+		zimg::graph::FilterGraph graph{ w, h, type, 0, 0, false };
+		graph.attach_filter(std::move(filter_uptr));
+		graph.complete();
+
+		AuditImage<uint8_t> src_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+		AuditImage<uint8_t> dst_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+		zimg::AlignedVector<char> tmp(graph.get_tmp_size_mt(4));
+
+		thread_scheduler sched_impl{ {}, x == 0 ? 3U : x == 1 ? 1U : 0U };
+		zimg::graph::FilterGraph::scheduler sched{ thread_scheduler::submit, thread_scheduler::wait, &sched_impl };
+
+		src_image.set_fill_val(test_byte1);
+		src_image.default_fill();
+		graph.process_mt(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr, 4, sched);
+		dst_image.set_fill_val(test_byte2);
+
+		EXPECT_TRUE(sched_impl.threads.empty());
+
+		SCOPED_TRACE("validating src");
+		src_image.validate();
+		SCOPED_TRACE("validating dst");
+		dst_image.validate();
+	}
+}
+
+TEST(FilterGraphTest, test_signature_stable)
+{
+	const unsigned w = 640;
+	const unsigned h = 480;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	// Signatures are stored in tile profiles, so they must not depend on the
+	// compiler or the build.
+	zimg::graph::FilterGraph graph{ w, h, type, 1, 1, true };
+	graph.attach_filter(std::make_shared<zimg::graph::CopyFilter>(w, h, type));
+	graph.attach_filter_uv(std::make_shared<zimg::graph::CopyFilter>(w / 2, h / 2, type));
+	graph.complete();
+
+	EXPECT_EQ(0xFB6B4023BD1D4389ULL, graph.signature());
+}
+
+TEST(FilterGraphTest, test_benchmark_tile_width)
+{
+	const unsigned w = 1024;
+	const unsigned h = 64;
+	const zimg::PixelType type = zimg::PixelType::WORD;
+
+	const uint8_t test_byte1 = 0xCD;
+	const uint8_t test_byte2 = 0xDD;
+
+	auto make_graph = [=](unsigned width)
+	{
+		auto filter1 = ztd::make_unique<SplatFilter<uint16_t>>(width, h, type);
+		auto filter2 = ztd::make_unique<SplatFilter<uint16_t>>(width, h, type);
+
+		filter1->set_input_val(0);
+		filter1->set_output_val(test_byte1);
+		filter1->set_horizontal_support(3);
+
+		filter2->set_input_val(test_byte1);
+		filter2->set_output_val(test_byte2);
+		filter2->set_vertical_support(2);
+
+		auto graph = ztd::make_unique<zimg::graph::FilterGraph>(width, h, type, 0, 0, false);
+		graph->attach_filter(std::move(filter1));
+		graph->attach_filter(std::move(filter2));
+		graph->complete();
+		return graph;
+	};
+
+	auto graph = make_graph(w);
+	EXPECT_EQ(make_graph(w)->signature(), graph->signature());
+	EXPECT_NE(make_graph(w / 2)->signature(), graph->signature());
+
+	graph->set_tile_width(256);
+	unsigned tile_width = graph->benchmark_tile_width();
+	EXPECT_EQ(256U, graph->tile_width());
+	EXPECT_GE(tile_width, 128U);
+	EXPECT_LE(tile_width, w);
+
+	graph->set_tile_width(tile_width);
+
+	AuditImage<uint16_t> src_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+	AuditImage<uint16_t> dst_image{ AuditBufferType::PLANE, w, h, type, 0, 0 };
+	zimg::AlignedVector<char> tmp(graph->get_tmp_size());
+
+	src_image.set_fill_val(0);
+	src_image.default_fill();
+	graph->process(src_image.as_read_buffer(), dst_image.as_write_buffer(), tmp.data(), nullptr, nullptr);
+	dst_image.set_fill_val(test_byte2);
+
+	SCOPED_TRACE("validating src");
+	src_image.validate();
+	SCOPED_TRACE("validating dst");
+	dst_image.validate();
+}
+
 TEST(FilterGraphTest, test_callback)
 {
 	static const unsigned w = 1024;
@@ -6,7 +6,7 @@
 MockFilter::MockFilter(unsigned width, unsigned height, zimg::PixelType type, const zimg::graph::ImageFilter::filter_flags &flags) :
 	m_attr{ width, height, type },
 	m_flags(flags),
-	m_total_calls{},
+	m_total_calls{ 0 },
 	m_simultaneous_lines{ flags.entire_plane ? zimg::graph::BUFFER_MAX : 1 },
 	m_horizontal_support{},
 	m_vertical_support{}
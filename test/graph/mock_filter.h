@@ -3,6 +3,7 @@
 #ifndef ZIMG_GRAPH_MOCK_FILTER_H_
 #define ZIMG_GRAPH_MOCK_FILTER_H_
 
+#include <atomic>
 #include <cstdint>
 #include "graph/image_filter.h"
 
@@ -16,7 +17,7 @@ protected:
 
 	image_attributes m_attr;
 	filter_flags m_flags;
-	mutable unsigned m_total_calls;
+	mutable std::atomic_uint m_total_calls;
 	unsigned m_simultaneous_lines;
 	unsigned m_horizontal_support;
 	unsigned m_vertical_support;
@@ -31,6 +32,8 @@ public:
 
 	void set_vertical_support(unsigned n);
 
+	const char *get_name() const override { return "mock"; }
+
 	// ImageFilter
 	filter_flags get_flags() const override;
 
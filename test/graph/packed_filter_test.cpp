@@ -0,0 +1,399 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "graph/graphbuilder.h"
+#include "graph/image_buffer.h"
+#include "graph/image_filter.h"
+#include "graph/packed_filter.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using zimg::graph::GraphBuilder;
+
+const GraphBuilder::PixelPacking packings[] = {
+	GraphBuilder::PixelPacking::RGB,
+	GraphBuilder::PixelPacking::BGR,
+	GraphBuilder::PixelPacking::RGBA,
+	GraphBuilder::PixelPacking::BGRA,
+	GraphBuilder::PixelPacking::ARGB,
+	GraphBuilder::PixelPacking::ABGR,
+};
+
+GraphBuilder::state make_state(unsigned width, GraphBuilder::PixelPacking packing, zimg::PixelType type, unsigned depth)
+{
+	GraphBuilder::state state{};
+	state.width = width;
+	state.height = 1;
+	state.type = type;
+	state.packing = packing;
+	state.color = GraphBuilder::ColorFamily::RGB;
+	state.depth = depth;
+	state.fullrange = true;
+	return state;
+}
+
+// Channel names of a packed pixel, in memory order.
+const char *channel_order(GraphBuilder::PixelPacking packing)
+{
+	switch (packing) {
+	case GraphBuilder::PixelPacking::RGB: return "RGB";
+	case GraphBuilder::PixelPacking::BGR: return "BGR";
+	case GraphBuilder::PixelPacking::RGBA: return "RGBA";
+	case GraphBuilder::PixelPacking::BGRA: return "BGRA";
+	case GraphBuilder::PixelPacking::ARGB: return "ARGB";
+	case GraphBuilder::PixelPacking::ABGR: return "ABGR";
+	default: return "";
+	}
+}
+
+template <class T>
+T sample_value(unsigned j, char channel)
+{
+	return static_cast<T>(j * 4 + (channel == 'R' ? 1 : channel == 'G' ? 2 : channel == 'B' ? 3 : 0));
+}
+
+template <class T>
+void test_unpack(unsigned width, GraphBuilder::PixelPacking packing, zimg::PixelType type, unsigned left, unsigned right)
+{
+	const char *order = channel_order(packing);
+	const unsigned channels = static_cast<unsigned>(std::strlen(order));
+	const char rgb[3] = { 'R', 'G', 'B' };
+
+	std::vector<T> src(width * channels);
+	std::vector<T> dst[3] = { std::vector<T>(width), std::vector<T>(width), std::vector<T>(width) };
+
+	for (unsigned j = 0; j < width; ++j) {
+		for (unsigned k = 0; k < channels; ++k) {
+			src[j * channels + k] = sample_value<T>(j, order[k]);
+		}
+	}
+
+	auto filter = zimg::graph::create_unpack_filter(make_state(width, packing, type, zimg::pixel_depth(type)), zimg::CPUClass::NONE);
+	ASSERT_TRUE(filter->get_flags().color);
+	ASSERT_FALSE(filter->get_flags().in_place);
+
+	zimg::graph::ImageBuffer<const void> src_buf[3] = { { src.data(), 0, zimg::graph::BUFFER_MAX } };
+	zimg::graph::ImageBuffer<void> dst_buf[3];
+	for (unsigned p = 0; p < 3; ++p) {
+		dst_buf[p] = { dst[p].data(), 0, zimg::graph::BUFFER_MAX };
+	}
+
+	filter->process(nullptr, src_buf, dst_buf, nullptr, 0, left, right);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		SCOPED_TRACE(rgb[p]);
+
+		for (unsigned j = 0; j < width; ++j) {
+			T expected = j >= left && j < right ? sample_value<T>(j, rgb[p]) : 0;
+			ASSERT_EQ(expected, dst[p][j]) << j;
+		}
+	}
+}
+
+template <class T>
+void test_pack(unsigned width, GraphBuilder::PixelPacking packing, zimg::PixelType type, unsigned depth, T alpha, unsigned left, unsigned right)
+{
+	const char *order = channel_order(packing);
+	const unsigned channels = static_cast<unsigned>(std::strlen(order));
+	const char rgb[3] = { 'R', 'G', 'B' };
+
+	std::vector<T> src[3] = { std::vector<T>(width), std::vector<T>(width), std::vector<T>(width) };
+	std::vector<T> dst(width * channels);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned j = 0; j < width; ++j) {
+			src[p][j] = sample_value<T>(j, rgb[p]);
+		}
+	}
+
+	auto filter = zimg::graph::create_pack_filter(make_state(width, packing, type, depth), zimg::CPUClass::NONE);
+	ASSERT_TRUE(filter->get_flags().color);
+	ASSERT_FALSE(filter->get_flags().in_place);
+
+	zimg::graph::ImageBuffer<const void> src_buf[3];
+	zimg::graph::ImageBuffer<void> dst_buf[3] = { { dst.data(), 0, zimg::graph::BUFFER_MAX } };
+	for (unsigned p = 0; p < 3; ++p) {
+		src_buf[p] = { src[p].data(), 0, zimg::graph::BUFFER_MAX };
+	}
+
+	filter->process(nullptr, src_buf, dst_buf, nullptr, 0, left, right);
+
+	for (unsigned j = 0; j < width; ++j) {
+		for (unsigned k = 0; k < channels; ++k) {
+			SCOPED_TRACE(order[k]);
+
+			T expected = j < left || j >= right ? 0 : order[k] == 'A' ? alpha : sample_value<T>(j, order[k]);
+			ASSERT_EQ(expected, dst[j * channels + k]) << j;
+		}
+	}
+}
+
+template <class T>
+void test_deinterleave(unsigned width, zimg::PixelType type, unsigned stride, unsigned left, unsigned right)
+{
+	std::vector<T> src(width * stride);
+	std::vector<std::vector<T>> dst(stride, std::vector<T>(width));
+
+	for (unsigned j = 0; j < width * stride; ++j) {
+		src[j] = static_cast<T>(j + 1);
+	}
+
+	auto filter = zimg::graph::create_deinterleave_filter(width, 1, type, stride, zimg::CPUClass::NONE);
+	ASSERT_FALSE(filter->get_flags().color);
+
+	// The other samples are read through planes starting at later samples.
+	for (unsigned p = 0; p < stride; ++p) {
+		SCOPED_TRACE(p);
+
+		zimg::graph::ImageBuffer<const void> src_buf[3] = { { src.data() + p, 0, zimg::graph::BUFFER_MAX } };
+		zimg::graph::ImageBuffer<void> dst_buf[3] = { { dst[p].data(), 0, zimg::graph::BUFFER_MAX } };
+
+		filter->process(nullptr, src_buf, dst_buf, nullptr, 0, left, right);
+
+		for (unsigned j = 0; j < width; ++j) {
+			T expected = j >= left && j < right ? static_cast<T>(j * stride + p + 1) : 0;
+			ASSERT_EQ(expected, dst[p][j]) << j;
+		}
+	}
+}
+
+template <class T>
+void test_interleave(unsigned width, zimg::PixelType type, unsigned stride, unsigned left, unsigned right)
+{
+	std::vector<std::vector<T>> src(stride, std::vector<T>(width));
+	std::vector<T> dst(width * stride);
+
+	for (unsigned p = 0; p < stride; ++p) {
+		for (unsigned j = 0; j < width; ++j) {
+			src[p][j] = static_cast<T>(j * stride + p + 1);
+		}
+	}
+
+	auto filter = zimg::graph::create_interleave_filter(width, 1, type, stride, zimg::CPUClass::NONE);
+	ASSERT_FALSE(filter->get_flags().color);
+
+	for (unsigned p = 0; p < stride; ++p) {
+		zimg::graph::ImageBuffer<const void> src_buf[3] = { { src[p].data(), 0, zimg::graph::BUFFER_MAX } };
+		zimg::graph::ImageBuffer<void> dst_buf[3] = { { dst.data() + p, 0, zimg::graph::BUFFER_MAX } };
+
+		filter->process(nullptr, src_buf, dst_buf, nullptr, 0, left, right);
+	}
+
+	for (unsigned j = 0; j < width * stride; ++j) {
+		T expected = j / stride >= left && j / stride < right ? static_cast<T>(j + 1) : 0;
+		ASSERT_EQ(expected, dst[j]) << j;
+	}
+}
+
+// Samples of a 4:2:2 image, unique within each channel.
+uint16_t yuv_value(unsigned j, unsigned channel)
+{
+	return static_cast<uint16_t>((j * 37 + channel * 301 + 5) & 0x3FF);
+}
+
+// Reference v210 encoding of a row, with zero padding.
+std::vector<uint32_t> make_v210_row(unsigned width)
+{
+	std::vector<uint32_t> row((width + 5) / 6 * 4);
+
+	for (unsigned j = 0; j < width; ++j) {
+		unsigned group = j / 6;
+		unsigned n = j % 6;
+
+		// Luma samples are at odd positions and chroma at even positions of
+		// the sequence Cb Y Cr Y Cb Y Cr Y Cb Y Cr Y.
+		unsigned y_pos = n * 2 + 1;
+		row[group * 4 + y_pos / 3] |= static_cast<uint32_t>(yuv_value(j, 0)) << (y_pos % 3 * 10);
+
+		if (n % 2 == 0) {
+			for (unsigned c = 1; c < 3; ++c) {
+				unsigned pos = n * 2 + (c - 1) * 2;
+				row[group * 4 + pos / 3] |= static_cast<uint32_t>(yuv_value(j / 2, c)) << (pos % 3 * 10);
+			}
+		}
+	}
+	return row;
+}
+
+void test_v210_unpack(unsigned width)
+{
+	std::vector<uint32_t> src = make_v210_row(width);
+
+	// Set the unused bits, which must be ignored.
+	for (uint32_t &x : src) {
+		x |= 0xC0000000UL;
+	}
+
+	for (unsigned c = 0; c < 3; ++c) {
+		SCOPED_TRACE(c);
+
+		unsigned plane_width = c ? width / 2 : width;
+		std::vector<uint16_t> dst(plane_width);
+
+		auto filter = zimg::graph::create_v210_unpack_filter(plane_width, 1, c, zimg::CPUClass::NONE);
+		ASSERT_FALSE(filter->get_flags().color);
+
+		zimg::graph::ImageBuffer<const void> src_buf[3] = { { src.data(), 0, zimg::graph::BUFFER_MAX } };
+		zimg::graph::ImageBuffer<void> dst_buf[3] = { { dst.data(), 0, zimg::graph::BUFFER_MAX } };
+
+		filter->process(nullptr, src_buf, dst_buf, nullptr, 0, 0, plane_width);
+
+		for (unsigned j = 0; j < plane_width; ++j) {
+			ASSERT_EQ(yuv_value(j, c), dst[j]) << j;
+		}
+	}
+}
+
+void test_v210_pack(unsigned width)
+{
+	std::vector<uint32_t> expected = make_v210_row(width);
+	std::vector<uint32_t> dst(expected.size());
+
+	for (unsigned c = 0; c < 3; ++c) {
+		unsigned plane_width = c ? width / 2 : width;
+		std::vector<uint16_t> src(plane_width);
+
+		for (unsigned j = 0; j < plane_width; ++j) {
+			src[j] = yuv_value(j, c);
+		}
+
+		auto filter = zimg::graph::create_v210_pack_filter(plane_width, 1, c, zimg::CPUClass::NONE);
+		ASSERT_FALSE(filter->get_flags().color);
+
+		zimg::graph::ImageBuffer<const void> src_buf[3] = { { src.data(), 0, zimg::graph::BUFFER_MAX } };
+		zimg::graph::ImageBuffer<void> dst_buf[3] = { { dst.data(), 0, zimg::graph::BUFFER_MAX } };
+
+		filter->process(nullptr, src_buf, dst_buf, nullptr, 0, 0, plane_width);
+	}
+
+	for (size_t k = 0; k < expected.size(); ++k) {
+		ASSERT_EQ(expected[k], dst[k]) << k;
+	}
+}
+
+void test_y410(unsigned width)
+{
+	std::vector<uint32_t> packed(width);
+	std::vector<uint16_t> planes[3] = { std::vector<uint16_t>(width), std::vector<uint16_t>(width), std::vector<uint16_t>(width) };
+
+	for (unsigned j = 0; j < width; ++j) {
+		packed[j] = yuv_value(j, 1) | (static_cast<uint32_t>(yuv_value(j, 0)) << 10) | (static_cast<uint32_t>(yuv_value(j, 2)) << 20) | 0xC0000000UL;
+	}
+
+	auto unpack = zimg::graph::create_y410_unpack_filter(width, 1, zimg::CPUClass::NONE);
+	auto pack = zimg::graph::create_y410_pack_filter(width, 1, zimg::CPUClass::NONE);
+	ASSERT_TRUE(unpack->get_flags().color);
+	ASSERT_TRUE(pack->get_flags().color);
+
+	zimg::graph::ImageBuffer<const void> packed_buf[3] = { { packed.data(), 0, zimg::graph::BUFFER_MAX } };
+	zimg::graph::ImageBuffer<void> planes_buf[3];
+	for (unsigned p = 0; p < 3; ++p) {
+		planes_buf[p] = { planes[p].data(), 0, zimg::graph::BUFFER_MAX };
+	}
+
+	unpack->process(nullptr, packed_buf, planes_buf, nullptr, 0, 0, width);
+
+	for (unsigned p = 0; p < 3; ++p) {
+		for (unsigned j = 0; j < width; ++j) {
+			ASSERT_EQ(yuv_value(j, p), planes[p][j]) << p << ' ' << j;
+		}
+	}
+
+	std::vector<uint32_t> repacked(width);
+	zimg::graph::ImageBuffer<const void> planes_const_buf[3];
+	zimg::graph::ImageBuffer<void> repacked_buf[3] = { { repacked.data(), 0, zimg::graph::BUFFER_MAX } };
+	for (unsigned p = 0; p < 3; ++p) {
+		planes_const_buf[p] = { planes[p].data(), 0, zimg::graph::BUFFER_MAX };
+	}
+
+	pack->process(nullptr, planes_const_buf, repacked_buf, nullptr, 0, 0, width);
+	ASSERT_EQ(packed, repacked);
+}
+
+} // namespace
+
+
+TEST(PackedFilterTest, test_unpack)
+{
+	const unsigned w = 37;
+
+	for (GraphBuilder::PixelPacking packing : packings) {
+		SCOPED_TRACE(channel_order(packing));
+
+		test_unpack<uint8_t>(w, packing, zimg::PixelType::BYTE, 0, w);
+		test_unpack<uint16_t>(w, packing, zimg::PixelType::WORD, 0, w);
+		test_unpack<uint16_t>(w, packing, zimg::PixelType::HALF, 0, w);
+		test_unpack<uint32_t>(w, packing, zimg::PixelType::FLOAT, 0, w);
+	}
+}
+
+TEST(PackedFilterTest, test_pack)
+{
+	const unsigned w = 37;
+
+	for (GraphBuilder::PixelPacking packing : packings) {
+		SCOPED_TRACE(channel_order(packing));
+
+		test_pack<uint8_t>(w, packing, zimg::PixelType::BYTE, 8, 0xFFU, 0, w);
+		test_pack<uint16_t>(w, packing, zimg::PixelType::WORD, 10, 0x03FFU, 0, w);
+		test_pack<uint16_t>(w, packing, zimg::PixelType::HALF, 16, 0x3C00U, 0, w);
+		test_pack<uint32_t>(w, packing, zimg::PixelType::FLOAT, 32, 0x3F800000UL, 0, w);
+	}
+}
+
+TEST(PackedFilterTest, test_partial_row)
+{
+	const unsigned w = 37;
+
+	test_unpack<uint8_t>(w, GraphBuilder::PixelPacking::BGRA, zimg::PixelType::BYTE, 5, 29);
+	test_unpack<uint16_t>(w, GraphBuilder::PixelPacking::RGB, zimg::PixelType::WORD, 11, 12);
+	test_pack<uint8_t>(w, GraphBuilder::PixelPacking::BGR, zimg::PixelType::BYTE, 8, 0xFFU, 5, 29);
+	test_pack<uint16_t>(w, GraphBuilder::PixelPacking::ARGB, zimg::PixelType::WORD, 16, 0xFFFFU, 11, 12);
+}
+
+TEST(PackedFilterTest, test_deinterleave)
+{
+	const unsigned w = 37;
+
+	for (unsigned stride : { 2, 4 }) {
+		SCOPED_TRACE(stride);
+
+		test_deinterleave<uint8_t>(w, zimg::PixelType::BYTE, stride, 0, w);
+		test_deinterleave<uint16_t>(w, zimg::PixelType::WORD, stride, 0, w);
+		test_deinterleave<uint32_t>(w, zimg::PixelType::FLOAT, stride, 0, w);
+		test_deinterleave<uint16_t>(w, zimg::PixelType::WORD, stride, 11, 12);
+	}
+}
+
+TEST(PackedFilterTest, test_interleave)
+{
+	const unsigned w = 37;
+
+	for (unsigned stride : { 2, 4 }) {
+		SCOPED_TRACE(stride);
+
+		test_interleave<uint8_t>(w, zimg::PixelType::BYTE, stride, 0, w);
+		test_interleave<uint16_t>(w, zimg::PixelType::WORD, stride, 0, w);
+		test_interleave<uint32_t>(w, zimg::PixelType::FLOAT, stride, 0, w);
+		test_interleave<uint16_t>(w, zimg::PixelType::WORD, stride, 11, 12);
+	}
+}
+
+TEST(PackedFilterTest, test_v210)
+{
+	// Widths filling the last group and leaving it partial.
+	for (unsigned w : { 36, 40 }) {
+		SCOPED_TRACE(w);
+		test_v210_unpack(w);
+		test_v210_pack(w);
+	}
+}
+
+TEST(PackedFilterTest, test_y410)
+{
+	test_y410(37);
+}
@@ -0,0 +1,106 @@
+#include "common/pixel.h"
+#include "graph/graphbuilder.h"
+#include "graph/image_filter.h"
+#include "graph/specialized_filter.h"
+#include "resize/filter.h"
+
+#include "gtest/gtest.h"
+#include "filter_validator.h"
+
+namespace {
+
+using zimg::graph::GraphBuilder;
+
+GraphBuilder::state make_state(zimg::PixelType type, unsigned depth, bool fullrange, zimg::colorspace::MatrixCoefficients matrix)
+{
+	const unsigned w = 591;
+	const unsigned h = 333;
+
+	GraphBuilder::state state{};
+	state.width = w;
+	state.height = h;
+	state.type = type;
+	state.color = matrix == zimg::colorspace::MatrixCoefficients::RGB ? GraphBuilder::ColorFamily::RGB : GraphBuilder::ColorFamily::YUV;
+	state.colorspace = { matrix, zimg::colorspace::TransferCharacteristics::REC_709, zimg::colorspace::ColorPrimaries::REC_709 };
+	state.depth = depth;
+	state.fullrange = fullrange;
+	state.active_width = w;
+	state.active_height = h;
+	return state;
+}
+
+void test_case(const GraphBuilder::state &source, const GraphBuilder::state &target, const char * const expected_sha1[3])
+{
+	auto filter = zimg::graph::create_specialized_filter(source, target, nullptr);
+	ASSERT_TRUE(filter);
+
+	FilterValidator validator{ filter.get(), source.width, source.height, { source.type, source.depth, source.fullrange } };
+	validator.set_sha1(expected_sha1)
+	         .set_yuv(source.color == GraphBuilder::ColorFamily::YUV)
+	         .validate();
+}
+
+} // namespace
+
+
+TEST(SpecializedFilterTest, test_integer_matrix)
+{
+	using zimg::PixelType;
+	using zimg::colorspace::MatrixCoefficients;
+
+	const char *expected_sha1[][3] = {
+		{
+			"c298a5bb59ba4b038c416b45754b1981208d3400",
+			"074a286ad7373bc10360e4a731175d2dddd142ef",
+			"f43931d342f0a089256a27fafd65639f0abf6325"
+		},
+		{
+			"44a0455344a8013faa2fcb8992ef72ecc6f9c4cc",
+			"fc3a480ba14ba66bc7b0b6d820fb1348b3eb1a90",
+			"16aac8adff991c1d4939d3dc3b61ea9bd33477d7"
+		},
+		{
+			"cc2678bfed75e19982c939c2623fabfbeb54e85b",
+			"9bc1779bb70daea5d6d2b984675024a5ab405750",
+			"e3d21f17dd4d3cb4b89bd867b7022897c2fd4211"
+		},
+	};
+
+	SCOPED_TRACE("rgb->709 8-bit");
+	test_case(make_state(PixelType::BYTE, 8, true, MatrixCoefficients::RGB),
+	          make_state(PixelType::BYTE, 8, false, MatrixCoefficients::REC_709),
+	          expected_sha1[0]);
+	SCOPED_TRACE("709 10-bit->rgb 8-bit");
+	test_case(make_state(PixelType::WORD, 10, false, MatrixCoefficients::REC_709),
+	          make_state(PixelType::BYTE, 8, true, MatrixCoefficients::RGB),
+	          expected_sha1[1]);
+	SCOPED_TRACE("601->709 16-bit");
+	test_case(make_state(PixelType::WORD, 16, false, MatrixCoefficients::REC_601),
+	          make_state(PixelType::WORD, 16, false, MatrixCoefficients::REC_709),
+	          expected_sha1[2]);
+}
+
+TEST(SpecializedFilterTest, test_no_match)
+{
+	using zimg::PixelType;
+	using zimg::colorspace::MatrixCoefficients;
+
+	GraphBuilder::state source = make_state(PixelType::BYTE, 8, false, MatrixCoefficients::REC_709);
+	GraphBuilder::state target = make_state(PixelType::BYTE, 8, true, MatrixCoefficients::RGB);
+	GraphBuilder::params params;
+
+	params.dither_type = zimg::depth::DitherType::ORDERED;
+	EXPECT_FALSE(zimg::graph::create_specialized_filter(source, target, &params));
+
+	source.subsample_w = 1;
+	EXPECT_FALSE(zimg::graph::create_specialized_filter(source, target, nullptr));
+
+	source.subsample_w = 0;
+	target.type = PixelType::FLOAT;
+	target.depth = 32;
+	EXPECT_FALSE(zimg::graph::create_specialized_filter(source, target, nullptr));
+
+	target = make_state(PixelType::BYTE, 8, true, MatrixCoefficients::RGB);
+	target.colorspace.transfer = zimg::colorspace::TransferCharacteristics::ST_2084;
+	EXPECT_FALSE(zimg::graph::create_specialized_filter(source, target, nullptr));
+}
@@ -0,0 +1,93 @@
+#ifdef ZIMG_X86_AVX512
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "common/make_unique.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "depth/depth.h"
+#include "graph/filtergraph.h"
+#include "graph/graphbuilder.h"
+#include "graph/image_buffer.h"
+#include "resize/filter.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using zimg::graph::GraphBuilder;
+
+GraphBuilder::state make_state(unsigned width, unsigned height, zimg::PixelType type, unsigned depth)
+{
+	GraphBuilder::state state{};
+	state.width = width;
+	state.height = height;
+	state.type = type;
+	state.color = GraphBuilder::ColorFamily::GREY;
+	state.depth = depth;
+	state.fullrange = false;
+	state.active_width = width;
+	state.active_height = height;
+	return state;
+}
+
+std::unique_ptr<zimg::graph::FilterGraph> build_graph(const GraphBuilder::state &source, const GraphBuilder::state &target, bool fusion)
+{
+	GraphBuilder::params params;
+	params.filter = ztd::make_unique<zimg::resize::BicubicFilter>(1.0 / 3.0, 1.0 / 3.0);
+	params.dither_type = zimg::depth::DitherType::ORDERED;
+	params.cpu = zimg::CPUClass::X86_AVX512;
+	params.disable_fusion = !fusion;
+
+	return GraphBuilder{}.set_source(source).connect_graph(target, &params).complete_graph();
+}
+
+zimg::AlignedVector<uint8_t> process_graph(const zimg::graph::FilterGraph &graph, const zimg::AlignedVector<uint16_t> &src, ptrdiff_t src_stride, ptrdiff_t dst_stride, unsigned dst_height)
+{
+	zimg::AlignedVector<uint8_t> dst(dst_stride * dst_height);
+	zimg::AlignedVector<char> tmp(graph.get_tmp_size());
+
+	zimg::graph::ImageBuffer<const void> src_buf[3] = { { src.data(), src_stride, zimg::graph::BUFFER_MAX } };
+	zimg::graph::ImageBuffer<void> dst_buf[3] = { { dst.data(), dst_stride, zimg::graph::BUFFER_MAX } };
+	graph.process(src_buf, dst_buf, tmp.data(), nullptr, nullptr);
+	return dst;
+}
+
+} // namespace
+
+
+TEST(GraphBuilderAVX512Test, test_resize_h_dither_not_fused)
+{
+	if (!zimg::query_x86_capabilities().avx512f) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	// The horizontal resizer produces 32 lines per call, exceeding the limit
+	// for the first stage of a fused filter. The width is not a multiple of
+	// the vector length, so that the scalar tail of the resizer is exercised.
+	const GraphBuilder::state source = make_state(1279, 97, zimg::PixelType::WORD, 16);
+	const GraphBuilder::state target = make_state(853, 97, zimg::PixelType::BYTE, 8);
+	const ptrdiff_t src_stride = zimg::ceil_n(source.width * sizeof(uint16_t), zimg::ALIGNMENT);
+	const ptrdiff_t dst_stride = zimg::ceil_n(target.width, zimg::ALIGNMENT);
+
+	std::mt19937 engine;
+	std::uniform_int_distribution<unsigned> dist{ 0, UINT16_MAX };
+
+	zimg::AlignedVector<uint16_t> src(src_stride / sizeof(uint16_t) * source.height);
+	std::generate(src.begin(), src.end(), [&]() { return static_cast<uint16_t>(dist(engine)); });
+
+	auto fused = build_graph(source, target, true);
+	auto unfused = build_graph(source, target, false);
+	EXPECT_EQ(unfused->get_filter_count(), fused->get_filter_count());
+
+	auto fused_dst = process_graph(*fused, src, src_stride, dst_stride, target.height);
+	auto unfused_dst = process_graph(*unfused, src, src_stride, dst_stride, target.height);
+	EXPECT_TRUE(fused_dst == unfused_dst);
+}
+
+#endif // ZIMG_X86_AVX512
@@ -0,0 +1,328 @@
+#ifdef ZIMG_X86
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/graphbuilder.h"
+#include "graph/image_buffer.h"
+#include "graph/image_filter.h"
+#include "graph/packed_filter.h"
+
+#include "gtest/gtest.h"
+#include "graph/filter_validator.h"
+
+namespace {
+
+using zimg::graph::GraphBuilder;
+
+const GraphBuilder::PixelPacking packings[] = {
+	GraphBuilder::PixelPacking::RGB,
+	GraphBuilder::PixelPacking::BGR,
+	GraphBuilder::PixelPacking::RGBA,
+	GraphBuilder::PixelPacking::BGRA,
+	GraphBuilder::PixelPacking::ARGB,
+	GraphBuilder::PixelPacking::ABGR,
+};
+
+const zimg::PixelType types[] = { zimg::PixelType::BYTE, zimg::PixelType::WORD, zimg::PixelType::HALF, zimg::PixelType::FLOAT };
+
+// Spans starting and ending at odd columns exercise the scalar edges.
+const std::pair<unsigned, unsigned> spans[] = { { 0, 591 }, { 3, 590 }, { 64, 129 }, { 7, 9 } };
+
+void test_case(GraphBuilder::PixelPacking packing, zimg::PixelType type, bool pack)
+{
+	const unsigned w = 591;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	GraphBuilder::state state{};
+	state.width = w;
+	state.height = 1;
+	state.type = type;
+	state.packing = packing;
+	state.color = GraphBuilder::ColorFamily::RGB;
+	state.depth = zimg::pixel_depth(type);
+	state.fullrange = true;
+
+	auto create = pack ? zimg::graph::create_pack_filter : zimg::graph::create_unpack_filter;
+	auto filter_c = create(state, zimg::CPUClass::NONE);
+	auto filter_avx2 = create(state, zimg::CPUClass::X86_AVX2);
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_avx2.get()));
+
+	size_t row_size = zimg::graph::packed_row_size(packing, w, type);
+	size_t plane_size = w * zimg::pixel_size(type);
+
+	std::vector<uint8_t> src_data[3];
+	std::mt19937 engine;
+
+	for (unsigned p = 0; p < (pack ? 3U : 1U); ++p) {
+		src_data[p].resize(pack ? plane_size : row_size);
+
+		for (uint8_t &x : src_data[p]) {
+			x = static_cast<uint8_t>(engine());
+		}
+	}
+
+	for (const auto &span : spans) {
+		SCOPED_TRACE(span.first);
+		SCOPED_TRACE(span.second);
+
+		std::vector<uint8_t> dst_c[3];
+		std::vector<uint8_t> dst_avx2[3];
+		zimg::graph::ImageBuffer<const void> src_buf[3];
+		zimg::graph::ImageBuffer<void> dst_buf_c[3];
+		zimg::graph::ImageBuffer<void> dst_buf_avx2[3];
+
+		for (unsigned p = 0; p < (pack ? 3U : 1U); ++p) {
+			src_buf[p] = { src_data[p].data(), 0, zimg::graph::BUFFER_MAX };
+		}
+		for (unsigned p = 0; p < (pack ? 1U : 3U); ++p) {
+			dst_c[p].resize(pack ? row_size : plane_size);
+			dst_avx2[p].resize(pack ? row_size : plane_size);
+			dst_buf_c[p] = { dst_c[p].data(), 0, zimg::graph::BUFFER_MAX };
+			dst_buf_avx2[p] = { dst_avx2[p].data(), 0, zimg::graph::BUFFER_MAX };
+		}
+
+		filter_c->process(nullptr, src_buf, dst_buf_c, nullptr, 0, span.first, span.second);
+		filter_avx2->process(nullptr, src_buf, dst_buf_avx2, nullptr, 0, span.first, span.second);
+
+		for (unsigned p = 0; p < 3; ++p) {
+			ASSERT_EQ(dst_c[p], dst_avx2[p]) << p;
+		}
+	}
+}
+
+void test_interleaved_case(zimg::PixelType type, unsigned stride, bool interleave)
+{
+	const unsigned w = 591;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	auto create = interleave ? zimg::graph::create_interleave_filter : zimg::graph::create_deinterleave_filter;
+	auto filter_c = create(w, 1, type, stride, zimg::CPUClass::NONE);
+	auto filter_avx2 = create(w, 1, type, stride, zimg::CPUClass::X86_AVX2);
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_avx2.get()));
+
+	// Both buffers hold one plane per sample of the stride: the separate planes
+	// back to back, or the interleaved plane offset by each sample.
+	size_t sample_size = zimg::pixel_size(type);
+	size_t plane_size = w * sample_size;
+	std::vector<uint8_t> src_data(plane_size * stride);
+	std::vector<uint8_t> dst_init(plane_size * stride);
+	std::mt19937 engine;
+
+	for (uint8_t &x : src_data) {
+		x = static_cast<uint8_t>(engine());
+	}
+	for (uint8_t &x : dst_init) {
+		x = static_cast<uint8_t>(engine());
+	}
+
+	for (const auto &span : spans) {
+		SCOPED_TRACE(span.first);
+		SCOPED_TRACE(span.second);
+
+		std::vector<uint8_t> dst_c = dst_init;
+		std::vector<uint8_t> dst_avx2 = dst_init;
+
+		for (unsigned p = 0; p < stride; ++p) {
+			size_t src_offset = p * (interleave ? plane_size : sample_size);
+			size_t dst_offset = p * (interleave ? sample_size : plane_size);
+
+			zimg::graph::ImageBuffer<const void> src_buf[3] = { { src_data.data() + src_offset, 0, zimg::graph::BUFFER_MAX } };
+			zimg::graph::ImageBuffer<void> dst_buf_c[3] = { { dst_c.data() + dst_offset, 0, zimg::graph::BUFFER_MAX } };
+			zimg::graph::ImageBuffer<void> dst_buf_avx2[3] = { { dst_avx2.data() + dst_offset, 0, zimg::graph::BUFFER_MAX } };
+
+			filter_c->process(nullptr, src_buf, dst_buf_c, nullptr, 0, span.first, span.second);
+			filter_avx2->process(nullptr, src_buf, dst_buf_avx2, nullptr, 0, span.first, span.second);
+
+			ASSERT_EQ(dst_c, dst_avx2) << p;
+		}
+	}
+}
+
+void test_v210_case(unsigned channel, bool pack)
+{
+	const unsigned w = 590;
+	const unsigned plane_width = channel ? w / 2 : w;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	auto create = pack ? zimg::graph::create_v210_pack_filter : zimg::graph::create_v210_unpack_filter;
+	auto filter_c = create(plane_width, 1, channel, zimg::CPUClass::NONE);
+	auto filter_avx2 = create(plane_width, 1, channel, zimg::CPUClass::X86_AVX2);
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_avx2.get()));
+
+	size_t row_size = zimg::graph::packed_row_size(GraphBuilder::PixelPacking::V210, w, zimg::PixelType::WORD);
+	size_t plane_size = plane_width * sizeof(uint16_t);
+	std::vector<uint8_t> src_data(pack ? plane_size : row_size);
+	std::vector<uint8_t> dst_init(pack ? row_size : plane_size);
+	std::mt19937 engine;
+
+	for (uint8_t &x : src_data) {
+		x = static_cast<uint8_t>(engine());
+	}
+	for (uint8_t &x : dst_init) {
+		x = static_cast<uint8_t>(engine());
+	}
+
+	// Spans starting and ending within a group exercise the scalar edges.
+	const std::pair<unsigned, unsigned> v210_spans[] = { { 0, plane_width }, { 5, plane_width - 4 }, { 31, 97 }, { 7, 9 } };
+
+	for (const auto &span : v210_spans) {
+		SCOPED_TRACE(span.first);
+		SCOPED_TRACE(span.second);
+
+		std::vector<uint8_t> dst_c = dst_init;
+		std::vector<uint8_t> dst_avx2 = dst_init;
+
+		zimg::graph::ImageBuffer<const void> src_buf[3] = { { src_data.data(), 0, zimg::graph::BUFFER_MAX } };
+		zimg::graph::ImageBuffer<void> dst_buf_c[3] = { { dst_c.data(), 0, zimg::graph::BUFFER_MAX } };
+		zimg::graph::ImageBuffer<void> dst_buf_avx2[3] = { { dst_avx2.data(), 0, zimg::graph::BUFFER_MAX } };
+
+		filter_c->process(nullptr, src_buf, dst_buf_c, nullptr, 0, span.first, span.second);
+		filter_avx2->process(nullptr, src_buf, dst_buf_avx2, nullptr, 0, span.first, span.second);
+
+		ASSERT_EQ(dst_c, dst_avx2);
+	}
+}
+
+void test_y410_case(bool pack)
+{
+	const unsigned w = 591;
+
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	auto create = pack ? zimg::graph::create_y410_pack_filter : zimg::graph::create_y410_unpack_filter;
+	auto filter_c = create(w, 1, zimg::CPUClass::NONE);
+	auto filter_avx2 = create(w, 1, zimg::CPUClass::X86_AVX2);
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_avx2.get()));
+
+	size_t row_size = zimg::graph::packed_row_size(GraphBuilder::PixelPacking::Y410, w, zimg::PixelType::WORD);
+	size_t plane_size = w * sizeof(uint16_t);
+
+	std::vector<uint8_t> src_data[3];
+	std::mt19937 engine;
+
+	for (unsigned p = 0; p < (pack ? 3U : 1U); ++p) {
+		src_data[p].resize(pack ? plane_size : row_size);
+
+		for (uint8_t &x : src_data[p]) {
+			x = static_cast<uint8_t>(engine());
+		}
+	}
+
+	for (const auto &span : spans) {
+		SCOPED_TRACE(span.first);
+		SCOPED_TRACE(span.second);
+
+		std::vector<uint8_t> dst_c[3];
+		std::vector<uint8_t> dst_avx2[3];
+		zimg::graph::ImageBuffer<const void> src_buf[3];
+		zimg::graph::ImageBuffer<void> dst_buf_c[3];
+		zimg::graph::ImageBuffer<void> dst_buf_avx2[3];
+
+		for (unsigned p = 0; p < (pack ? 3U : 1U); ++p) {
+			src_buf[p] = { src_data[p].data(), 0, zimg::graph::BUFFER_MAX };
+		}
+		for (unsigned p = 0; p < (pack ? 1U : 3U); ++p) {
+			dst_c[p].resize(pack ? row_size : plane_size);
+			dst_avx2[p].resize(pack ? row_size : plane_size);
+			dst_buf_c[p] = { dst_c[p].data(), 0, zimg::graph::BUFFER_MAX };
+			dst_buf_avx2[p] = { dst_avx2[p].data(), 0, zimg::graph::BUFFER_MAX };
+		}
+
+		filter_c->process(nullptr, src_buf, dst_buf_c, nullptr, 0, span.first, span.second);
+		filter_avx2->process(nullptr, src_buf, dst_buf_avx2, nullptr, 0, span.first, span.second);
+
+		for (unsigned p = 0; p < 3; ++p) {
+			ASSERT_EQ(dst_c[p], dst_avx2[p]) << p;
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(PackedFilterAVX2Test, test_unpack)
+{
+	for (GraphBuilder::PixelPacking packing : packings) {
+		for (zimg::PixelType type : types) {
+			SCOPED_TRACE(static_cast<int>(packing));
+			SCOPED_TRACE(static_cast<int>(type));
+			test_case(packing, type, false);
+		}
+	}
+}
+
+TEST(PackedFilterAVX2Test, test_pack)
+{
+	for (GraphBuilder::PixelPacking packing : packings) {
+		for (zimg::PixelType type : types) {
+			SCOPED_TRACE(static_cast<int>(packing));
+			SCOPED_TRACE(static_cast<int>(type));
+			test_case(packing, type, true);
+		}
+	}
+}
+
+TEST(PackedFilterAVX2Test, test_deinterleave)
+{
+	for (zimg::PixelType type : types) {
+		SCOPED_TRACE(static_cast<int>(type));
+		test_interleaved_case(type, 2, false);
+		test_interleaved_case(type, 4, false);
+	}
+}
+
+TEST(PackedFilterAVX2Test, test_interleave)
+{
+	for (zimg::PixelType type : types) {
+		SCOPED_TRACE(static_cast<int>(type));
+		test_interleaved_case(type, 2, true);
+		test_interleaved_case(type, 4, true);
+	}
+}
+
+TEST(PackedFilterAVX2Test, test_v210_unpack)
+{
+	for (unsigned channel = 0; channel < 3; ++channel) {
+		SCOPED_TRACE(channel);
+		test_v210_case(channel, false);
+	}
+}
+
+TEST(PackedFilterAVX2Test, test_v210_pack)
+{
+	for (unsigned channel = 0; channel < 3; ++channel) {
+		SCOPED_TRACE(channel);
+		test_v210_case(channel, true);
+	}
+}
+
+TEST(PackedFilterAVX2Test, test_y410_unpack)
+{
+	test_y410_case(false);
+}
+
+TEST(PackedFilterAVX2Test, test_y410_pack)
+{
+	test_y410_case(true);
+}
+
+#endif // ZIMG_X86
@@ -0,0 +1,96 @@
+#ifdef ZIMG_X86
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/image_buffer.h"
+#include "graph/image_filter.h"
+#include "graph/packed_filter.h"
+
+#include "gtest/gtest.h"
+#include "graph/filter_validator.h"
+
+namespace {
+
+const zimg::PixelType types[] = { zimg::PixelType::BYTE, zimg::PixelType::WORD, zimg::PixelType::HALF, zimg::PixelType::FLOAT };
+
+// Spans starting and ending at odd columns exercise the scalar edges.
+const std::pair<unsigned, unsigned> spans[] = { { 0, 591 }, { 3, 590 }, { 64, 129 }, { 7, 9 } };
+
+void test_interleaved_case(zimg::PixelType type, unsigned stride, bool interleave)
+{
+	const unsigned w = 591;
+
+	if (!zimg::query_x86_capabilities().sse2) {
+		SUCCEED() << "sse2 not available, skipping";
+		return;
+	}
+
+	auto create = interleave ? zimg::graph::create_interleave_filter : zimg::graph::create_deinterleave_filter;
+	auto filter_c = create(w, 1, type, stride, zimg::CPUClass::NONE);
+	auto filter_sse2 = create(w, 1, type, stride, zimg::CPUClass::X86_SSE2);
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_sse2.get()));
+
+	// Both buffers hold one plane per sample of the stride: the separate planes
+	// back to back, or the interleaved plane offset by each sample.
+	size_t sample_size = zimg::pixel_size(type);
+	size_t plane_size = w * sample_size;
+	std::vector<uint8_t> src_data(plane_size * stride);
+	std::vector<uint8_t> dst_init(plane_size * stride);
+	std::mt19937 engine;
+
+	for (uint8_t &x : src_data) {
+		x = static_cast<uint8_t>(engine());
+	}
+	for (uint8_t &x : dst_init) {
+		x = static_cast<uint8_t>(engine());
+	}
+
+	for (const auto &span : spans) {
+		SCOPED_TRACE(span.first);
+		SCOPED_TRACE(span.second);
+
+		std::vector<uint8_t> dst_c = dst_init;
+		std::vector<uint8_t> dst_sse2 = dst_init;
+
+		for (unsigned p = 0; p < stride; ++p) {
+			size_t src_offset = p * (interleave ? plane_size : sample_size);
+			size_t dst_offset = p * (interleave ? sample_size : plane_size);
+
+			zimg::graph::ImageBuffer<const void> src_buf[3] = { { src_data.data() + src_offset, 0, zimg::graph::BUFFER_MAX } };
+			zimg::graph::ImageBuffer<void> dst_buf_c[3] = { { dst_c.data() + dst_offset, 0, zimg::graph::BUFFER_MAX } };
+			zimg::graph::ImageBuffer<void> dst_buf_sse2[3] = { { dst_sse2.data() + dst_offset, 0, zimg::graph::BUFFER_MAX } };
+
+			filter_c->process(nullptr, src_buf, dst_buf_c, nullptr, 0, span.first, span.second);
+			filter_sse2->process(nullptr, src_buf, dst_buf_sse2, nullptr, 0, span.first, span.second);
+
+			ASSERT_EQ(dst_c, dst_sse2) << p;
+		}
+	}
+}
+
+} // namespace
+
+
+TEST(PackedFilterSSE2Test, test_deinterleave)
+{
+	for (zimg::PixelType type : types) {
+		SCOPED_TRACE(static_cast<int>(type));
+		test_interleaved_case(type, 2, false);
+		test_interleaved_case(type, 4, false);
+	}
+}
+
+TEST(PackedFilterSSE2Test, test_interleave)
+{
+	for (zimg::PixelType type : types) {
+		SCOPED_TRACE(static_cast<int>(type));
+		test_interleaved_case(type, 2, true);
+		test_interleaved_case(type, 4, true);
+	}
+}
+
+#endif // ZIMG_X86
@@ -0,0 +1,102 @@
+#ifdef ZIMG_X86
+
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/graphbuilder.h"
+#include "graph/image_filter.h"
+#include "graph/specialized_filter.h"
+#include "resize/filter.h"
+
+#include "gtest/gtest.h"
+#include "graph/filter_validator.h"
+
+namespace {
+
+using zimg::graph::GraphBuilder;
+
+GraphBuilder::state make_state(zimg::PixelType type, unsigned depth, bool fullrange, zimg::colorspace::MatrixCoefficients matrix)
+{
+	const unsigned w = 591;
+	const unsigned h = 333;
+
+	GraphBuilder::state state{};
+	state.width = w;
+	state.height = h;
+	state.type = type;
+	state.color = matrix == zimg::colorspace::MatrixCoefficients::RGB ? GraphBuilder::ColorFamily::RGB : GraphBuilder::ColorFamily::YUV;
+	state.colorspace = { matrix, zimg::colorspace::TransferCharacteristics::REC_709, zimg::colorspace::ColorPrimaries::REC_709 };
+	state.depth = depth;
+	state.fullrange = fullrange;
+	state.active_width = w;
+	state.active_height = h;
+	return state;
+}
+
+void test_case(const GraphBuilder::state &source, const GraphBuilder::state &target, const char * const expected_sha1[3], double expected_snr)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	GraphBuilder::params params;
+	params.specialized_kernels = true;
+
+	params.cpu = zimg::CPUClass::NONE;
+	auto filter_c = zimg::graph::create_specialized_filter(source, target, &params);
+	params.cpu = zimg::CPUClass::X86_AVX2;
+	auto filter_avx2 = zimg::graph::create_specialized_filter(source, target, &params);
+	ASSERT_TRUE(filter_c);
+	ASSERT_TRUE(filter_avx2);
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_avx2.get()));
+
+	FilterValidator validator{ filter_avx2.get(), source.width, source.height, { source.type, source.depth, source.fullrange } };
+	validator.set_sha1(expected_sha1)
+	         .set_ref_filter(filter_c.get(), expected_snr)
+	         .set_yuv(source.color == GraphBuilder::ColorFamily::YUV)
+	         .validate();
+}
+
+} // namespace
+
+
+TEST(SpecializedFilterAVX2Test, test_integer_matrix)
+{
+	using zimg::PixelType;
+	using zimg::colorspace::MatrixCoefficients;
+
+	const char *expected_sha1[][3] = {
+		{
+			"49cad246ab85eff54d7dda10e14c020d6f82c561",
+			"223f8e1fe6de1592786638f34bbb2bc78e23e224",
+			"f43931d342f0a089256a27fafd65639f0abf6325"
+		},
+		{
+			"df954a3390636024d5b0a7a17d1e938e57239c0a",
+			"fc3a480ba14ba66bc7b0b6d820fb1348b3eb1a90",
+			"16aac8adff991c1d4939d3dc3b61ea9bd33477d7"
+		},
+		{
+			"f386860b7ab5509da60b203aee679b4b51ff45d4",
+			"1be813ad7b6a663d64a37deb578e874d334262f6",
+			"c7195f07d314daff961bfba45eaec6bfaf23d0a4"
+		},
+	};
+	const double expected_snr = 120.0;
+
+	SCOPED_TRACE("rgb->709 8-bit");
+	test_case(make_state(PixelType::BYTE, 8, true, MatrixCoefficients::RGB),
+	          make_state(PixelType::BYTE, 8, false, MatrixCoefficients::REC_709),
+	          expected_sha1[0], expected_snr);
+	SCOPED_TRACE("709 10-bit->rgb 8-bit");
+	test_case(make_state(PixelType::WORD, 10, false, MatrixCoefficients::REC_709),
+	          make_state(PixelType::BYTE, 8, true, MatrixCoefficients::RGB),
+	          expected_sha1[1], expected_snr);
+	SCOPED_TRACE("601->709 16-bit");
+	test_case(make_state(PixelType::WORD, 16, false, MatrixCoefficients::REC_601),
+	          make_state(PixelType::WORD, 16, false, MatrixCoefficients::REC_709),
+	          expected_sha1[2], expected_snr);
+}
+
+#endif // ZIMG_X86
@@ -0,0 +1,169 @@
+#ifdef ZIMG_GENERIC_SIMD
+
+#include <cmath>
+#include <memory>
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "graph/image_filter.h"
+#include "resize/filter.h"
+#include "resize/resize_impl.h"
+
+#include "gtest/gtest.h"
+#include "graph/filter_validator.h"
+
+namespace {
+
+void test_case(const zimg::resize::Filter &filter, bool horizontal, unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h,
+               const zimg::PixelFormat &format, const char * const expected_sha1[3], double expected_snr)
+{
+	SCOPED_TRACE(filter.support());
+	SCOPED_TRACE(horizontal ? static_cast<double>(dst_w) / src_w : static_cast<double>(dst_h) / src_h);
+
+	auto builder = zimg::resize::ResizeImplBuilder{ src_w, src_h, format.type }
+		.set_horizontal(horizontal)
+		.set_dst_dim(horizontal ? dst_w : dst_h)
+		.set_depth(format.depth)
+		.set_filter(&filter)
+		.set_shift(0.0)
+		.set_subwidth(horizontal ? src_w : src_h);
+
+	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	auto filter_simd = builder.set_cpu(zimg::CPUClass::GENERIC_SIMD).create();
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_simd.get()));
+
+	FilterValidator validator{ filter_simd.get(), src_w, src_h, format };
+	validator.set_sha1(expected_sha1)
+	         .set_ref_filter(filter_c.get(), expected_snr)
+	         .validate();
+}
+
+} // namespace
+
+
+TEST(ResizeImplGenericSIMDTest, test_resize_h_u8)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 960;
+	const unsigned h = 480;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	const char *expected_sha1[][3] = {
+		{ "d25af586a747c02b3f07d17168ecba710f570957" },
+		{ "9fac889f1f1cf657304f7ce98d7b084abcea4555" },
+		{ "b87a817d682b4b86e68bcc3340a0bfbeb24149b1" },
+		{ "7113b2c9468bc4b8d748cf48e4e808f4ba2a178c" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, true, src_w, h, dst_w, h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, src_w, h, dst_w, h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
+}
+
+TEST(ResizeImplGenericSIMDTest, test_resize_h_u16)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 960;
+	const unsigned h = 480;
+	const zimg::PixelFormat format{ zimg::PixelType::WORD, 16 };
+
+	const char *expected_sha1[][3] = {
+		{ "a6b7fea8f8de785248f520f605bd7c8da66f59d5" },
+		{ "810c906d2b2b5e17703b220d64f9d3c10690cc16" },
+		{ "b74758c6d844da2d1acf48bbc75459533f47eb9f" },
+		{ "779236bf9e1d646caa8b384b283c6dfea1e12dff" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, true, src_w, h, dst_w, h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, src_w, h, dst_w, h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
+}
+
+TEST(ResizeImplGenericSIMDTest, test_resize_h_f32)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 960;
+	const unsigned h = 480;
+	const zimg::PixelFormat format = zimg::PixelType::FLOAT;
+
+	const char *expected_sha1[][3] = {
+		{ "1b2e37a345d315b0fa4d11e3532c70cb57b1e569" },
+		{ "888a6c69c5fb1cd26aabc31c4903ff37bb64a2dd" },
+		{ "b1fe8c492b130357abda4f942fac1ff87c9bf6dc" },
+		{ "5edc3167d96b32f805a748b02f49bb55c250defe" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, true, src_w, h, dst_w, h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, src_w, h, dst_w, h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
+}
+
+TEST(ResizeImplGenericSIMDTest, test_resize_v_u8)
+{
+	const unsigned w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 720;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	const char *expected_sha1[][3] = {
+		{ "08d0ac1e90d884a0da4b9dae5cede654e33fdc75" },
+		{ "41654c038c26c15b408366993257a9bdca5a8d73" },
+		{ "d1a168cacbe9ce4321c716cf2ce73af31ccbfdbc" },
+		{ "17569d3afa2d4072372a0157b3bdb150ad4ab9e2" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, false, w, src_h, w, dst_h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, src_h, w, dst_h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[3], expected_snr);
+}
+
+TEST(ResizeImplGenericSIMDTest, test_resize_v_u16)
+{
+	const unsigned w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 720;
+	const zimg::PixelFormat format{ zimg::PixelType::WORD, 16 };
+
+	const char *expected_sha1[][3] = {
+		{ "fbde3fbb93720f073dcc8579bc17edf6c2cab982" },
+		{ "2e0b375e7014b842016e7db4fb62ecf96bb230d7" },
+		{ "5f9d6c73f468d1cbfb2bc850828dd0ac9f05193d" },
+		{ "9747a61169a63015fd8491b566c5f3e577f7e93e" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, false, w, src_h, w, dst_h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, src_h, w, dst_h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[3], expected_snr);
+}
+
+TEST(ResizeImplGenericSIMDTest, test_resize_v_f32)
+{
+	const unsigned w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 720;
+	const zimg::PixelFormat format = zimg::PixelType::FLOAT;
+
+	const char *expected_sha1[][3] = {
+		{ "6b7507617dc89d5d3077f9cc4c832b261dea2be0" },
+		{ "7baab9856db54af192c456f64cd4f429a417ed4b" },
+		{ "221b53af0005046d2ebad0bae842e90a0bd78d5a" },
+		{ "bc4cd75a9267f012bbd3f012a5c33ad40e1f8b70" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, false, w, src_h, w, dst_h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, src_h, w, dst_h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[3], expected_snr);
+}
+
+#endif // ZIMG_GENERIC_SIMD
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
@@ -249,3 +250,25 @@ TEST(ResizeImplTest, test_vertical_shift)
 	SCOPED_TRACE("down");
 	test_case(zimg::PixelType::FLOAT, false, 1.0 / 2.1, shift, subwidth_factor, expected_sha1_down);
 }
+
+TEST(ResizeImplTest, test_shared_filter)
+{
+	const zimg::resize::BicubicFilter bicubic1{ 0.0, 0.5 };
+	const zimg::resize::BicubicFilter bicubic2{ 0.0, 0.5 };
+	const zimg::resize::BicubicFilter bicubic3{ 1.0 / 3.0, 1.0 / 3.0 };
+
+	auto filter1 = zimg::resize::compute_filter_shared(bicubic1, 640, 480, 0.0, 640.0);
+	auto filter2 = zimg::resize::compute_filter_shared(bicubic2, 640, 480, 0.0, 640.0);
+	auto filter3 = zimg::resize::compute_filter_shared(bicubic3, 640, 480, 0.0, 640.0);
+	auto filter4 = zimg::resize::compute_filter_shared(bicubic1, 640, 480, 0.25, 640.0);
+
+	EXPECT_EQ(filter1, filter2);
+	EXPECT_NE(filter1, filter3);
+	EXPECT_NE(filter1, filter4);
+
+	zimg::resize::FilterContext expected = zimg::resize::compute_filter(bicubic1, 640, 480, 0.0, 640.0);
+	ASSERT_EQ(expected.filter_rows, filter1->filter_rows);
+	ASSERT_EQ(expected.filter_width, filter1->filter_width);
+	EXPECT_TRUE(std::equal(expected.data.begin(), expected.data.end(), filter1->data.begin()));
+	EXPECT_TRUE(std::equal(expected.left.begin(), expected.left.end(), filter1->left.begin()));
+}
@@ -4,6 +4,7 @@
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "common/x86/cpuinfo_x86.h"
+#include "depth/quantize.h"
 #include "resize/filter.h"
 #include "resize/resize_impl.h"
 
@@ -47,9 +48,65 @@ void test_case(const zimg::resize::Filter &filter, bool horizontal, unsigned src
 	validator.validate();
 }
 
+void test_case_int_load(const zimg::resize::Filter &filter, bool horizontal, unsigned src_w, unsigned src_h, unsigned dst_w, unsigned dst_h,
+                        const zimg::PixelFormat &format, const char * const expected_sha1[3], double expected_snr)
+{
+	if (!zimg::query_x86_capabilities().avx2) {
+		SUCCEED() << "avx2 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE(filter.support());
+	SCOPED_TRACE(horizontal ? static_cast<double>(dst_w) / src_w : static_cast<double>(dst_h) / src_h);
+
+	double range = zimg::depth::integer_range(format);
+	double offset = zimg::depth::integer_offset(format);
+
+	auto builder = zimg::resize::ResizeImplBuilder{ src_w, src_h, zimg::PixelType::FLOAT }
+		.set_horizontal(horizontal)
+		.set_dst_dim(horizontal ? dst_w : dst_h)
+		.set_depth(zimg::pixel_depth(zimg::PixelType::FLOAT))
+		.set_filter(&filter)
+		.set_shift(0.0)
+		.set_subwidth(horizontal ? src_w : src_h)
+		.set_src_type(format.type)
+		.set_src_scale(static_cast<float>(1.0 / range))
+		.set_src_offset(static_cast<float>(-offset / range));
+
+	std::unique_ptr<zimg::graph::ImageFilter> filter_avx2 = builder.set_cpu(zimg::CPUClass::X86_AVX2).create();
+	std::unique_ptr<zimg::graph::ImageFilter> filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_avx2.get()));
+
+	FilterValidator validator{ filter_avx2.get(), src_w, src_h, format };
+	validator.set_sha1(expected_sha1)
+	         .set_ref_filter(filter_c.get(), expected_snr);
+	validator.validate();
+}
+
 } // namespace
 
 
+TEST(ResizeImplAVX2Test, test_resize_h_u8)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 960;
+	const unsigned h = 480;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	const char *expected_sha1[][3] = {
+		{ "d25af586a747c02b3f07d17168ecba710f570957" },
+		{ "9fac889f1f1cf657304f7ce98d7b084abcea4555" },
+		{ "b87a817d682b4b86e68bcc3340a0bfbeb24149b1" },
+		{ "7113b2c9468bc4b8d748cf48e4e808f4ba2a178c" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, true, src_w, h, dst_w, h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, src_w, h, dst_w, h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
+}
+
 TEST(ResizeImplAVX2Test, test_resize_h_u10)
 {
 	const unsigned src_w = 640;
@@ -92,6 +149,27 @@ TEST(ResizeImplAVX2Test, test_resize_h_u16)
 	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
 }
 
+TEST(ResizeImplAVX2Test, test_resize_v_u8)
+{
+	const unsigned w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 720;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	const char *expected_sha1[][3] = {
+		{ "08d0ac1e90d884a0da4b9dae5cede654e33fdc75" },
+		{ "41654c038c26c15b408366993257a9bdca5a8d73" },
+		{ "d1a168cacbe9ce4321c716cf2ce73af31ccbfdbc" },
+		{ "17569d3afa2d4072372a0157b3bdb150ad4ab9e2" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, false, w, src_h, w, dst_h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, src_h, w, dst_h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[3], expected_snr);
+}
+
 TEST(ResizeImplAVX2Test, test_resize_v_u10)
 {
 	const unsigned w = 640;
@@ -218,4 +296,38 @@ TEST(ResizeImplAVX2Test, test_resize_v_f32)
 	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, type, expected_sha1[3], expected_snr);
 }
 
+TEST(ResizeImplAVX2Test, test_resize_h_u8_to_f32)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 960;
+	const unsigned h = 480;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	const char *expected_sha1[][3] = {
+		{ "16c553b2d1ccf7cf6617297c64f830664c38451e" },
+		{ "e72e23223de9afb0f70427bc073b8cb7895308b4" }
+	};
+	const double expected_snr = 120.0;
+
+	test_case_int_load(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format, expected_sha1[0], expected_snr);
+	test_case_int_load(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[1], expected_snr);
+}
+
+TEST(ResizeImplAVX2Test, test_resize_v_u10_to_f32)
+{
+	const unsigned w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 720;
+	const zimg::PixelFormat format{ zimg::PixelType::WORD, 10 };
+
+	const char *expected_sha1[][3] = {
+		{ "e2331a258703a6fd6a8cac093c47af83a6b5760c" },
+		{ "82cfcb37764d2c23db06c840ef00ee1cf2d6e3fb" }
+	};
+	const double expected_snr = 120.0;
+
+	test_case_int_load(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format, expected_sha1[0], expected_snr);
+	test_case_int_load(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[1], expected_snr);
+}
+
 #endif // ZIMG_X86
@@ -1,9 +1,11 @@
 #ifdef ZIMG_X86
 
 #include <cmath>
+#include <memory>
 #include "common/cpuinfo.h"
 #include "common/pixel.h"
 #include "common/x86/cpuinfo_x86.h"
+#include "graph/image_filter.h"
 #include "resize/filter.h"
 #include "resize/resize_impl.h"
 
@@ -31,20 +33,50 @@ void test_case(const zimg::resize::Filter &filter, bool horizontal, unsigned src
 		.set_shift(0.0)
 		.set_subwidth(horizontal ? src_w : src_h);
 
-	auto filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
-	auto filter_sse2 = builder.set_cpu(zimg::CPUClass::X86_SSE2).create();
-
-	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_sse2.get()));
+	std::unique_ptr<zimg::graph::ImageFilter> filter_sse2 = builder.set_cpu(zimg::CPUClass::X86_SSE2).create();
+	std::unique_ptr<zimg::graph::ImageFilter> filter_ref;
 
 	FilterValidator validator{ filter_sse2.get(), src_w, src_h, format };
-	validator.set_sha1(expected_sha1)
-	         .set_ref_filter(filter_c.get(), expected_snr)
-	         .validate();
+	validator.set_sha1(expected_sha1);
+
+	// No half-precision implementation is available in C, so compare against F16C instead.
+	if (format.type != zimg::PixelType::HALF) {
+		filter_ref = builder.set_cpu(zimg::CPUClass::NONE).create();
+		ASSERT_FALSE(assert_different_dynamic_type(filter_ref.get(), filter_sse2.get()));
+		validator.set_ref_filter(filter_ref.get(), expected_snr);
+	} else if (zimg::query_x86_capabilities().avx2 && zimg::query_x86_capabilities().f16c) {
+		filter_ref = builder.set_cpu(zimg::CPUClass::X86_AVX2).create();
+		ASSERT_FALSE(assert_different_dynamic_type(filter_ref.get(), filter_sse2.get()));
+		validator.set_ref_filter(filter_ref.get(), expected_snr);
+	}
+
+	validator.validate();
 }
 
 } // namespace
 
 
+TEST(ResizeImplSSE2Test, test_resize_h_u8)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 960;
+	const unsigned h = 480;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	const char *expected_sha1[][3] = {
+		{ "d25af586a747c02b3f07d17168ecba710f570957" },
+		{ "9fac889f1f1cf657304f7ce98d7b084abcea4555" },
+		{ "b87a817d682b4b86e68bcc3340a0bfbeb24149b1" },
+		{ "7113b2c9468bc4b8d748cf48e4e808f4ba2a178c" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, true, src_w, h, dst_w, h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, src_w, h, dst_w, h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
+}
+
 TEST(ResizeImplSSE2Test, test_resize_h_u10)
 {
 	const unsigned src_w = 640;
@@ -87,6 +119,27 @@ TEST(ResizeImplSSE2Test, test_resize_h_u16)
 	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
 }
 
+TEST(ResizeImplSSE2Test, test_resize_v_u8)
+{
+	const unsigned w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 720;
+	const zimg::PixelFormat format{ zimg::PixelType::BYTE, 8 };
+
+	const char *expected_sha1[][3] = {
+		{ "08d0ac1e90d884a0da4b9dae5cede654e33fdc75" },
+		{ "41654c038c26c15b408366993257a9bdca5a8d73" },
+		{ "d1a168cacbe9ce4321c716cf2ce73af31ccbfdbc" },
+		{ "17569d3afa2d4072372a0157b3bdb150ad4ab9e2" }
+	};
+	const double expected_snr = INFINITY;
+
+	test_case(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, false, w, src_h, w, dst_h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, src_h, w, dst_h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[3], expected_snr);
+}
+
 TEST(ResizeImplSSE2Test, test_resize_v_u10)
 {
 	const unsigned w = 640;
@@ -129,4 +182,46 @@ TEST(ResizeImplSSE2Test, test_resize_v_u16)
 	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[3], expected_snr);
 }
 
+TEST(ResizeImplSSE2Test, test_resize_h_f16)
+{
+	const unsigned src_w = 640;
+	const unsigned dst_w = 960;
+	const unsigned h = 480;
+	const zimg::PixelType format = zimg::PixelType::HALF;
+
+	const char *expected_sha1[][3] = {
+		{ "c2b512147973973d5e402dc04725965e60c9542d" },
+		{ "f1d50cbb6c7f851686e73c97c04c320263e75759" },
+		{ "18f37b744ff4c8e4606223cc88ea4ec86ae62ab3" },
+		{ "6c87e6a3b161781e96c545988c5e80efe8387d36" }
+	};
+	const double expected_snr = 60.0;
+
+	test_case(zimg::resize::BilinearFilter{}, true, src_w, h, dst_w, h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, true, src_w, h, dst_w, h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, src_w, h, dst_w, h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, true, dst_w, h, src_w, h, format, expected_sha1[3], expected_snr);
+}
+
+TEST(ResizeImplSSE2Test, test_resize_v_f16)
+{
+	const unsigned w = 640;
+	const unsigned src_h = 480;
+	const unsigned dst_h = 720;
+	const zimg::PixelType format = zimg::PixelType::HALF;
+
+	const char *expected_sha1[][3] = {
+		{ "0ca3771eb0b432e9bdb01cd1aabe6f16edaea1cc" },
+		{ "09e3b53343e03ae59e12976cfb2b74450031cb22" },
+		{ "227add9872512855524a343e13a3ce37578036fb" },
+		{ "e36fca7540ef773a7e40aa59460313c329426f3b" }
+	};
+	const double expected_snr = 60.0;
+
+	test_case(zimg::resize::BilinearFilter{}, false, w, src_h, w, dst_h, format, expected_sha1[0], expected_snr);
+	test_case(zimg::resize::Spline16Filter{}, false, w, src_h, w, dst_h, format, expected_sha1[1], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, src_h, w, dst_h, format, expected_sha1[2], expected_snr);
+	test_case(zimg::resize::LanczosFilter{ 4 }, false, w, dst_h, w, src_h, format, expected_sha1[3], expected_snr);
+}
+
 #endif // ZIMG_X86
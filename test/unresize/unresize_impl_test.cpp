@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "common/alloc.h"
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "graph/filtergraph.h"
+#include "graph/image_buffer.h"
+#include "graph/image_filter.h"
+#include "unresize/bilinear.h"
+#include "unresize/unresize_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const unsigned w = 19;
+
+// Heights of the unresized image and of the upscaled image. The ratios close
+// to one have a decay spanning most of the image, and the tall images wrap
+// around the forward substitution ring buffer several times.
+const std::pair<unsigned, unsigned> v_cases[] = {
+	{ 10, 12 },
+	{ 17, 20 },
+	{ 37, 74 },
+	{ 40, 41 },
+	{ 48, 64 },
+	{ 100, 101 },
+	{ 167, 333 },
+	{ 500, 501 },
+};
+
+class Plane {
+	zimg::AlignedVector<float> m_data;
+	ptrdiff_t m_stride;
+public:
+	explicit Plane(unsigned height) :
+		m_stride{ static_cast<ptrdiff_t>(zimg::ceil_n(w * sizeof(float), zimg::ALIGNMENT)) }
+	{
+		m_data.resize(m_stride / sizeof(float) * height, NAN);
+	}
+
+	float *row(unsigned i) { return m_data.data() + i * (m_stride / sizeof(float)); }
+	const float *row(unsigned i) const { return m_data.data() + i * (m_stride / sizeof(float)); }
+
+	zimg::graph::ImageBuffer<void> buffer(unsigned mask = zimg::graph::BUFFER_MAX) { return{ m_data.data(), m_stride, mask }; }
+
+	void fill(float x) { std::fill(m_data.begin(), m_data.end(), x); }
+};
+
+Plane random_plane(unsigned height)
+{
+	std::mt19937 engine;
+	std::uniform_real_distribution<float> dist{ 0.0f, 1.0f };
+	Plane plane{ height };
+
+	for (unsigned i = 0; i < height; ++i) {
+		std::generate_n(plane.row(i), w, [&]() { return dist(engine); });
+	}
+	return plane;
+}
+
+// Solve the normal equations over the entire column, without truncating the
+// back substitution.
+Plane reference_unresize_v(const Plane &src, const zimg::unresize::BilinearContext &ctx)
+{
+	unsigned n = ctx.output_width;
+	Plane dst{ n };
+
+	for (unsigned j = 0; j < w; ++j) {
+		std::vector<double> z(n);
+
+		for (unsigned i = 0; i < n; ++i) {
+			double accum = 0.0;
+
+			for (unsigned k = 0; k < ctx.matrix_row_size; ++k) {
+				accum += ctx.matrix_coefficients[i * ctx.matrix_row_stride + k] * src.row(ctx.matrix_row_offsets[i] + k)[j];
+			}
+			z[i] = (accum - ctx.lu_c[i] * (i ? z[i - 1] : 0.0)) * ctx.lu_l[i];
+		}
+		for (unsigned i = n; i != 0; --i) {
+			z[i - 1] -= ctx.lu_u[i - 1] * (i < n ? z[i] : 0.0);
+			dst.row(i - 1)[j] = static_cast<float>(z[i - 1]);
+		}
+	}
+	return dst;
+}
+
+void compare_planes(const Plane &ref, const Plane &test, unsigned height)
+{
+	for (unsigned i = 0; i < height; ++i) {
+		for (unsigned j = 0; j < w; ++j) {
+			float x = ref.row(i)[j];
+			float y = test.row(i)[j];
+			ASSERT_NEAR(x, y, 1e-4f * std::max(1.0f, std::fabs(x))) << "row " << i << " col " << j;
+		}
+	}
+}
+
+void test_case_v(unsigned orig_h, unsigned up_h, zimg::CPUClass cpu)
+{
+	SCOPED_TRACE(orig_h);
+	SCOPED_TRACE(up_h);
+
+	auto filter = zimg::unresize::UnresizeImplBuilder{ w, up_h, zimg::PixelType::FLOAT }
+		.set_horizontal(false)
+		.set_orig_dim(orig_h)
+		.set_shift(0.0)
+		.set_cpu(cpu)
+		.create();
+	auto ctx = zimg::unresize::create_bilinear_context(orig_h, up_h, 0.0);
+
+	Plane src = random_plane(up_h);
+	Plane ref = reference_unresize_v(src, ctx);
+
+	// The input is held in a ring buffer of the advertised size, in which only
+	// the rows of the required range are valid.
+	unsigned src_mask = zimg::graph::select_zimg_buffer_mask(filter->get_max_buffering());
+	Plane src_ring{ src_mask == zimg::graph::BUFFER_MAX ? up_h : src_mask + 1 };
+	Plane dst{ orig_h };
+
+	zimg::AlignedVector<unsigned char> context(filter->get_context_size());
+	zimg::AlignedVector<unsigned char> tmp(filter->get_tmp_size(0, w));
+	filter->init_context(context.data());
+
+	unsigned step = filter->get_simultaneous_lines();
+	unsigned prev_last = 0;
+
+	for (unsigned i = 0; i < orig_h; i += step) {
+		auto range = filter->get_required_row_range(i);
+		ASSERT_LE(range.first, range.second);
+		ASSERT_LE(range.second, up_h);
+		ASSERT_LE(range.second - range.first, filter->get_max_buffering());
+
+		// The required range advances with the output.
+		ASSERT_LE(prev_last, range.second);
+		prev_last = range.second;
+
+		src_ring.fill(NAN);
+		for (unsigned ii = range.first; ii < range.second; ++ii) {
+			std::copy_n(src.row(ii), w, src_ring.row(ii & src_mask));
+		}
+
+		zimg::graph::ImageBuffer<const void> src_buf = src_ring.buffer(src_mask);
+		zimg::graph::ImageBuffer<void> dst_buf = dst.buffer();
+		filter->process(context.data(), &src_buf, &dst_buf, tmp.data(), i, 0, w);
+	}
+	EXPECT_EQ(up_h, prev_last);
+
+	compare_planes(ref, dst, orig_h);
+}
+
+} // namespace
+
+
+TEST(UnresizeImplTest, test_unresize_v_streaming)
+{
+	for (const auto &c : v_cases) {
+		test_case_v(c.first, c.second, zimg::CPUClass::NONE);
+	}
+}
+
+TEST(UnresizeImplTest, test_unresize_v_streaming_simd)
+{
+	for (const auto &c : v_cases) {
+		test_case_v(c.first, c.second, zimg::CPUClass::AUTO_64B);
+	}
+}
+
+TEST(UnresizeImplTest, test_bilinear_decay)
+{
+	const float eps = std::numeric_limits<float>::epsilon();
+
+	for (const auto &c : v_cases) {
+		SCOPED_TRACE(c.first);
+		SCOPED_TRACE(c.second);
+
+		auto ctx = zimg::unresize::create_bilinear_context(c.first, c.second, 0.0);
+		unsigned n = ctx.output_width;
+		ASSERT_GE(ctx.lu_decay, 1U);
+		ASSERT_LE(ctx.lu_decay, n);
+
+		// The product of u over the decay window is negligible for every row
+		// that has a full window.
+		for (unsigned i = 0; i + ctx.lu_decay < n; ++i) {
+			double prod = 1.0;
+
+			for (unsigned k = 0; k < ctx.lu_decay; ++k) {
+				prod *= std::fabs(ctx.lu_u[i + k]);
+			}
+			EXPECT_LT(prod, eps * 1.0001) << "row " << i;
+		}
+	}
+
+	// Nearly unit ratios have |u| close to one, so that the decay spans most
+	// of the image.
+	auto ctx = zimg::unresize::create_bilinear_context(40, 41, 0.0);
+	EXPECT_GT(ctx.lu_decay, 20U);
+}
+
+TEST(UnresizeImplTest, test_unresize_v_graph)
+{
+	const unsigned orig_h = 500;
+	const unsigned up_h = 501;
+
+	auto filter = zimg::unresize::UnresizeImplBuilder{ w, up_h, zimg::PixelType::FLOAT }
+		.set_horizontal(false)
+		.set_orig_dim(orig_h)
+		.set_shift(0.0)
+		.create();
+	auto ctx = zimg::unresize::create_bilinear_context(orig_h, up_h, 0.0);
+
+	Plane src = random_plane(up_h);
+	Plane ref = reference_unresize_v(src, ctx);
+
+	zimg::graph::FilterGraph graph{ w, up_h, zimg::PixelType::FLOAT, 0, 0, false };
+	graph.attach_filter(std::move(filter));
+	graph.complete();
+
+	// Only a window of input rows is buffered, instead of the entire plane.
+	unsigned src_mask = zimg::graph::select_zimg_buffer_mask(graph.get_input_buffering());
+	ASSERT_NE(zimg::graph::BUFFER_MAX, src_mask);
+	ASSERT_LT(src_mask + 1, up_h);
+
+	struct callback_data {
+		const Plane *src;
+		Plane *ring;
+		unsigned mask;
+		unsigned next;
+	};
+
+	auto cb = [](void *ptr, unsigned i, unsigned left, unsigned right) -> int
+	{
+		callback_data *data = static_cast<callback_data *>(ptr);
+
+		// Rows are requested once, in order.
+		EXPECT_EQ(data->next, i);
+		data->next = i + 1;
+
+		std::copy(data->src->row(i) + left, data->src->row(i) + right, data->ring->row(i & data->mask) + left);
+		return 0;
+	};
+
+	Plane src_ring{ src_mask + 1 };
+	Plane dst{ orig_h };
+	callback_data cb_data{ &src, &src_ring, src_mask, 0 };
+
+	zimg::graph::ImageBuffer<const void> src_buf[3] = { src_ring.buffer(src_mask) };
+	zimg::graph::ImageBuffer<void> dst_buf[3] = { dst.buffer() };
+	zimg::AlignedVector<unsigned char> tmp(graph.get_tmp_size());
+
+	graph.process(src_buf, dst_buf, tmp.data(), { cb, &cb_data }, nullptr);
+	EXPECT_EQ(up_h, cb_data.next);
+
+	compare_planes(ref, dst, orig_h);
+}
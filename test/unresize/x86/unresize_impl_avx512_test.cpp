@@ -0,0 +1,72 @@
+#ifdef ZIMG_X86_AVX512
+
+#include "common/cpuinfo.h"
+#include "common/pixel.h"
+#include "common/x86/cpuinfo_x86.h"
+#include "graph/image_filter.h"
+#include "unresize/unresize_impl.h"
+
+#include "gtest/gtest.h"
+#include "graph/filter_validator.h"
+
+namespace {
+
+void test_case(bool horizontal, unsigned up_w, unsigned up_h, unsigned orig_dim, const char * const expected_sha1[3], double expected_snr)
+{
+	if (!zimg::query_x86_capabilities().avx512f) {
+		SUCCEED() << "avx512 not available, skipping";
+		return;
+	}
+
+	SCOPED_TRACE(horizontal ? static_cast<double>(orig_dim) / up_w : static_cast<double>(orig_dim) / up_h);
+
+	auto builder = zimg::unresize::UnresizeImplBuilder{ up_w, up_h, zimg::PixelType::FLOAT }
+		.set_horizontal(horizontal)
+		.set_orig_dim(orig_dim)
+		.set_shift(0.0);
+
+	std::unique_ptr<zimg::graph::ImageFilter> filter_avx512 = builder.set_cpu(zimg::CPUClass::X86_AVX512).create();
+	std::unique_ptr<zimg::graph::ImageFilter> filter_c = builder.set_cpu(zimg::CPUClass::NONE).create();
+
+	ASSERT_FALSE(assert_different_dynamic_type(filter_c.get(), filter_avx512.get()));
+
+	FilterValidator validator{ filter_avx512.get(), up_w, up_h, zimg::PixelType::FLOAT };
+	validator.set_sha1(expected_sha1)
+	         .set_ref_filter(filter_c.get(), expected_snr)
+	         .validate();
+}
+
+} // namespace
+
+
+TEST(UnresizeImplAVX512Test, test_unresize_h_f32)
+{
+	const unsigned up_w = 591;
+	const unsigned h = 333;
+
+	const char *expected_sha1[][3] = {
+		{ "1796aeeec441eb843392921c2413d5464c7bfcb8" },
+		{ "6702ea2fc5d85f050a6cf45afb9d89819396bd38" }
+	};
+	const double expected_snr = 120.0;
+
+	test_case(true, up_w, h, 400, expected_sha1[0], expected_snr);
+	test_case(true, up_w, h, 297, expected_sha1[1], expected_snr);
+}
+
+TEST(UnresizeImplAVX512Test, test_unresize_v_f32)
+{
+	const unsigned w = 591;
+	const unsigned up_h = 333;
+
+	const char *expected_sha1[][3] = {
+		{ "83c2bcbdd80c3e77b8ba0545075344b8d14bdb4d" },
+		{ "d760abdff9d2ee791b8bb6dd803b56bf529158dd" }
+	};
+	const double expected_snr = 120.0;
+
+	test_case(false, w, up_h, 225, expected_sha1[0], expected_snr);
+	test_case(false, w, up_h, 167, expected_sha1[1], expected_snr);
+}
+
+#endif // ZIMG_X86_AVX512